@@ -0,0 +1,269 @@
+/*
+    Project: QIS-X Batch Upscaler
+
+    Description:
+    ------------
+    Headless command-line front end for the CPU upscaler. Takes image files
+    and/or directories, upscales each one to a target size or scale factor and
+    writes the results, with decode, upscale and encode overlapped across cores
+    (see BatchUpscaler.h). Prints images/sec and MPix/sec when done.
+
+    With --bench it runs the benchmarks from Benchmark.h instead and prints
+    their tables; the decoder benchmark times the given files.
+
+    Usage:
+    ------
+        QIS_X-Batch [options] <file|directory>...
+        QIS_X-Batch --bench <suite> [--iterations <n>] [file|directory]...
+
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "BatchUpscaler.h"
+#include "Benchmark.h"
+#include "ImageIO.h"
+
+namespace {
+
+    void PrintUsage()
+    {
+        printf(
+            "Usage: QIS_X-Batch [options] <file|directory>...\n"
+            "  -o <dir>              Output directory (default: upscaled)\n"
+            "  --width <px>          Target width (height follows aspect unless given)\n"
+            "  --height <px>         Target height\n"
+            "  --scale <factor>      Scale when no size is given (default: 1.5)\n"
+            "  --format png|pam      Output format (default: png)\n"
+            "  --sharpen <strength>  Unsharp strength (default: 1.5)\n"
+            "  --rcas <sharpness>    Contrast-adaptive sharpening (0..1) instead of the unsharp mask\n"
+            "  --path separable|fixed|fused|easu|reference\n"
+            "  --simd auto|scalar|sse4.1|avx2|neon\n"
+            "  --linear              Upscale and sharpen in linear light (sRGB content)\n"
+            "  --threads <n>         Upscaler threads (default: one per physical core)\n"
+            "  --decode-threads <n>  Decoder threads (default: 2)\n"
+            "  --encode-threads <n>  Encoder threads (default: 2)\n"
+            "  --queue <n>           Frames in flight between stages (default: 4)\n"
+            "  --mips box|kaiser     Also write each output's mip chain (<name>_mip<N>)\n"
+            "  --srgb                Filter mips in linear light (sRGB content)\n"
+            "  --trace <file>        Write a Chrome trace (chrome://tracing) of the stages\n"
+            "  --trace-log <file>    Write the same profile as a compact binary log\n"
+            "  --bench <suite>       Run benchmarks instead: upscale, linear, sharpen, temporal,\n"
+            "                        decode (times the input files), convert, resize, pacing or all\n"
+            "  --iterations <n>      Timed iterations per benchmark row (default: 5)\n");
+    }
+
+    // Sizes match the numbers quoted when each benchmark was added: an 854x480
+    // render upscaled to 1080p, a 1080p frame for conversions, a 4K texture
+    // reduced to 1080p on load.
+    bool RunBenchmarks(const std::string& suite, int iterations, const std::vector<std::string>& files)
+    {
+        const bool all = suite == "all";
+        bool known = false;
+        auto run = [&](const char* name, const char* title, const auto& fn) {
+            if (!all && suite != name)
+                return;
+            known = true;
+            printf("== %s ==\n%s\n", title, fn().c_str());
+            fflush(stdout);
+        };
+
+        run("upscale", "Upscale paths, 854x480 -> 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkUpscalePaths(854, 480, 1920, 1080, iterations));
+        });
+        run("linear", "Gamma vs linear-light filtering, 854x480 -> 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkLinearLight(854, 480, 1920, 1080, iterations));
+        });
+        run("sharpen", "Unsharp mask vs RCAS, 854x480 -> 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkSharpening(854, 480, 1920, 1080, iterations));
+        });
+        run("temporal", "Temporal accumulation, 854x480 -> 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkTemporal(854, 480, 1920, 1080, iterations));
+        });
+        run("decode", "Image decoders", [&] {
+            if (files.empty())
+                return std::string("(no input files given)\n");
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkImageDecoders(files, iterations));
+        });
+        run("convert", "Pixel conversions, 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkPixelConversions(1920, 1080, iterations));
+        });
+        run("resize", "Resize on load, 3840x2160 -> 1920x1080", [&] {
+            return qisx::FormatBenchmarkTable(qisx::BenchmarkResize(3840, 2160, 1920, 1080, iterations));
+        });
+        run("pacing", "Frame pacing, 4 ms of work per frame", [&] {
+            return qisx::FormatPacingTable(qisx::BenchmarkFramePacing({ 30.0, 60.0, 144.0 }, 2.0, 4.0));
+        });
+        return known;
+    }
+
+    bool ParsePath(const char* name, qisx::UpscalePath& path)
+    {
+        if (!strcmp(name, "separable")) path = qisx::UpscalePath::Separable;
+        else if (!strcmp(name, "fixed")) path = qisx::UpscalePath::FixedPoint;
+        else if (!strcmp(name, "fused")) path = qisx::UpscalePath::Fused;
+        else if (!strcmp(name, "easu")) path = qisx::UpscalePath::EdgeAdaptive;
+        else if (!strcmp(name, "reference")) path = qisx::UpscalePath::Reference;
+        else return false;
+        return true;
+    }
+
+    bool ParseSimd(const char* name, qisx::SimdLevel& level)
+    {
+        for (qisx::SimdLevel l : { qisx::SimdLevel::Auto, qisx::SimdLevel::Scalar, qisx::SimdLevel::SSE41,
+                 qisx::SimdLevel::AVX2, qisx::SimdLevel::NEON }) {
+            if (!strcmp(name, qisx::SimdLevelName(l))) {
+                level = l;
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    qisx::BatchOptions options;
+    options.outputDir = "upscaled";
+    std::vector<std::string> inputs;
+    std::string tracePath, traceLogPath;
+    std::string benchSuite;
+    int benchIterations = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takesValue = [&](const char* name) {
+            if (strcmp(arg, name))
+                return false;
+            if (!value) {
+                fprintf(stderr, "%s needs a value\n", name);
+                exit(2);
+            }
+            i++;
+            return true;
+        };
+
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            PrintUsage();
+            return 0;
+        }
+        else if (takesValue("-o")) options.outputDir = value;
+        else if (takesValue("--width")) options.width = uint32_t(atoi(value));
+        else if (takesValue("--height")) options.height = uint32_t(atoi(value));
+        else if (takesValue("--scale")) options.scale = float(atof(value));
+        else if (takesValue("--format")) options.outputExtension = value;
+        else if (takesValue("--sharpen")) options.upscaler.sharpenStrength = float(atof(value));
+        else if (takesValue("--rcas")) options.upscaler.rcasSharpness = float(atof(value));
+        else if (takesValue("--threads")) options.upscaler.threadCount = uint32_t(atoi(value));
+        else if (takesValue("--decode-threads")) options.decodeThreads = unsigned(atoi(value));
+        else if (takesValue("--encode-threads")) options.encodeThreads = unsigned(atoi(value));
+        else if (takesValue("--queue")) options.queueDepth = size_t(atoi(value));
+        else if (takesValue("--trace")) tracePath = value;
+        else if (takesValue("--trace-log")) traceLogPath = value;
+        else if (takesValue("--bench")) benchSuite = value;
+        else if (takesValue("--iterations")) benchIterations = atoi(value);
+        else if (!strcmp(arg, "--linear")) options.upscaler.linearLight = true;
+        else if (!strcmp(arg, "--srgb")) options.mips.srgb = true;
+        else if (takesValue("--mips")) {
+            options.writeMips = true;
+            if (!strcmp(value, "box")) options.mips.filter = qisx::MipFilter::Box;
+            else if (!strcmp(value, "kaiser")) options.mips.filter = qisx::MipFilter::Kaiser;
+            else {
+                fprintf(stderr, "unknown mip filter '%s'\n", value);
+                return 2;
+            }
+        }
+        else if (takesValue("--path")) {
+            if (!ParsePath(value, options.upscaler.path)) {
+                fprintf(stderr, "unknown path '%s'\n", value);
+                return 2;
+            }
+        }
+        else if (takesValue("--simd")) {
+            if (!ParseSimd(value, options.upscaler.simd)) {
+                fprintf(stderr, "unknown SIMD level '%s'\n", value);
+                return 2;
+            }
+        }
+        else if (arg[0] == '-' && arg[1] != '\0') {
+            fprintf(stderr, "unknown option %s\n", arg);
+            PrintUsage();
+            return 2;
+        }
+        else {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (!benchSuite.empty()) {
+        if (benchIterations < 1) {
+            fprintf(stderr, "iterations must be positive\n");
+            return 2;
+        }
+        if (!RunBenchmarks(benchSuite, benchIterations, qisx::CollectBatchInputs(inputs))) {
+            fprintf(stderr, "unknown benchmark suite '%s'\n", benchSuite.c_str());
+            return 2;
+        }
+        return 0;
+    }
+
+    if (options.outputExtension != "png" && options.outputExtension != "pam") {
+        fprintf(stderr, "unsupported output format '%s'\n", options.outputExtension.c_str());
+        return 2;
+    }
+    if (options.scale <= 0.0f) {
+        fprintf(stderr, "scale must be positive\n");
+        return 2;
+    }
+
+    // Encoder threads already run in parallel; keep each chain on its own thread
+    options.mips.threadCount = 1;
+    options.mips.simd = options.upscaler.simd;
+
+    options.inputs = qisx::CollectBatchInputs(inputs);
+    if (options.inputs.empty()) {
+        PrintUsage();
+        return 2;
+    }
+
+    // One profiled frame per image; keep them all
+    qisx::Profiler::Options profilerOptions;
+    profilerOptions.maxFrames = uint32_t(options.inputs.size());
+    qisx::Profiler profiler(nullptr, profilerOptions);
+    if (!tracePath.empty() || !traceLogPath.empty())
+        options.profiler = &profiler;
+
+    qisx::BatchStats stats;
+    bool ok = qisx::RunBatch(options, stats, [](const std::string& message) {
+        fprintf(stderr, "error: %s\n", message.c_str());
+    });
+
+    printf("%u images (%u failed) in %.3f s: %.2f images/s, %.1f MPix/s output (%.1f MPix in)\n",
+        stats.images, stats.failures, stats.seconds, stats.ImagesPerSecond(), stats.MegapixelsPerSecond(),
+        stats.inputPixels / 1e6);
+    printf("busy time: decode %.3f s, upscale %.3f s, encode %.3f s\n",
+        stats.decodeSeconds, stats.upscaleSeconds, stats.encodeSeconds);
+    printf("input: %.1f MB read, %.1f MB copied before decoding\n",
+        stats.inputBytes / 1e6, stats.inputBytesCopied / 1e6);
+
+    if (options.profiler) {
+        const qisx::ProfileCapture capture = profiler.Capture();
+        for (const qisx::PassSummary& pass : qisx::SummarizePasses(capture))
+            printf("%-8s %5u calls, mean %.2f ms, max %.2f ms\n", pass.name.c_str(), pass.calls, pass.meanMs, pass.maxMs);
+        const std::string json = qisx::ToChromeTrace(capture);
+        if (!tracePath.empty() && !qisx::WriteFileBytes(tracePath, std::vector<uint8_t>(json.begin(), json.end()))) {
+            fprintf(stderr, "error: cannot write %s\n", tracePath.c_str());
+            ok = false;
+        }
+        if (!traceLogPath.empty() && !qisx::WriteFileBytes(traceLogPath, qisx::ToBinaryLog(capture))) {
+            fprintf(stderr, "error: cannot write %s\n", traceLogPath.c_str());
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
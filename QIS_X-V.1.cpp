@@ -28,12 +28,18 @@
 #include <DirectXMath.h>
 #include<dxgi1_4.h>
 
+#include<algorithm>
 #include<format>
 #include<iostream>
 #include <cstdio>
 
 #include "QIS_X-V.1.h"
+#include "D3D11SwapChain.h"
 #include "FrameSync.h"
+#include "GpuProfiler.h"
+#include "ImageIO.h"
+#include "DynamicResolution.h"
+#include "JitterSequence.h"
 #include "Texture.h"
 
 #pragma comment(lib, "d3d11.lib")
@@ -46,22 +52,45 @@ HWND g_hWnd = nullptr;
 ID3D11Device* g_pDevice = nullptr;
 ID3D11DeviceContext* g_pContext = nullptr;
 IDXGISwapChain* g_pSwapChain = nullptr;
+qisx::D3D11SwapChain* g_pSwapChainTargets = nullptr;      // Cached back buffer RTV
+qisx::SwapChainManager* g_pSwapChainManager = nullptr;    // Resizes and the single Present
+UINT g_OutputWidth = 1280;                       // Back buffer size, follows the window
+UINT g_OutputHeight = 720;
 FrameSync* g_frameSync = nullptr;
 ID3D11ShaderResourceView* g_pDemoTexture = nullptr;
 UINT g_textureWidth = 0;
 UINT g_textureHeight = 0;
 bool g_SplitScreen = true;
+enum class UpscaleShader { Fused, Main, Easu, Count };
+UpscaleShader g_UpscaleShader = UpscaleShader::Fused;  // F2 cycles PS_fused / PS_main / PS_easu for A/B comparison
+bool g_UseRcas = false;                          // F3 toggles PS_rcas in place of the unsharp mask
+float g_RcasSharpness = 0.8f;                    // F4 / F5 lower / raise it in steps of 0.1
+bool g_UseJitter = false;                        // F6 jitters the scene pass for temporal upscaling
+qisx::JitterSequence g_Jitter(854, 480, 1280);   // Halton (2, 3), 18 phases at 480p -> 720p
+bool g_UseDrs = false;                           // F7 sizes the scene pass from frame times (DynamicResolution)
+qisx::DynamicResolution g_Drs;                   // 50-100% of the 720p target, initially 2/3 (~480p)
+UINT g_RenderWidth = 854;                        // Region of g_pLowResRT the scene pass draws into
+UINT g_RenderHeight = 480;
+qisx::Profiler g_Profiler;                       // Per-pass CPU times; F8 writes the last 600 frames
+qisx::GpuProfiler g_GpuProfiler(g_Profiler);     // Per-pass GPU times (timestamp queries)
 
 
 // Upscaling Resources
-ID3D11Texture2D* g_pLowResRT = nullptr;          // 480p render target
+ID3D11Texture2D* g_pLowResRT = nullptr;          // Scene target, 720p so DRS can grow without reallocating
 ID3D11RenderTargetView* g_pLowResRTV = nullptr;  // RTV for low-res
 ID3D11ShaderResourceView* g_pLowResSRV = nullptr; // SRV for upscaling
+ID3D11Texture2D* g_pUpscaledRT = nullptr;        // Output-size upscale result, sharpened by PS_rcas
+ID3D11RenderTargetView* g_pUpscaledRTV = nullptr;
+ID3D11ShaderResourceView* g_pUpscaledSRV = nullptr;
+ID3D11Buffer* g_pUpscaleCB = nullptr;            // UpscaleConstants (b0)
 
 // Full-screen Quad Resources
 ID3D11Buffer* g_pQuadVB = nullptr;               // Vertex buffer
 ID3D11VertexShader* g_pVS = nullptr;             // Vertex shader
 ID3D11PixelShader* g_pPS = nullptr;              // Pixel shader
+ID3D11PixelShader* g_pFusedPS = nullptr;         // Single-pass bicubic + sharpen (PS_fused)
+ID3D11PixelShader* g_pEasuPS = nullptr;          // Edge-adaptive upscale (PS_easu)
+ID3D11PixelShader* g_pRcasPS = nullptr;          // Contrast-adaptive sharpening (PS_rcas)
 ID3D11InputLayout* g_pInputLayout = nullptr;     // Input layout
 ID3D11SamplerState* g_pSamplerState = nullptr;   // Sampler state
 
@@ -76,6 +105,15 @@ struct CB {
     float screenSize;
 };
 
+// Matches cbuffer UpscaleConstants in shaders.hlsl
+struct UpscaleConstants {
+    float sharpenStrength;
+    float rcasSharpness;
+    float jitterOffset[2];  // JitterSample::clipX / clipY for the scene pass
+    float viewportSize[2];  // g_RenderWidth / g_RenderHeight for the upscale pass, 0 for the scene pass
+    float viewportPadding[2];
+};
+
 
 // Helper Function for error Checking
 void CheckHR(HRESULT hr, const char* message) {
@@ -85,6 +123,66 @@ void CheckHR(HRESULT hr, const char* message) {
     }
 }
 
+// Selected upscale shader; variants that failed to compile fall back to PS_main
+ID3D11PixelShader* ActiveUpscaleShader() {
+    if (g_UpscaleShader == UpscaleShader::Fused && g_pFusedPS) return g_pFusedPS;
+    if (g_UpscaleShader == UpscaleShader::Easu && g_pEasuPS) return g_pEasuPS;
+    return g_pPS;
+}
+
+const wchar_t* ActiveUpscaleShaderName() {
+    ID3D11PixelShader* shader = ActiveUpscaleShader();
+    return shader == g_pFusedPS ? L"fused" : shader == g_pEasuPS ? L"easu" : L"PS_main";
+}
+
+bool RcasActive() {
+    return g_UseRcas && g_pRcasPS && g_pUpscaledRTV && g_pUpscaleCB;
+}
+
+// Writes the kept frames as qisx_profile.json (chrome://tracing) and
+// qisx_profile.qprof, and the per-pass means to the debug output.
+void WriteProfile() {
+    const qisx::ProfileCapture capture = g_Profiler.Capture();
+    for (const qisx::PassSummary& pass : qisx::SummarizePasses(capture)) {
+        OutputDebugStringA(std::format("{} {}: mean {:.3f} ms, max {:.3f} ms over {} frames\n",
+            pass.track == qisx::ProfileTrack::Gpu ? "GPU" : "CPU", pass.name, pass.meanMs, pass.maxMs, pass.frames).c_str());
+    }
+    const std::string json = qisx::ToChromeTrace(capture);
+    const bool ok = qisx::WriteFileBytes("qisx_profile.json", std::vector<uint8_t>(json.begin(), json.end()))
+        && qisx::WriteFileBytes("qisx_profile.qprof", qisx::ToBinaryLog(capture));
+    OutputDebugStringA(ok ? "Profile written to qisx_profile.json / .qprof\n" : "Failed to write profile\n");
+}
+
+// Region of the scene target used from the next frame on. Only the viewport
+// and the constants change; the jitter sequence follows the new ratio.
+void SetRenderSize(UINT width, UINT height) {
+    g_RenderWidth = width;
+    g_RenderHeight = height;
+    g_Jitter.Configure(width, height, g_OutputWidth);
+}
+
+// Full-resolution intermediate for the RCAS pass; without it F3 does nothing.
+// PS_rcas reads it texel for texel, so it follows the back buffer size.
+void CreateUpscaledTarget(UINT width, UINT height) {
+    if (g_pUpscaledSRV) { g_pUpscaledSRV->Release(); g_pUpscaledSRV = nullptr; }
+    if (g_pUpscaledRTV) { g_pUpscaledRTV->Release(); g_pUpscaledRTV = nullptr; }
+    if (g_pUpscaledRT) { g_pUpscaledRT->Release(); g_pUpscaledRT = nullptr; }
+
+    D3D11_TEXTURE2D_DESC texDesc = {};
+    texDesc.Width = width;
+    texDesc.Height = height;
+    texDesc.MipLevels = 1;
+    texDesc.ArraySize = 1;
+    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Usage = D3D11_USAGE_DEFAULT;
+    texDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+    if (SUCCEEDED(g_pDevice->CreateTexture2D(&texDesc, nullptr, &g_pUpscaledRT))) {
+        CheckHR(g_pDevice->CreateRenderTargetView(g_pUpscaledRT, nullptr, &g_pUpscaledRTV), "Failed to create upscaled RTV");
+        CheckHR(g_pDevice->CreateShaderResourceView(g_pUpscaledRT, nullptr, &g_pUpscaledSRV), "Failed to create upscaled SRV");
+    }
+}
+
 
 
 
@@ -108,8 +206,12 @@ void Cleanup();
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR pCmdLine, int nCmdShow) {
     if (!InitWindow(hInstance, nCmdShow)) return 1;
     if (!InitD3D11()) return 1;
+    g_pSwapChainTargets = new qisx::D3D11SwapChain(g_pDevice, g_pSwapChain);
+    g_pSwapChainManager = new qisx::SwapChainManager(*g_pSwapChainTargets, g_OutputWidth, g_OutputHeight);
     if (!CreateLowResResources()) return 1;
     if (!CreateFullscreenQuad()) return 1;
+    if (!g_GpuProfiler.Init(g_pDevice, g_pContext))
+        OutputDebugStringA("GPU timestamps unavailable; profiling CPU only\n");
    
 
 
@@ -160,6 +262,18 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR pCmdLine, int nCmdShow
         else {
             
             frameSync.BeginFrame();
+            if (!g_pSwapChainManager->BeginFrame()) {
+                frameSync.EndFrame(60);
+                continue;
+            }
+            if (g_pSwapChainManager->GetWidth() != g_OutputWidth || g_pSwapChainManager->GetHeight() != g_OutputHeight) {
+                g_OutputWidth = g_pSwapChainManager->GetWidth();
+                g_OutputHeight = g_pSwapChainManager->GetHeight();
+                CreateUpscaledTarget(g_OutputWidth, g_OutputHeight);
+                SetRenderSize(g_RenderWidth, g_RenderHeight);
+            }
+            g_Profiler.BeginFrame();
+            g_GpuProfiler.BeginFrame();
 
             // Clear both render targets
             float clearColor[4] = { 0.0f , 0.0f , 0.0f , 1.0f };
@@ -167,26 +281,61 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR pCmdLine, int nCmdShow
 
   
             // 1. Render scene to low-res render target (480p)
-            RenderSceneToLowResRT();
-            // 2. Upscale to backbuffer (720p)
-            UpscaleToBackbuffer();
+            {
+                qisx::ProfileScope cpu(g_Profiler, "Scene");
+                qisx::GpuScope gpu(g_GpuProfiler, "Scene");
+                RenderSceneToLowResRT();
+            }
+            // 2. Upscale to backbuffer (window size, 720p initially)
+            {
+                qisx::ProfileScope cpu(g_Profiler, "Upscale");
+                qisx::GpuScope gpu(g_GpuProfiler, "Upscale");
+                UpscaleToBackbuffer();
+            }
+            g_GpuProfiler.EndFrame();
 
 
 
             static float fpsUpdateTimer = 0.0f;
             fpsUpdateTimer += frameSync.GetDeltaTime();
             if (fpsUpdateTimer >= 0.25f) {
+                // Tail latency over the last two seconds
+                const qisx::FrameTimeSummary stats = frameSync.GetStats(frameSync.GetTimer().GetHistory().GetCapacity(), 2.0f);
                 wchar_t title[256];
-                swprintf_s(title, L"QIS-X Upscaler - %.1f FPS (Frame Time: %.2fms)",
+                swprintf_s(title, L"QIS-X Upscaler - %.1f FPS (Frame Time: %.2fms, p99 %.2fms, 1%% low %.0f) [%ux%u%s, %s%s%s]",
                     frameSync.GetFPS(),
-                    frameSync.GetDeltaTime() * 1000.0f);
+                    frameSync.GetDeltaTime() * 1000.0f,
+                    stats.p99Ms,
+                    stats.onePercentLowFps,
+                    g_RenderWidth, g_RenderHeight,
+                    g_UseDrs ? L" drs" : L"",
+                    ActiveUpscaleShaderName(),
+                    RcasActive() ? std::format(L" + rcas {:.1f}", g_RcasSharpness).c_str() : L"",
+                    g_UseJitter ? std::format(L", jitter {} phases", g_Jitter.GetPhaseCount()).c_str() : L"");
                 SetWindowText(g_hWnd, title);
                 fpsUpdateTimer = 0.0f;
             }
 
-            // 3. Present
-            g_pSwapChain->Present(1, 0);
-            frameSync.EndFrame(60);
+            // CPU time of the frame so far and the GPU time of the newest
+            // resolved frame (two behind; -1 without timestamps, when the CPU
+            // time stands in for it) size the next one
+            if (g_UseDrs) {
+                const qisx::FrameTimer& timer = frameSync.GetTimer();
+                const float cpuMs = float(timer.GetClock().Now() - timer.GetFrameStart()) * 1e-6f;
+                if (g_Drs.Update(cpuMs, g_GpuProfiler.GetLastFrameMs()))
+                    SetRenderSize(g_Drs.GetWidth(), g_Drs.GetHeight());
+            }
+
+            // 3. Present, the only one per frame
+            {
+                qisx::ProfileScope cpu(g_Profiler, "Present");
+                g_pSwapChainManager->Present(1);
+            }
+            {
+                qisx::ProfileScope cpu(g_Profiler, "Pace");
+                frameSync.EndFrame(60);
+            }
+            g_Profiler.EndFrame();
 
 
         }
@@ -206,6 +355,43 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     case WM_DESTROY:
         PostQuitMessage(0);
         return 0;
+    case WM_SIZE:
+        // Applied by the next BeginFrame; minimising (0 x 0) keeps the buffers
+        if (g_pSwapChainManager && wParam != SIZE_MINIMIZED)
+            g_pSwapChainManager->RequestResize(LOWORD(lParam), HIWORD(lParam));
+        return 0;
+    case WM_KEYDOWN:
+        if (wParam == VK_F2) {
+            g_UpscaleShader = static_cast<UpscaleShader>((int(g_UpscaleShader) + 1) % int(UpscaleShader::Count));
+            return 0;
+        }
+        if (wParam == VK_F3) {
+            g_UseRcas = !g_UseRcas;
+            return 0;
+        }
+        if (wParam == VK_F4 || wParam == VK_F5) {
+            g_RcasSharpness = std::clamp(g_RcasSharpness + (wParam == VK_F5 ? 0.1f : -0.1f), 0.0f, 1.0f);
+            return 0;
+        }
+        if (wParam == VK_F6) {
+            g_UseJitter = !g_UseJitter;
+            g_Jitter.Reset();
+            return 0;
+        }
+        if (wParam == VK_F8) {
+            WriteProfile();
+            return 0;
+        }
+        if (wParam == VK_F7) {
+            g_UseDrs = !g_UseDrs;
+            g_Drs.Reset();
+            if (g_UseDrs)
+                SetRenderSize(g_Drs.GetWidth(), g_Drs.GetHeight());
+            else
+                SetRenderSize(854, 480);
+            return 0;
+        }
+        return DefWindowProc(hWnd, msg, wParam, lParam);
     default:
         return DefWindowProc(hWnd, msg, wParam, lParam);
     }
@@ -282,10 +468,11 @@ bool InitD3D11() {
 }
 
 bool CreateLowResResources() {
-    // Create low-res texture (854x480)
+    // Create the scene target at the largest DRS size (scale 1); each frame
+    // draws into its top-left g_RenderWidth x g_RenderHeight
     D3D11_TEXTURE2D_DESC texDesc = {};
-    texDesc.Width = 854;
-    texDesc.Height = 480;
+    texDesc.Width = g_Drs.GetOptions().maxWidth;
+    texDesc.Height = g_Drs.GetOptions().maxHeight;
     texDesc.MipLevels = 1;
     texDesc.ArraySize = 1;
     texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -302,6 +489,18 @@ bool CreateLowResResources() {
     hr = g_pDevice->CreateShaderResourceView(g_pLowResRT, nullptr, &g_pLowResSRV);
     CheckHR(hr, "Failed to create SRV");
 
+    CreateUpscaledTarget(g_OutputWidth, g_OutputHeight);
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.ByteWidth = sizeof(UpscaleConstants);
+    cbDesc.Usage = D3D11_USAGE_DEFAULT;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    const UpscaleConstants constants = { 1.5f, g_RcasSharpness };
+    D3D11_SUBRESOURCE_DATA cbData = { &constants };
+    CheckHR(g_pDevice->CreateBuffer(&cbDesc, &cbData, &g_pUpscaleCB), "Failed to create upscale constant buffer");
+    if (g_pUpscaleCB)
+        g_pContext->PSSetConstantBuffers(0, 1, &g_pUpscaleCB);  // PS_main also draws the scene
+
     return SUCCEEDED(hr);
     if (g_pLowResRT == nullptr) {  
         OutputDebugStringA("Error: g_pLowResRT is null before calling CreateShaderResourceView\n");  
@@ -380,6 +579,52 @@ bool CreateFullscreenQuad() {
     CheckHR(hr, "Failed to create pixel shader");
     psBlob->Release();
 
+    // Fused variant is optional; fall back to PS_main if it fails to compile
+    ID3DBlob* fusedBlob = nullptr;
+    hr = D3DCompileFromFile(L"shaders.hlsl", nullptr, nullptr,
+        "PS_fused", "ps_5_0", 0, 0, &fusedBlob, &errorBlob);
+    if (SUCCEEDED(hr)) {
+        hr = g_pDevice->CreatePixelShader(fusedBlob->GetBufferPointer(),
+            fusedBlob->GetBufferSize(), nullptr, &g_pFusedPS);
+        CheckHR(hr, "Failed to create fused pixel shader");
+        fusedBlob->Release();
+    }
+    else if (errorBlob) {
+        OutputDebugStringA((char*)errorBlob->GetBufferPointer());
+        errorBlob->Release();
+    }
+
+    // Same for the edge-adaptive variant and the RCAS pass
+    ID3DBlob* easuBlob = nullptr;
+    errorBlob = nullptr;
+    hr = D3DCompileFromFile(L"shaders.hlsl", nullptr, nullptr,
+        "PS_easu", "ps_5_0", 0, 0, &easuBlob, &errorBlob);
+    if (SUCCEEDED(hr)) {
+        hr = g_pDevice->CreatePixelShader(easuBlob->GetBufferPointer(),
+            easuBlob->GetBufferSize(), nullptr, &g_pEasuPS);
+        CheckHR(hr, "Failed to create EASU pixel shader");
+        easuBlob->Release();
+    }
+    else if (errorBlob) {
+        OutputDebugStringA((char*)errorBlob->GetBufferPointer());
+        errorBlob->Release();
+    }
+
+    ID3DBlob* rcasBlob = nullptr;
+    errorBlob = nullptr;
+    hr = D3DCompileFromFile(L"shaders.hlsl", nullptr, nullptr,
+        "PS_rcas", "ps_5_0", 0, 0, &rcasBlob, &errorBlob);
+    if (SUCCEEDED(hr)) {
+        hr = g_pDevice->CreatePixelShader(rcasBlob->GetBufferPointer(),
+            rcasBlob->GetBufferSize(), nullptr, &g_pRcasPS);
+        CheckHR(hr, "Failed to create RCAS pixel shader");
+        rcasBlob->Release();
+    }
+    else if (errorBlob) {
+        OutputDebugStringA((char*)errorBlob->GetBufferPointer());
+        errorBlob->Release();
+    }
+
     // Create sampler state
     D3D11_SAMPLER_DESC sampDesc = {};
     sampDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
@@ -397,8 +642,8 @@ bool CreateFullscreenQuad() {
 
 void RenderSceneToLowResRT() {
 
-    // Set viewport to match low-res render target (854x480)
-    D3D11_VIEWPORT vp = { 0.0f, 0.0f, 854.0f, 480.0f, 0.0f, 1.0f };
+    // Draw into the active region of the low-res render target
+    D3D11_VIEWPORT vp = { 0.0f, 0.0f, float(g_RenderWidth), float(g_RenderHeight), 0.0f, 1.0f };
     g_pContext->RSSetViewports(1, &vp);
 
     // Clear to a visible color (green)
@@ -406,6 +651,15 @@ void RenderSceneToLowResRT() {
     g_pContext->ClearRenderTargetView(g_pLowResRTV, clearColor);
     g_pContext->OMSetRenderTargets(1, &g_pLowResRTV, nullptr);
 
+    // Sub-pixel jitter for this frame. VS_main offsets the quad by it; a scene
+    // with a camera would add sample.ProjectionDelta() to its projection instead.
+    // viewportSize stays 0: PS_main samples all of the demo texture here.
+    if (g_pUpscaleCB) {
+        const qisx::JitterSample sample = g_UseJitter ? g_Jitter.Next() : qisx::JitterSample{};
+        const UpscaleConstants constants = { RcasActive() ? 0.0f : 1.5f, g_RcasSharpness, { sample.clipX, sample.clipY } };
+        g_pContext->UpdateSubresource(g_pUpscaleCB, 0, nullptr, &constants, 0, 0);
+        g_pContext->VSSetConstantBuffers(0, 1, &g_pUpscaleCB);
+    }
 
     // Set input layout and primitive topology
     g_pContext->IASetInputLayout(g_pInputLayout);
@@ -427,36 +681,35 @@ void RenderSceneToLowResRT() {
 }
 
 void UpscaleToBackbuffer() {
-    // Get back buffer
-    ID3D11Texture2D* pBackBuffer = nullptr;
-    HRESULT hr = g_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&pBackBuffer);
-    if (FAILED(hr)) {
-        OutputDebugStringA("Failed to get back buffer\n");
+    // Back buffer view, created by the swap chain manager once per resize
+    ID3D11RenderTargetView* pBackbufferRTV = g_pSwapChainTargets->GetTarget(g_pSwapChainManager->GetCurrentTarget());
+    if (!pBackbufferRTV) {
+        OutputDebugStringA("No back buffer RTV\n");
         return;
     }
 
-    // Create render target view
-    ID3D11RenderTargetView* pBackbufferRTV = nullptr;
-    hr = g_pDevice->CreateRenderTargetView(pBackBuffer, nullptr, &pBackbufferRTV);
-    pBackBuffer->Release();
-
-    if (FAILED(hr)) {
-        OutputDebugStringA("Failed to create RTV for back buffer\n");
-        return;
+    // With RCAS the upscale renders unsharpened into the intermediate target,
+    // which PS_rcas then sharpens into the back buffer
+    const bool rcas = RcasActive();
+    if (g_pUpscaleCB) {
+        const UpscaleConstants constants = { rcas ? 0.0f : 1.5f, g_RcasSharpness, { 0.0f, 0.0f },  // No jitter
+            { float(g_RenderWidth), float(g_RenderHeight) } };
+        g_pContext->UpdateSubresource(g_pUpscaleCB, 0, nullptr, &constants, 0, 0);
+        g_pContext->PSSetConstantBuffers(0, 1, &g_pUpscaleCB);
     }
 
     // Clear to magenta so we know if rendering fails
     float clearColor[4] = { 1.0f, 0.0f, 1.0f, 1.0f };
     g_pContext->ClearRenderTargetView(pBackbufferRTV, clearColor);
-    g_pContext->OMSetRenderTargets(1, &pBackbufferRTV, nullptr);
+    g_pContext->OMSetRenderTargets(1, rcas ? &g_pUpscaledRTV : &pBackbufferRTV, nullptr);
 
     // Set viewport
-    D3D11_VIEWPORT vp = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+    D3D11_VIEWPORT vp = { 0.0f, 0.0f, float(g_OutputWidth), float(g_OutputHeight), 0.0f, 1.0f };
     g_pContext->RSSetViewports(1, &vp);
 
     // Set shaders and resources
     g_pContext->VSSetShader(g_pVS, nullptr, 0);
-    g_pContext->PSSetShader(g_pPS, nullptr, 0);
+    g_pContext->PSSetShader(ActiveUpscaleShader(), nullptr, 0);
     g_pContext->PSSetShaderResources(0, 1, &g_pLowResSRV);
     g_pContext->PSSetSamplers(0, 1, &g_pSamplerState);
     g_pContext->IASetInputLayout(g_pInputLayout);
@@ -470,24 +723,44 @@ void UpscaleToBackbuffer() {
     // Draw the quad
     g_pContext->Draw(4, 0);
 
-    // Present
-    g_pSwapChain->Present(1, 0);
-    pBackbufferRTV->Release();
+    if (rcas) {
+        g_pContext->OMSetRenderTargets(1, &pBackbufferRTV, nullptr);
+        g_pContext->PSSetShader(g_pRcasPS, nullptr, 0);
+        g_pContext->PSSetShaderResources(0, 1, &g_pUpscaledSRV);
+        g_pContext->Draw(4, 0);
+
+        // Unbind so the intermediate can be a render target again next frame
+        ID3D11ShaderResourceView* nullSRV = nullptr;
+        g_pContext->PSSetShaderResources(0, 1, &nullSRV);
+    }
 }
 
 //-----------------------------------------------------------------------------
 // Cleanup 
 //-----------------------------------------------------------------------------
 void Cleanup() {
+    g_GpuProfiler.Shutdown();
+    delete g_pSwapChainManager;
+    g_pSwapChainManager = nullptr;
+    delete g_pSwapChainTargets;
+    g_pSwapChainTargets = nullptr;
     if (g_pDemoTexture) {
         g_pDemoTexture->Release();
         g_pDemoTexture = nullptr; // Prevent dangling pointers
     }
+    ClearTextureCache();
     if (g_pSamplerState) g_pSamplerState->Release();
     if (g_pInputLayout) g_pInputLayout->Release();
+    if (g_pRcasPS) g_pRcasPS->Release();
+    if (g_pEasuPS) g_pEasuPS->Release();
+    if (g_pFusedPS) g_pFusedPS->Release();
     if (g_pPS) g_pPS->Release();
     if (g_pVS) g_pVS->Release();
     if (g_pQuadVB) g_pQuadVB->Release();
+    if (g_pUpscaleCB) g_pUpscaleCB->Release();
+    if (g_pUpscaledSRV) g_pUpscaledSRV->Release();
+    if (g_pUpscaledRTV) g_pUpscaledRTV->Release();
+    if (g_pUpscaledRT) g_pUpscaledRT->Release();
     if (g_pLowResSRV) g_pLowResSRV->Release();
     if (g_pLowResRTV) g_pLowResRTV->Release();
     if (g_pLowResRT) g_pLowResRT->Release();
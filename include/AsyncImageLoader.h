@@ -0,0 +1,127 @@
+#pragma once
+#include "Image.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace qisx {
+
+    enum class AsyncLoadStatus {
+        Queued,
+        Decoding,
+        Uploading,  // Decoded; waiting for or in the middle of render-thread upload
+        Complete,
+        Failed,
+        Cancelled,
+    };
+
+    // Hooks for one load. Everything except convert runs on the thread that
+    // calls AsyncImageLoader::Pump() (the render thread).
+    struct AsyncLoadCallbacks {
+        // Worker thread, after decoding: in-place conversion to the destination
+        // layout (channel order, premultiplied alpha, ...). Optional.
+        std::function<bool(Image& image)> convert;
+
+        // Allocates the destination, e.g. an empty texture. Optional.
+        std::function<bool(uint32_t width, uint32_t height)> begin;
+
+        // Copies a band of rows starting at firstRow, e.g. UpdateSubresource with
+        // a box. Without it the decoded Image itself is the result (CPU buffer).
+        std::function<bool(const ImageView& band, uint32_t firstRow)> upload;
+
+        // Called exactly once when the load completes, fails or is cancelled.
+        // image holds the decoded pixels (empty on failure) and may be moved from.
+        std::function<void(AsyncLoadStatus status, const std::string& error, Image& image)> complete;
+    };
+
+    // Caller's view of a load in flight.
+    class AsyncLoad {
+    public:
+        AsyncLoadStatus Status() const { return m_status.load(); }
+        bool Done() const
+        {
+            const AsyncLoadStatus s = Status();
+            return s == AsyncLoadStatus::Complete || s == AsyncLoadStatus::Failed || s == AsyncLoadStatus::Cancelled;
+        }
+        const std::filesystem::path& Path() const { return m_path; }
+        const std::string& Error() const { return m_error; }   // Valid once Done()
+
+    private:
+        friend class AsyncImageLoader;
+
+        std::filesystem::path m_path;
+        std::string m_error;
+        std::atomic<AsyncLoadStatus> m_status{ AsyncLoadStatus::Queued };
+        AsyncLoadCallbacks m_callbacks;
+        Image m_image;
+        bool m_decodeFailed = false;    // Set by the worker; only Finish() publishes Failed
+        uint32_t m_nextRow = 0;
+        bool m_begun = false;
+    };
+
+    using AsyncLoadHandle = std::shared_ptr<const AsyncLoad>;
+
+    struct AsyncPumpStats {
+        double milliseconds = 0.0;  // Time spent inside Pump()
+        uint32_t rowsUploaded = 0;
+        uint32_t completed = 0;     // Loads finished (any outcome) during this call
+    };
+
+    // Reads, decodes and converts images on worker threads and finishes them on
+    // the render thread in row bands sized to fit a per-frame time budget, so a
+    // large image is spread over several frames instead of causing a hitch.
+    //
+    // Band sizes come from the measured cost of earlier bands. Pump() always
+    // makes some progress, so a single begin() or one-row band slower than the
+    // whole budget can still overrun it.
+    class AsyncImageLoader {
+    public:
+        struct Options {
+            unsigned workerThreads = 2;
+            double frameBudgetMs = 2.0;
+        };
+
+        explicit AsyncImageLoader(const Options& options);
+        ~AsyncImageLoader();    // Cancels loads that have not finished
+
+        AsyncImageLoader(const AsyncImageLoader&) = delete;
+        AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+        // Thread-safe. The path is opened as given (wide on Windows), never
+        // narrowed to the ANSI code page.
+        AsyncLoadHandle Load(const std::filesystem::path& path, AsyncLoadCallbacks callbacks);
+
+        // Call once per frame from the render thread.
+        AsyncPumpStats Pump();
+
+        // Loads started and not yet completed, failed or cancelled.
+        size_t Pending() const { return m_pending.load(); }
+
+        const Options& GetOptions() const { return m_options; }
+
+    private:
+        void Decode(const std::shared_ptr<AsyncLoad>& load);
+        void Finish(AsyncLoad& load, AsyncLoadStatus status);
+
+        Options m_options;
+        std::atomic<bool> m_stopping{ false };
+        std::atomic<size_t> m_pending{ 0 };
+
+        std::mutex m_readyMutex;
+        std::deque<std::shared_ptr<AsyncLoad>> m_ready;     // Decoded (or failed), oldest first
+        std::shared_ptr<AsyncLoad> m_current;               // Being uploaded; render thread only
+
+        // Render-thread cost estimates, refined after every call
+        double m_msPerMegabyte = 1.0;
+        double m_beginMs = 0.1;
+
+        std::unique_ptr<ThreadPool> m_pool;     // Last: joined before the rest is destroyed
+    };
+
+}
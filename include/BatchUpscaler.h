@@ -0,0 +1,70 @@
+#pragma once
+#include "CpuUpscaler.h"
+#include "MipGenerator.h"
+#include "Profiler.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace qisx {
+
+    struct BatchOptions {
+        std::vector<std::string> inputs;    // Image files (see CollectBatchInputs)
+        std::string outputDir;              // Created if missing
+        std::string outputExtension = "png";
+
+        // Target size. With both zero, each image is scaled by `scale`; with one
+        // zero, that side follows the source aspect ratio.
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float scale = 1.5f;
+
+        unsigned decodeThreads = 2;
+        unsigned encodeThreads = 2;
+        size_t queueDepth = 4;              // Frames in flight between each pair of stages
+        CpuUpscaler::Options upscaler;
+
+        // Also writes the mip chain of each output as <name>_mip<N>.<ext>, N >= 1
+        bool writeMips = false;
+        MipGenerator::Options mips;         // Run per encoder thread
+
+        // Records Decode / Upscale / Encode / Mips scopes, one frame per
+        // upscaled image. Must be created on the thread that calls RunBatch.
+        Profiler* profiler = nullptr;
+    };
+
+    struct BatchStats {
+        uint32_t images = 0;                // Written successfully
+        uint32_t failures = 0;
+        uint64_t inputPixels = 0;
+        uint64_t outputPixels = 0;
+        uint64_t inputBytes = 0;            // Encoded size of the files read
+        uint64_t inputBytesCopied = 0;      // Of those, copied before decoding (0 when mapped)
+        double seconds = 0.0;               // Wall time of the whole batch
+
+        // Busy time summed over each stage's threads
+        double decodeSeconds = 0.0;
+        double upscaleSeconds = 0.0;
+        double encodeSeconds = 0.0;
+
+        double ImagesPerSecond() const { return seconds > 0.0 ? images / seconds : 0.0; }
+        double MegapixelsPerSecond() const { return seconds > 0.0 ? outputPixels / 1e6 / seconds : 0.0; }
+    };
+
+    // Expands directories (non-recursively) to the image files inside them,
+    // sorted; plain file arguments are kept as given.
+    std::vector<std::string> CollectBatchInputs(const std::vector<std::string>& paths);
+
+    // Output size for a src image under options (never zero).
+    void ComputeBatchTargetSize(const BatchOptions& options, uint32_t srcWidth, uint32_t srcHeight,
+        uint32_t& dstWidth, uint32_t& dstHeight);
+
+    // Upscales every input through a decode -> upscale -> encode pipeline:
+    // decode and encode workers run concurrently with the (internally tiled and
+    // multithreaded) upscaler, joined by BoundedQueues of options.queueDepth so
+    // memory stays bounded. `log` receives one line per failure. Returns false if
+    // any image failed or the output directory cannot be created.
+    bool RunBatch(const BatchOptions& options, BatchStats& stats,
+        const std::function<void(const std::string& message)>& log = {});
+
+}
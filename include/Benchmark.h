@@ -0,0 +1,90 @@
+#pragma once
+#include "CpuUpscaler.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace qisx {
+
+    struct BenchmarkResult {
+        std::string name;
+        int iterations = 0;
+        double bestMs = 0.0;        // Fastest single iteration
+        double meanMs = 0.0;
+        double megapixelsPerSec = 0.0;  // Based on bestMs and the output pixel count
+        double fetchesPerPixel = 0.0;   // Source texel reads per output pixel (0 = not reported)
+    };
+
+    // Runs fn once to warm caches, then `iterations` timed times.
+    BenchmarkResult RunBenchmark(const std::string& name, int iterations, uint64_t pixelsPerIteration,
+        const std::function<void()>& fn);
+
+    // Times every CPU upscaler path on a synthetic srcW x srcH -> dstW x dstH frame.
+    // The reference path is always first so callers can report speedups against it.
+    std::vector<BenchmarkResult> BenchmarkUpscalePaths(uint32_t srcW, uint32_t srcH,
+        uint32_t dstW, uint32_t dstH, int iterations);
+
+    // Times the separable path (scalar and best kernels, polyphase off) and the
+    // fused path with gamma-space and linear-light filtering, in adjacent rows,
+    // so each linear row shows the cost of the fused sRGB conversions.
+    std::vector<BenchmarkResult> BenchmarkLinearLight(uint32_t srcW, uint32_t srcH,
+        uint32_t dstW, uint32_t dstH, int iterations);
+
+    // Compares the two sharpeners on a srcW x srcH -> dstW x dstH frame: the
+    // separable path with its unsharp mask (first row), the same path with RCAS
+    // instead, RCAS alone on a dstW x dstH frame per kernel set, and EASU + RCAS.
+    std::vector<BenchmarkResult> BenchmarkSharpening(uint32_t srcW, uint32_t srcH,
+        uint32_t dstW, uint32_t dstH, int iterations);
+
+    // Times TemporalUpscaler on 16 frames of a SyntheticScene sequence with
+    // JitterSequence offsets (rendered up front) at srcW x srcH -> dstW x dstH,
+    // single-threaded and on all cores, after the separable spatial path as the
+    // baseline row.
+    std::vector<BenchmarkResult> BenchmarkTemporal(uint32_t srcW, uint32_t srcH,
+        uint32_t dstW, uint32_t dstH, int iterations);
+
+    // Times every decoder that accepts each file (the registered portable ones,
+    // plus WIC on Windows), decoding into a preallocated RGBA8 image. Rows are
+    // named "<decoder> <file name>"; megapixelsPerSec counts decoded pixels.
+    std::vector<BenchmarkResult> BenchmarkImageDecoders(const std::vector<std::string>& files, int iterations);
+
+    // Times PixelConvert on a width x height frame for the conversions the
+    // texture loader performs most (one row each for the scalar and vector
+    // kernels, plus float-path and threaded rows). megapixelsPerSec counts
+    // converted pixels.
+    std::vector<BenchmarkResult> BenchmarkPixelConversions(uint32_t width, uint32_t height, int iterations);
+
+    // Times the resize-on-load filters (Resampler box and Lanczos3, stored and
+    // linear light, scalar and vector kernels) on a srcW x srcH -> dstW x dstH
+    // reduction. megapixelsPerSec counts source pixels.
+    std::vector<BenchmarkResult> BenchmarkResize(uint32_t srcW, uint32_t srcH,
+        uint32_t dstW, uint32_t dstH, int iterations);
+
+    // Frame pacing quality at one target rate.
+    struct PacingResult {
+        std::string name;
+        double targetHz = 0.0;
+        uint32_t frames = 0;
+        double meanIntervalMs = 0.0;    // Time between frame starts
+        double jitterMs = 0.0;          // Standard deviation of the interval
+        double p99ErrorMs = 0.0;        // 99th percentile of |interval - period|
+        double cpuPercent = 0.0;        // Thread CPU time / wall time, including the simulated work
+    };
+
+    // Paces a loop of workMs busy frames at each target rate for
+    // secondsPerTarget, once with the previous FrameSync strategy (Sleep for
+    // 80% of the period minus the previous frame time, then spin the rest)
+    // and once with FramePacer, on the real clock.
+    std::vector<PacingResult> BenchmarkFramePacing(const std::vector<double>& targetsHz,
+        double secondsPerTarget, double workMs);
+
+    std::string FormatPacingTable(const std::vector<PacingResult>& results);
+
+    // Summarises CpuUpscaler::GetTileTimings(): tile time spread and tiles per thread.
+    std::string FormatTileTimings(const std::vector<CpuUpscaler::TileTiming>& timings);
+
+    // Formats results as a fixed-width table, with speedup relative to the first row.
+    std::string FormatBenchmarkTable(const std::vector<BenchmarkResult>& results);
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace qisx {
+
+    // Blocking multi-producer/multi-consumer FIFO with a fixed capacity, used to
+    // connect pipeline stages so a fast stage cannot run arbitrarily far ahead
+    // (and hold arbitrarily many decoded frames) of a slow one.
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : m_capacity(capacity ? capacity : 1) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Blocks while full. Returns false (dropping item) once the queue is closed.
+        bool Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+            if (m_closed)
+                return false;
+            m_items.push_back(std::move(item));
+            lock.unlock();
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        // Blocks while empty. Returns false when the queue is closed and drained.
+        bool Pop(T& item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+            if (m_items.empty())
+                return false;
+            item = std::move(m_items.front());
+            m_items.pop_front();
+            lock.unlock();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        // Wakes all waiters; queued items can still be popped.
+        void Close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_notFull.notify_all();
+            m_notEmpty.notify_all();
+        }
+
+        size_t Capacity() const { return m_capacity; }
+
+    private:
+        const size_t m_capacity;
+        std::mutex m_mutex;
+        std::condition_variable m_notFull;
+        std::condition_variable m_notEmpty;
+        std::deque<T> m_items;
+        bool m_closed = false;
+    };
+
+}
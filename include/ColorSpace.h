@@ -0,0 +1,39 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+namespace qisx {
+
+    // Exact sRGB transfer functions on [0, 1].
+    float SrgbToLinear(float encoded);
+    float LinearToSrgb(float linear);
+
+    // Table-driven 8-bit conversions for filtering in linear light.
+    //
+    // Decoding is a plain 256-entry lookup. Encoding indexes a table by
+    // sqrt(linear): the curve is close to a square root, so 4096 evenly spaced
+    // entries land within 0.1 LSB of the exact value everywhere, including the
+    // steep segment near black where a linearly indexed table of that size is
+    // off by a whole code.
+    constexpr int kSrgbEncodeTableSize = 4096;
+
+    struct SrgbTables {
+        float toLinear[256];                            // 8-bit sRGB code -> linear [0, 1]
+        uint8_t fromSqrtLinear[kSrgbEncodeTableSize + 1];
+    };
+
+    const SrgbTables& GetSrgbTables();  // Built on first use; thread-safe
+
+    inline uint8_t LinearToSrgb8(const SrgbTables& tables, float linear)
+    {
+        linear = linear > 0.0f ? (linear < 1.0f ? linear : 1.0f) : 0.0f;
+        return tables.fromSqrtLinear[int(std::sqrt(linear) * kSrgbEncodeTableSize + 0.5f)];
+    }
+
+    inline uint8_t LinearToUnorm8(float value)
+    {
+        value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+        return uint8_t(value * 255.0f + 0.5f);
+    }
+
+}
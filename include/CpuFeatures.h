@@ -0,0 +1,35 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define QISX_ARCH_X86 1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define QISX_ARCH_ARM64 1
+#endif
+
+// Per-function ISA targeting so SIMD kernels can live next to scalar code
+// without special compiler flags. MSVC accepts the intrinsics unconditionally.
+#if defined(__GNUC__) || defined(__clang__)
+#define QISX_TARGET(isa) __attribute__((target(isa)))
+#else
+#define QISX_TARGET(isa)
+#endif
+
+namespace qisx {
+
+    enum class SimdLevel {
+        Auto,       // Best level supported by the running CPU
+        Scalar,
+        SSE41,
+        AVX2,
+        NEON,
+    };
+
+    // Detected once via CPUID (+ XGETBV for AVX state) on x86; NEON is baseline on ARM64.
+    SimdLevel DetectSimdLevel();
+
+    // True if kernels for level are compiled in and the running CPU can execute them.
+    bool IsSimdLevelSupported(SimdLevel level);
+
+    const char* SimdLevelName(SimdLevel level);
+
+}
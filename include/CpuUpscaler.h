@@ -0,0 +1,154 @@
+#pragma once
+#include "Image.h"
+#include "SharpenRcas.h"
+#include "ThreadPool.h"
+#include "UpscaleEasu.h"
+#include "UpscaleFixed.h"
+#include "UpscaleKernels.h"
+#include <memory>
+
+namespace qisx {
+
+    enum class UpscalePath {
+        Reference,      // Per-pixel transcription of PS_main (baseline)
+        Separable,      // Horizontal-then-vertical passes driven by AxisFilter tables
+        Fused,          // Single pass: bicubic and blur from one 4x4 gather per pixel (PS_fused)
+        FixedPoint,     // Separable with Q14 weights and int16 rows (UpscaleFixed.h)
+        EdgeAdaptive,   // 12-tap direction-adaptive kernel, no unsharp mask (UpscaleEasu.h, PS_easu)
+    };
+
+    // Headless CPU implementation of the upscaling pass in shaders.hlsl (PS_main).
+    //
+    // The reference path is a straight transcription of the shader: a Catmull-Rom
+    // 4x4 gather with edge renormalisation followed by an unsharp mask against a
+    // 3x3 box of bilinear taps. It is deliberately unoptimised and serves as the
+    // throughput baseline and correctness oracle for every other path.
+    //
+    // The separable path precomputes indices and weights once per output column
+    // and row, turning 16 kernel evaluations + 16 MACs per pixel into 8 MACs for
+    // the bicubic (and the same again for the blur). It agrees with the reference
+    // within +/-1 LSB (float summation order). Its row kernels are dispatched at
+    // runtime to SSE4.1/AVX2/NEON versions (see UpscaleKernelsSimd.cpp). When
+    // the width ratio is one of the common exact ones, the horizontal pass is
+    // replaced by a polyphase kernel with compile-time weights (UpscalePolyphase.h).
+    //
+    // The fixed-point path runs the separable passes in integers (Q14 weights,
+    // int16 rows) for CPUs where float throughput or bandwidth is the limit.
+    //
+    // The fused path mirrors PS_fused in shaders.hlsl: it gathers the 4x4
+    // footprint once per output pixel and derives both the bicubic and the blur
+    // from it (16 texel reads instead of the reference's 16 + 9x4 bilinear).
+    //
+    // The edge-adaptive path mirrors PS_easu: a different filter rather than a
+    // faster PS_main, so it is compared against the others on quality, not
+    // bit-exactness. It reads a luma plane built once per frame and ignores
+    // sharpenStrength and linearLight.
+    //
+    // By default the filters run on the stored (gamma-encoded) values, as the
+    // shader does on an R8G8B8A8_UNORM view. The unsharp mask then does not
+    // conserve light across an edge, which shows as dark halos along high
+    // contrast edges. With linearLight the colour channels
+    // are decoded through the 256-entry sRGB LUT as the rows are filtered and
+    // re-encoded through the 4K sqrt-indexed table as they are written (both
+    // from ColorSpace.h), fused into the row kernels; alpha stays linear. The
+    // polyphase kernels are bypassed in this mode and the fixed-point path falls
+    // back to the separable one, whose rows already hold floats.
+    //
+    // With rcasSharpness > 0 the unsharp mask is replaced by the
+    // contrast-adaptive RCAS pass (SharpenRcas.h, PS_rcas): the chosen path
+    // upscales without sharpening into an internal frame, which is then
+    // sharpened into dst in row bands. It combines with every path, including
+    // EdgeAdaptive, which is designed to be followed by it. RCAS always runs
+    // on the stored values, also with linearLight.
+    //
+    // Frames are split into output tiles that run on a work-stealing ThreadPool.
+    // Each tile reads exactly the source footprint its filter tables reference
+    // (the 2-texel bicubic apron; the sharpen blur lies inside the same
+    // footprint), so tiled output is bit-identical to a single-tile run.
+    //
+    // Tolerance: output matches PS_main within +/-2 LSB per channel. The residual
+    // comes from the GPU's fixed-point bilinear weights in the blur taps (scaled by
+    // the sharpen strength) and from float->UNORM rounding. One intentional
+    // difference: the blur offsets use the real source texel size, whereas the
+    // shader hardcodes 1/854 x 1/480 (identical for the 854x480 low-res target).
+    class CpuUpscaler {
+    public:
+        struct Options {
+            float sharpenStrength = 1.5f;   // Same default as PS_main
+            bool debugBorder = false;       // Reproduce the red 1% border drawn by PS_main
+            UpscalePath path = UpscalePath::Separable;
+            SimdLevel simd = SimdLevel::Auto;   // Falls back to scalar if unsupported
+            uint32_t threadCount = 0;           // 0 = one per physical core
+            uint32_t tileWidth = 256;           // Output pixels; ~32 KB of row scratch per tile
+            uint32_t tileHeight = 64;
+            bool polyphase = true;              // Constexpr-table row kernels for exact 3/2, 2, 4/3, 3 widths
+            bool linearLight = false;           // Filter sRGB colour in linear light (FixedPoint runs Separable)
+            float rcasSharpness = 0.0f;         // > 0: RCAS on the output instead of the unsharp mask (1 = strongest)
+        };
+
+        struct TileTiming {
+            uint32_t x, y, width, height;
+            unsigned slot;          // Thread pool slot that ran the tile
+            double microseconds;
+        };
+
+        CpuUpscaler() = default;
+        explicit CpuUpscaler(const Options& options) : m_options(options) {}
+
+        const Options& GetOptions() const { return m_options; }
+        void SetOptions(const Options& options) { m_options = options; }
+
+        // Upscales src into dst (any sizes). Returns false on empty or aliasing views.
+        // Filter tables and row buffers are kept between calls, so repeated frames of
+        // the same size do not allocate. Not reentrant: use one instance per thread.
+        bool Upscale(const ImageView& src, const MutableImageView& dst);
+
+        // Per-tile timings of the last Upscale() call, in tile order.
+        const std::vector<TileTiming>& GetTileTimings() const { return m_tileTimings; }
+        unsigned GetThreadCount() const { return m_pool ? m_pool->GetThreadCount() : 1; }
+
+    private:
+        struct Rect {
+            uint32_t x0, y0, x1, y1;
+        };
+
+        void UpscaleReference(const ImageView& src, const MutableImageView& dst, const Rect& rect) const;
+        void UpscaleFused(const ImageView& src, const MutableImageView& dst, const Rect& rect) const;
+        void UpscaleSeparable(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+            const UpscaleKernelTable& kernels, std::vector<float>& scratch) const;
+        void UpscaleFixed(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+            const FixedKernelTable& kernels, std::vector<int16_t>& scratch) const;
+        void UpscaleEdgeAdaptive(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+            const EasuKernelTable& kernels) const;
+
+        Options m_options;
+        float m_strength = 0.0f;                    // Unsharp strength of the current frame
+        AxisFilter m_filterX;
+        AxisFilter m_filterY;
+        FixedAxisFilter m_fixedX;
+        FixedAxisFilter m_fixedY;
+        EasuAxis m_easuX;
+        EasuAxis m_easuY;
+        std::vector<float> m_luma;                  // EdgeAdaptive: luma plane of the current source
+        Image m_unsharpened;                        // RCAS input
+        std::unique_ptr<ThreadPool> m_pool;
+        std::vector<std::vector<float>> m_scratch;  // Row cache per pool slot
+        std::vector<std::vector<int16_t>> m_fixedScratch;
+        std::vector<TileTiming> m_tileTimings;
+    };
+
+    // Catmull-Rom kernel, identical to W() in shaders.hlsl.
+    inline float BicubicWeight(float x)
+    {
+        x = x < 0.0f ? -x : x;
+        if (x < 1.0f)
+            return (1.5f * x - 2.5f) * x * x + 1.0f;
+        else if (x < 2.0f)
+            return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+        return 0.0f;
+    }
+
+    // Paints PS_main's red debug border (uv within 1% of an edge) over dst.
+    void DrawDebugBorder(const MutableImageView& dst);
+
+}
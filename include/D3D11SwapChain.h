@@ -0,0 +1,33 @@
+#pragma once
+#include "SwapChainManager.h"
+#include <d3d11.h>
+#include <dxgi.h>
+#include <wrl/client.h>
+
+namespace qisx {
+
+    // SwapChainBackend over a DXGI flip-model swap chain. D3D11 only lets the
+    // application reach buffer 0, which DXGI rotates to the current back
+    // buffer on every Present, so a single cached view serves every frame.
+    class D3D11SwapChain : public SwapChainBackend {
+    public:
+        D3D11SwapChain(ID3D11Device* device, IDXGISwapChain* swapChain);
+        ~D3D11SwapChain() override;
+
+        uint32_t GetTargetCount() const override { return 1; }
+        uint32_t GetCurrentTarget() const override { return 0; }
+        bool CreateTargets() override;
+        void ReleaseTargets() override;
+        bool ResizeBuffers(uint32_t width, uint32_t height) override;
+        bool Present(uint32_t syncInterval) override;
+
+        // View of the current back buffer; null until CreateTargets succeeds.
+        ID3D11RenderTargetView* GetTarget(uint32_t index) const { return index == 0 ? m_target.Get() : nullptr; }
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D11Device> m_device;
+        Microsoft::WRL::ComPtr<IDXGISwapChain> m_swapChain;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_target;
+    };
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+namespace qisx {
+
+    // Dynamic resolution scaling: picks the render size for each frame from
+    // measured frame times so the frame fits its budget.
+    //
+    // The renderer allocates its low-res target once at maxWidth x maxHeight
+    // (scale 1) and draws into the top-left GetWidth() x GetHeight() texels;
+    // the upscaler reads that size from a constant buffer (the CPU upscalers
+    // take a sub-view), so a scale change never recreates a resource.
+    //
+    // The controller assumes GPU cost is proportional to the pixel count, so
+    // the scale that would meet the target is scale * sqrt(target / measured).
+    // Measured times are smoothed with an EMA, and after each change the
+    // smoothed value is rescaled by the expected cost change so the EMA's lag
+    // does not cause a second correction. It steps towards that scale
+    // asymmetrically: down as soon as the smoothed time leaves the deadband
+    // above the target (in steps of at most maxStepDown), up only after
+    // upDelayFrames consecutive frames below it (at most maxStepUp per
+    // frame). Inside the deadband the scale holds, so noise does not make the
+    // resolution hunt.
+    class DynamicResolution {
+    public:
+        struct Options {
+            uint32_t maxWidth = 1280;       // Allocated render target (scale 1)
+            uint32_t maxHeight = 720;
+            float minScale = 0.5f;
+            float maxScale = 1.0f;
+            float initialScale = 2.0f / 3.0f;
+            float budgetMs = 1000.0f / 60.0f;
+            float headroom = 0.9f;          // Target = budgetMs * headroom
+            float deadband = 0.05f;         // Relative band around the target with no change
+            float smoothing = 0.25f;        // EMA weight of the newest frame time
+            float maxStepDown = 0.08f;      // Largest scale change per frame
+            float maxStepUp = 0.02f;
+            uint32_t upDelayFrames = 30;    // Frames under target before growing
+            uint32_t alignment = 2;         // Render sizes are multiples of this
+        };
+
+        DynamicResolution() : DynamicResolution(Options()) {}
+        explicit DynamicResolution(const Options& options);
+
+        const Options& GetOptions() const { return m_options; }
+
+        // Feeds the timings of the frame just finished and updates the size for
+        // the next. gpuMs < 0 means unknown, and cpuMs is used as the cost.
+        // With both known, a frame whose CPU time alone exceeds the target
+        // while the GPU time does not is CPU bound: the scale holds, since
+        // fewer pixels would not help. Returns true when the size changed.
+        bool Update(float cpuMs, float gpuMs = -1.0f);
+
+        // Returns to the initial scale and forgets the history.
+        void Reset();
+
+        float GetScale() const { return m_scale; }
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+        float GetSmoothedMs() const { return m_smoothedMs; }
+        uint32_t GetChangeCount() const { return m_changes; }
+
+    private:
+        void SetScale(float scale);
+
+        Options m_options;
+        float m_scale = 1.0f;
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        float m_smoothedMs = -1.0f;    // < 0 until the first frame
+        uint32_t m_framesUnder = 0;
+        uint32_t m_changes = 0;
+    };
+
+}
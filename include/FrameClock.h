@@ -0,0 +1,75 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace qisx {
+
+    // Monotonic time source for frame timing, in nanoseconds from an arbitrary
+    // epoch, plus the OS wait FramePacer builds on. FrameTimer, FramePacer and
+    // FrameSync take one so timing and pacing can be driven by a simulated
+    // clock in tests.
+    class FrameClock {
+    public:
+        virtual ~FrameClock() = default;
+        virtual int64_t Now() = 0;
+
+        // Blocks for about nanoseconds. May wake late (the OS timer resolution
+        // and scheduling delay); FramePacer measures and compensates that.
+        virtual void SleepFor(int64_t nanoseconds) = 0;
+
+        // Called on every iteration of a spin-wait.
+        virtual void Relax() {}
+    };
+
+    // std::chrono::steady_clock (QueryPerformanceCounter on Windows). SleepFor
+    // uses a high-resolution waitable timer on Windows 10 1803+ (a regular
+    // waitable timer before that) and clock_nanosleep elsewhere.
+    class SteadyFrameClock : public FrameClock {
+    public:
+        int64_t Now() override
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void SleepFor(int64_t nanoseconds) override;
+        void Relax() override;
+    };
+
+    // Manually advanced clock for tests. SleepFor advances it by the requested
+    // time plus a configurable wake-up overshoot, and every Now() call can cost
+    // a fixed amount of time so spin-waits terminate.
+    class SimulatedFrameClock : public FrameClock {
+    public:
+        int64_t Now() override
+        {
+            const int64_t now = m_now;
+            m_now += m_readCost;
+            return now;
+        }
+
+        void SleepFor(int64_t nanoseconds) override
+        {
+            m_sleeps++;
+            m_now += (nanoseconds > 0 ? nanoseconds : 0) + m_sleepOvershoot;
+        }
+
+        void Set(int64_t now) { m_now = now; }
+        void Advance(int64_t nanoseconds) { m_now += nanoseconds; }
+        void AdvanceSeconds(double seconds) { m_now += int64_t(seconds * 1e9 + 0.5); }
+
+        void SetSleepOvershoot(int64_t nanoseconds) { m_sleepOvershoot = nanoseconds; }
+        void SetReadCost(int64_t nanoseconds) { m_readCost = nanoseconds; }
+        uint64_t GetSleepCount() const { return m_sleeps; }
+
+    private:
+        int64_t m_now = 0;
+        int64_t m_sleepOvershoot = 0;
+        int64_t m_readCost = 0;
+        uint64_t m_sleeps = 0;
+    };
+
+    // Process-wide SteadyFrameClock, the default for FrameTimer, FramePacer and FrameSync.
+    FrameClock& DefaultFrameClock();
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "FrameClock.h"
+#include <cstdint>
+
+namespace qisx {
+
+    // Low-CPU frame limiter: waits for fixed-period deadlines with an OS sleep
+    // for most of the wait and a short spin at the end.
+    //
+    // Deadlines are absolute (the previous deadline plus the period), so the
+    // time the frame's own work took is accounted for and rounding never
+    // accumulates into drift. A frame that misses its deadline by more than a
+    // period restarts the schedule from now instead of bursting to catch up.
+    //
+    // The OS wakes late by a machine-dependent amount (about 1 ms with a
+    // 1 ms timer resolution, tens of microseconds with high-resolution
+    // timers). The pacer measures every sleep's overshoot and keeps an
+    // estimate that rises quickly and decays slowly, then sleeps until
+    // deadline - estimate - spinThreshold and spins only for the rest.
+    class FramePacer {
+    public:
+        struct Options {
+            int64_t spinThresholdNs = 250'000;      // Always spin at least this long before the deadline
+            int64_t maxOvershootNs = 4'000'000;     // Cap on the learned overshoot
+            float overshootRise = 0.25f;            // EMA weight when a sleep overshoots more than estimated
+            float overshootDecay = 0.02f;           // ... and when it overshoots less
+        };
+
+        struct Stats {
+            uint64_t frames = 0;
+            uint64_t missedDeadlines = 0;   // Frames that arrived after their deadline
+            int64_t sleptNs = 0;            // Time spent in SleepFor
+            int64_t spunNs = 0;             // Time spent spinning
+        };
+
+        explicit FramePacer(FrameClock* clock = nullptr) : FramePacer(clock, Options()) {}   // nullptr = DefaultFrameClock()
+        FramePacer(FrameClock* clock, const Options& options);
+
+        // Waits for the end of the current frame period (periodNs after the
+        // previous deadline) and returns the clock time on return. The first
+        // call, and a call after a change of period, start the schedule at now.
+        int64_t WaitForNextFrame(int64_t periodNs);
+
+        // Sleeps then spins until the clock reaches deadline.
+        void WaitUntil(int64_t deadline);
+
+        // Forgets the schedule; the next WaitForNextFrame starts a new one.
+        void Reset() { m_nextDeadline = 0; m_periodNs = 0; }
+
+        int64_t GetOvershootEstimate() const { return m_overshootNs; }
+        int64_t GetNextDeadline() const { return m_nextDeadline; }
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        FrameClock* m_clock;
+        Options m_options;
+        int64_t m_overshootNs = 0;
+        int64_t m_nextDeadline = 0;
+        int64_t m_periodNs = 0;
+        Stats m_stats;
+    };
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "FrameClock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace qisx {
+
+    // Fixed-size ring of frame times, written by the render thread and readable
+    // from any thread without locks.
+    //
+    // Push never allocates or blocks: it stores the value and publishes the new
+    // frame count with a release store. Snapshot copies the newest entries and
+    // then re-reads the count, discarding any entry the writer may have
+    // overwritten during the copy, so readers see a consistent (if slightly
+    // shorter) window. Only one thread may Push.
+    class FrameTimeRing {
+    public:
+        explicit FrameTimeRing(uint32_t capacity = 4095);   // Rounded up to a power of two minus one
+
+        FrameTimeRing(const FrameTimeRing&) = delete;
+        FrameTimeRing& operator=(const FrameTimeRing&) = delete;
+
+        uint32_t GetCapacity() const { return m_mask; }    // Newest frames a Snapshot can return
+        uint64_t GetFrameCount() const { return m_written.load(std::memory_order_acquire); }
+
+        void Push(float seconds);
+
+        // Copies up to maxFrames of the newest frame times, oldest first, into out
+        // (resized; no allocation once out has the capacity). Returns the count.
+        size_t Snapshot(uint32_t maxFrames, std::vector<float>& out) const;
+
+    private:
+        std::unique_ptr<std::atomic<float>[]> m_values;
+        uint32_t m_mask = 0;
+        std::atomic<uint64_t> m_written{ 0 };
+    };
+
+    // Frame-time distribution over a window. Times are in milliseconds.
+    struct FrameTimeSummary {
+        uint32_t frames = 0;
+        double windowMs = 0.0;      // Sum of the frame times
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double p999Ms = 0.0;
+        double maxMs = 0.0;
+        double averageFps = 0.0;    // frames / window
+        double onePercentLowFps = 0.0;  // 1000 / mean of the slowest 1% of frames (at least one)
+        uint32_t stutters = 0;      // Frames longer than stutterFactor * p50
+    };
+
+    // Summarises frame times (seconds, any order). Sorts frameSeconds in place.
+    // Percentiles use the nearest-rank method.
+    FrameTimeSummary SummarizeFrameTimes(std::vector<float>& frameSeconds, float stutterFactor = 2.0f);
+
+    // Per-frame timing for a render loop: delta time, an exponentially smoothed
+    // delta, a one-second average FPS and a FrameTimeRing of recent frames for
+    // percentile reporting. FrameSync wraps one; it is portable so the
+    // statistics can be tested with a SimulatedFrameClock.
+    class FrameTimer {
+    public:
+        struct Options {
+            uint32_t historyFrames = 4095;  // Ring capacity
+            float smoothing = 0.2f;         // EMA weight of the newest delta
+            float stutterFactor = 2.0f;     // See FrameTimeSummary::stutters
+        };
+
+        explicit FrameTimer(FrameClock* clock = nullptr) : FrameTimer(clock, Options()) {}     // nullptr = DefaultFrameClock()
+        FrameTimer(FrameClock* clock, const Options& options);
+
+        // Call once per frame. Measures the time since the previous Tick (or
+        // construction) and records it. Returns true when the one-second FPS
+        // average was updated.
+        bool Tick();
+
+        float GetDeltaTime() const { return m_deltaTime; }
+        float GetSmoothedDeltaTime() const { return m_smoothedDeltaTime; }
+        float GetFPS() const { return m_currentFPS; }
+        int64_t GetFrameStart() const { return m_lastFrameTime; }     // Clock time of the last Tick
+
+        FrameClock& GetClock() const { return *m_clock; }
+        const FrameTimeRing& GetHistory() const { return m_history; }
+
+        // Statistics over the newest maxFrames frames, further limited to the
+        // newest maxSeconds of frame time when maxSeconds > 0. Reuses an internal
+        // buffer: call from one thread (other threads can Snapshot GetHistory()).
+        FrameTimeSummary Summarize(uint32_t maxFrames, float maxSeconds = 0.0f);
+
+    private:
+        FrameClock* m_clock;
+        Options m_options;
+        FrameTimeRing m_history;
+        std::vector<float> m_scratch;
+
+        int64_t m_lastFrameTime = 0;
+        float m_deltaTime = 0.016f;     // Start with a 60Hz assumption
+        float m_smoothedDeltaTime = 0.016f;
+        int m_frameCount = 0;
+        int64_t m_fpsWindowStart = 0;
+        float m_currentFPS = 0.0f;
+    };
+
+}
@@ -2,29 +2,36 @@
 #include <Windows.h>
 #include<dxgi.h>
 #include<dxgi1_4.h>
+#include "FramePacer.h"
+#include "FrameStats.h"
 
 class FrameSync {
 private:
     IDXGISwapChain* m_pSwapChain;
-	LARGE_INTEGER m_frequency;
-	LARGE_INTEGER m_lastFrameTime;
-	float m_deltaTime;
-	float m_smoothedDeltaTime;
-    int m_frameCount;
-    float m_timeElapsed;
-    float m_currentFPS;
+    qisx::FrameTimer m_timer;
+    qisx::FramePacer m_pacer;
 	HANDLE m_frameLatencyWait;
 
 public:
-    FrameSync(IDXGISwapChain* m_pSwapChain);
+    // clock drives all timing (nullptr = steady clock); tests pass a
+    // qisx::SimulatedFrameClock
+    FrameSync(IDXGISwapChain* m_pSwapChain, qisx::FrameClock* clock = nullptr);
     ~FrameSync();
 
     void BeginFrame();
+    // Limits the frame rate to targetFPS (0 = unlimited) on a fixed schedule:
+    // sleeps on a high-resolution timer, then spins for the last few hundred
+    // microseconds (see qisx::FramePacer)
     void EndFrame(int targetFPS = 0);
 
-    float GetDeltaTime() const { return m_deltaTime; }
-    float GetSmoothedDeltaTime() const { return m_smoothedDeltaTime; }
-    float GetFPS() const { return m_currentFPS;  }
+    float GetDeltaTime() const { return m_timer.GetDeltaTime(); }
+    float GetSmoothedDeltaTime() const { return m_timer.GetSmoothedDeltaTime(); }
+    float GetFPS() const { return m_timer.GetFPS();  }
+
+    // Frame-time percentiles, 1% lows and stutters over the newest frames
+    qisx::FrameTimeSummary GetStats(uint32_t maxFrames, float maxSeconds = 0.0f) { return m_timer.Summarize(maxFrames, maxSeconds); }
+    const qisx::FrameTimer& GetTimer() const { return m_timer; }
+    const qisx::FramePacer& GetPacer() const { return m_pacer; }
 
 private:
     void WaitForGPU();
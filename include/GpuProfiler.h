@@ -0,0 +1,89 @@
+#pragma once
+#include "Profiler.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace qisx {
+
+    // D3D11 timestamp queries for the passes of a frame, reported to a
+    // Profiler as GPU events.
+    //
+    // Each frame gets a disjoint query and begin/end timestamps for the frame
+    // and each pass, from one of kFramesInFlight sets. A set is read back when
+    // it comes round again, kFramesInFlight - 1 frames later, without flushing;
+    // if the GPU has not finished it by then the frame is dropped rather than
+    // stalling the CPU (GetDroppedFrames). Disjoint frames (clock changes) are
+    // dropped too.
+    //
+    // The GPU clock is not the CPU clock: each frame's GPU events are placed
+    // so its first timestamp coincides with the CPU time of BeginFrame. The
+    // offset between the tracks in a trace is therefore not meaningful, but
+    // durations and the order of GPU passes are.
+    class GpuProfiler {
+    public:
+        static constexpr uint32_t kFramesInFlight = 3;
+        static constexpr uint32_t kMaxPasses = 16;     // Per frame; further passes are not timed
+
+        explicit GpuProfiler(Profiler& profiler) : m_profiler(profiler) {}
+
+        // Creates the queries. Returns false (and times nothing) if that fails.
+        bool Init(ID3D11Device* device, ID3D11DeviceContext* context);
+        void Shutdown();
+
+        // Call around the frame's GPU work, after Profiler::BeginFrame and
+        // before Profiler::EndFrame.
+        void BeginFrame();
+        void EndFrame();
+
+        // name must be a string literal, as for Profiler::BeginScope.
+        uint32_t BeginPass(const char* name);
+        void EndPass(uint32_t pass);
+
+        // GPU time of the newest resolved frame, -1 until one resolves.
+        float GetLastFrameMs() const { return m_lastFrameMs; }
+        uint64_t GetDroppedFrames() const { return m_dropped; }
+
+    private:
+        struct Pass {
+            const char* name = nullptr;
+            Microsoft::WRL::ComPtr<ID3D11Query> begin;
+            Microsoft::WRL::ComPtr<ID3D11Query> end;
+        };
+
+        struct FrameQueries {
+            Microsoft::WRL::ComPtr<ID3D11Query> disjoint;
+            Microsoft::WRL::ComPtr<ID3D11Query> begin;
+            Microsoft::WRL::ComPtr<ID3D11Query> end;
+            Pass passes[kMaxPasses];
+            uint32_t passCount = 0;
+            uint64_t frame = 0;
+            int64_t cpuStartNs = 0;
+            bool pending = false;       // Issued and not read back yet
+        };
+
+        void Resolve(FrameQueries& queries);
+
+        Profiler& m_profiler;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_context;
+        FrameQueries m_frames[kFramesInFlight];
+        uint32_t m_current = 0;
+        bool m_inFrame = false;
+        float m_lastFrameMs = -1.0f;
+        uint64_t m_dropped = 0;
+    };
+
+    // Times the enclosing block as a GPU pass.
+    class GpuScope {
+    public:
+        GpuScope(GpuProfiler& profiler, const char* name) : m_profiler(profiler), m_pass(profiler.BeginPass(name)) {}
+        ~GpuScope() { m_profiler.EndPass(m_pass); }
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+        uint32_t m_pass;
+    };
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qisx {
+
+    // Read-only view over tightly or loosely packed RGBA8 pixels.
+    struct ImageView {
+        const uint8_t* data = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t rowPitch = 0;    // Bytes between the start of consecutive rows
+
+        const uint8_t* Row(uint32_t y) const { return data + y * rowPitch; }
+        bool Empty() const { return !data || width == 0 || height == 0; }
+    };
+
+    // Writable view over RGBA8 pixels (e.g. a mapped staging texture).
+    struct MutableImageView {
+        uint8_t* data = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t rowPitch = 0;
+
+        uint8_t* Row(uint32_t y) const { return data + y * rowPitch; }
+        bool Empty() const { return !data || width == 0 || height == 0; }
+        operator ImageView() const { return { data, width, height, rowPitch }; }
+    };
+
+    // Owning RGBA8 image with a tightly packed row pitch.
+    class Image {
+    public:
+        Image() = default;
+        Image(uint32_t width, uint32_t height)
+            : m_width(width), m_height(height), m_pixels(size_t(width) * height * 4) {}
+
+        uint32_t Width() const { return m_width; }
+        uint32_t Height() const { return m_height; }
+        size_t RowPitch() const { return size_t(m_width) * 4; }
+        size_t SizeInBytes() const { return m_pixels.size(); }
+
+        uint8_t* Data() { return m_pixels.data(); }
+        const uint8_t* Data() const { return m_pixels.data(); }
+
+        ImageView View() const { return { m_pixels.data(), m_width, m_height, RowPitch() }; }
+        MutableImageView MutableView() { return { m_pixels.data(), m_width, m_height, RowPitch() }; }
+
+    private:
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        std::vector<uint8_t> m_pixels;
+    };
+
+}
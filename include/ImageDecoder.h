@@ -0,0 +1,55 @@
+#pragma once
+#include "Image.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace qisx {
+
+    struct ImageInfo {
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Decoder for one file format. Decoders write RGBA8 straight into a caller
+    // owned view (any row pitch, e.g. a mapped upload buffer or an Image), so no
+    // intermediate full-size pixel copy is needed between decode and upload.
+    // Implementations must be stateless or internally synchronised: one decoder
+    // instance is shared by every thread.
+    class ImageDecoder {
+    public:
+        virtual ~ImageDecoder() = default;
+
+        virtual const char* Name() const = 0;
+
+        // Cheap signature check on the first bytes of the file.
+        virtual bool CanDecode(const uint8_t* data, size_t size) const = 0;
+
+        // Parses headers only.
+        virtual bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info, std::string* error) const = 0;
+
+        // Decodes the whole image into dst, whose size must match ReadInfo().
+        virtual bool Decode(const uint8_t* data, size_t size, const MutableImageView& dst, std::string* error) const = 0;
+    };
+
+    std::unique_ptr<ImageDecoder> CreatePngDecoder();
+    std::unique_ptr<ImageDecoder> CreateJpegDecoder();     // Baseline and progressive, 8-bit, grey/YCbCr
+    std::unique_ptr<ImageDecoder> CreateNetpbmDecoder();   // PAM (P7) and PPM (P6)
+#if defined(_WIN32)
+    std::unique_ptr<ImageDecoder> CreateWicDecoder();      // Any format Windows Imaging Component reads
+#endif
+
+    // Adds a decoder to the process-wide list. Later registrations are tried
+    // first, so an application can override a built-in decoder. Thread-safe.
+    void RegisterImageDecoder(std::unique_ptr<ImageDecoder> decoder);
+
+    // First registered decoder whose CanDecode() accepts data, or nullptr. The
+    // portable PNG, JPEG and Netpbm decoders are always registered.
+    const ImageDecoder* FindImageDecoder(const uint8_t* data, size_t size);
+
+    // All registered decoders, most recently registered first.
+    std::vector<const ImageDecoder*> GetImageDecoders();
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "Image.h"
+#include "ImageDecoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace qisx {
+
+    // Portable image file I/O for the headless tools. Everything is decoded to and
+    // encoded from tightly packed RGBA8 (the layout CpuUpscaler consumes).
+    //
+    // Reading: any format with a registered ImageDecoder (PNG, baseline and
+    // progressive JPEG, PAM/PPM by default; see ImageDecoder.h).
+    // Writing: PNG (RGBA8, zlib with fixed-Huffman LZ77) and PAM.
+    enum class ImageFileFormat {
+        Unknown,
+        Pam,
+        Ppm,
+        Png,
+        Jpeg,
+    };
+
+    // Sniffs the format from the first bytes of a file.
+    ImageFileFormat DetectImageFormat(const uint8_t* data, size_t size);
+
+    // Format implied by a path's extension (.png, .jpg/.jpeg, .pam, .ppm); Unknown otherwise.
+    ImageFileFormat ImageFormatFromExtension(const std::string& path);
+
+    // Decodes an in-memory file into image. On failure returns false and, if
+    // error is non-null, a short reason.
+    bool DecodeImage(const uint8_t* data, size_t size, Image& image, std::string* error = nullptr);
+    bool LoadImageFile(const std::string& path, Image& image, std::string* error = nullptr);
+
+    // Supplies the pixels to decode into once the image size is known: a view of
+    // exactly info.width x info.height with any row pitch, e.g. a pooled buffer
+    // or a mapped upload heap. Returning false aborts the load.
+    using ImageDestination = std::function<bool(const ImageInfo& info, MutableImageView& dst)>;
+
+    // What one load moved besides decoding. bytesCopied counts file bytes copied
+    // into an intermediate buffer before decoding: zero when the file was mapped.
+    struct ImageLoadStats {
+        size_t fileBytes = 0;
+        size_t bytesCopied = 0;
+        bool mapped = false;
+    };
+
+    bool DecodeImageInto(const uint8_t* data, size_t size, const ImageDestination& destination,
+        std::string* error = nullptr);
+
+    // Zero-copy load: maps the file and decodes from the mapping straight into
+    // the caller's destination. Falls back to reading the file into memory if it
+    // cannot be mapped (e.g. a pipe), which stats then report.
+    bool LoadImageFileInto(const std::string& path, const ImageDestination& destination,
+        ImageLoadStats* stats = nullptr, std::string* error = nullptr);
+
+    bool EncodePng(const ImageView& image, std::vector<uint8_t>& out);
+    bool EncodePam(const ImageView& image, std::vector<uint8_t>& out);
+
+    // Encodes by extension and writes the file.
+    bool SaveImageFile(const std::string& path, const ImageView& image, std::string* error = nullptr);
+
+    bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& bytes);
+    bool WriteFileBytes(const std::string& path, const std::vector<uint8_t>& bytes);
+
+}
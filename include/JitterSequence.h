@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+namespace qisx {
+
+    // Sub-pixel offset for one frame of a jittered render.
+    struct JitterSample {
+        float x = 0.0f;         // Render-target pixels, -0.5..0.5: pixel (i, j) samples (i + 0.5 + x, j + 0.5 + y)
+        float y = 0.0f;
+        float clipX = 0.0f;     // The same offset in clip space (2x / width, -2y / height; D3D's y is up)
+        float clipY = 0.0f;
+        uint32_t phase = 0;     // Position in the sequence, 0..GetPhaseCount()-1
+
+        // Writes to delta the matrix that, added to projection, jitters it by this
+        // sample. Both are row-major for row vectors (v' = v * M, DirectXMath's
+        // XMFLOAT4X4 layout); transpose for column vectors. The delta shifts clip
+        // x and y by clip w times the offset, so it is exact for perspective and
+        // orthographic projections alike.
+        void ProjectionDelta(const float projection[16], float delta[16]) const;
+    };
+
+    // Radical inverse of index in the given base: the Halton sequence, 0..1.
+    float Halton(uint32_t index, uint32_t base);
+
+    // Per-frame Halton (2, 3) jitter for temporal upscaling.
+    //
+    // The sequence repeats after a phase count that grows with the square of
+    // the upscale ratio (8 * (display / render)^2, as in FSR2), so every output
+    // pixel of the display still receives about eight distinct sample
+    // positions per cycle. Index 0 of the Halton sequence (0, 0) is skipped.
+    class JitterSequence {
+    public:
+        JitterSequence() = default;
+        JitterSequence(uint32_t renderWidth, uint32_t renderHeight, uint32_t displayWidth)
+        {
+            Configure(renderWidth, renderHeight, displayWidth);
+        }
+
+        // Sets the render size and the display width it is upscaled to, and
+        // restarts the sequence. A 1:1 ratio gives 8 phases (TAA).
+        void Configure(uint32_t renderWidth, uint32_t renderHeight, uint32_t displayWidth);
+
+        static uint32_t PhaseCount(uint32_t renderWidth, uint32_t displayWidth);
+
+        uint32_t GetPhaseCount() const { return m_phaseCount; }
+        uint64_t GetFrameIndex() const { return m_frame; }
+
+        // Sample for any frame number; Next() returns the current frame's and advances.
+        JitterSample Get(uint64_t frame) const;
+        JitterSample Next() { return Get(m_frame++); }
+        void Reset() { m_frame = 0; }
+
+    private:
+        uint32_t m_renderWidth = 1;
+        uint32_t m_renderHeight = 1;
+        uint32_t m_phaseCount = 8;
+        uint64_t m_frame = 0;
+    };
+
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace qisx {
+
+    struct LruCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;     // Entries dropped to stay within the budget
+        size_t entries = 0;
+        size_t bytes = 0;           // Sum of the sizes given to Insert()
+        size_t budgetBytes = 0;
+    };
+
+    // Thread-safe least-recently-used cache with a byte budget. Value should be a
+    // cheap shared handle (ComPtr, shared_ptr): lookups return copies, and values
+    // dropped by eviction are destroyed after the lock is released.
+    //
+    // The cache never loads anything itself; two threads missing on the same key
+    // may both load it, and the second Insert() simply replaces the first.
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class LruCache {
+    public:
+        explicit LruCache(size_t budgetBytes) : m_budget(budgetBytes) {}
+
+        LruCache(const LruCache&) = delete;
+        LruCache& operator=(const LruCache&) = delete;
+
+        // On a hit copies the value to out and marks it most recently used.
+        bool Find(const Key& key, Value& out)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(key);
+            if (it == m_index.end()) {
+                m_misses++;
+                return false;
+            }
+            m_order.splice(m_order.begin(), m_order, it->second);
+            out = it->second->value;
+            m_hits++;
+            return true;
+        }
+
+        // Adds or replaces key, then evicts least recently used entries until the
+        // total fits the budget. A value larger than the whole budget is not
+        // cached (returns false).
+        bool Insert(const Key& key, Value value, size_t bytes)
+        {
+            std::vector<Value> dropped;
+            bool cached = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_index.find(key);
+                if (it != m_index.end()) {
+                    m_bytes -= it->second->bytes;
+                    dropped.push_back(std::move(it->second->value));
+                    m_order.erase(it->second);
+                    m_index.erase(it);
+                }
+                if (bytes <= m_budget) {
+                    m_order.push_front({ key, std::move(value), bytes });
+                    m_index.emplace(key, m_order.begin());
+                    m_bytes += bytes;
+                    cached = true;
+                }
+                EvictLocked(dropped);
+            }
+            return cached;
+        }
+
+        bool Erase(const Key& key)
+        {
+            Value dropped{};
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_index.find(key);
+                if (it == m_index.end())
+                    return false;
+                m_bytes -= it->second->bytes;
+                dropped = std::move(it->second->value);
+                m_order.erase(it->second);
+                m_index.erase(it);
+            }
+            return true;
+        }
+
+        void Clear()
+        {
+            std::list<Entry> dropped;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                dropped.swap(m_order);
+                m_index.clear();
+                m_bytes = 0;
+            }
+        }
+
+        // Shrinking the budget evicts immediately.
+        void SetBudget(size_t budgetBytes)
+        {
+            std::vector<Value> dropped;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budget = budgetBytes;
+            EvictLocked(dropped);
+        }
+
+        LruCacheStats GetStats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            LruCacheStats stats;
+            stats.hits = m_hits;
+            stats.misses = m_misses;
+            stats.evictions = m_evictions;
+            stats.entries = m_index.size();
+            stats.bytes = m_bytes;
+            stats.budgetBytes = m_budget;
+            return stats;
+        }
+
+    private:
+        struct Entry {
+            Key key;
+            Value value;
+            size_t bytes;
+        };
+
+        void EvictLocked(std::vector<Value>& dropped)
+        {
+            while (m_bytes > m_budget && !m_order.empty()) {
+                Entry& victim = m_order.back();
+                m_bytes -= victim.bytes;
+                dropped.push_back(std::move(victim.value));
+                m_index.erase(victim.key);
+                m_order.pop_back();
+                m_evictions++;
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        std::list<Entry> m_order;   // Most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_index;
+        size_t m_budget;
+        size_t m_bytes = 0;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+        uint64_t m_evictions = 0;
+    };
+
+}
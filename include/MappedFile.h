@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace qisx {
+
+    // Read-only memory mapping of a whole file. Decoders can read straight from
+    // Data() without the file first being copied into a heap buffer; pages are
+    // faulted in from the OS file cache as the decoder touches them.
+    //
+    // An empty file opens successfully with Data() == nullptr and Size() == 0.
+    // The file must not be truncated by another process while it is mapped.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // On failure returns false and, if error is non-null, a short reason.
+        bool Open(const std::string& path, std::string* error = nullptr);
+#if defined(_WIN32)
+        bool Open(const std::wstring& path, std::string* error = nullptr);
+#endif
+        void Close();
+
+        bool IsOpen() const { return m_open; }
+        const uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+    };
+
+}
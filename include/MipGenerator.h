@@ -0,0 +1,63 @@
+#pragma once
+#include "CpuFeatures.h"
+#include "Image.h"
+#include "Resampler.h"
+#include <vector>
+
+namespace qisx {
+
+    enum class MipFilter {
+        Box,        // Area average of the parent texels (2x2 for even sizes)
+        Kaiser,     // Kaiser-windowed sinc, 3 child texels each side: sharper, slight ringing
+    };
+
+    // Levels in a full chain down to 1x1, counting the base. Sizes follow D3D:
+    // each level is max(1, parent / 2), so odd sizes round down.
+    uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+    // CPU mip chain generator for RGBA8 images, for textures created without a
+    // device context (so GenerateMips is unavailable) and for baking chains
+    // offline.
+    //
+    // Each level is filtered from the one above it in float. With srgb set the
+    // colour channels are decoded to linear light first and re-encoded after
+    // filtering, which is what GenerateMips does for *_SRGB formats; without it
+    // the values are filtered as stored. Alpha is always linear and is not
+    // premultiplied.
+    //
+    // Each level is one Resampler pass (row bands on a work-stealing ThreadPool,
+    // SSE4.1 or NEON row kernels). Output does not depend on the thread count.
+    class MipGenerator {
+    public:
+        struct Options {
+            MipFilter filter = MipFilter::Box;
+            bool srgb = false;
+            uint32_t maxLevels = 0;             // Including the base; 0 = full chain
+            SimdLevel simd = SimdLevel::Auto;   // Falls back to scalar if unsupported
+            uint32_t threadCount = 0;           // 0 = one per physical core
+            uint32_t bandHeight = 16;           // Child rows per task
+        };
+
+        MipGenerator() = default;
+        explicit MipGenerator(const Options& options) : m_options(options) {}
+
+        const Options& GetOptions() const { return m_options; }
+        void SetOptions(const Options& options) { m_options = options; }
+
+        // Fills mips with levels 1.. of base (mips[0] is half size). Existing
+        // images of the right size are reused. Returns false on an empty base.
+        // Not reentrant: use one instance per thread.
+        bool Generate(const ImageView& base, std::vector<Image>& mips);
+
+        // Filters one level: child must be the size MipLevelCount implies for
+        // parent (max(1, size / 2) on each axis).
+        bool GenerateLevel(const ImageView& parent, const MutableImageView& child);
+
+        unsigned GetThreadCount() const { return m_resampler.GetThreadCount(); }
+
+    private:
+        Options m_options;
+        Resampler m_resampler;
+    };
+
+}
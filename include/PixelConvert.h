@@ -0,0 +1,57 @@
+#pragma once
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace qisx {
+
+    // Uncompressed pixel layouts, named by memory order (BGRA8 is B at the
+    // lowest address) and, for packed formats, from the least significant bit
+    // (BGR565: blue in bits 0-4). They cover the WIC formats the texture loader
+    // meets; X marks a padding channel and P premultiplied alpha.
+    enum class PixelFormat {
+        Unknown,
+
+        RGBA8, BGRA8, RGBX8, BGRX8, PRGBA8, PBGRA8, RGB8, BGR8,
+        Gray8, Alpha8, Gray1, Gray2, Gray4, CMYK8,
+
+        BGR565, BGR555, BGRA5551, RGBA1010102, BGR101010,
+
+        Gray16, RGB16, BGR16, RGBA16, BGRA16, RGBX16, PRGBA16, PBGRA16,
+
+        GrayHalf, RGBHalf, RGBXHalf, RGBAHalf, PRGBAHalf,
+
+        GrayFloat, RGBFloat, RGBXFloat, RGBAFloat, PRGBAFloat,
+    };
+
+    const char* PixelFormatName(PixelFormat format);
+    uint32_t PixelFormatBitsPerPixel(PixelFormat format);  // 0 for Unknown
+
+    // The format a texture of this source is uploaded as: itself when the GPU
+    // samples it directly, otherwise the nearest directly supported format.
+    // Mirrors g_WICConvert in WICTextureLoader.cpp.
+    PixelFormat NearestTargetFormat(PixelFormat format);
+
+    // Every format can be read; everything but the sub-byte grays and CMYK can
+    // be written.
+    bool CanConvertPixels(PixelFormat src, PixelFormat dst);
+
+    // Converts width x height pixels between any readable and writable format.
+    //
+    // Common pairs (swizzles, 24->32 bit expansion, grey to RGBA, 48->64 bit,
+    // premultiplied to straight alpha, ...) have integer kernels with SSE4.1
+    // and NEON versions. Everything else goes through a float RGBA row, which is
+    // exact for 8 and 16-bit unorm data; grey is written as Rec. 709 luma.
+    //
+    // With a pool, rows are split into bands across its threads. Returns false
+    // for unsupported pairs or empty sizes. src and dst must not overlap.
+    bool ConvertPixels(const void* src, size_t srcRowPitch, PixelFormat srcFormat,
+        void* dst, size_t dstRowPitch, PixelFormat dstFormat,
+        uint32_t width, uint32_t height, ThreadPool* pool = nullptr, SimdLevel simd = SimdLevel::Auto);
+
+    // IEEE half <-> float, round to nearest even.
+    float HalfToFloat(uint16_t half);
+    uint16_t FloatToHalf(float value);
+
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "FrameClock.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace qisx {
+
+    enum class ProfileTrack : uint8_t { Cpu, Gpu };
+
+    // One timed pass. Times are FrameClock nanoseconds; GPU events are mapped
+    // onto the same timeline by GpuProfiler.
+    struct ProfileEvent {
+        uint32_t name;          // Index into ProfileCapture::names
+        uint32_t thread;        // Small id in order of first use (0 = first recording thread)
+        ProfileTrack track;
+        uint64_t frame;
+        int64_t startNs;
+        int64_t endNs;          // == startNs while the scope is still open
+    };
+
+    struct ProfileFrame {
+        uint64_t index;
+        int64_t startNs;
+        int64_t endNs;
+        uint32_t thread;        // Thread that called BeginFrame, same ids as ProfileEvent
+    };
+
+    // Frames and events recorded by a Profiler, or read back from a binary log.
+    // Events are sorted by frame, then start time.
+    struct ProfileCapture {
+        std::vector<std::string> names;
+        std::vector<ProfileFrame> frames;
+        std::vector<ProfileEvent> events;
+    };
+
+    // Per-pass aggregate over a capture. Times per frame sum every call of the
+    // pass in that frame; mean and max are over the frames the pass ran in.
+    struct PassSummary {
+        std::string name;
+        ProfileTrack track = ProfileTrack::Cpu;
+        uint32_t frames = 0;
+        uint32_t calls = 0;
+        float totalMs = 0.0f;
+        float meanMs = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    // Passes in order of first appearance, CPU before GPU.
+    std::vector<PassSummary> SummarizePasses(const ProfileCapture& capture);
+
+    // Chrome trace_event JSON (chrome://tracing, Perfetto): one complete event
+    // per pass, a "Frame" event per frame on the thread that began it,
+    // and GPU passes as a separate process. Timestamps are microseconds from
+    // the first frame or event.
+    std::string ToChromeTrace(const ProfileCapture& capture);
+
+    // Compact binary log: a name table, then frames and events as LEB128
+    // varints, start times delta-coded against the previous record and end
+    // times as durations (about 10 bytes per millisecond-scale event instead
+    // of 40). FromBinaryLog returns false on a malformed or truncated log.
+    std::vector<uint8_t> ToBinaryLog(const ProfileCapture& capture);
+    bool FromBinaryLog(const uint8_t* data, size_t size, ProfileCapture& capture);
+
+    // Scoped pass markers with per-frame aggregation.
+    //
+    // BeginFrame/EndFrame delimit frames; Begin/EndScope (or ProfileScope)
+    // time passes within them and may be called from any thread. Events are
+    // stored with the frame that was current when they began, and the newest
+    // maxFrames finished frames are kept. GPU passes resolve a few frames
+    // late and are attached to their frame with AddGpuEvent while it is still
+    // kept. Recording takes a mutex, which is noise for per-pass markers but
+    // rules out per-pixel or per-row use.
+    //
+    // Nothing here depends on a graphics API: the CPU side runs headless, and
+    // tests drive it with SimulatedFrameClock.
+    class Profiler {
+    public:
+        struct Options {
+            uint32_t maxFrames = 600;       // Finished frames kept for capture
+        };
+
+        struct Scope {
+            uint64_t frame = 0;
+            uint32_t slot = UINT32_MAX;     // UINT32_MAX = not recorded
+        };
+
+        explicit Profiler(FrameClock* clock = nullptr) : Profiler(clock, Options()) {}   // nullptr = DefaultFrameClock()
+        Profiler(FrameClock* clock, const Options& options);
+
+        // Ends the current frame (if any) and starts the next.
+        void BeginFrame();
+        void EndFrame();
+
+        // name must outlive the profiler (a string literal); names are
+        // interned by content on first use.
+        Scope BeginScope(const char* name);
+        void EndScope(const Scope& scope);
+
+        // Adds a pass that ran on the GPU during frame (see GpuProfiler).
+        // Dropped if the frame is no longer kept.
+        void AddGpuEvent(uint64_t frame, const char* name, int64_t startNs, int64_t endNs);
+
+        // Summed duration of the pass in a kept or current frame, -1 if it
+        // did not run there.
+        float GetPassMs(uint64_t frame, const char* name, ProfileTrack track = ProfileTrack::Cpu) const;
+
+        // Index of the current frame (0 before the first BeginFrame).
+        uint64_t GetFrameIndex() const;
+        FrameClock& GetClock() const { return *m_clock; }
+
+        // Copies the newest maxFrames kept frames plus the current one.
+        ProfileCapture Capture(uint32_t maxFrames = UINT32_MAX) const;
+
+        // Forgets every frame and event; names and thread ids are kept.
+        void Clear();
+
+    private:
+        struct FrameData {
+            ProfileFrame frame;
+            std::vector<ProfileEvent> events;
+        };
+
+        uint32_t NameId(const char* name);
+        uint32_t ThreadId();
+        FrameData* FindFrame(uint64_t frame);
+        const FrameData* FindFrame(uint64_t frame) const;
+
+        FrameClock* m_clock;
+        Options m_options;
+        mutable std::mutex m_mutex;
+        std::deque<FrameData> m_frames;     // Finished, oldest first
+        FrameData m_current;
+        bool m_inFrame = false;
+        std::vector<std::string> m_names;
+        std::unordered_map<const char*, uint32_t> m_nameIds;
+        std::unordered_map<std::thread::id, uint32_t> m_threadIds;
+    };
+
+    // Times the enclosing block as a CPU pass; a null profiler times nothing.
+    class ProfileScope {
+    public:
+        ProfileScope(Profiler& profiler, const char* name) : ProfileScope(&profiler, name) {}
+        ProfileScope(Profiler* profiler, const char* name) : m_profiler(profiler)
+        {
+            if (m_profiler)
+                m_scope = m_profiler->BeginScope(name);
+        }
+        ~ProfileScope()
+        {
+            if (m_profiler)
+                m_profiler->EndScope(m_scope);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        Profiler* m_profiler;
+        Profiler::Scope m_scope;
+    };
+
+}
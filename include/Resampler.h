@@ -0,0 +1,61 @@
+#pragma once
+#include "CpuFeatures.h"
+#include "Image.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <vector>
+
+namespace qisx {
+
+    enum class ResampleFilter {
+        Box,        // Area average of the covered source texels: no ringing
+        Kaiser,     // Kaiser-windowed sinc, radius 3, beta 4
+        Lanczos3,   // Lanczos-windowed sinc, radius 3: sharpest, slight ringing
+    };
+
+    // Separable RGBA8 resampler between any two sizes; the engine behind
+    // MipGenerator and the texture loader's resize-on-load.
+    //
+    // When an axis shrinks, the filter is stretched over each output texel's
+    // source footprint, so every source texel contributes (no aliasing from
+    // skipped texels as with bilinear). When it grows, the filter interpolates
+    // at its natural width; Box then degenerates to area-weighted nearest.
+    //
+    // Filtering is in float. With srgb set the colour channels are decoded to
+    // linear light first and re-encoded after filtering; without it the values
+    // are filtered as stored. The fourth channel is always linear, so RGBA and
+    // BGRA data both work.
+    //
+    // Output rows are split into bands on a work-stealing ThreadPool, each band
+    // keeping a ring of horizontally filtered source rows; the row kernels are
+    // dispatched to SSE4.1 or NEON when available. Output does not depend on the
+    // thread count.
+    class Resampler {
+    public:
+        struct Options {
+            ResampleFilter filter = ResampleFilter::Box;
+            bool srgb = false;
+            SimdLevel simd = SimdLevel::Auto;   // Falls back to scalar if unsupported
+            uint32_t threadCount = 0;           // 0 = one per physical core
+            uint32_t bandHeight = 16;           // Output rows per task
+        };
+
+        Resampler() = default;
+        explicit Resampler(const Options& options) : m_options(options) {}
+
+        const Options& GetOptions() const { return m_options; }
+        void SetOptions(const Options& options) { m_options = options; }
+
+        // Resamples all of src into dst. Returns false on empty or aliasing views.
+        // Not reentrant: use one instance per thread.
+        bool Resample(const ImageView& src, const MutableImageView& dst);
+
+        unsigned GetThreadCount() const { return m_pool ? m_pool->GetThreadCount() : 1; }
+
+    private:
+        Options m_options;
+        std::unique_ptr<ThreadPool> m_pool;
+        std::vector<std::vector<float>> m_scratch;  // Per pool slot
+    };
+
+}
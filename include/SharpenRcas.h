@@ -0,0 +1,59 @@
+#pragma once
+#include "CpuFeatures.h"
+#include "Image.h"
+#include <cstdint>
+
+namespace qisx {
+
+    // Contrast-adaptive sharpening in the style of FSR1's RCAS, the CPU side of
+    // PS_rcas in shaders.hlsl. Unlike PS_main's unsharp mask (a fixed-strength
+    // 3x3 box blur of the low-res source) it runs on the upscaled image and
+    // reads five pixels:
+    //
+    //          b
+    //        d e f
+    //          h
+    //
+    // The output is (lobe * (b + d + f + h) + e) / (4 * lobe + 1) with a
+    // negative lobe. Per colour channel, the strongest lobe that keeps the
+    // result inside 0..255 is derived from the min/max of the cross; the weakest
+    // channel limit wins, is capped at kRcasLimit and then scaled by the
+    // sharpness. Flat and low-contrast areas therefore get the full lobe and
+    // edges near the ends of the range less, so the pass does not clip or ring.
+    // Alpha is copied from e; image edges are clamped.
+    //
+    // sharpness is 0..1 (1 = strongest); FSR's "stops" map to exp2(-stops).
+    constexpr float kRcasLimit = 0.25f - 1.0f / 16.0f;
+
+    // Sharpens one row of width RGBA8 pixels into dst. above and below are the
+    // (clamped) neighbouring rows of row.
+    using RcasRowFn = void (*)(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+        uint32_t width, float sharpness, uint8_t* dst);
+
+    struct RcasKernelTable {
+        SimdLevel level;
+        RcasRowFn row;
+    };
+
+    // Best kernels at or below level (Auto = this CPU). Never returns nullptr.
+    const RcasKernelTable* GetRcasKernels(SimdLevel level);
+
+    // Sharpens rows [y0, y1) of src into dst, which must be the same size and
+    // not alias src.
+    void SharpenRcas(const ImageView& src, const MutableImageView& dst, uint32_t y0, uint32_t y1,
+        float sharpness, const RcasKernelTable& kernels);
+
+    void RcasRowScalar(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+        uint32_t width, float sharpness, uint8_t* dst);
+
+#if defined(QISX_ARCH_X86)
+    void RcasRowSSE41(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+        uint32_t width, float sharpness, uint8_t* dst);
+    void RcasRowAVX2(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+        uint32_t width, float sharpness, uint8_t* dst);
+#elif defined(QISX_ARCH_ARM64)
+    void RcasRowNEON(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+        uint32_t width, float sharpness, uint8_t* dst);
+#endif
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+
+namespace qisx {
+
+    // The swap chain operations SwapChainManager needs. D3D11SwapChain wraps a
+    // DXGI swap chain; MockSwapChain runs headless so tests can drive the
+    // frame flow.
+    class SwapChainBackend {
+    public:
+        virtual ~SwapChainBackend() = default;
+
+        // Number of render target views the backend keeps and the one to draw
+        // into this frame. A D3D11 flip-model swap chain only exposes buffer 0,
+        // which always aliases the current back buffer: one view, index 0.
+        virtual uint32_t GetTargetCount() const = 0;
+        virtual uint32_t GetCurrentTarget() const = 0;
+
+        // Creates / releases the views of every target. All views must be
+        // released before ResizeBuffers.
+        virtual bool CreateTargets() = 0;
+        virtual void ReleaseTargets() = 0;
+
+        virtual bool ResizeBuffers(uint32_t width, uint32_t height) = 0;
+        virtual bool Present(uint32_t syncInterval) = 0;
+    };
+
+    // Owns the per-buffer render target views and is the single place frames
+    // are presented.
+    //
+    // Views are created on the first BeginFrame and again only after a resize,
+    // never per frame. Resizes requested from the window procedure are
+    // deferred to the next BeginFrame, between frames, where the views are
+    // released, the buffers resized and the views recreated. Present presents
+    // the open frame once; a second Present before the next BeginFrame is
+    // refused and counted instead of showing the frame twice.
+    class SwapChainManager {
+    public:
+        struct Stats {
+            uint64_t frames = 0;
+            uint64_t presents = 0;
+            uint64_t refusedPresents = 0;   // Present without an open frame
+            uint64_t failedPresents = 0;
+            uint64_t targetCreations = 0;   // CreateTargets calls
+            uint64_t resizes = 0;
+        };
+
+        SwapChainManager(SwapChainBackend& backend, uint32_t width, uint32_t height);
+        ~SwapChainManager();
+
+        SwapChainManager(const SwapChainManager&) = delete;
+        SwapChainManager& operator=(const SwapChainManager&) = delete;
+
+        // Applies a pending resize, makes sure the views exist and opens the
+        // frame. Returns false if there is nothing to render into.
+        bool BeginFrame();
+
+        // Presents the open frame and closes it.
+        bool Present(uint32_t syncInterval);
+
+        // Takes effect at the next BeginFrame. Zero sizes (a minimised
+        // window) and the current size are ignored.
+        void RequestResize(uint32_t width, uint32_t height);
+
+        // Releases the views, e.g. before the device goes away.
+        void ReleaseTargets();
+
+        uint32_t GetCurrentTarget() const { return m_backend.GetCurrentTarget(); }
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        SwapChainBackend& m_backend;
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_pendingWidth = 0;
+        uint32_t m_pendingHeight = 0;
+        bool m_haveTargets = false;
+        bool m_inFrame = false;
+        Stats m_stats;
+    };
+
+    // Headless backend: counts calls, rotates through bufferCount buffers on
+    // each Present and, like DXGI, fails ResizeBuffers while views are alive.
+    class MockSwapChain : public SwapChainBackend {
+    public:
+        explicit MockSwapChain(uint32_t bufferCount = 3) : m_bufferCount(bufferCount ? bufferCount : 1) {}
+
+        uint32_t GetTargetCount() const override { return m_bufferCount; }
+        uint32_t GetCurrentTarget() const override { return uint32_t(m_presents % m_bufferCount); }
+
+        bool CreateTargets() override
+        {
+            if (m_failCreate)
+                return false;
+            m_liveTargets = m_bufferCount;
+            m_targetsCreated += m_bufferCount;
+            return true;
+        }
+
+        void ReleaseTargets() override { m_liveTargets = 0; }
+
+        bool ResizeBuffers(uint32_t width, uint32_t height) override
+        {
+            if (m_liveTargets)
+                return false;
+            m_width = width;
+            m_height = height;
+            m_resizes++;
+            return true;
+        }
+
+        bool Present(uint32_t) override
+        {
+            m_presents++;
+            return true;
+        }
+
+        void SetFailCreate(bool fail) { m_failCreate = fail; }
+
+        uint32_t GetLiveTargets() const { return m_liveTargets; }
+        uint64_t GetTargetsCreated() const { return m_targetsCreated; }
+        uint64_t GetPresents() const { return m_presents; }
+        uint64_t GetResizes() const { return m_resizes; }
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+
+    private:
+        uint32_t m_bufferCount;
+        uint32_t m_liveTargets = 0;
+        uint64_t m_targetsCreated = 0;
+        uint64_t m_presents = 0;
+        uint64_t m_resizes = 0;
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        bool m_failCreate = false;
+    };
+
+}
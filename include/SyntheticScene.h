@@ -0,0 +1,48 @@
+#pragma once
+#include "Image.h"
+#include <cstdint>
+
+namespace qisx {
+
+    // Analytic test scene for the temporal upscaler, defined in UV space so it can
+    // be point-sampled at any resolution and sub-pixel offset without a GPU.
+    //
+    // The static background puts detail above the Nyquist limit of typical
+    // low-res inputs: a zone plate in red, slanted stripes in green and a hard
+    // edged checkerboard in blue. An optional solid disc moves across it at a
+    // constant velocity, which exercises motion vectors and disocclusion.
+    class SyntheticScene {
+    public:
+        struct Options {
+            bool disc = false;
+            float discX = 0.3f;         // Disc centre at frame 0, in UV
+            float discY = 0.5f;
+            float discRadius = 0.12f;
+            float velocityX = 0.0f;     // UV per frame
+            float velocityY = 0.0f;
+        };
+
+        SyntheticScene() = default;
+        explicit SyntheticScene(const Options& options) : m_options(options) {}
+
+        const Options& GetOptions() const { return m_options; }
+
+        // RGB at (u, v) of the given frame, 0..255 per channel.
+        void Sample(uint32_t frame, float u, float v, float rgb[3]) const;
+
+        // Renders one sample per pixel at (x + 0.5 + jitterX, y + 0.5 + jitterY)
+        // into color (alpha 255). When motion is non-null it receives one (u, v)
+        // pair per pixel, tightly packed: the UV offset from this frame's position
+        // of the surface under the sample to its position in the previous frame.
+        void Render(uint32_t frame, float jitterX, float jitterY, const MutableImageView& color, float* motion) const;
+
+        // Ground truth for a frame: samples x samples box-filtered sub-samples per pixel.
+        void RenderReference(uint32_t frame, const MutableImageView& color, uint32_t samples = 8) const;
+
+    private:
+        bool InsideDisc(uint32_t frame, float u, float v) const;
+
+        Options m_options;
+    };
+
+}
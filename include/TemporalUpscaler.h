@@ -0,0 +1,85 @@
+#pragma once
+#include "Image.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <vector>
+
+namespace qisx {
+
+    // One jittered low-res frame for TemporalUpscaler.
+    struct TemporalFrame {
+        ImageView color;
+        // One (u, v) pair per color pixel, tightly packed: the UV offset from
+        // the surface's position in this frame to its position in the previous
+        // one (previous UV = UV + motion). nullptr = static scene.
+        const float* motion = nullptr;
+        // Sub-pixel offset the frame was rendered with, in input pixels
+        // (-0.5..0.5): pixel (x, y) was sampled at (x + 0.5 + jitterX, y + 0.5 + jitterY).
+        float jitterX = 0.0f;
+        float jitterY = 0.0f;
+        bool reset = false;     // Discard the history (camera cut)
+    };
+
+    // Temporal accumulation upscaler: the CPU reference for reconstructing a
+    // full-res image from a sequence of jittered low-res frames, in the spirit of
+    // TAAU / FSR2 but without their heuristics.
+    //
+    // The upscaler keeps a float RGBA history at output resolution and a
+    // per-pixel accumulated weight. For each output pixel it
+    //  1. splats the 3x3 nearest input samples at their jittered positions with
+    //     a Gaussian of the distance in output pixels, and takes their min/max;
+    //  2. reprojects the history through the motion vector of the nearest input
+    //     sample and fetches it bilinearly (history that lands off-screen is
+    //     replaced by a bilinear estimate from the current frame);
+    //  3. clamps the history colour to the neighbourhood min/max, which rejects
+    //     stale history after disocclusion or shading changes;
+    //  4. blends history and new samples by weight, capping the history weight
+    //     at maxHistoryWeight so the result keeps responding to change.
+    //
+    // On static content each frame contributes samples at new sub-pixel
+    // positions, so the output converges towards a supersampled image of the
+    // scene rather than an interpolation of one low-res frame.
+    //
+    // Output rows are split into bands on a ThreadPool; the result does not
+    // depend on the thread count. The kernel is scalar.
+    class TemporalUpscaler {
+    public:
+        struct Options {
+            float maxHistoryWeight = 16.0f;     // Caps the effective frame count averaged
+            uint32_t threadCount = 0;           // 0 = one per physical core
+            uint32_t bandHeight = 16;           // Output rows per task
+        };
+
+        TemporalUpscaler() = default;
+        explicit TemporalUpscaler(const Options& options) : m_options(options) {}
+
+        const Options& GetOptions() const { return m_options; }
+        void SetOptions(const Options& options) { m_options = options; }
+
+        // Accumulates frame into the history and writes the result to dst. The
+        // history is reset when frame.reset is set or the input or output size
+        // changes. Returns false on empty views or when dst is smaller than the
+        // input. Not reentrant: use one instance per thread.
+        bool Accumulate(const TemporalFrame& frame, const MutableImageView& dst);
+
+        // Discards the history; the next frame starts from a spatial estimate.
+        void Reset() { m_historyValid = false; }
+
+        unsigned GetThreadCount() const { return m_pool ? m_pool->GetThreadCount() : 1; }
+
+    private:
+        Options m_options;
+        std::unique_ptr<ThreadPool> m_pool;
+
+        std::vector<float> m_input;     // Current frame as float RGBA
+
+        // Ping-pong history: RGBA and weight per output pixel
+        std::vector<float> m_color[2];
+        std::vector<float> m_weight[2];
+        unsigned m_current = 0;
+        bool m_historyValid = false;
+        uint32_t m_srcWidth = 0, m_srcHeight = 0;
+        uint32_t m_dstWidth = 0, m_dstHeight = 0;
+    };
+
+}
@@ -1,7 +1,32 @@
 #pragma once
 #include<d3d11.h>
 #include<iostream>
+#include<WICTextureLoader.h>
+#include "AsyncImageLoader.h"
+#include "LruCache.h"
+#include<functional>
 
 
-ID3D11ShaderResourceView* LoadTextureFromFile(ID3D11Device* device, const wchar_t* filename , bool forceReload = false);
-void ReleaseTexture(ID3D11ShaderResourceView*& textureSRV);
\ No newline at end of file
+// Loads filename, or returns it from the texture cache (keyed by device, path and
+// loadFlags). The returned view holds its own reference: release it with
+// ReleaseTexture() whether or not it came from the cache. forceReload drops the
+// cached copy and reads the file again. WIC_LOADER_MIP_AUTOGEN adds a full mip
+// chain built on the CPU (gamma-correct with FORCE_SRGB). Thread-safe.
+ID3D11ShaderResourceView* LoadTextureFromFile(ID3D11Device* device, const wchar_t* filename , bool forceReload = false,
+	DirectX::WIC_LOADER_FLAGS loadFlags = DirectX::WIC_LOADER_DEFAULT);
+void ReleaseTexture(ID3D11ShaderResourceView*& textureSRV);
+
+// Decodes filename on loader's worker threads; loader.Pump() then creates the
+// texture and fills it in row bands on the render thread. done is called once
+// from Pump() with a view holding its own reference (nullptr on failure); the
+// view is also added to the texture cache. Only the portable formats are
+// supported (PNG, JPEG, PAM/PPM).
+qisx::AsyncLoadHandle LoadTextureAsync(qisx::AsyncImageLoader& loader, ID3D11Device* device, const wchar_t* filename,
+	std::function<void(ID3D11ShaderResourceView* textureSRV)> done, bool forceSRGB = false);
+
+// The cache evicts least recently used textures once the decoded size of
+// everything it holds (all mips) exceeds the budget.
+constexpr size_t kDefaultTextureCacheBudget = size_t(256) << 20;
+void SetTextureCacheBudget(size_t bytes);
+void ClearTextureCache();   // Call before releasing the device
+qisx::LruCacheStats GetTextureCacheStats();
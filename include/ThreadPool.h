@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qisx {
+
+    // Number of physical cores (SMT siblings counted once); falls back to the
+    // logical processor count when the topology cannot be read.
+    unsigned PhysicalCoreCount();
+
+    // Work-stealing thread pool.
+    //
+    // Every participant owns a deque: it pops from the front of its own and,
+    // when empty, steals from the back of a neighbour's. ParallelFor seeds each
+    // deque with a contiguous block of indices so neighbouring tiles tend to run
+    // on the same core, and stealing evens out the tail.
+    //
+    // A pool of N threads runs N-1 background workers; the thread calling
+    // ParallelFor is the Nth participant. Worker slots passed to tasks are in
+    // [0, GetThreadCount()) and are unique among concurrently running tasks, so
+    // they can index per-thread scratch memory.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(unsigned threadCount = 0);  // 0 = PhysicalCoreCount()
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned GetThreadCount() const { return m_threadCount; }
+
+        // Runs body(index, slot) for every index in [0, count) and returns when all
+        // have finished. Calls from different threads are serialised.
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t index, unsigned slot)>& body);
+
+        // Queues a fire-and-forget task on a background worker. Runs inline when the
+        // pool has no background workers.
+        void Submit(std::function<void(unsigned slot)> task);
+
+    private:
+        struct Task {
+            std::function<void(unsigned)> fn;                                   // Submit()
+            const std::function<void(uint32_t, unsigned)>* body = nullptr;      // ParallelFor()
+            uint32_t index = 0;
+            std::atomic<uint32_t>* remaining = nullptr;
+        };
+
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void WorkerLoop(unsigned slot);
+        bool TryRunOne(unsigned slot, bool rangeTasksOnly);
+        void Run(Task& task, unsigned slot);
+        void Push(unsigned queue, Task&& task);
+
+        unsigned m_threadCount = 1;
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        std::atomic<uint32_t> m_queued{ 0 };        // All queued tasks
+        std::atomic<uint32_t> m_queuedRange{ 0 };   // Queued ParallelFor tasks
+        std::atomic<unsigned> m_nextSubmit{ 0 };
+        bool m_stopping = false;
+
+        std::mutex m_parallelForMutex;
+    };
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qisx {
+
+    // Edge-adaptive spatial upscaler in the style of FSR1's EASU, the CPU side of
+    // PS_easu in shaders.hlsl.
+    //
+    // Each output pixel reads a 12-tap footprint around its source position p
+    // (f = floor(p)):
+    //
+    //          b c
+    //        e f g h
+    //        i j k l
+    //          n o
+    //
+    // Luma gradients at the four inner texels f, g, j, k, weighted bilinearly by
+    // the fraction of p, give an edge direction and an edge strength. The kernel
+    // is a polynomial approximation of Lanczos-2 evaluated on the squared tap
+    // offsets rotated into that direction: along an edge it is stretched (up to
+    // sqrt(2) for diagonals), across it narrowed, and its negative lobe grows with
+    // edge strength. Flat regions fall back to an isotropic kernel. The result is
+    // clamped to the min/max of f, g, j, k, which removes the ringing of the
+    // negative lobe.
+    //
+    // Luma is 0.5 R + G + 0.5 B (symmetric, so RGBA and BGRA both work), read
+    // from a plane precomputed once per frame. All four channels are filtered
+    // with the same weights. There is no unsharp mask; EASU output is meant to
+    // be followed by a sharpening pass.
+    constexpr int kEasuTaps = 12;
+
+    // Per-axis source positions: clamped indices floor(p)-1 .. floor(p)+2 and
+    // the fraction p - floor(p), with p = (o + 0.5) * src / dst - 0.5.
+    struct EasuAxis {
+        uint32_t srcSize = 0;
+        uint32_t dstSize = 0;
+        std::vector<int32_t> index;
+        std::vector<float> frac;
+
+        const int32_t* Index(uint32_t i) const { return &index[size_t(i) * 4]; }
+    };
+
+    // Rebuilds axis for a srcSize -> dstSize axis (no-op when the sizes match).
+    void BuildEasuAxis(uint32_t srcSize, uint32_t dstSize, EasuAxis& axis);
+
+    // One row of the luma plane, normalised to 0..1.
+    void EasuLumaRow(const uint8_t* srcRow, uint32_t width, float* out);
+
+    // Source rows for one output row: floor(p)-1 .. floor(p)+2 (clamped) of the
+    // RGBA8 image and of its luma plane, and the vertical fraction.
+    struct EasuRows {
+        const uint8_t* color[4];
+        const float* luma[4];
+        float fracY;
+    };
+
+    // Writes output columns [x0, x1) of one row as RGBA8 (dst points at x0).
+    using EasuRowFn = void (*)(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst);
+
+    struct EasuKernelTable {
+        SimdLevel level;
+        EasuRowFn row;
+    };
+
+    // Best kernels at or below level (Auto = this CPU). The per-pixel work is
+    // four lanes wide (four analysis texels, RGBA accumulation, 12 taps in three
+    // vectors), so SSE4.1 covers AVX2 machines too. Never returns nullptr.
+    const EasuKernelTable* GetEasuKernels(SimdLevel level);
+
+    void EasuRowScalar(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst);
+
+#if defined(QISX_ARCH_X86)
+    void EasuRowSSE41(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst);
+#elif defined(QISX_ARCH_ARM64)
+    void EasuRowNEON(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst);
+#endif
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "UpscaleKernels.h"
+
+namespace qisx {
+
+    // Fixed-point version of the separable upscaler for RGBA8 sources.
+    //
+    // Weights are Q14 int16 and the horizontally filtered rows are int16 in Q6
+    // (value * 64), which halves the row cache traffic of the float path and maps
+    // onto pmaddwd: a pixel's four channels times a pair of taps is one 8-lane
+    // multiply-add. Catmull-Rom overshoot stays in range (|row| <= ~1.2 * 255 * 64).
+    //
+    // The vertical pass folds the unsharp mask into eight taps,
+    //     out = sum((1 + s) * wb[t] * B[t]) + sum(-s * wl[t] * L[t]),
+    // quantised per output row with as many fraction bits as the int16 weights
+    // and the int32 accumulator allow. Per-axis weight sums are made exact, so
+    // flat regions are reproduced exactly. Output is within 1 LSB of the float path.
+    constexpr int kFixedWeightBits = 14;
+    constexpr int kFixedRowBits = 6;
+
+    struct FixedAxisFilter {
+        uint32_t srcSize = 0;
+        uint32_t dstSize = 0;
+        std::vector<int32_t> index;
+        std::vector<int16_t> bicubic;   // Q14, sums to 1 << 14 per output
+        std::vector<int16_t> blur;      // Q14, sums to 1 << 14 per output
+
+        const int32_t* Index(uint32_t i) const { return &index[size_t(i) * kFilterTaps]; }
+        const int16_t* Bicubic(uint32_t i) const { return &bicubic[size_t(i) * kFilterTaps]; }
+        const int16_t* Blur(uint32_t i) const { return &blur[size_t(i) * kFilterTaps]; }
+    };
+
+    // Quantises a float filter (no-op when it already matches src's sizes).
+    void BuildFixedAxisFilter(const AxisFilter& src, FixedAxisFilter& filter);
+
+    // Vertical taps for one output row with the sharpen strength folded in.
+    struct FixedVerticalWeights {
+        int16_t bicubic[kFilterTaps];
+        int16_t blur[kFilterTaps];
+        int shift;                      // Total right shift back to 0..255
+    };
+
+    void QuantiseVerticalWeights(const float* bicubicWeights, const float* blurWeights, float strength,
+        FixedVerticalWeights& weights);
+
+    using FixedHorizontalPassFn = void (*)(const uint8_t* srcRow, const FixedAxisFilter& filter,
+        uint32_t x0, uint32_t x1, int16_t* bicubicOut, int16_t* blurOut);
+    using FixedVerticalPassFn = void (*)(const int16_t* const bicubicRows[kFilterTaps],
+        const int16_t* const blurRows[kFilterTaps], const FixedVerticalWeights& weights,
+        uint32_t count, uint8_t* dst);
+
+    struct FixedKernelTable {
+        SimdLevel level;
+        FixedHorizontalPassFn horizontal;
+        FixedVerticalPassFn vertical;
+    };
+
+    // Best fixed-point kernels at or below level (Auto = this CPU). SSE4.1 covers
+    // AVX2 machines too; other ISAs use the scalar kernels. Never returns nullptr.
+    const FixedKernelTable* GetFixedKernels(SimdLevel level);
+
+    void HorizontalPassFixedScalar(const uint8_t* srcRow, const FixedAxisFilter& filter,
+        uint32_t x0, uint32_t x1, int16_t* bicubicOut, int16_t* blurOut);
+    void VerticalPassFixedScalar(const int16_t* const bicubicRows[kFilterTaps],
+        const int16_t* const blurRows[kFilterTaps], const FixedVerticalWeights& weights,
+        uint32_t count, uint8_t* dst);
+
+#if defined(QISX_ARCH_X86)
+    void HorizontalPassFixedSSE41(const uint8_t* srcRow, const FixedAxisFilter& filter,
+        uint32_t x0, uint32_t x1, int16_t* bicubicOut, int16_t* blurOut);
+    void VerticalPassFixedSSE41(const int16_t* const bicubicRows[kFilterTaps],
+        const int16_t* const blurRows[kFilterTaps], const FixedVerticalWeights& weights,
+        uint32_t count, uint8_t* dst);
+#endif
+
+}
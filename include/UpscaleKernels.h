@@ -0,0 +1,124 @@
+#pragma once
+#include "CpuFeatures.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qisx {
+
+    constexpr int kFilterTaps = 4;
+
+    // Precomputed taps for one axis of the separable upscaler.
+    //
+    // For every output coordinate there are kFilterTaps source indices (the
+    // Catmull-Rom footprint floor(pos)-1 .. floor(pos)+2, clamped to the image)
+    // and two weight sets over those same indices:
+    //  - bicubic: W(i - frac), with out-of-range taps zeroed and the rest
+    //    renormalised, which is exactly the shader's totalWeight division because
+    //    the in-bounds test in BicubicSample is separable.
+    //  - blur: one axis of PS_main's 3x3 box of bilinear taps. Three clamped lerps
+    //    at pos-1, pos, pos+1 collapse to ((1-f), 1, 1, f) / 3 on the same four
+    //    indices, so the sharpen source needs no extra footprint.
+    struct AxisFilter {
+        uint32_t srcSize = 0;
+        uint32_t dstSize = 0;
+        std::vector<int32_t> index;
+        std::vector<float> bicubic;
+        std::vector<float> blur;
+
+        const int32_t* Index(uint32_t i) const { return &index[size_t(i) * kFilterTaps]; }
+        const float* Bicubic(uint32_t i) const { return &bicubic[size_t(i) * kFilterTaps]; }
+        const float* Blur(uint32_t i) const { return &blur[size_t(i) * kFilterTaps]; }
+    };
+
+    // Rebuilds filter for a srcSize -> dstSize axis (no-op when the sizes match).
+    void BuildAxisFilter(uint32_t srcSize, uint32_t dstSize, AxisFilter& filter);
+
+    // Horizontal pass: filters output columns [x0, x1) of one RGBA8 source row into
+    // two float RGBA rows (bicubic and blur), indexed from x0.
+    void HorizontalPassScalar(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+
+    // Vertical pass: combines four horizontally filtered rows per weight set and
+    // applies the unsharp mask, writing `count` saturated RGBA8 pixels.
+    void VerticalPassScalar(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+
+    // Linear-light variants. The horizontal pass decodes colour through the
+    // 256-entry sRGB LUT (alpha as unorm) and writes 0..1 rows; the vertical pass
+    // applies the unsharp mask in linear light and re-encodes colour through the
+    // sqrt-indexed 4K table of ColorSpace.h. Same signatures, so the tile loop
+    // and row ring are shared with the gamma-space kernels.
+    //
+    // The vector horizontal kernels decode each source pixel once per chunk of
+    // output columns (DecodeLinearSpan) instead of once per tap, then filter the
+    // floats: at typical upscale ratios every source pixel feeds ~8 taps.
+    constexpr uint32_t kLinearSpanPixels = 256;
+
+    // End (exclusive) of the longest run of columns from x0 whose taps fit in
+    // kLinearSpanPixels source pixels starting at filter.Index(x0)[0].
+    uint32_t LinearSpanEnd(const AxisFilter& filter, uint32_t x0, uint32_t x1);
+
+    // Decodes `count` RGBA8 pixels to linear-light floats (alpha as unorm).
+    void DecodeLinearSpan(const uint8_t* src, uint32_t count, float* out);
+
+    void HorizontalPassLinearScalar(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassLinearScalar(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+
+    using HorizontalPassFn = void (*)(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    using VerticalPassFn = void (*)(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+
+    struct UpscaleKernelTable {
+        SimdLevel level;
+        HorizontalPassFn horizontal;
+        VerticalPassFn vertical;
+        HorizontalPassFn horizontalLinear;
+        VerticalPassFn verticalLinear;
+    };
+
+    // Kernels for level (Auto picks the best for this CPU). Returns nullptr when the
+    // ISA is not compiled into this build or the CPU cannot run it.
+    const UpscaleKernelTable* GetUpscaleKernels(SimdLevel level);
+
+#if defined(QISX_ARCH_X86)
+    void HorizontalPassSSE41(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassSSE41(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+    void HorizontalPassLinearSSE41(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassLinearSSE41(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+    void HorizontalPassAVX2(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassAVX2(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+    void HorizontalPassLinearAVX2(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassLinearAVX2(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+#elif defined(QISX_ARCH_ARM64)
+    void HorizontalPassNEON(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassNEON(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+    void HorizontalPassLinearNEON(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut);
+    void VerticalPassLinearNEON(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t count, uint8_t* dst);
+#endif
+
+}
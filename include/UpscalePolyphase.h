@@ -0,0 +1,77 @@
+#pragma once
+#include "UpscaleKernels.h"
+#include <array>
+
+namespace qisx {
+
+    // Taps for one output phase of an exact N/D (dst/src) scale. Output x = q*N + p
+    // reads source texels q*D + base - 1 .. q*D + base + 2 with these weights.
+    struct PolyphaseTaps {
+        int base = 0;
+        float bicubic[kFilterTaps] = {};
+        float blur[kFilterTaps] = {};
+    };
+
+    namespace detail {
+
+        constexpr float BicubicWeightConstexpr(float x)
+        {
+            x = x < 0.0f ? -x : x;
+            if (x < 1.0f)
+                return (1.5f * x - 2.5f) * x * x + 1.0f;
+            else if (x < 2.0f)
+                return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+            return 0.0f;
+        }
+
+        constexpr int FloorDiv(int num, int den)
+        {
+            return (num >= 0) ? num / den : -((-num + den - 1) / den);
+        }
+
+        // pos = (x + 0.5) * D / N - 0.5, evaluated in integers as (2pD + D - N) / 2N
+        template <int N, int D>
+        constexpr std::array<PolyphaseTaps, N> BuildPolyphaseTaps()
+        {
+            std::array<PolyphaseTaps, N> phases{};
+            for (int p = 0; p < N; p++) {
+                const int num = 2 * p * D + D - N;
+                const int base = FloorDiv(num, 2 * N);
+                const float f = float(num - base * 2 * N) / float(2 * N);
+
+                PolyphaseTaps& taps = phases[p];
+                taps.base = base;
+
+                float total = 0.0f;
+                for (int t = 0; t < kFilterTaps; t++) {
+                    taps.bicubic[t] = BicubicWeightConstexpr(float(t - 1) - f);
+                    total += taps.bicubic[t];
+                }
+                for (int t = 0; t < kFilterTaps; t++)
+                    taps.bicubic[t] /= total;
+
+                taps.blur[0] = (1.0f - f) / 3.0f;
+                taps.blur[1] = 1.0f / 3.0f;
+                taps.blur[2] = 1.0f / 3.0f;
+                taps.blur[3] = f / 3.0f;
+            }
+            return phases;
+        }
+
+    }
+
+    // Compile-time phase table for an N/D upscale (N outputs per D source texels).
+    template <int N, int D>
+    struct Polyphase {
+        static_assert(N > D && D > 0, "polyphase kernels are specialised for upscaling");
+        static constexpr std::array<PolyphaseTaps, N> taps = detail::BuildPolyphaseTaps<N, D>();
+    };
+
+    // Horizontal pass specialised for srcSize -> dstSize when the ratio is one of the
+    // pre-instantiated ones (3/2, 2, 4/3, 3). Interior columns use the constexpr
+    // phase tables with one contiguous 4-texel load per output and no index
+    // lookups; the renormalised edge columns go through the AxisFilter kernel of
+    // the same ISA. Returns nullptr for other ratios (use the generic kernel).
+    HorizontalPassFn SelectPolyphaseHorizontal(uint32_t srcSize, uint32_t dstSize, SimdLevel level);
+
+}
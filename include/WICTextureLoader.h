@@ -65,9 +65,12 @@ namespace DirectX
             WIC_LOADER_FORCE_SRGB = 0x1,
             WIC_LOADER_IGNORE_SRGB = 0x2,
             WIC_LOADER_SRGB_DEFAULT = 0x4,
+            WIC_LOADER_MIP_AUTOGEN = 0x8,   // Build the mip chain even when no device context is given
             WIC_LOADER_FIT_POW2 = 0x20,
             WIC_LOADER_MAKE_SQUARE = 0x40,
             WIC_LOADER_FORCE_RGBA32 = 0x80,
+            WIC_LOADER_RESIZE_LANCZOS = 0x100,  // Lanczos3 instead of the area filter when maxsize/FIT_POW2/MAKE_SQUARE resize
+            WIC_LOADER_RESIZE_WIC = 0x200,      // Resize with IWICBitmapScaler (Fant) instead of qisx::Resampler
         };
     }
 
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qisx {
+
+    // Minimal zlib (RFC 1950/1951) support for the PNG codec.
+
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+    uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+    // Appends a zlib stream for data to out: greedy LZ77 over a 32 KB window
+    // (short hash chains) coded with the fixed Huffman table. Favours speed over
+    // ratio; every inflater reads it.
+    void ZlibCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+    // A contiguous piece of a compressed stream (e.g. one PNG IDAT payload).
+    struct ByteSpan {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    // Inflates a zlib stream split across `spanCount` spans, without joining them,
+    // into exactly `outSize` bytes at out. Returns false on corrupt or short input,
+    // a bad Adler-32, or output that would not fill or would overflow outSize.
+    bool ZlibDecompress(const ByteSpan* spans, size_t spanCount, uint8_t* out, size_t outSize);
+
+}
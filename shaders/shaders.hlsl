@@ -1,6 +1,25 @@
 Texture2D sourceTex : register(t0);
 SamplerState samplerState : register(s0);
 
+// Runtime parameters, updated by the application every frame
+cbuffer UpscaleConstants : register(b0)
+{
+    float sharpenStrength;  // Unsharp mask of PS_main / PS_fused (0 when PS_rcas follows)
+    float rcasSharpness;    // PS_rcas: 0..1, 1 = strongest (FSR: exp2(-stops))
+    float2 jitterOffset;    // VS_main: clip-space sub-pixel offset of the scene pass (JitterSequence), 0 otherwise
+    float2 viewportSize;    // Upscale passes: rendered top-left region of sourceTex (DynamicResolution), 0 = all of it
+    float2 viewportPadding;
+};
+
+// Size in texels of the part of sourceTex that holds the image. With dynamic
+// resolution the scene is drawn into the top-left of a larger target.
+float2 ActiveSourceSize()
+{
+    float2 texSize;
+    sourceTex.GetDimensions(texSize.x, texSize.y);
+    return viewportSize.x > 0.0 ? min(viewportSize, texSize) : texSize;
+}
+
 struct VS_IN
 {
     float3 pos : POSITION;
@@ -16,7 +35,7 @@ struct PS_IN
 PS_IN VS_main(VS_IN input)
 {
     PS_IN output;
-    output.pos = float4(input.pos, 1.0);
+    output.pos = float4(input.pos.xy + jitterOffset, input.pos.z, 1.0);
     output.uv = input.uv;
     return output;
 }
@@ -32,9 +51,10 @@ float W(float x)
     return 0.0;
 }
 
-float4 BicubicSample(Texture2D tex, float2 uv, float2 texSize)
+// uv spans the active region (activeSize texels); taps outside it are dropped.
+float4 BicubicSample(Texture2D tex, float2 uv, float2 activeSize, float2 texSize)
 {
-    float2 pixelPos = uv * texSize - 0.5;
+    float2 pixelPos = uv * activeSize - 0.5;
     float2 fracPart = frac(pixelPos);
     float2 intPart = floor(pixelPos);
 
@@ -47,13 +67,13 @@ float4 BicubicSample(Texture2D tex, float2 uv, float2 texSize)
         [unroll]
         for (int x = -1; x <= 2; x++)
         {
-            float2 sampleCoord = (intPart + float2(x, y) + 0.5) / texSize;
-            if (all(sampleCoord >= 0.0 && sampleCoord <= 1.0))
+            float2 tap = intPart + float2(x, y);
+            if (all(tap >= 0.0 && tap < activeSize))
             {
                 float wx = W(x - fracPart.x);
                 float wy = W(y - fracPart.y);
                 float weight = wx * wy;
-                sampled += tex.SampleLevel(samplerState, sampleCoord, 0) * weight;
+                sampled += tex.SampleLevel(samplerState, (tap + 0.5) / texSize, 0) * weight;
                 totalWeight += weight;
             }
         }
@@ -66,13 +86,16 @@ float4 PS_main(PS_IN input) : SV_TARGET
 {
     float2 texSize;
     sourceTex.GetDimensions(texSize.x, texSize.y);
+    float2 activeSize = ActiveSourceSize();
     
     // Perform bicubic sampling
-    float4 color = BicubicSample(sourceTex, input.uv, texSize);
+    float4 color = BicubicSample(sourceTex, input.uv, activeSize, texSize);
     
-    // Sharpening parameters (tunable)
-    static const float sharpenStrength = 1.5; // Adjust for intensity (e.g., 0.5 to 2.0)
-    static const float2 texelSize = float2(1.0 / 854.0, 1.0 / 480.0); // Based on low-res render target
+    // Sharpening parameters (strength comes from UpscaleConstants)
+    float2 texelSize = 1.0 / texSize;
+    float2 sourceUV = input.uv * activeSize * texelSize;
+    float2 minUV = 0.5 * texelSize;
+    float2 maxUV = (activeSize - 0.5) * texelSize;
     
     // Sample the 3x3 neighborhood for sharpening
     float2 offsets[9] =
@@ -91,7 +114,7 @@ float4 PS_main(PS_IN input) : SV_TARGET
     float4 blurred = float4(0.0, 0.0, 0.0, 0.0);
     for (int i = 0; i < 9; i++)
     {
-        blurred += sourceTex.SampleLevel(samplerState, input.uv + offsets[i], 0);
+        blurred += sourceTex.SampleLevel(samplerState, clamp(sourceUV + offsets[i], minUV, maxUV), 0);
     }
     blurred /= 9.0; // Average for blur
 
@@ -108,4 +131,217 @@ float4 PS_main(PS_IN input) : SV_TARGET
     }
     
     return sharpened;
-}
\ No newline at end of file
+}
+
+// Per-axis taps for the fused pass. Indices cover the Catmull-Rom footprint
+// floor(pos)-1 .. floor(pos)+2 clamped to the texture. Out-of-range taps get
+// zero bicubic weight and the rest are renormalised (same as BicubicSample's
+// totalWeight, which factors per axis). The three clamped bilinear taps of
+// PS_main's blur at pos-1, pos, pos+1 collapse onto the same four texels.
+void AxisTaps(float f, int base, int size, out int4 index, out float4 bicubic, out float4 blur)
+{
+    int4 taps = base + int4(-1, 0, 1, 2);
+    bool4 inside = taps >= 0 && taps < size;
+
+    bicubic = float4(W(-1.0 - f), W(-f), W(1.0 - f), W(2.0 - f));
+    bicubic = inside ? bicubic : 0.0;
+    bicubic /= max(dot(bicubic, 1.0), 1e-5);
+
+    blur = float4(1.0 - f, 1.0, 1.0, f) / 3.0;
+    index = clamp(taps, 0, size - 1);
+}
+
+// Single-pass bicubic + unsharp mask: both filters read one 4x4 neighbourhood
+// (16 Loads) instead of PS_main's 16 bicubic + 9 blur samples.
+float4 PS_fused(PS_IN input) : SV_TARGET
+{
+    int2 texSize = int2(ActiveSourceSize());
+
+    float2 pixelPos = input.uv * float2(texSize) - 0.5;
+    float2 intPart = floor(pixelPos);
+    float2 fracPart = pixelPos - intPart;
+
+    int4 ix, iy;
+    float4 bx, by, lx, ly;
+    AxisTaps(fracPart.x, (int)intPart.x, texSize.x, ix, bx, lx);
+    AxisTaps(fracPart.y, (int)intPart.y, texSize.y, iy, by, ly);
+
+    float4 color = 0;
+    float4 blurred = 0;
+
+    [unroll]
+    for (int y = 0; y < 4; y++)
+    {
+        float4 rowColor = 0;
+        float4 rowBlur = 0;
+
+        [unroll]
+        for (int x = 0; x < 4; x++)
+        {
+            float4 texel = sourceTex.Load(int3(ix[x], iy[y], 0));
+            rowColor += texel * bx[x];
+            rowBlur += texel * lx[x];
+        }
+        color += rowColor * by[y];
+        blurred += rowBlur * ly[y];
+    }
+
+    float4 sharpened = saturate(color + sharpenStrength * (color - blurred));
+
+    // Debug border (red)
+    if (input.uv.x < 0.01 || input.uv.x > 0.99 || input.uv.y < 0.01 || input.uv.y > 0.99)
+    {
+        return float4(1.0, 0.0, 0.0, 1.0);
+    }
+
+    return sharpened;
+}
+
+// Edge-adaptive upscale in the style of FSR1's EASU (CPU side: UpscaleEasu.h).
+// 12 Loads around p, f = floor(p):
+//
+//      b c
+//    e f g h
+//    i j k l
+//      n o
+//
+// Luma gradients at f, g, j, k, weighted bilinearly by frac(p), pick an edge
+// direction and strength; the Lanczos-2 approximation is stretched along the
+// edge and narrowed across it. Output is clamped to min/max(f, g, j, k), so
+// there is no ringing and no unsharp mask; sharpening is a separate pass.
+float EasuLuma(float4 c)
+{
+    return (c.r * 0.5 + c.g + c.b * 0.5) * 0.5; // 0..1, as EasuLumaRow
+}
+
+// One analysis texel: accumulates direction and edge length with weight w
+void EasuEdge(inout float2 dir, inout float len, float w, float up, float left, float centre, float right, float down)
+{
+    float dx = right - left;
+    float ex = max(abs(right - centre), abs(centre - left));
+    float lx = saturate(abs(dx) / max(ex, 1.0 / 32768.0));
+    float dy = down - up;
+    float ey = max(abs(down - centre), abs(centre - up));
+    float ly = saturate(abs(dy) / max(ey, 1.0 / 32768.0));
+    dir += float2(dx, dy) * w;
+    len += (lx * lx + ly * ly) * w;
+}
+
+void EasuTap(inout float4 color, inout float total, float2 off, float2 dir, float2 len2, float lobe, float clip, float4 texel)
+{
+    float2 v = float2(dot(off, dir), dot(off, float2(-dir.y, dir.x))) * len2;
+    float d2 = min(dot(v, v), clip);
+    float wB = 0.4 * d2 - 1.0;
+    float wA = lobe * d2 - 1.0;
+    wB *= wB;
+    wA *= wA;
+    wB = 1.5625 * wB - 0.5625;
+    float w = wB * wA;
+    color += texel * w;
+    total += w;
+}
+
+float4 PS_easu(PS_IN input) : SV_TARGET
+{
+    float2 activeSize = ActiveSourceSize();
+    int2 maxIndex = int2(activeSize) - 1;
+
+    float2 pixelPos = input.uv * activeSize - 0.5;
+    float2 intPart = floor(pixelPos);
+    float2 pp = pixelPos - intPart;
+    int2 f0 = int2(intPart);
+
+#define EASU_LOAD(dx, dy) sourceTex.Load(int3(clamp(f0 + int2(dx, dy), 0, maxIndex), 0))
+    float4 b = EASU_LOAD(0, -1), c = EASU_LOAD(1, -1);
+    float4 e = EASU_LOAD(-1, 0), f = EASU_LOAD(0, 0), g = EASU_LOAD(1, 0), h = EASU_LOAD(2, 0);
+    float4 i = EASU_LOAD(-1, 1), j = EASU_LOAD(0, 1), k = EASU_LOAD(1, 1), l = EASU_LOAD(2, 1);
+    float4 n = EASU_LOAD(0, 2), o = EASU_LOAD(1, 2);
+#undef EASU_LOAD
+
+    float bL = EasuLuma(b), cL = EasuLuma(c);
+    float eL = EasuLuma(e), fL = EasuLuma(f), gL = EasuLuma(g), hL = EasuLuma(h);
+    float iL = EasuLuma(i), jL = EasuLuma(j), kL = EasuLuma(k), lL = EasuLuma(l);
+    float nL = EasuLuma(n), oL = EasuLuma(o);
+
+    float2 dir = 0;
+    float len = 0;
+    EasuEdge(dir, len, (1.0 - pp.x) * (1.0 - pp.y), bL, eL, fL, gL, jL);
+    EasuEdge(dir, len, pp.x * (1.0 - pp.y), cL, fL, gL, hL, kL);
+    EasuEdge(dir, len, (1.0 - pp.x) * pp.y, fL, iL, jL, kL, nL);
+    EasuEdge(dir, len, pp.x * pp.y, gL, jL, kL, lL, oL);
+
+    float dirR = dot(dir, dir);
+    dir = dirR < 1.0 / 32768.0 ? float2(1.0, 0.0) : dir * rsqrt(dirR);
+    len = len * 0.5;
+    len *= len;
+    float stretch = 1.0 / max(abs(dir.x), abs(dir.y));
+    float2 len2 = float2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+    float lobe = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;
+    float clip = 1.0 / lobe;
+
+    float4 color = 0;
+    float total = 0;
+    EasuTap(color, total, float2(0.0, -1.0) - pp, dir, len2, lobe, clip, b);
+    EasuTap(color, total, float2(1.0, -1.0) - pp, dir, len2, lobe, clip, c);
+    EasuTap(color, total, float2(-1.0, 0.0) - pp, dir, len2, lobe, clip, e);
+    EasuTap(color, total, float2(0.0, 0.0) - pp, dir, len2, lobe, clip, f);
+    EasuTap(color, total, float2(1.0, 0.0) - pp, dir, len2, lobe, clip, g);
+    EasuTap(color, total, float2(2.0, 0.0) - pp, dir, len2, lobe, clip, h);
+    EasuTap(color, total, float2(-1.0, 1.0) - pp, dir, len2, lobe, clip, i);
+    EasuTap(color, total, float2(0.0, 1.0) - pp, dir, len2, lobe, clip, j);
+    EasuTap(color, total, float2(1.0, 1.0) - pp, dir, len2, lobe, clip, k);
+    EasuTap(color, total, float2(2.0, 1.0) - pp, dir, len2, lobe, clip, l);
+    EasuTap(color, total, float2(0.0, 2.0) - pp, dir, len2, lobe, clip, n);
+    EasuTap(color, total, float2(1.0, 2.0) - pp, dir, len2, lobe, clip, o);
+
+    float4 lo = min(min(f, g), min(j, k));
+    float4 hi = max(max(f, g), max(j, k));
+    float4 result = clamp(color / total, lo, hi);
+
+    // Debug border (red)
+    if (input.uv.x < 0.01 || input.uv.x > 0.99 || input.uv.y < 0.01 || input.uv.y > 0.99)
+    {
+        return float4(1.0, 0.0, 0.0, 1.0);
+    }
+
+    return result;
+}
+
+// Contrast-adaptive sharpening in the style of FSR1's RCAS (CPU side:
+// SharpenRcas.h). Runs on the upscaled image, in place of PS_main's unsharp
+// mask, and reads the pixel and its four neighbours with Load, so the texel
+// size is that of the bound resource:
+//
+//      b
+//    d e f
+//      h
+//
+// Per colour channel, the strongest negative lobe that keeps the result in
+// 0..1 follows from the min/max of the cross; the weakest channel wins, is
+// capped at RCAS_LIMIT and scaled by rcasSharpness.
+
+#define RCAS_LIMIT (0.25 - 1.0 / 16.0)
+
+float4 PS_rcas(PS_IN input) : SV_TARGET
+{
+    uint width, height;
+    sourceTex.GetDimensions(width, height);
+    int2 maxIndex = int2(width, height) - 1;
+    int2 p = int2(input.pos.xy);
+
+    float4 e = sourceTex.Load(int3(p, 0));
+    float3 b = sourceTex.Load(int3(clamp(p + int2(0, -1), 0, maxIndex), 0)).rgb;
+    float3 d = sourceTex.Load(int3(clamp(p + int2(-1, 0), 0, maxIndex), 0)).rgb;
+    float3 f = sourceTex.Load(int3(clamp(p + int2(1, 0), 0, maxIndex), 0)).rgb;
+    float3 h = sourceTex.Load(int3(clamp(p + int2(0, 1), 0, maxIndex), 0)).rgb;
+
+    float3 mn4 = min(min(b, d), min(f, h));
+    float3 mx4 = max(max(b, d), max(f, h));
+    float3 hitMin = min(mn4, e.rgb) / max(4.0 * mx4, 1.0 / 255.0);
+    float3 hitMax = (1.0 - max(mx4, e.rgb)) / min(4.0 * mn4 - 4.0, -1.0 / 255.0);
+    float3 lobeRGB = max(-hitMin, hitMax);
+    float lobe = max(-RCAS_LIMIT, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * rcasSharpness;
+
+    float3 color = (lobe * ((b + d) + (f + h)) + e.rgb) / (4.0 * lobe + 1.0);
+    return float4(saturate(color), e.a);
+}
@@ -0,0 +1,201 @@
+#include "AsyncImageLoader.h"
+#include "ImageIO.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+
+namespace qisx {
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Moves an estimate towards a new measurement; quick to adapt, but one
+    // preempted call cannot wreck it.
+    void Blend(double& estimate, double sample)
+    {
+        estimate = estimate * 0.75 + sample * 0.25;
+    }
+
+    // Maps the file by its native path: the wide name on Windows, so names the
+    // ANSI code page cannot represent still open the right file.
+    bool LoadImagePath(const std::filesystem::path& path, Image& image, std::string* error)
+    {
+        MappedFile file;
+#if defined(_WIN32)
+        const bool opened = file.Open(path.wstring(), error);
+#else
+        const bool opened = file.Open(path.string(), error);
+#endif
+        return opened && DecodeImage(file.Data(), file.Size(), image, error);
+    }
+
+}
+
+AsyncImageLoader::AsyncImageLoader(const Options& options)
+    : m_options(options)
+    , m_pool(std::make_unique<ThreadPool>(std::max(1u, options.workerThreads) + 1))
+{
+}
+
+AsyncImageLoader::~AsyncImageLoader()
+{
+    // Queued decodes see the flag and skip their work; running ones finish
+    m_stopping = true;
+    m_pool.reset();
+
+    if (m_current)
+        Finish(*m_current, AsyncLoadStatus::Cancelled);
+    for (const std::shared_ptr<AsyncLoad>& load : m_ready)
+        Finish(*load, load->m_decodeFailed ? AsyncLoadStatus::Failed : AsyncLoadStatus::Cancelled);
+}
+
+AsyncLoadHandle AsyncImageLoader::Load(const std::filesystem::path& path, AsyncLoadCallbacks callbacks)
+{
+    auto load = std::make_shared<AsyncLoad>();
+    load->m_path = path;
+    load->m_callbacks = std::move(callbacks);
+    m_pending++;
+    m_pool->Submit([this, load](unsigned) { Decode(load); });
+    return load;
+}
+
+void AsyncImageLoader::Decode(const std::shared_ptr<AsyncLoad>& load)
+{
+    if (!m_stopping) {
+        load->m_status = AsyncLoadStatus::Decoding;
+        std::string error;
+        bool ok = LoadImagePath(load->m_path, load->m_image, &error);
+        if (ok && load->m_callbacks.convert && !load->m_callbacks.convert(load->m_image)) {
+            ok = false;
+            error = "conversion failed";
+        }
+        // A failure stays Decoding until Pump() finishes it, so Done() never
+        // reports a load whose complete callback has not run yet
+        if (ok)
+            load->m_status = AsyncLoadStatus::Uploading;
+        else {
+            load->m_error = error;
+            load->m_image = Image();
+            load->m_decodeFailed = true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_ready.push_back(load);
+}
+
+void AsyncImageLoader::Finish(AsyncLoad& load, AsyncLoadStatus status)
+{
+    if (status == AsyncLoadStatus::Cancelled && load.m_error.empty())
+        load.m_error = "cancelled";
+    if (status != AsyncLoadStatus::Complete)
+        load.m_image = Image();
+    if (load.m_callbacks.complete)
+        load.m_callbacks.complete(status, load.m_error, load.m_image);
+    // Release the pixels and callback captures; the handle only reports status now
+    load.m_image = Image();
+    load.m_callbacks = AsyncLoadCallbacks{};
+    load.m_status = status;
+    m_pending--;
+}
+
+AsyncPumpStats AsyncImageLoader::Pump()
+{
+    const auto start = Clock::now();
+    const double budget = m_options.frameBudgetMs;
+    AsyncPumpStats stats;
+    bool progressed = false;
+
+    // Leaves a little headroom, since estimates are averages
+    auto fits = [&](double estimateMs) { return !progressed || MillisecondsSince(start) + estimateMs <= budget * 0.9; };
+
+    for (;;) {
+        if (!m_current) {
+            std::lock_guard<std::mutex> lock(m_readyMutex);
+            if (m_ready.empty())
+                break;
+            m_current = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+        AsyncLoad& load = *m_current;
+
+        if (load.m_decodeFailed) {
+            Finish(load, AsyncLoadStatus::Failed);
+            m_current.reset();
+            stats.completed++;
+            continue;
+        }
+
+        const AsyncLoadCallbacks& callbacks = load.m_callbacks;
+        const uint32_t width = load.m_image.Width();
+        const uint32_t height = load.m_image.Height();
+
+        if (!load.m_begun && callbacks.begin) {
+            if (!fits(m_beginMs))
+                break;
+            const auto t = Clock::now();
+            const bool ok = callbacks.begin(width, height);
+            Blend(m_beginMs, MillisecondsSince(t));
+            progressed = true;
+            if (!ok) {
+                load.m_error = "begin failed";
+                Finish(load, AsyncLoadStatus::Failed);
+                m_current.reset();
+                stats.completed++;
+                continue;
+            }
+        }
+        load.m_begun = true;
+
+        bool failed = false;
+        if (callbacks.upload) {
+            const double rowMegabytes = double(load.m_image.RowPitch()) / (1 << 20);
+            while (load.m_nextRow < height) {
+                const double remainingMs = budget * 0.9 - MillisecondsSince(start);
+                uint32_t rows = uint32_t(std::max(0.0, remainingMs / (m_msPerMegabyte * rowMegabytes)));
+                rows = std::min(rows, height - load.m_nextRow);
+                if (rows == 0) {
+                    if (progressed)
+                        break;
+                    rows = 1;
+                }
+
+                const ImageView view = load.m_image.View();
+                const ImageView band{ view.Row(load.m_nextRow), width, rows, view.rowPitch };
+                const auto t = Clock::now();
+                const bool ok = callbacks.upload(band, load.m_nextRow);
+                const double ms = MillisecondsSince(t);
+                Blend(m_msPerMegabyte, ms / std::max(1e-6, rows * rowMegabytes));
+                progressed = true;
+                stats.rowsUploaded += rows;
+                load.m_nextRow += rows;
+                if (!ok) {
+                    failed = true;
+                    break;
+                }
+            }
+            if (!failed && load.m_nextRow < height)
+                break;  // Out of budget; resume next frame
+        }
+
+        if (failed)
+            load.m_error = "upload failed";
+        Finish(load, failed ? AsyncLoadStatus::Failed : AsyncLoadStatus::Complete);
+        m_current.reset();
+        stats.completed++;
+        progressed = true;
+        if (!fits(0.0))
+            break;
+    }
+
+    stats.milliseconds = MillisecondsSince(start);
+    return stats;
+}
+
+}
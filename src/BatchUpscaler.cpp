@@ -0,0 +1,234 @@
+#include "BatchUpscaler.h"
+#include "BoundedQueue.h"
+#include "ImageIO.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace qisx {
+
+namespace {
+
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    struct BatchJob {
+        size_t input = 0;
+        Image image;
+    };
+
+    double SecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+}
+
+std::vector<std::string> CollectBatchInputs(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> files;
+    for (const std::string& path : paths) {
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (const fs::directory_entry& entry : fs::directory_iterator(path, ec)) {
+            if (entry.is_regular_file(ec) && ImageFormatFromExtension(entry.path().string()) != ImageFileFormat::Unknown)
+                found.push_back(entry.path().string());
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+void ComputeBatchTargetSize(const BatchOptions& options, uint32_t srcWidth, uint32_t srcHeight,
+    uint32_t& dstWidth, uint32_t& dstHeight)
+{
+    if (options.width && options.height) {
+        dstWidth = options.width;
+        dstHeight = options.height;
+    }
+    else if (options.width) {
+        dstWidth = options.width;
+        dstHeight = uint32_t(std::lround(double(srcHeight) * options.width / srcWidth));
+    }
+    else if (options.height) {
+        dstHeight = options.height;
+        dstWidth = uint32_t(std::lround(double(srcWidth) * options.height / srcHeight));
+    }
+    else {
+        dstWidth = uint32_t(std::lround(double(srcWidth) * options.scale));
+        dstHeight = uint32_t(std::lround(double(srcHeight) * options.scale));
+    }
+    dstWidth = std::max(1u, dstWidth);
+    dstHeight = std::max(1u, dstHeight);
+}
+
+bool RunBatch(const BatchOptions& options, BatchStats& stats,
+    const std::function<void(const std::string& message)>& log)
+{
+    stats = BatchStats{};
+    const auto batchStart = Clock::now();
+
+    std::error_code ec;
+    if (!options.outputDir.empty())
+        fs::create_directories(options.outputDir, ec);
+    if (ec || (!options.outputDir.empty() && !fs::is_directory(options.outputDir))) {
+        if (log)
+            log("cannot create output directory " + options.outputDir);
+        return false;
+    }
+
+    std::mutex statsMutex;
+    auto fail = [&](size_t input, const std::string& reason) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.failures++;
+        if (log)
+            log(options.inputs[input] + ": " + reason);
+    };
+
+    BoundedQueue<BatchJob> decoded(options.queueDepth);
+    BoundedQueue<BatchJob> upscaled(options.queueDepth);
+
+    // Decode: workers claim inputs in order; the last one out closes the queue
+    std::atomic<size_t> nextInput{ 0 };
+    std::atomic<unsigned> activeDecoders{ std::max(1u, options.decodeThreads) };
+    std::vector<std::thread> decoders;
+    for (unsigned i = 0; i < std::max(1u, options.decodeThreads); i++) {
+        decoders.emplace_back([&] {
+            double busy = 0.0;
+            uint64_t bytes = 0;
+            uint64_t bytesCopied = 0;
+            for (size_t input; (input = nextInput.fetch_add(1)) < options.inputs.size();) {
+                const auto start = Clock::now();
+                BatchJob job;
+                job.input = input;
+                std::string error;
+                ImageLoadStats load;
+                bool ok;
+                {
+                    ProfileScope scope(options.profiler, "Decode");
+                    ok = LoadImageFileInto(options.inputs[input], [&](const ImageInfo& info, MutableImageView& dst) {
+                        job.image = Image(info.width, info.height);
+                        dst = job.image.MutableView();
+                        return true;
+                    }, &load, &error);
+                }
+                busy += SecondsSince(start);
+                bytes += load.fileBytes;
+                bytesCopied += load.bytesCopied;
+
+                if (!ok)
+                    fail(input, error);
+                else if (!decoded.Push(std::move(job)))
+                    break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                stats.decodeSeconds += busy;
+                stats.inputBytes += bytes;
+                stats.inputBytesCopied += bytesCopied;
+            }
+            if (activeDecoders.fetch_sub(1) == 1)
+                decoded.Close();
+        });
+    }
+
+    // Encode
+    std::vector<std::thread> encoders;
+    for (unsigned i = 0; i < std::max(1u, options.encodeThreads); i++) {
+        encoders.emplace_back([&] {
+            double busy = 0.0;
+            MipGenerator mipGenerator(options.mips);
+            std::vector<Image> mips;
+            for (BatchJob job; upscaled.Pop(job);) {
+                const auto start = Clock::now();
+                const fs::path input(options.inputs[job.input]);
+                const fs::path output = fs::path(options.outputDir) / (input.stem().string() + "." + options.outputExtension);
+
+                std::error_code same;
+                std::string error;
+                bool ok = false;
+                if (fs::equivalent(input, output, same))
+                    error = "output would overwrite the input";
+                else {
+                    ProfileScope scope(options.profiler, "Encode");
+                    ok = SaveImageFile(output.string(), job.image.View(), &error);
+                }
+                if (ok && options.writeMips) {
+                    ProfileScope scope(options.profiler, "Mips");
+                    ok = mipGenerator.Generate(job.image.View(), mips);
+                    for (size_t level = 0; ok && level < mips.size(); level++) {
+                        const fs::path mipOutput = fs::path(options.outputDir)
+                            / (input.stem().string() + "_mip" + std::to_string(level + 1) + "." + options.outputExtension);
+                        ok = SaveImageFile(mipOutput.string(), mips[level].View(), &error);
+                    }
+                }
+                busy += SecondsSince(start);
+
+                if (!ok) {
+                    fail(job.input, error);
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(statsMutex);
+                stats.images++;
+                stats.outputPixels += uint64_t(job.image.Width()) * job.image.Height();
+            }
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.encodeSeconds += busy;
+        });
+    }
+
+    // Upscale on this thread; CpuUpscaler spreads each frame over its own pool
+    CpuUpscaler upscaler(options.upscaler);
+    for (BatchJob job; decoded.Pop(job);) {
+        if (options.profiler)
+            options.profiler->BeginFrame();
+        const auto start = Clock::now();
+        uint32_t width = 0, height = 0;
+        ComputeBatchTargetSize(options, job.image.Width(), job.image.Height(), width, height);
+
+        BatchJob result;
+        result.input = job.input;
+        result.image = Image(width, height);
+        bool ok;
+        {
+            ProfileScope scope(options.profiler, "Upscale");
+            ok = upscaler.Upscale(job.image.View(), result.image.MutableView());
+        }
+        stats.upscaleSeconds += SecondsSince(start);
+
+        if (!ok) {
+            fail(job.input, "upscale failed");
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.inputPixels += uint64_t(job.image.Width()) * job.image.Height();
+        }
+        upscaled.Push(std::move(result));
+    }
+    upscaled.Close();
+    if (options.profiler)
+        options.profiler->EndFrame();
+
+    for (std::thread& t : decoders)
+        t.join();
+    for (std::thread& t : encoders)
+        t.join();
+
+    stats.seconds = SecondsSince(batchStart);
+    return stats.failures == 0;
+}
+
+}
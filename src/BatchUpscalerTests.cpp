@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "BatchUpscaler.h"
+#include "BoundedQueue.h"
+#include "ImageIO.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    fs::path MakeTempDir(const char* name)
+    {
+        const fs::path dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir;
+    }
+
+}
+
+TEST(BatchUpscalerTests, QueueBlocksAtCapacity)
+{
+    qisx::BoundedQueue<int> queue(2);
+    ASSERT_TRUE(queue.Push(1));
+    ASSERT_TRUE(queue.Push(2));
+
+    std::atomic<bool> pushed{ false };
+    std::thread producer([&] {
+        queue.Push(3);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());
+
+    int value = 0;
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+
+    queue.Close();
+    EXPECT_FALSE(queue.Push(4));
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(BatchUpscalerTests, TargetSizeFollowsOptions)
+{
+    qisx::BatchOptions options;
+    uint32_t w = 0, h = 0;
+
+    qisx::ComputeBatchTargetSize(options, 854, 480, w, h);
+    EXPECT_EQ(w, 1281u);
+    EXPECT_EQ(h, 720u);
+
+    options.width = 1920;
+    qisx::ComputeBatchTargetSize(options, 1280, 720, w, h);
+    EXPECT_EQ(w, 1920u);
+    EXPECT_EQ(h, 1080u);
+
+    options.height = 100;
+    qisx::ComputeBatchTargetSize(options, 1280, 720, w, h);
+    EXPECT_EQ(w, 1920u);
+    EXPECT_EQ(h, 100u);
+}
+
+// More images than queue slots, with a bad file mixed in: every good image is
+// written at the right size and the failure is reported, not fatal.
+TEST(BatchUpscalerTests, ProcessesDirectoryAndReportsFailures)
+{
+    const fs::path in = MakeTempDir("qisx_batch_in");
+    const fs::path out = fs::temp_directory_path() / "qisx_batch_out";
+    fs::remove_all(out);
+
+    for (int i = 0; i < 7; i++) {
+        qisx::Image image(40 + i, 30);
+        for (size_t b = 0; b < image.SizeInBytes(); b++)
+            image.Data()[b] = uint8_t(b * (i + 3));
+        ASSERT_TRUE(qisx::SaveImageFile((in / ("img" + std::to_string(i) + ".pam")).string(), image.View()));
+    }
+    ASSERT_TRUE(qisx::WriteFileBytes((in / "broken.ppm").string(), { 'P', '6', '\n', '9' }));
+    ASSERT_TRUE(qisx::WriteFileBytes((in / "notes.txt").string(), { 'x' }));
+
+    qisx::BatchOptions options;
+    options.inputs = qisx::CollectBatchInputs({ in.string() });
+    options.outputDir = out.string();
+    options.outputExtension = "pam";
+    options.scale = 2.0f;
+    options.queueDepth = 2;
+    options.upscaler.threadCount = 2;
+    ASSERT_EQ(options.inputs.size(), 8u);     // .txt skipped
+
+    std::vector<std::string> messages;
+    std::mutex messagesMutex;
+    qisx::BatchStats stats;
+    EXPECT_FALSE(qisx::RunBatch(options, stats, [&](const std::string& m) {
+        std::lock_guard<std::mutex> lock(messagesMutex);
+        messages.push_back(m);
+    }));
+
+    EXPECT_EQ(stats.images, 7u);
+    EXPECT_EQ(stats.failures, 1u);
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_NE(messages[0].find("broken.ppm"), std::string::npos);
+    EXPECT_GT(stats.ImagesPerSecond(), 0.0);
+
+    uint64_t pixels = 0;
+    for (int i = 0; i < 7; i++) {
+        qisx::Image result;
+        ASSERT_TRUE(qisx::LoadImageFile((out / ("img" + std::to_string(i) + ".pam")).string(), result));
+        EXPECT_EQ(result.Width(), uint32_t(2 * (40 + i)));
+        EXPECT_EQ(result.Height(), 60u);
+        pixels += uint64_t(result.Width()) * result.Height();
+    }
+    EXPECT_EQ(stats.outputPixels, pixels);
+
+    fs::remove_all(in);
+    fs::remove_all(out);
+}
+
+TEST(BatchUpscalerTests, WritesMipChains)
+{
+    const fs::path in = MakeTempDir("qisx_batch_mips_in");
+    const fs::path out = fs::temp_directory_path() / "qisx_batch_mips_out";
+    fs::remove_all(out);
+
+    qisx::Image image(10, 6);
+    for (size_t b = 0; b < image.SizeInBytes(); b++)
+        image.Data()[b] = uint8_t(b * 5);
+    ASSERT_TRUE(qisx::SaveImageFile((in / "tile.pam").string(), image.View()));
+
+    qisx::BatchOptions options;
+    options.inputs = { (in / "tile.pam").string() };
+    options.outputDir = out.string();
+    options.outputExtension = "pam";
+    options.scale = 2.0f;
+    options.writeMips = true;
+    options.mips.srgb = true;
+    qisx::BatchStats stats;
+    ASSERT_TRUE(qisx::RunBatch(options, stats));
+
+    // 20x12 output: 10x6, 5x3, 2x1, 1x1
+    const uint32_t sizes[][2] = { { 10, 6 }, { 5, 3 }, { 2, 1 }, { 1, 1 } };
+    for (int level = 1; level <= 4; level++) {
+        qisx::Image mip;
+        ASSERT_TRUE(qisx::LoadImageFile((out / ("tile_mip" + std::to_string(level) + ".pam")).string(), mip)) << level;
+        EXPECT_EQ(mip.Width(), sizes[level - 1][0]);
+        EXPECT_EQ(mip.Height(), sizes[level - 1][1]);
+    }
+    EXPECT_FALSE(fs::exists(out / "tile_mip5.pam"));
+}
@@ -0,0 +1,543 @@
+#include "Benchmark.h"
+#include "CpuUpscaler.h"
+#include "FramePacer.h"
+#include "ImageDecoder.h"
+#include "ImageIO.h"
+#include "JitterSequence.h"
+#include "PixelConvert.h"
+#include "Resampler.h"
+#include "SyntheticScene.h"
+#include "TemporalUpscaler.h"
+#include "UpscalePolyphase.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    // Deterministic pattern with hard edges and gradients so the sharpen path
+    // sees realistic data instead of a flat colour.
+    void FillTestPattern(Image& image)
+    {
+        uint32_t state = 0x12345678u;
+        for (uint32_t y = 0; y < image.Height(); y++) {
+            uint8_t* p = image.Data() + y * image.RowPitch();
+            for (uint32_t x = 0; x < image.Width(); x++, p += 4) {
+                state = state * 1664525u + 1013904223u;
+                const bool checker = ((x / 16) ^ (y / 16)) & 1;
+                p[0] = static_cast<uint8_t>(checker ? 230 : 25);
+                p[1] = static_cast<uint8_t>((x * 255) / std::max(1u, image.Width() - 1));
+                p[2] = static_cast<uint8_t>(state >> 24);
+                p[3] = 255;
+            }
+        }
+    }
+
+    // CPU time consumed by the calling thread, in seconds.
+    double ThreadCpuSeconds()
+    {
+#if defined(_WIN32)
+        FILETIME creation, exit, kernel, user;
+        GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+        const auto ticks = [](const FILETIME& t) { return (uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+        return double(ticks(kernel) + ticks(user)) * 1e-7;
+#else
+        timespec t;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+        return double(t.tv_sec) + double(t.tv_nsec) * 1e-9;
+#endif
+    }
+
+}
+
+BenchmarkResult RunBenchmark(const std::string& name, int iterations, uint64_t pixelsPerIteration,
+    const std::function<void()>& fn)
+{
+    using Clock = std::chrono::steady_clock;
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = std::max(1, iterations);
+
+    fn();
+
+    double total = 0.0;
+    double best = 1e30;
+    for (int i = 0; i < result.iterations; i++) {
+        const auto start = Clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        total += ms;
+        best = std::min(best, ms);
+    }
+
+    result.bestMs = best;
+    result.meanMs = total / result.iterations;
+    result.megapixelsPerSec = best > 0.0 ? (pixelsPerIteration / 1e6) / (best / 1000.0) : 0.0;
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkUpscalePaths(uint32_t srcW, uint32_t srcH,
+    uint32_t dstW, uint32_t dstH, int iterations)
+{
+    Image src(srcW, srcH);
+    Image dst(dstW, dstH);
+    FillTestPattern(src);
+
+    const uint64_t pixels = uint64_t(dstW) * dstH;
+    std::vector<BenchmarkResult> results;
+
+    // Texel reads per output pixel. Reference: 16 bicubic taps + 9 bilinear taps
+    // of 4 texels each. Fused: the shared 4x4 footprint. Separable: 4 reads per
+    // horizontally filtered source row, amortised over the output rows using it.
+    const double separableFetches = 4.0 * srcH / dstH;
+
+    CpuUpscaler reference({ 1.5f, false, UpscalePath::Reference, SimdLevel::Auto, 1 });
+    results.push_back(RunBenchmark("reference", iterations, pixels,
+        [&] { reference.Upscale(src.View(), dst.MutableView()); }));
+    results.back().fetchesPerPixel = 16 + 9 * 4;
+
+    CpuUpscaler fused({ 1.5f, false, UpscalePath::Fused, SimdLevel::Auto, 1 });
+    results.push_back(RunBenchmark("fused", iterations, pixels,
+        [&] { fused.Upscale(src.View(), dst.MutableView()); }));
+    results.back().fetchesPerPixel = 16;
+
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::NEON };
+    for (SimdLevel level : levels) {
+        if (!GetUpscaleKernels(level))
+            continue;
+        CpuUpscaler::Options options{ 1.5f, false, UpscalePath::Separable, level, 1 };
+        options.polyphase = false;
+        CpuUpscaler separable(options);
+        results.push_back(RunBenchmark(std::string("separable/") + SimdLevelName(level), iterations, pixels,
+            [&] { separable.Upscale(src.View(), dst.MutableView()); }));
+        results.back().fetchesPerPixel = separableFetches;
+
+        // Same kernels with the constexpr polyphase horizontal pass, when the ratio has one
+        if (SelectPolyphaseHorizontal(srcW, dstW, level)) {
+            options.polyphase = true;
+            CpuUpscaler polyphase(options);
+            results.push_back(RunBenchmark(std::string("polyphase/") + SimdLevelName(level), iterations, pixels,
+                [&] { polyphase.Upscale(src.View(), dst.MutableView()); }));
+            results.back().fetchesPerPixel = separableFetches;
+        }
+    }
+
+    // Integer path: one row per distinct kernel set
+    std::vector<const FixedKernelTable*> fixedKernels = { GetFixedKernels(SimdLevel::Scalar) };
+    if (GetFixedKernels(SimdLevel::Auto) != fixedKernels[0])
+        fixedKernels.push_back(GetFixedKernels(SimdLevel::Auto));
+    for (const FixedKernelTable* kernels : fixedKernels) {
+        CpuUpscaler fixed({ 1.5f, false, UpscalePath::FixedPoint, kernels->level, 1 });
+        results.push_back(RunBenchmark(std::string("fixed/") + SimdLevelName(kernels->level), iterations, pixels,
+            [&] { fixed.Upscale(src.View(), dst.MutableView()); }));
+        results.back().fetchesPerPixel = separableFetches;
+    }
+
+    // Edge-adaptive filter (PS_easu): 12 colour taps plus 12 luma reads, the
+    // latter from the per-frame plane (one extra read per source texel)
+    std::vector<const EasuKernelTable*> easuKernels = { GetEasuKernels(SimdLevel::Scalar) };
+    if (GetEasuKernels(SimdLevel::Auto) != easuKernels[0])
+        easuKernels.push_back(GetEasuKernels(SimdLevel::Auto));
+    for (const EasuKernelTable* kernels : easuKernels) {
+        CpuUpscaler easu({ 1.5f, false, UpscalePath::EdgeAdaptive, kernels->level, 1 });
+        results.push_back(RunBenchmark(std::string("easu/") + SimdLevelName(kernels->level), iterations, pixels,
+            [&] { easu.Upscale(src.View(), dst.MutableView()); }));
+        results.back().fetchesPerPixel = 12;
+    }
+
+    // Thread scaling of the tiled engine with the best kernels
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 2; threads <= std::min(16u, maxThreads); threads *= 2) {
+        CpuUpscaler tiled({ 1.5f, false, UpscalePath::Separable, SimdLevel::Auto, threads });
+        results.push_back(RunBenchmark("separable/auto x" + std::to_string(threads), iterations, pixels,
+            [&] { tiled.Upscale(src.View(), dst.MutableView()); }));
+        results.back().fetchesPerPixel = separableFetches;
+    }
+
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkLinearLight(uint32_t srcW, uint32_t srcH,
+    uint32_t dstW, uint32_t dstH, int iterations)
+{
+    Image src(srcW, srcH);
+    Image dst(dstW, dstH);
+    FillTestPattern(src);
+
+    const uint64_t pixels = uint64_t(dstW) * dstH;
+    std::vector<BenchmarkResult> results;
+
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+    if (GetUpscaleKernels(SimdLevel::Auto)->level != SimdLevel::Scalar)
+        levels.push_back(GetUpscaleKernels(SimdLevel::Auto)->level);
+
+    for (SimdLevel level : levels) {
+        for (bool linear : { false, true }) {
+            CpuUpscaler::Options options{ 1.5f, false, UpscalePath::Separable, level, 1 };
+            options.polyphase = false;
+            options.linearLight = linear;
+            CpuUpscaler upscaler(options);
+            results.push_back(RunBenchmark(std::string(linear ? "linear/" : "gamma/") + SimdLevelName(level),
+                iterations, pixels, [&] { upscaler.Upscale(src.View(), dst.MutableView()); }));
+        }
+    }
+
+    for (bool linear : { false, true }) {
+        CpuUpscaler::Options options{ 1.5f, false, UpscalePath::Fused, SimdLevel::Auto, 1 };
+        options.linearLight = linear;
+        CpuUpscaler fused(options);
+        results.push_back(RunBenchmark(linear ? "linear/fused" : "gamma/fused", iterations, pixels,
+            [&] { fused.Upscale(src.View(), dst.MutableView()); }));
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkSharpening(uint32_t srcW, uint32_t srcH,
+    uint32_t dstW, uint32_t dstH, int iterations)
+{
+    Image src(srcW, srcH);
+    Image dst(dstW, dstH);
+    FillTestPattern(src);
+
+    const uint64_t pixels = uint64_t(dstW) * dstH;
+    std::vector<BenchmarkResult> results;
+
+    CpuUpscaler::Options options{ 1.5f, false, UpscalePath::Separable, SimdLevel::Auto, 1 };
+    CpuUpscaler unsharp(options);
+    results.push_back(RunBenchmark("separable+unsharp", iterations, pixels,
+        [&] { unsharp.Upscale(src.View(), dst.MutableView()); }));
+
+    options.rcasSharpness = 0.8f;
+    CpuUpscaler rcas(options);
+    results.push_back(RunBenchmark("separable+rcas", iterations, pixels,
+        [&] { rcas.Upscale(src.View(), dst.MutableView()); }));
+
+    // The pass on its own, on an upscaled frame
+    Image upscaled(dstW, dstH);
+    CpuUpscaler({ 0.0f, false, UpscalePath::Separable, SimdLevel::Auto, 1 }).Upscale(src.View(), upscaled.MutableView());
+    std::vector<const RcasKernelTable*> kernels;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::NEON }) {
+        const RcasKernelTable* table = GetRcasKernels(level);
+        if (table->level == level)
+            kernels.push_back(table);
+    }
+    for (const RcasKernelTable* table : kernels) {
+        results.push_back(RunBenchmark(std::string("rcas/") + SimdLevelName(table->level), iterations, pixels,
+            [&] { SharpenRcas(upscaled.View(), dst.MutableView(), 0, dstH, 0.8f, *table); }));
+        results.back().fetchesPerPixel = 5;
+    }
+
+    options.path = UpscalePath::EdgeAdaptive;
+    CpuUpscaler easu(options);
+    results.push_back(RunBenchmark("easu+rcas", iterations, pixels,
+        [&] { easu.Upscale(src.View(), dst.MutableView()); }));
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkTemporal(uint32_t srcW, uint32_t srcH,
+    uint32_t dstW, uint32_t dstH, int iterations)
+{
+    SyntheticScene::Options sceneOptions;
+    sceneOptions.disc = true;
+    sceneOptions.velocityX = 0.003f;
+    const SyntheticScene scene(sceneOptions);
+
+    // Halton (2, 3) jitter, one motion-vector plane per frame
+    constexpr uint32_t kFrames = 16;
+    const JitterSequence jitter(srcW, srcH, dstW);
+    std::vector<Image> colors;
+    std::vector<std::vector<float>> motion(kFrames, std::vector<float>(size_t(srcW) * srcH * 2));
+    std::vector<TemporalFrame> frames(kFrames);
+    for (uint32_t i = 0; i < kFrames; i++) {
+        const JitterSample sample = jitter.Get(i);
+        frames[i].jitterX = sample.x;
+        frames[i].jitterY = sample.y;
+        colors.emplace_back(srcW, srcH);
+        scene.Render(i, sample.x, sample.y, colors.back().MutableView(), motion[i].data());
+    }
+    for (uint32_t i = 0; i < kFrames; i++) {
+        frames[i].color = colors[i].View();
+        frames[i].motion = motion[i].data();
+    }
+
+    Image dst(dstW, dstH);
+    const uint64_t pixels = uint64_t(dstW) * dstH;
+    std::vector<BenchmarkResult> results;
+
+    CpuUpscaler spatial({ 1.5f, false, UpscalePath::Separable, SimdLevel::Auto, 1 });
+    results.push_back(RunBenchmark("separable", iterations, pixels,
+        [&] { spatial.Upscale(colors[0].View(), dst.MutableView()); }));
+
+    for (uint32_t threads : { 1u, 0u }) {
+        TemporalUpscaler temporal({ 16.0f, threads });
+        uint32_t next = 0;
+        results.push_back(RunBenchmark(threads == 1 ? "temporal/1 thread" : "temporal/all cores", iterations, pixels,
+            [&] { temporal.Accumulate(frames[next++ % kFrames], dst.MutableView()); }));
+        results.back().fetchesPerPixel = 9 + 4;
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkImageDecoders(const std::vector<std::string>& files, int iterations)
+{
+    std::vector<const ImageDecoder*> decoders = GetImageDecoders();
+#if defined(_WIN32)
+    const std::unique_ptr<ImageDecoder> wic = CreateWicDecoder();
+    decoders.push_back(wic.get());
+#endif
+
+    std::vector<BenchmarkResult> results;
+    for (const std::string& file : files) {
+        std::vector<uint8_t> bytes;
+        if (!ReadFileBytes(file, bytes))
+            continue;
+        const std::string name = file.substr(file.find_last_of("/\\") + 1);
+
+        for (const ImageDecoder* decoder : decoders) {
+            ImageInfo info;
+            if (!decoder->CanDecode(bytes.data(), bytes.size())
+                || !decoder->ReadInfo(bytes.data(), bytes.size(), info, nullptr))
+                continue;
+            Image image(info.width, info.height);
+            results.push_back(RunBenchmark(std::string(decoder->Name()) + " " + name, iterations,
+                uint64_t(info.width) * info.height,
+                [&] { decoder->Decode(bytes.data(), bytes.size(), image.MutableView(), nullptr); }));
+        }
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkPixelConversions(uint32_t width, uint32_t height, int iterations)
+{
+    struct Conversion {
+        PixelFormat src;
+        PixelFormat dst;
+    };
+    const Conversion conversions[] = {
+        { PixelFormat::BGRA8, PixelFormat::RGBA8 },
+        { PixelFormat::BGR8, PixelFormat::RGBA8 },
+        { PixelFormat::Gray8, PixelFormat::RGBA8 },
+        { PixelFormat::PBGRA8, PixelFormat::RGBA8 },
+        { PixelFormat::RGB16, PixelFormat::RGBA16 },
+        { PixelFormat::CMYK8, PixelFormat::RGBA8 },
+        { PixelFormat::RGBAHalf, PixelFormat::RGBA8 },
+    };
+
+    // Worst case source: 8 bytes per pixel; the pattern is random bytes
+    std::vector<uint8_t> src(size_t(width) * height * 8);
+    uint32_t state = 0x12345678u;
+    for (uint8_t& b : src) {
+        state = state * 1664525u + 1013904223u;
+        b = uint8_t(state >> 24);
+    }
+    std::vector<uint8_t> dst(size_t(width) * height * 8);
+    ThreadPool pool;
+    const uint64_t pixels = uint64_t(width) * height;
+
+    std::vector<BenchmarkResult> results;
+    for (const Conversion& c : conversions) {
+        const size_t srcPitch = size_t(width) * PixelFormatBitsPerPixel(c.src) / 8;
+        const size_t dstPitch = size_t(width) * PixelFormatBitsPerPixel(c.dst) / 8;
+        const std::string name = std::string(PixelFormatName(c.src)) + "->" + PixelFormatName(c.dst);
+
+        results.push_back(RunBenchmark(name + " scalar", iterations, pixels, [&] {
+            ConvertPixels(src.data(), srcPitch, c.src, dst.data(), dstPitch, c.dst, width, height, nullptr, SimdLevel::Scalar);
+        }));
+        results.push_back(RunBenchmark(name, iterations, pixels, [&] {
+            ConvertPixels(src.data(), srcPitch, c.src, dst.data(), dstPitch, c.dst, width, height);
+        }));
+        if (pool.GetThreadCount() > 1) {
+            results.push_back(RunBenchmark(name + " threaded", iterations, pixels, [&] {
+                ConvertPixels(src.data(), srcPitch, c.src, dst.data(), dstPitch, c.dst, width, height, &pool);
+            }));
+        }
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult> BenchmarkResize(uint32_t srcW, uint32_t srcH,
+    uint32_t dstW, uint32_t dstH, int iterations)
+{
+    Image src(srcW, srcH);
+    Image dst(dstW, dstH);
+    FillTestPattern(src);
+
+    std::vector<BenchmarkResult> results;
+    for (ResampleFilter filter : { ResampleFilter::Box, ResampleFilter::Lanczos3 }) {
+        for (bool srgb : { false, true }) {
+            for (SimdLevel simd : { SimdLevel::Scalar, SimdLevel::Auto }) {
+                Resampler::Options options;
+                options.filter = filter;
+                options.srgb = srgb;
+                options.simd = simd;
+                options.threadCount = 1;
+                Resampler resampler(options);
+                const std::string name = std::string(filter == ResampleFilter::Box ? "box" : "lanczos3")
+                    + (srgb ? " srgb" : "") + (simd == SimdLevel::Scalar ? " scalar" : "");
+                results.push_back(RunBenchmark(name, iterations, uint64_t(srcW) * srcH,
+                    [&] { resampler.Resample(src.View(), dst.MutableView()); }));
+            }
+        }
+    }
+
+    Resampler threaded;
+    if (threaded.Resample(src.View(), dst.MutableView()) && threaded.GetThreadCount() > 1) {
+        results.push_back(RunBenchmark("box threaded", iterations, uint64_t(srcW) * srcH,
+            [&] { threaded.Resample(src.View(), dst.MutableView()); }));
+    }
+    return results;
+}
+
+std::vector<PacingResult> BenchmarkFramePacing(const std::vector<double>& targetsHz,
+    double secondsPerTarget, double workMs)
+{
+    FrameClock& clock = DefaultFrameClock();
+    const int64_t workNs = int64_t(workMs * 1e6);
+    auto work = [&] {
+        const int64_t end = clock.Now() + workNs;
+        while (clock.Now() < end) {
+        }
+    };
+
+    std::vector<PacingResult> results;
+    for (double hz : targetsHz) {
+        const int64_t periodNs = int64_t(1e9 / hz);
+        const uint32_t frames = std::max(2u, uint32_t(secondsPerTarget * hz));
+
+        for (int strategy = 0; strategy < 2; strategy++) {
+            FramePacer pacer(&clock);
+            std::vector<double> intervals;
+            intervals.reserve(frames);
+
+            const double cpuStart = ThreadCpuSeconds();
+            const int64_t wallStart = clock.Now();
+            int64_t frameStart = wallStart;
+            double previousDelta = 1.0 / hz;
+            for (uint32_t i = 0; i < frames; i++) {
+                work();
+                if (strategy == 0) {
+                    // The former FrameSync::EndFrame
+                    const double remaining = 1.0 / hz - previousDelta;
+                    if (remaining > 0.001) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(int64_t(remaining * 800.0)));
+                        const int64_t spinStart = clock.Now();
+                        while ((clock.Now() - spinStart) * 1e-9 < remaining) {
+                        }
+                    }
+                }
+                else {
+                    pacer.WaitForNextFrame(periodNs);
+                }
+                const int64_t now = clock.Now();
+                previousDelta = double(now - frameStart) * 1e-9;
+                if (i > 0)
+                    intervals.push_back(previousDelta * 1e3);
+                frameStart = now;
+            }
+            const double wall = double(clock.Now() - wallStart) * 1e-9;
+            const double cpu = ThreadCpuSeconds() - cpuStart;
+
+            PacingResult result;
+            result.name = std::string(strategy == 0 ? "sleep+spin/" : "pacer/") + std::to_string(int(hz + 0.5)) + "Hz";
+            result.targetHz = hz;
+            result.frames = uint32_t(intervals.size());
+            double sum = 0.0;
+            for (double ms : intervals)
+                sum += ms;
+            result.meanIntervalMs = sum / intervals.size();
+            double variance = 0.0;
+            std::vector<double> errors;
+            for (double ms : intervals) {
+                variance += (ms - result.meanIntervalMs) * (ms - result.meanIntervalMs);
+                errors.push_back(std::abs(ms - 1e3 / hz));
+            }
+            result.jitterMs = std::sqrt(variance / intervals.size());
+            std::sort(errors.begin(), errors.end());
+            result.p99ErrorMs = errors[std::min(errors.size() - 1, size_t(errors.size() * 0.99))];
+            result.cpuPercent = wall > 0.0 ? 100.0 * cpu / wall : 0.0;
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+std::string FormatPacingTable(const std::vector<PacingResult>& results)
+{
+    std::string table;
+    char line[160];
+    snprintf(line, sizeof(line), "%-20s %8s %12s %10s %12s %8s\n", "pacing", "frames", "interval ms", "jitter ms", "p99 err ms", "cpu %");
+    table += line;
+    for (const PacingResult& r : results) {
+        snprintf(line, sizeof(line), "%-20s %8u %12.3f %10.3f %12.3f %8.1f\n",
+            r.name.c_str(), r.frames, r.meanIntervalMs, r.jitterMs, r.p99ErrorMs, r.cpuPercent);
+        table += line;
+    }
+    return table;
+}
+
+std::string FormatTileTimings(const std::vector<CpuUpscaler::TileTiming>& timings)
+{
+    if (timings.empty())
+        return "no tiles\n";
+
+    double total = 0.0;
+    double slowest = 0.0;
+    double fastest = 1e30;
+    unsigned maxSlot = 0;
+    for (const CpuUpscaler::TileTiming& t : timings) {
+        total += t.microseconds;
+        slowest = std::max(slowest, t.microseconds);
+        fastest = std::min(fastest, t.microseconds);
+        maxSlot = std::max(maxSlot, t.slot);
+    }
+
+    std::vector<uint32_t> tilesPerSlot(maxSlot + 1, 0);
+    for (const CpuUpscaler::TileTiming& t : timings)
+        tilesPerSlot[t.slot]++;
+
+    char line[160];
+    snprintf(line, sizeof(line), "%zu tiles: min %.1f us, mean %.1f us, max %.1f us\n",
+        timings.size(), fastest, total / timings.size(), slowest);
+    std::string report = line;
+    for (size_t slot = 0; slot < tilesPerSlot.size(); slot++) {
+        snprintf(line, sizeof(line), "  slot %zu: %u tiles\n", slot, tilesPerSlot[slot]);
+        report += line;
+    }
+    return report;
+}
+
+std::string FormatBenchmarkTable(const std::vector<BenchmarkResult>& results)
+{
+    std::string table;
+    char line[160];
+    snprintf(line, sizeof(line), "%-24s %10s %10s %12s %9s %12s\n", "path", "best ms", "mean ms", "MPix/s", "speedup", "fetches/px");
+    table += line;
+
+    const double baseline = results.empty() ? 0.0 : results.front().bestMs;
+    for (const BenchmarkResult& r : results) {
+        const double speedup = r.bestMs > 0.0 ? baseline / r.bestMs : 0.0;
+        char fetches[32] = "-";
+        if (r.fetchesPerPixel > 0.0)
+            snprintf(fetches, sizeof(fetches), "%.2f", r.fetchesPerPixel);
+        snprintf(line, sizeof(line), "%-24s %10.3f %10.3f %12.1f %8.2fx %12s\n",
+            r.name.c_str(), r.bestMs, r.meanMs, r.megapixelsPerSec, speedup, fetches);
+        table += line;
+    }
+    return table;
+}
+
+}
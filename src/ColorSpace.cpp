@@ -0,0 +1,37 @@
+#include "ColorSpace.h"
+
+namespace qisx {
+
+namespace {
+
+    SrgbTables BuildSrgbTables()
+    {
+        SrgbTables tables;
+        for (int i = 0; i < 256; i++)
+            tables.toLinear[i] = SrgbToLinear(i / 255.0f);
+        for (int i = 0; i <= kSrgbEncodeTableSize; i++) {
+            const double s = double(i) / kSrgbEncodeTableSize;
+            tables.fromSqrtLinear[i] = uint8_t(LinearToSrgb(float(s * s)) * 255.0f + 0.5f);
+        }
+        return tables;
+    }
+
+}
+
+float SrgbToLinear(float encoded)
+{
+    return encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float linear)
+{
+    return linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+}
+
+const SrgbTables& GetSrgbTables()
+{
+    static const SrgbTables tables = BuildSrgbTables();
+    return tables;
+}
+
+}
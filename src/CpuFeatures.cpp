@@ -0,0 +1,103 @@
+#include "CpuFeatures.h"
+
+#if defined(QISX_ARCH_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+#if defined(QISX_ARCH_X86)
+    struct X86Features {
+        bool sse41 = false;
+        bool avx2 = false;
+    };
+
+    X86Features QueryX86Features()
+    {
+        X86Features features;
+#if defined(_MSC_VER)
+        int regs[4] = {};
+        __cpuid(regs, 0);
+        const int maxLeaf = regs[0];
+
+        __cpuid(regs, 1);
+        features.sse41 = (regs[2] & (1 << 19)) != 0;
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool avx = (regs[2] & (1 << 28)) != 0;
+
+        // AVX registers are only usable if the OS saves YMM state on context switch
+        bool ymmEnabled = false;
+        if (osxsave && avx)
+            ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+
+        if (maxLeaf >= 7 && ymmEnabled) {
+            __cpuidex(regs, 7, 0);
+            features.avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+#else
+        // libgcc's probe already accounts for OS-enabled AVX state
+        __builtin_cpu_init();
+        features.sse41 = __builtin_cpu_supports("sse4.1");
+        features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return features;
+    }
+#endif
+
+}
+
+SimdLevel DetectSimdLevel()
+{
+    static const SimdLevel level = [] {
+#if defined(QISX_ARCH_X86)
+        const X86Features features = QueryX86Features();
+        if (features.avx2)
+            return SimdLevel::AVX2;
+        if (features.sse41)
+            return SimdLevel::SSE41;
+        return SimdLevel::Scalar;
+#elif defined(QISX_ARCH_ARM64)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }();
+    return level;
+}
+
+bool IsSimdLevelSupported(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Auto:
+    case SimdLevel::Scalar:
+        return true;
+#if defined(QISX_ARCH_X86)
+    case SimdLevel::SSE41:
+        return DetectSimdLevel() == SimdLevel::SSE41 || DetectSimdLevel() == SimdLevel::AVX2;
+    case SimdLevel::AVX2:
+        return DetectSimdLevel() == SimdLevel::AVX2;
+#elif defined(QISX_ARCH_ARM64)
+    case SimdLevel::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Auto:   return "auto";
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE41:  return "sse4.1";
+    case SimdLevel::AVX2:   return "avx2";
+    case SimdLevel::NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+}
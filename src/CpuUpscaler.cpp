@@ -0,0 +1,435 @@
+#include "CpuUpscaler.h"
+#include "ColorSpace.h"
+#include "UpscalePolyphase.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace qisx {
+
+namespace {
+
+    struct Float4 {
+        float r, g, b, a;
+    };
+
+    // With linear set, colour is decoded from sRGB (alpha stays unorm).
+    inline Float4 FetchTexel(const ImageView& src, int x, int y, const SrgbTables* linear)
+    {
+        const uint8_t* p = src.Row(uint32_t(y)) + size_t(x) * 4;
+        const float scale = 1.0f / 255.0f;
+        if (linear)
+            return { linear->toLinear[p[0]], linear->toLinear[p[1]], linear->toLinear[p[2]], p[3] * scale };
+        return { p[0] * scale, p[1] * scale, p[2] * scale, p[3] * scale };
+    }
+
+    // SampleLevel() with D3D11_FILTER_MIN_MAG_MIP_LINEAR and clamp addressing.
+    Float4 SampleBilinear(const ImageView& src, float u, float v, const SrgbTables* linear)
+    {
+        const float px = u * src.width - 0.5f;
+        const float py = v * src.height - 0.5f;
+        const float fx0 = std::floor(px);
+        const float fy0 = std::floor(py);
+        const float fx = px - fx0;
+        const float fy = py - fy0;
+
+        const int maxX = int(src.width) - 1;
+        const int maxY = int(src.height) - 1;
+        const int x0 = std::clamp(int(fx0), 0, maxX);
+        const int x1 = std::clamp(int(fx0) + 1, 0, maxX);
+        const int y0 = std::clamp(int(fy0), 0, maxY);
+        const int y1 = std::clamp(int(fy0) + 1, 0, maxY);
+
+        const Float4 t00 = FetchTexel(src, x0, y0, linear);
+        const Float4 t10 = FetchTexel(src, x1, y0, linear);
+        const Float4 t01 = FetchTexel(src, x0, y1, linear);
+        const Float4 t11 = FetchTexel(src, x1, y1, linear);
+
+        auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+        return {
+            lerp(lerp(t00.r, t10.r, fx), lerp(t01.r, t11.r, fx), fy),
+            lerp(lerp(t00.g, t10.g, fx), lerp(t01.g, t11.g, fx), fy),
+            lerp(lerp(t00.b, t10.b, fx), lerp(t01.b, t11.b, fx), fy),
+            lerp(lerp(t00.a, t10.a, fx), lerp(t01.a, t11.a, fx), fy),
+        };
+    }
+
+    // BicubicSample() from shaders.hlsl. Taps that fall outside the texture are
+    // dropped and the remaining weights renormalised via totalWeight.
+    Float4 BicubicSample(const ImageView& src, float u, float v, const SrgbTables* linear)
+    {
+        const float px = u * src.width - 0.5f;
+        const float py = v * src.height - 0.5f;
+        const float ix = std::floor(px);
+        const float iy = std::floor(py);
+        const float fx = px - ix;
+        const float fy = py - iy;
+
+        Float4 sampled = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float totalWeight = 0.0f;
+
+        for (int y = -1; y <= 2; y++) {
+            const int sy = int(iy) + y;
+            if (sy < 0 || sy >= int(src.height))
+                continue;
+            const float wy = BicubicWeight(y - fy);
+
+            for (int x = -1; x <= 2; x++) {
+                const int sx = int(ix) + x;
+                if (sx < 0 || sx >= int(src.width))
+                    continue;
+
+                const float weight = BicubicWeight(x - fx) * wy;
+                const Float4 t = FetchTexel(src, sx, sy, linear);
+                sampled.r += t.r * weight;
+                sampled.g += t.g * weight;
+                sampled.b += t.b * weight;
+                sampled.a += t.a * weight;
+                totalWeight += weight;
+            }
+        }
+
+        const float inv = 1.0f / std::max(totalWeight, 1e-5f);
+        return { sampled.r * inv, sampled.g * inv, sampled.b * inv, sampled.a * inv };
+    }
+
+    inline uint8_t ToUnorm8(float v)
+    {
+        v = std::clamp(v, 0.0f, 1.0f);
+        return static_cast<uint8_t>(v * 255.0f + 0.5f);
+    }
+
+    inline uint8_t ToColor8(float v, const SrgbTables* linear)
+    {
+        return linear ? LinearToSrgb8(*linear, v) : ToUnorm8(v);
+    }
+
+}
+
+void CpuUpscaler::UpscaleReference(const ImageView& src, const MutableImageView& dst, const Rect& rect) const
+{
+    const float texelU = 1.0f / src.width;
+    const float texelV = 1.0f / src.height;
+    const float strength = m_strength;
+    const SrgbTables* linear = m_options.linearLight ? &GetSrgbTables() : nullptr;
+
+    for (uint32_t oy = rect.y0; oy < rect.y1; oy++) {
+        const float v = (oy + 0.5f) / dst.height;
+        uint8_t* out = dst.Row(oy) + size_t(rect.x0) * 4;
+
+        for (uint32_t ox = rect.x0; ox < rect.x1; ox++, out += 4) {
+            const float u = (ox + 0.5f) / dst.width;
+
+            if (m_options.debugBorder && (u < 0.01f || u > 0.99f || v < 0.01f || v > 0.99f)) {
+                out[0] = 255; out[1] = 0; out[2] = 0; out[3] = 255;
+                continue;
+            }
+
+            const Float4 color = BicubicSample(src, u, v, linear);
+
+            // 3x3 box of bilinear taps around the output position (unsharp mask source)
+            Float4 blurred = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    const Float4 t = SampleBilinear(src, u + dx * texelU, v + dy * texelV, linear);
+                    blurred.r += t.r;
+                    blurred.g += t.g;
+                    blurred.b += t.b;
+                    blurred.a += t.a;
+                }
+            }
+
+            const float invNine = 1.0f / 9.0f;
+            out[0] = ToColor8(color.r + strength * (color.r - blurred.r * invNine), linear);
+            out[1] = ToColor8(color.g + strength * (color.g - blurred.g * invNine), linear);
+            out[2] = ToColor8(color.b + strength * (color.b - blurred.b * invNine), linear);
+            out[3] = ToUnorm8(color.a + strength * (color.a - blurred.a * invNine));
+        }
+    }
+}
+
+void CpuUpscaler::UpscaleFused(const ImageView& src, const MutableImageView& dst, const Rect& rect) const
+{
+    const float keep = 1.0f + m_strength;
+    const float strength = m_strength;
+    const SrgbTables* linear = m_options.linearLight ? &GetSrgbTables() : nullptr;
+
+    for (uint32_t oy = rect.y0; oy < rect.y1; oy++) {
+        const int32_t* rows = m_filterY.Index(oy);
+        const float* wby = m_filterY.Bicubic(oy);
+        const float* wly = m_filterY.Blur(oy);
+        uint8_t* out = dst.Row(oy) + size_t(rect.x0) * 4;
+
+        for (uint32_t ox = rect.x0; ox < rect.x1; ox++, out += 4) {
+            const int32_t* cols = m_filterX.Index(ox);
+            const float* wbx = m_filterX.Bicubic(ox);
+            const float* wlx = m_filterX.Blur(ox);
+
+            // One read per texel of the 4x4 footprint feeds both filters
+            float bicubic[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float blur[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int ty = 0; ty < kFilterTaps; ty++) {
+                const uint8_t* row = src.Row(uint32_t(rows[ty]));
+                for (int tx = 0; tx < kFilterTaps; tx++) {
+                    const uint8_t* p = row + size_t(cols[tx]) * 4;
+                    const float wb = wbx[tx] * wby[ty];
+                    const float wl = wlx[tx] * wly[ty];
+                    float texel[4] = { float(p[0]), float(p[1]), float(p[2]), float(p[3]) };
+                    if (linear) {
+                        for (int c = 0; c < 3; c++)
+                            texel[c] = linear->toLinear[p[c]] * 255.0f;
+                    }
+                    for (int c = 0; c < 4; c++) {
+                        bicubic[c] += texel[c] * wb;
+                        blur[c] += texel[c] * wl;
+                    }
+                }
+            }
+
+            for (int c = 0; c < 4; c++) {
+                const float v = std::clamp(keep * bicubic[c] - strength * blur[c], 0.0f, 255.0f);
+                out[c] = (linear && c < 3) ? LinearToSrgb8(*linear, v * (1.0f / 255.0f)) : static_cast<uint8_t>(v + 0.5f);
+            }
+        }
+    }
+}
+
+void CpuUpscaler::UpscaleSeparable(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+    const UpscaleKernelTable& kernels, std::vector<float>& scratch) const
+{
+    // Ring of horizontally filtered source rows. An output row needs four
+    // consecutive (clamped) source rows, so row r always lives in slot r % 4.
+    const uint32_t width = rect.x1 - rect.x0;
+    const size_t rowFloats = size_t(width) * 4;
+    scratch.resize(rowFloats * kFilterTaps * 2);
+    int32_t cachedRow[kFilterTaps] = { -1, -1, -1, -1 };
+
+    for (uint32_t oy = rect.y0; oy < rect.y1; oy++) {
+        const int32_t* index = m_filterY.Index(oy);
+        const float* bicubicRows[kFilterTaps];
+        const float* blurRows[kFilterTaps];
+
+        for (int t = 0; t < kFilterTaps; t++) {
+            const int32_t row = index[t];
+            const int slot = row % kFilterTaps;
+            float* bicubic = &scratch[rowFloats * (slot * 2)];
+            float* blur = bicubic + rowFloats;
+
+            if (cachedRow[slot] != row) {
+                kernels.horizontal(src.Row(uint32_t(row)), m_filterX, rect.x0, rect.x1, bicubic, blur);
+                cachedRow[slot] = row;
+            }
+            bicubicRows[t] = bicubic;
+            blurRows[t] = blur;
+        }
+
+        kernels.vertical(bicubicRows, blurRows, m_filterY.Bicubic(oy), m_filterY.Blur(oy),
+            m_strength, width, dst.Row(oy) + size_t(rect.x0) * 4);
+    }
+}
+
+void CpuUpscaler::UpscaleFixed(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+    const FixedKernelTable& kernels, std::vector<int16_t>& scratch) const
+{
+    // Same row ring as UpscaleSeparable, in Q6 int16
+    const uint32_t width = rect.x1 - rect.x0;
+    const size_t rowValues = size_t(width) * 4;
+    scratch.resize(rowValues * kFilterTaps * 2);
+    int32_t cachedRow[kFilterTaps] = { -1, -1, -1, -1 };
+
+    for (uint32_t oy = rect.y0; oy < rect.y1; oy++) {
+        const int32_t* index = m_fixedY.Index(oy);
+        const int16_t* bicubicRows[kFilterTaps];
+        const int16_t* blurRows[kFilterTaps];
+
+        for (int t = 0; t < kFilterTaps; t++) {
+            const int32_t row = index[t];
+            const int slot = row % kFilterTaps;
+            int16_t* bicubic = &scratch[rowValues * (slot * 2)];
+            int16_t* blur = bicubic + rowValues;
+
+            if (cachedRow[slot] != row) {
+                kernels.horizontal(src.Row(uint32_t(row)), m_fixedX, rect.x0, rect.x1, bicubic, blur);
+                cachedRow[slot] = row;
+            }
+            bicubicRows[t] = bicubic;
+            blurRows[t] = blur;
+        }
+
+        FixedVerticalWeights weights;
+        QuantiseVerticalWeights(m_filterY.Bicubic(oy), m_filterY.Blur(oy), m_strength, weights);
+        kernels.vertical(bicubicRows, blurRows, weights, width, dst.Row(oy) + size_t(rect.x0) * 4);
+    }
+}
+
+void CpuUpscaler::UpscaleEdgeAdaptive(const ImageView& src, const MutableImageView& dst, const Rect& rect,
+    const EasuKernelTable& kernels) const
+{
+    for (uint32_t oy = rect.y0; oy < rect.y1; oy++) {
+        const int32_t* index = m_easuY.Index(oy);
+        EasuRows rows;
+        for (int t = 0; t < 4; t++) {
+            rows.color[t] = src.Row(uint32_t(index[t]));
+            rows.luma[t] = &m_luma[size_t(index[t]) * src.width];
+        }
+        rows.fracY = m_easuY.frac[oy];
+        kernels.row(rows, m_easuX, rect.x0, rect.x1, dst.Row(oy) + size_t(rect.x0) * 4);
+    }
+}
+
+bool CpuUpscaler::Upscale(const ImageView& src, const MutableImageView& dst)
+{
+    if (src.Empty() || dst.Empty() || src.data == dst.data)
+        return false;
+
+    const UpscaleKernelTable* kernels = GetUpscaleKernels(m_options.simd);
+    if (!kernels)
+        kernels = GetUpscaleKernels(SimdLevel::Scalar);
+
+    // Linear light swaps in the LUT-fused row kernels. The polyphase and
+    // fixed-point kernels read raw bytes, so they only run in gamma space.
+    const bool linear = m_options.linearLight;
+    const UpscalePath path = (linear && m_options.path == UpscalePath::FixedPoint) ? UpscalePath::Separable : m_options.path;
+
+    UpscaleKernelTable rowKernels = *kernels;
+    if (linear) {
+        rowKernels.horizontal = kernels->horizontalLinear;
+        rowKernels.vertical = kernels->verticalLinear;
+    }
+    else if (m_options.polyphase) {
+        if (HorizontalPassFn polyphase = SelectPolyphaseHorizontal(src.width, dst.width, kernels->level))
+            rowKernels.horizontal = polyphase;
+    }
+
+    if (path != UpscalePath::Reference) {
+        BuildAxisFilter(src.width, dst.width, m_filterX);
+        BuildAxisFilter(src.height, dst.height, m_filterY);
+    }
+    const FixedKernelTable* fixedKernels = GetFixedKernels(kernels->level);
+    if (path == UpscalePath::FixedPoint) {
+        BuildFixedAxisFilter(m_filterX, m_fixedX);
+        BuildFixedAxisFilter(m_filterY, m_fixedY);
+    }
+
+    const unsigned threads = m_options.threadCount ? m_options.threadCount : PhysicalCoreCount();
+    if (threads > 1 && (!m_pool || m_pool->GetThreadCount() != threads))
+        m_pool = std::make_unique<ThreadPool>(threads);
+    else if (threads <= 1)
+        m_pool.reset();
+    m_scratch.resize(GetThreadCount());
+    m_fixedScratch.resize(GetThreadCount());
+
+    const EasuKernelTable* easuKernels = GetEasuKernels(kernels->level);
+    if (path == UpscalePath::EdgeAdaptive) {
+        BuildEasuAxis(src.width, dst.width, m_easuX);
+        BuildEasuAxis(src.height, dst.height, m_easuY);
+        m_luma.resize(size_t(src.width) * src.height);
+        auto lumaRow = [&](uint32_t y, unsigned) { EasuLumaRow(src.Row(y), src.width, &m_luma[size_t(y) * src.width]); };
+        if (m_pool) {
+            m_pool->ParallelFor(src.height, lumaRow);
+        }
+        else {
+            for (uint32_t y = 0; y < src.height; y++)
+                lumaRow(y, 0);
+        }
+    }
+
+    // RCAS replaces the unsharp mask and needs finished neighbours across tile
+    // edges, so the tiles write an unsharpened frame first
+    const bool rcas = m_options.rcasSharpness > 0.0f;
+    m_strength = rcas ? 0.0f : m_options.sharpenStrength;
+    MutableImageView target = dst;
+    if (rcas) {
+        if (m_unsharpened.Width() != dst.width || m_unsharpened.Height() != dst.height)
+            m_unsharpened = Image(dst.width, dst.height);
+        target = m_unsharpened.MutableView();
+    }
+
+    const uint32_t tileW = std::max(1u, m_options.tileWidth);
+    const uint32_t tileH = std::max(1u, m_options.tileHeight);
+    const uint32_t tilesX = (dst.width + tileW - 1) / tileW;
+    const uint32_t tilesY = (dst.height + tileH - 1) / tileH;
+    m_tileTimings.resize(size_t(tilesX) * tilesY);
+
+    auto runTile = [&](uint32_t tile, unsigned slot) {
+        const auto start = std::chrono::steady_clock::now();
+
+        Rect rect;
+        rect.x0 = (tile % tilesX) * tileW;
+        rect.y0 = (tile / tilesX) * tileH;
+        rect.x1 = std::min(dst.width, rect.x0 + tileW);
+        rect.y1 = std::min(dst.height, rect.y0 + tileH);
+
+        switch (path) {
+        case UpscalePath::Reference:
+            UpscaleReference(src, target, rect);
+            break;
+        case UpscalePath::Fused:
+            UpscaleFused(src, target, rect);
+            break;
+        case UpscalePath::FixedPoint:
+            UpscaleFixed(src, target, rect, *fixedKernels, m_fixedScratch[slot]);
+            break;
+        case UpscalePath::EdgeAdaptive:
+            UpscaleEdgeAdaptive(src, target, rect, *easuKernels);
+            break;
+        case UpscalePath::Separable:
+        default:
+            UpscaleSeparable(src, target, rect, rowKernels, m_scratch[slot]);
+            break;
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        m_tileTimings[tile] = { rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0, slot,
+            std::chrono::duration<double, std::micro>(elapsed).count() };
+    };
+
+    if (m_pool) {
+        m_pool->ParallelFor(tilesX * tilesY, runTile);
+    }
+    else {
+        for (uint32_t tile = 0; tile < tilesX * tilesY; tile++)
+            runTile(tile, 0);
+    }
+
+    if (rcas) {
+        const RcasKernelTable* rcasKernels = GetRcasKernels(kernels->level);
+        const float sharpness = std::min(m_options.rcasSharpness, 1.0f);
+        const uint32_t bands = (dst.height + tileH - 1) / tileH;
+        auto runBand = [&](uint32_t band, unsigned) {
+            const uint32_t y0 = band * tileH;
+            SharpenRcas(target, dst, y0, std::min(dst.height, y0 + tileH), sharpness, *rcasKernels);
+        };
+        if (m_pool) {
+            m_pool->ParallelFor(bands, runBand);
+        }
+        else {
+            for (uint32_t band = 0; band < bands; band++)
+                runBand(band, 0);
+        }
+    }
+
+    // The reference path draws the border per pixel, like the shader, but
+    // RCAS would alter its inner edge
+    if (m_options.debugBorder && (path != UpscalePath::Reference || rcas))
+        DrawDebugBorder(dst);
+    return true;
+}
+
+void DrawDebugBorder(const MutableImageView& dst)
+{
+    for (uint32_t oy = 0; oy < dst.height; oy++) {
+        const float v = (oy + 0.5f) / dst.height;
+        const bool rowInBorder = v < 0.01f || v > 0.99f;
+        uint8_t* out = dst.Row(oy);
+
+        for (uint32_t ox = 0; ox < dst.width; ox++, out += 4) {
+            const float u = (ox + 0.5f) / dst.width;
+            if (rowInBorder || u < 0.01f || u > 0.99f) {
+                out[0] = 255; out[1] = 0; out[2] = 0; out[3] = 255;
+            }
+        }
+    }
+}
+
+}
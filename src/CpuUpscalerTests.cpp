@@ -0,0 +1,221 @@
+#include "gtest/gtest.h"
+#include "ColorSpace.h"
+#include "CpuUpscaler.h"
+#include <cmath>
+
+namespace {
+
+    qisx::Image MakeSolid(uint32_t w, uint32_t h, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+    {
+        qisx::Image image(w, h);
+        for (size_t i = 0; i < image.SizeInBytes(); i += 4) {
+            image.Data()[i + 0] = r;
+            image.Data()[i + 1] = g;
+            image.Data()[i + 2] = b;
+            image.Data()[i + 3] = a;
+        }
+        return image;
+    }
+
+}
+
+// A flat image must stay flat: bicubic weights renormalise to 1 and the
+// unsharp mask has nothing to sharpen, including at the edges.
+TEST(CpuUpscalerTests, FlatColourIsPreserved)
+{
+    qisx::Image src = MakeSolid(854, 480, 10, 128, 200, 255);
+    qisx::Image dst(1280, 720);
+
+    qisx::CpuUpscaler upscaler;
+    ASSERT_TRUE(upscaler.Upscale(src.View(), dst.MutableView()));
+
+    for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+        ASSERT_EQ(dst.Data()[i + 0], 10);
+        ASSERT_EQ(dst.Data()[i + 1], 128);
+        ASSERT_EQ(dst.Data()[i + 2], 200);
+        ASSERT_EQ(dst.Data()[i + 3], 255);
+    }
+}
+
+// Catmull-Rom interpolates: at 1:1 scale every output sample lands on a texel
+// centre, and with sharpening disabled the image must be reproduced exactly.
+TEST(CpuUpscalerTests, IdentityScaleWithoutSharpenIsExact)
+{
+    qisx::Image src(37, 23);
+    for (size_t i = 0; i < src.SizeInBytes(); i++)
+        src.Data()[i] = static_cast<uint8_t>((i * 97) & 0xFF);
+
+    qisx::Image dst(37, 23);
+    qisx::CpuUpscaler upscaler({ 0.0f, false });
+    ASSERT_TRUE(upscaler.Upscale(src.View(), dst.MutableView()));
+
+    for (size_t i = 0; i < dst.SizeInBytes(); i++)
+        ASSERT_EQ(dst.Data()[i], src.Data()[i]) << "byte " << i;
+}
+
+TEST(CpuUpscalerTests, DebugBorderMatchesShader)
+{
+    qisx::Image src = MakeSolid(854, 480, 0, 255, 0, 255);
+    qisx::Image dst(1280, 720);
+
+    qisx::CpuUpscaler upscaler({ 1.5f, true });
+    ASSERT_TRUE(upscaler.Upscale(src.View(), dst.MutableView()));
+
+    const uint8_t* corner = dst.Data();
+    EXPECT_EQ(corner[0], 255);
+    EXPECT_EQ(corner[1], 0);
+
+    const uint8_t* centre = dst.Data() + 360 * dst.RowPitch() + 640 * 4;
+    EXPECT_EQ(centre[0], 0);
+    EXPECT_EQ(centre[1], 255);
+}
+
+TEST(CpuUpscalerTests, RejectsEmptyViews)
+{
+    qisx::Image dst(16, 16);
+    qisx::CpuUpscaler upscaler;
+    EXPECT_FALSE(upscaler.Upscale(qisx::ImageView{}, dst.MutableView()));
+}
+
+// The table-driven paths must agree with the per-pixel transcription.
+TEST(CpuUpscalerTests, TableDrivenPathsMatchReference)
+{
+    const uint32_t sizes[][4] = {
+        { 854, 480, 1280, 720 },
+        { 64, 48, 173, 91 },
+        { 3, 2, 17, 9 },
+        { 100, 100, 100, 100 },
+    };
+
+    for (const auto& s : sizes) {
+        qisx::Image src(s[0], s[1]);
+        uint32_t state = 1;
+        for (size_t i = 0; i < src.SizeInBytes(); i++) {
+            state = state * 1664525u + 1013904223u;
+            src.Data()[i] = static_cast<uint8_t>(state >> 24);
+        }
+
+        qisx::Image expected(s[2], s[3]);
+        qisx::Image actual(s[2], s[3]);
+        qisx::CpuUpscaler reference({ 1.5f, false, qisx::UpscalePath::Reference });
+        ASSERT_TRUE(reference.Upscale(src.View(), expected.MutableView()));
+
+        for (qisx::UpscalePath path : { qisx::UpscalePath::Separable, qisx::UpscalePath::Fused }) {
+            qisx::CpuUpscaler upscaler({ 1.5f, false, path });
+            ASSERT_TRUE(upscaler.Upscale(src.View(), actual.MutableView()));
+
+            for (size_t i = 0; i < actual.SizeInBytes(); i++)
+                ASSERT_NEAR(actual.Data()[i], expected.Data()[i], 1) << s[0] << "x" << s[1] << " byte " << i;
+        }
+    }
+}
+
+// Tiles read their own apron, so any tiling and thread count must reproduce
+// the single-tile output exactly.
+TEST(CpuUpscalerTests, TiledOutputMatchesSingleTile)
+{
+    qisx::Image src(211, 97);
+    uint32_t state = 5;
+    for (size_t i = 0; i < src.SizeInBytes(); i++) {
+        state = state * 1664525u + 1013904223u;
+        src.Data()[i] = static_cast<uint8_t>(state >> 24);
+    }
+
+    qisx::CpuUpscaler::Options whole;
+    whole.threadCount = 1;
+    whole.tileWidth = 4096;
+    whole.tileHeight = 4096;
+
+    qisx::Image expected(317, 146);
+    qisx::CpuUpscaler single(whole);
+    ASSERT_TRUE(single.Upscale(src.View(), expected.MutableView()));
+    EXPECT_EQ(single.GetTileTimings().size(), 1u);
+
+    for (uint32_t threads : { 1u, 3u, 4u }) {
+        qisx::CpuUpscaler::Options tiled = whole;
+        tiled.threadCount = threads;
+        tiled.tileWidth = 37;
+        tiled.tileHeight = 19;
+
+        qisx::Image actual(317, 146);
+        qisx::CpuUpscaler upscaler(tiled);
+        ASSERT_TRUE(upscaler.Upscale(src.View(), actual.MutableView()));
+        EXPECT_EQ(upscaler.GetThreadCount(), threads);
+        EXPECT_EQ(upscaler.GetTileTimings().size(), size_t(9 * 8));
+
+        for (size_t i = 0; i < actual.SizeInBytes(); i++)
+            ASSERT_EQ(actual.Data()[i], expected.Data()[i]) << threads << " threads, byte " << i;
+    }
+}
+
+// Linear light changes where the filters run, not what they converge to: a flat
+// colour survives every path, and the paths still agree with the reference.
+TEST(CpuUpscalerTests, LinearLightPathsMatchReference)
+{
+    const qisx::Image flat = MakeSolid(61, 37, 10, 128, 200, 77);
+    qisx::Image src(64, 48);
+    uint32_t state = 3;
+    for (size_t i = 0; i < src.SizeInBytes(); i++) {
+        state = state * 1664525u + 1013904223u;
+        src.Data()[i] = static_cast<uint8_t>(state >> 24);
+    }
+
+    qisx::CpuUpscaler::Options options;
+    options.linearLight = true;
+    options.path = qisx::UpscalePath::Reference;
+    qisx::Image expected(173, 91);
+    ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), expected.MutableView()));
+
+    for (qisx::UpscalePath path : { qisx::UpscalePath::Reference, qisx::UpscalePath::Separable,
+        qisx::UpscalePath::Fused, qisx::UpscalePath::FixedPoint }) {
+        options.path = path;
+        qisx::Image flatOut(92, 80);
+        ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(flat.View(), flatOut.MutableView()));
+        for (size_t i = 0; i < flatOut.SizeInBytes(); i += 4) {
+            ASSERT_EQ(flatOut.Data()[i + 0], 10);
+            ASSERT_EQ(flatOut.Data()[i + 1], 128);
+            ASSERT_EQ(flatOut.Data()[i + 2], 200);
+            ASSERT_EQ(flatOut.Data()[i + 3], 77);
+        }
+
+        qisx::Image actual(173, 91);
+        ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), actual.MutableView()));
+        for (size_t i = 0; i < actual.SizeInBytes(); i++)
+            ASSERT_NEAR(actual.Data()[i], expected.Data()[i], 1) << int(path) << " byte " << i;
+    }
+}
+
+// The unsharp mask's undershoot and overshoot cancel in the space it runs in.
+// In gamma space that space is the wrong one, so an edge between two greys
+// changes brightness; in linear light the emitted light is conserved (the
+// levels keep the undershoot clear of black, where clamping would add light).
+TEST(CpuUpscalerTests, LinearLightConservesEdgeBrightness)
+{
+    qisx::Image src(32, 4);
+    for (uint32_t y = 0; y < src.Height(); y++) {
+        for (uint32_t x = 0; x < src.Width(); x++) {
+            uint8_t* p = src.Data() + y * src.RowPitch() + x * 4;
+            p[0] = p[1] = p[2] = x < 16 ? 110 : 190;
+            p[3] = 255;
+        }
+    }
+
+    const qisx::SrgbTables& tables = qisx::GetSrgbTables();
+    auto meanLight = [&](const qisx::Image& image) {
+        double sum = 0.0;
+        for (uint32_t x = 0; x < image.Width(); x++)
+            sum += tables.toLinear[image.Data()[image.RowPitch() + x * 4]];
+        return sum / image.Width();
+    };
+
+    qisx::CpuUpscaler::Options options;
+    qisx::Image gamma(80, 10);
+    ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), gamma.MutableView()));
+    options.linearLight = true;
+    qisx::Image linear(80, 10);
+    ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), linear.MutableView()));
+
+    const double expected = meanLight(src);
+    EXPECT_NEAR(meanLight(linear), expected, 0.002);
+    EXPECT_GT(std::abs(meanLight(gamma) - expected), 4 * std::abs(meanLight(linear) - expected));
+}
@@ -0,0 +1,50 @@
+#include "D3D11SwapChain.h"
+
+namespace qisx {
+
+D3D11SwapChain::D3D11SwapChain(ID3D11Device* device, IDXGISwapChain* swapChain)
+    : m_device(device),
+      m_swapChain(swapChain)
+{
+}
+
+D3D11SwapChain::~D3D11SwapChain() = default;
+
+bool D3D11SwapChain::CreateTargets()
+{
+    m_target.Reset();
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> backBuffer;
+    if (!m_swapChain || FAILED(m_swapChain->GetBuffer(0, IID_PPV_ARGS(&backBuffer))))
+        return false;
+    return SUCCEEDED(m_device->CreateRenderTargetView(backBuffer.Get(), nullptr, &m_target));
+}
+
+void D3D11SwapChain::ReleaseTargets()
+{
+    m_target.Reset();
+}
+
+bool D3D11SwapChain::ResizeBuffers(uint32_t width, uint32_t height)
+{
+    // The context may still reference the view as a bound render target;
+    // ResizeBuffers fails until it is unbound and released
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+    m_device->GetImmediateContext(&context);
+    context->OMSetRenderTargets(0, nullptr, nullptr);
+    context->Flush();
+
+    // Keep the buffer count, format and flags (the frame latency waitable
+    // object must be requested again on every resize)
+    DXGI_SWAP_CHAIN_DESC desc = {};
+    if (FAILED(m_swapChain->GetDesc(&desc)))
+        return false;
+    return SUCCEEDED(m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, desc.Flags));
+}
+
+bool D3D11SwapChain::Present(uint32_t syncInterval)
+{
+    // DXGI_STATUS_OCCLUDED (minimised window) is a success code
+    return SUCCEEDED(m_swapChain->Present(syncInterval, 0));
+}
+
+}
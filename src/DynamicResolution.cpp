@@ -0,0 +1,77 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+DynamicResolution::DynamicResolution(const Options& options)
+    : m_options(options)
+{
+    m_options.alignment = std::max(1u, m_options.alignment);
+    m_options.minScale = std::clamp(m_options.minScale, 0.01f, 1.0f);
+    m_options.maxScale = std::clamp(m_options.maxScale, m_options.minScale, 1.0f);
+    Reset();
+}
+
+void DynamicResolution::Reset()
+{
+    m_smoothedMs = -1.0f;
+    m_framesUnder = 0;
+    m_changes = 0;
+    SetScale(m_options.initialScale);
+}
+
+void DynamicResolution::SetScale(float scale)
+{
+    m_scale = std::clamp(scale, m_options.minScale, m_options.maxScale);
+    auto size = [&](uint32_t max) {
+        const uint32_t align = m_options.alignment;
+        const uint32_t aligned = uint32_t(std::lround(float(max) * m_scale / float(align))) * align;
+        return std::clamp(aligned, std::min(align, max), max);
+    };
+    m_width = size(m_options.maxWidth);
+    m_height = size(m_options.maxHeight);
+}
+
+bool DynamicResolution::Update(float cpuMs, float gpuMs)
+{
+    const float targetMs = m_options.budgetMs * m_options.headroom;
+    if (gpuMs >= 0.0f && cpuMs > targetMs && gpuMs <= targetMs) {
+        m_framesUnder = 0;
+        return false;
+    }
+
+    const float cost = gpuMs >= 0.0f ? gpuMs : cpuMs;
+    if (!(cost > 0.0f))
+        return false;
+    m_smoothedMs = m_smoothedMs < 0.0f ? cost : m_smoothedMs + (cost - m_smoothedMs) * m_options.smoothing;
+
+    const float ratio = targetMs / m_smoothedMs;
+    float scale = m_scale;
+    if (ratio < 1.0f - m_options.deadband) {
+        m_framesUnder = 0;
+        scale = std::max(m_scale * std::sqrt(ratio), m_scale - m_options.maxStepDown);
+    }
+    else if (ratio > 1.0f + m_options.deadband) {
+        if (++m_framesUnder >= m_options.upDelayFrames)
+            scale = std::min(m_scale * std::sqrt(ratio), m_scale + m_options.maxStepUp);
+    }
+    else {
+        m_framesUnder = 0;
+    }
+
+    const float previous = m_scale;
+    const uint32_t width = m_width, height = m_height;
+    SetScale(scale);
+    if (m_scale != previous) {
+        // Expect the cost to follow the pixel count, so the smoothed time
+        // does not keep asking for the change just made
+        m_smoothedMs *= (m_scale * m_scale) / (previous * previous);
+    }
+    if (m_width == width && m_height == height)
+        return false;
+    m_changes++;
+    return true;
+}
+
+}
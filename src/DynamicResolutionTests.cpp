@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "DynamicResolution.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    // GPU cost model for closed-loop tests: fixed work plus a part that
+    // follows the pixel count, with a little deterministic noise.
+    struct GpuModel {
+        float fixedMs;
+        float fullResMs;    // Pixel-dependent cost at scale 1
+        uint32_t state = 7;
+
+        float Frame(const qisx::DynamicResolution& drs)
+        {
+            state = state * 1664525u + 1013904223u;
+            const float noise = (float(state >> 8) / float(1 << 24) - 0.5f) * 0.6f;
+            const float pixels = float(drs.GetWidth()) * drs.GetHeight()
+                / (float(drs.GetOptions().maxWidth) * drs.GetOptions().maxHeight);
+            return fixedMs + fullResMs * pixels + noise;
+        }
+    };
+
+    // A captured trace: 2 s of a light scene at ~11 ms, a 1 s heavy burst at
+    // ~26 ms, then light again. Frame times do not depend on the scale
+    // (open loop), as when replaying a capture.
+    std::vector<float> RecordedTrace()
+    {
+        std::vector<float> trace;
+        const struct { int frames; float ms; } segments[] = { { 120, 11.0f }, { 60, 26.0f }, { 240, 11.0f } };
+        uint32_t state = 99;
+        for (const auto& segment : segments) {
+            for (int i = 0; i < segment.frames; i++) {
+                state = state * 1664525u + 1013904223u;
+                trace.push_back(segment.ms + float(state >> 24) / 255.0f - 0.5f);
+            }
+        }
+        return trace;
+    }
+
+}
+
+TEST(DynamicResolutionTests, ConvergesToBudgetWithoutHunting)
+{
+    qisx::DynamicResolution::Options options;
+    options.initialScale = 1.0f;
+    qisx::DynamicResolution drs(options);
+    GpuModel gpu{ 4.0f, 24.0f };
+
+    // Target 15 ms: 11 / 24 of the full-res pixel cost, a scale of about 0.68
+    const float expected = std::sqrt(11.0f / 24.0f);
+    float lastMs = 0.0f;
+    uint32_t changesBefore = 0;
+    for (int frame = 0; frame < 600; frame++) {
+        lastMs = gpu.Frame(drs);
+        drs.Update(2.0f, lastMs);
+        if (frame == 399)
+            changesBefore = drs.GetChangeCount();
+    }
+
+    EXPECT_NEAR(drs.GetScale(), expected, 0.03f);
+    EXPECT_NEAR(drs.GetSmoothedMs(), 15.0f, 15.0f * 0.06f);
+    EXPECT_LE(drs.GetChangeCount() - changesBefore, 2u) << "resolution keeps changing at steady load";
+}
+
+TEST(DynamicResolutionTests, RecordedTraceDropsFastAndRecoversSlowly)
+{
+    qisx::DynamicResolution drs;
+    const std::vector<float> trace = RecordedTrace();
+    const float initial = drs.GetScale();
+
+    std::vector<float> scales;
+    for (float ms : trace) {
+        drs.Update(ms);
+        scales.push_back(drs.GetScale());
+        ASSERT_GE(drs.GetScale(), drs.GetOptions().minScale);
+        ASSERT_LE(drs.GetScale(), drs.GetOptions().maxScale);
+        ASSERT_EQ(drs.GetWidth() % 2, 0u);
+        ASSERT_EQ(drs.GetHeight() % 2, 0u);
+    }
+
+    // Light start: grows after the delay, but not in the first 30 frames
+    EXPECT_EQ(scales[20], initial);
+    EXPECT_GT(scales[119], initial);
+    // Heavy burst: down to the floor within a few frames
+    EXPECT_LT(scales[120 + 10], scales[119] * 0.8f);
+    EXPECT_EQ(scales[179], drs.GetOptions().minScale);
+    // Light again: holds for the delay, then climbs by small steps
+    EXPECT_EQ(scales[180 + 20], drs.GetOptions().minScale);
+    EXPECT_GT(scales.back(), 0.9f);
+    for (size_t i = 181; i < scales.size(); i++)
+        ASSERT_LE(scales[i] - scales[i - 1], drs.GetOptions().maxStepUp + 1e-6f) << "frame " << i;
+}
+
+TEST(DynamicResolutionTests, ClampsAndAlignsSizes)
+{
+    qisx::DynamicResolution::Options options;
+    options.maxWidth = 1000;
+    options.maxHeight = 563;
+    options.minScale = 0.4f;
+    options.maxScale = 0.9f;
+    options.alignment = 8;
+    qisx::DynamicResolution drs(options);
+
+    for (int i = 0; i < 100; i++)
+        drs.Update(100.0f);
+    EXPECT_FLOAT_EQ(drs.GetScale(), 0.4f);
+    EXPECT_EQ(drs.GetWidth(), 400u);
+    EXPECT_EQ(drs.GetHeight(), 224u);   // 225.2 rounded to a multiple of 8
+
+    for (int i = 0; i < 500; i++)
+        drs.Update(1.0f);
+    EXPECT_FLOAT_EQ(drs.GetScale(), 0.9f);
+    EXPECT_EQ(drs.GetWidth(), 904u);
+    EXPECT_EQ(drs.GetHeight(), 504u);
+
+    drs.Reset();
+    EXPECT_FLOAT_EQ(drs.GetScale(), 2.0f / 3.0f);
+    EXPECT_EQ(drs.GetChangeCount(), 0u);
+}
+
+TEST(DynamicResolutionTests, CpuBoundFramesHoldTheScale)
+{
+    qisx::DynamicResolution drs;
+    const float scale = drs.GetScale();
+    for (int i = 0; i < 100; i++)
+        EXPECT_FALSE(drs.Update(30.0f, 6.0f));
+    EXPECT_EQ(drs.GetScale(), scale);
+
+    // GPU bound again
+    for (int i = 0; i < 10; i++)
+        drs.Update(30.0f, 30.0f);
+    EXPECT_LT(drs.GetScale(), scale);
+}
+
+// The CPU upscalers read the active region as a sub-view of the
+// over-allocated target, which must match upscaling a tight copy of it.
+TEST(DynamicResolutionTests, SubRectangleUpscalesLikeATightImage)
+{
+    qisx::Image target(1280, 720);
+    uint32_t state = 5;
+    for (size_t i = 0; i < target.SizeInBytes(); i++) {
+        state = state * 1664525u + 1013904223u;
+        target.Data()[i] = static_cast<uint8_t>(state >> 24);
+    }
+
+    qisx::DynamicResolution drs;
+    for (int i = 0; i < 5; i++)
+        drs.Update(25.0f);
+    ASSERT_LT(drs.GetWidth(), 854u);
+
+    const qisx::ImageView active = { target.Data(), drs.GetWidth(), drs.GetHeight(), target.RowPitch() };
+    qisx::Image tight(drs.GetWidth(), drs.GetHeight());
+    for (uint32_t y = 0; y < tight.Height(); y++)
+        memcpy(tight.Data() + y * tight.RowPitch(), active.Row(y), tight.RowPitch());
+
+    qisx::Image expected(1280, 720), actual(1280, 720);
+    qisx::CpuUpscaler upscaler;
+    ASSERT_TRUE(upscaler.Upscale(tight.View(), expected.MutableView()));
+    ASSERT_TRUE(upscaler.Upscale(active, actual.MutableView()));
+    EXPECT_EQ(memcmp(expected.Data(), actual.Data(), expected.SizeInBytes()), 0);
+}
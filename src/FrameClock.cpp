@@ -0,0 +1,82 @@
+#include "FrameClock.h"
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002    // Older SDKs
+#endif
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace qisx {
+
+#if defined(_WIN32)
+
+namespace {
+
+    // One timer per thread, high resolution where the OS supports it. Closed
+    // with the thread.
+    struct WaitableTimer {
+        HANDLE handle = nullptr;
+
+        WaitableTimer()
+        {
+            handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+            if (!handle)
+                handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+        ~WaitableTimer()
+        {
+            if (handle)
+                CloseHandle(handle);
+        }
+    };
+
+}
+
+void SteadyFrameClock::SleepFor(int64_t nanoseconds)
+{
+    if (nanoseconds <= 0)
+        return;
+    thread_local WaitableTimer timer;
+    LARGE_INTEGER due;
+    due.QuadPart = -((nanoseconds + 99) / 100);    // Relative, in 100 ns units
+    if (timer.handle && SetWaitableTimer(timer.handle, &due, 0, nullptr, nullptr, FALSE))
+        WaitForSingleObject(timer.handle, INFINITE);
+    else
+        Sleep(DWORD(nanoseconds / 1'000'000));
+}
+
+#else
+
+void SteadyFrameClock::SleepFor(int64_t nanoseconds)
+{
+    if (nanoseconds <= 0)
+        return;
+    timespec request;
+    request.tv_sec = time_t(nanoseconds / 1'000'000'000);
+    request.tv_nsec = long(nanoseconds % 1'000'000'000);
+    timespec remaining;
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &request, &remaining) == EINTR)
+        request = remaining;
+}
+
+#endif
+
+void SteadyFrameClock::Relax()
+{
+    std::this_thread::yield();
+}
+
+FrameClock& DefaultFrameClock()
+{
+    static SteadyFrameClock clock;
+    return clock;
+}
+
+}
@@ -0,0 +1,63 @@
+#include "FramePacer.h"
+#include <algorithm>
+
+namespace qisx {
+
+FramePacer::FramePacer(FrameClock* clock, const Options& options)
+    : m_clock(clock ? clock : &DefaultFrameClock()),
+      m_options(options)
+{
+}
+
+int64_t FramePacer::WaitForNextFrame(int64_t periodNs)
+{
+    m_stats.frames++;
+    const int64_t now = m_clock->Now();
+    if (periodNs <= 0)
+        return now;
+
+    if (m_periodNs != periodNs || m_nextDeadline == 0) {
+        // New schedule: this frame ends a period from now
+        m_periodNs = periodNs;
+        m_nextDeadline = now + periodNs;
+    }
+
+    if (now >= m_nextDeadline) {
+        m_stats.missedDeadlines++;
+        // More than a period late: restart from now rather than presenting a
+        // burst of frames to catch up
+        m_nextDeadline = now - m_nextDeadline > periodNs ? now + periodNs : m_nextDeadline + periodNs;
+        return now;
+    }
+
+    WaitUntil(m_nextDeadline);
+    m_nextDeadline += periodNs;
+    return m_clock->Now();
+}
+
+void FramePacer::WaitUntil(int64_t deadline)
+{
+    int64_t now = m_clock->Now();
+    const int64_t sleep = deadline - now - m_options.spinThresholdNs - m_overshootNs;
+    if (sleep > 0) {
+        m_clock->SleepFor(sleep);
+        const int64_t woke = m_clock->Now();
+        m_stats.sleptNs += woke - now;
+
+        // Learn the wake-up latency: rise fast so the next frame does not
+        // oversleep again, decay slowly so one lucky wake-up does not either
+        const int64_t overshoot = std::clamp<int64_t>(woke - now - sleep, 0, m_options.maxOvershootNs);
+        const float weight = overshoot > m_overshootNs ? m_options.overshootRise : m_options.overshootDecay;
+        m_overshootNs += int64_t(float(overshoot - m_overshootNs) * weight);
+        now = woke;
+    }
+
+    const int64_t spinStart = now;
+    while (now < deadline) {
+        m_clock->Relax();
+        now = m_clock->Now();
+    }
+    m_stats.spunNs += now - spinStart;
+}
+
+}
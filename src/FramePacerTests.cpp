@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+    constexpr int64_t kMs = 1'000'000;
+    constexpr int64_t k60Hz = 1'000'000'000 / 60;
+
+}
+
+// Sleeps that wake 1 ms late: the pacer learns the overshoot, wakes just
+// before the deadline and only spins for the last few hundred microseconds.
+TEST(FramePacerTests, LearnsOvershootAndSpinsBriefly)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.Set(1000 * kMs);
+    clock.SetSleepOvershoot(1 * kMs);
+    clock.SetReadCost(1000);    // 1 us per clock read
+    qisx::FramePacer pacer(&clock);
+
+    int64_t previous = pacer.WaitForNextFrame(k60Hz);
+    for (int frame = 0; frame < 60; frame++) {
+        clock.Advance(5 * kMs);    // Frame work
+        const qisx::FramePacer::Stats before = pacer.GetStats();
+        const int64_t deadline = pacer.GetNextDeadline();
+        const int64_t now = pacer.WaitForNextFrame(k60Hz);
+
+        // Never early. The first sleeps wake up to the full overshoot late;
+        // once it is learned, only the clock read granularity remains.
+        EXPECT_GE(now, deadline);
+        EXPECT_LE(now - deadline, 1 * kMs + 4000) << "frame " << frame;
+        if (frame >= 10) {
+            EXPECT_LE(now - deadline, 4000) << "frame " << frame;
+            EXPECT_NEAR(double(now - previous), double(k60Hz), 8000.0) << "frame " << frame;
+        }
+        previous = now;
+
+        if (frame >= 30) {
+            const int64_t spun = pacer.GetStats().spunNs - before.spunNs;
+            EXPECT_LT(spun, pacer.GetStats().sleptNs / 10) << "frame " << frame;
+            EXPECT_LE(spun, 500'000) << "frame " << frame;
+        }
+    }
+    EXPECT_GT(pacer.GetOvershootEstimate(), 800'000);
+    EXPECT_LE(pacer.GetOvershootEstimate(), 1 * kMs + 4000);
+    EXPECT_EQ(pacer.GetStats().missedDeadlines, 0u);
+}
+
+// Deadlines are absolute, so frame times that vary do not accumulate drift.
+TEST(FramePacerTests, ScheduleDoesNotDrift)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.SetSleepOvershoot(300'000);
+    clock.SetReadCost(700);
+    qisx::FramePacer pacer(&clock);
+
+    pacer.WaitForNextFrame(k60Hz);
+    const int64_t start = pacer.GetNextDeadline() - k60Hz;     // The deadline just met
+    uint32_t state = 1;
+    for (int frame = 0; frame < 600; frame++) {
+        state = state * 1664525u + 1013904223u;
+        clock.Advance(int64_t(state >> 8) % (12 * kMs));
+        pacer.WaitForNextFrame(k60Hz);
+    }
+    EXPECT_NEAR(double(clock.Now() - start), 600.0 * double(k60Hz), 10'000.0);
+    EXPECT_EQ(pacer.GetStats().missedDeadlines, 0u);
+}
+
+// A long frame is not followed by a burst of short ones to catch up.
+TEST(FramePacerTests, MissedDeadlineRestartsSchedule)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.SetReadCost(1000);
+    qisx::FramePacer pacer(&clock);
+    pacer.WaitForNextFrame(k60Hz);
+
+    clock.Advance(50 * kMs);    // Three periods of work
+    const uint64_t sleeps = clock.GetSleepCount();
+    const int64_t late = pacer.WaitForNextFrame(k60Hz);
+    EXPECT_EQ(clock.GetSleepCount(), sleeps);
+    EXPECT_EQ(pacer.GetStats().missedDeadlines, 1u);
+
+    clock.Advance(2 * kMs);
+    const int64_t next = pacer.WaitForNextFrame(k60Hz);
+    EXPECT_GE(next - late, k60Hz);
+    EXPECT_LE(next - late, k60Hz + 10'000);
+
+    // Changing the target rate starts a new schedule as well
+    clock.Advance(1 * kMs);
+    const int64_t first144 = pacer.WaitForNextFrame(1'000'000'000 / 144);
+    clock.Advance(1 * kMs);
+    const int64_t second144 = pacer.WaitForNextFrame(1'000'000'000 / 144);
+    EXPECT_NEAR(double(second144 - first144), 1e9 / 144.0, 10'000.0);
+}
@@ -0,0 +1,138 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+FrameTimeRing::FrameTimeRing(uint32_t capacity)
+{
+    // One slot more than the usable capacity is the one the writer may be
+    // filling while a reader copies
+    uint32_t size = 2;
+    while (size < capacity + 1 && size < (1u << 31))
+        size <<= 1;
+    m_values = std::make_unique<std::atomic<float>[]>(size);
+    m_mask = size - 1;
+}
+
+void FrameTimeRing::Push(float seconds)
+{
+    // The release store of the value orders it after the previous count, so a
+    // reader that sees it also sees at least index frames written
+    const uint64_t index = m_written.load(std::memory_order_relaxed);
+    m_values[index & m_mask].store(seconds, std::memory_order_release);
+    m_written.store(index + 1, std::memory_order_release);
+}
+
+size_t FrameTimeRing::Snapshot(uint32_t maxFrames, std::vector<float>& out) const
+{
+    const uint64_t end = m_written.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>({ maxFrames, end, m_mask });
+    const uint64_t begin = end - count;
+
+    out.resize(size_t(count));
+    for (uint64_t i = 0; i < count; i++)
+        out[size_t(i)] = m_values[(begin + i) & m_mask].load(std::memory_order_relaxed);
+
+    // The writer may have overwritten entries below after - capacity while we
+    // copied, and may be in the middle of writing frame `after` too
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = m_written.load(std::memory_order_relaxed) + 1;
+    const uint64_t oldestIntact = after > m_mask + 1 ? after - (m_mask + 1) : 0;
+    if (oldestIntact > begin) {
+        const size_t torn = size_t(std::min(oldestIntact - begin, count));
+        out.erase(out.begin(), out.begin() + torn);
+    }
+    return out.size();
+}
+
+FrameTimeSummary SummarizeFrameTimes(std::vector<float>& frameSeconds, float stutterFactor)
+{
+    FrameTimeSummary summary;
+    if (frameSeconds.empty())
+        return summary;
+
+    std::sort(frameSeconds.begin(), frameSeconds.end());
+    const size_t n = frameSeconds.size();
+    double total = 0.0;
+    for (float t : frameSeconds)
+        total += t;
+
+    // Nearest rank: the smallest value with at least p% of the frames at or below it
+    auto percentile = [&](double p) {
+        const size_t rank = size_t(std::ceil(p / 100.0 * double(n)));
+        return double(frameSeconds[std::clamp<size_t>(rank, 1, n) - 1]) * 1000.0;
+    };
+
+    summary.frames = uint32_t(n);
+    summary.windowMs = total * 1000.0;
+    summary.meanMs = summary.windowMs / double(n);
+    summary.p50Ms = percentile(50.0);
+    summary.p95Ms = percentile(95.0);
+    summary.p99Ms = percentile(99.0);
+    summary.p999Ms = percentile(99.9);
+    summary.maxMs = double(frameSeconds.back()) * 1000.0;
+    summary.averageFps = total > 0.0 ? double(n) / total : 0.0;
+
+    const size_t slowest = std::max<size_t>(1, n / 100);
+    double slowTotal = 0.0;
+    for (size_t i = n - slowest; i < n; i++)
+        slowTotal += frameSeconds[i];
+    summary.onePercentLowFps = slowTotal > 0.0 ? double(slowest) / slowTotal : 0.0;
+
+    const float threshold = float(summary.p50Ms / 1000.0) * stutterFactor;
+    const auto firstStutter = std::upper_bound(frameSeconds.begin(), frameSeconds.end(), threshold);
+    summary.stutters = uint32_t(frameSeconds.end() - firstStutter);
+    return summary;
+}
+
+FrameTimer::FrameTimer(FrameClock* clock, const Options& options)
+    : m_clock(clock ? clock : &DefaultFrameClock()),
+      m_options(options),
+      m_history(options.historyFrames)
+{
+    m_scratch.reserve(m_history.GetCapacity());
+    m_lastFrameTime = m_clock->Now();
+    m_fpsWindowStart = m_lastFrameTime;
+}
+
+bool FrameTimer::Tick()
+{
+    const int64_t now = m_clock->Now();
+    m_deltaTime = float(double(now - m_lastFrameTime) * 1e-9);
+    m_lastFrameTime = now;
+    m_history.Push(m_deltaTime);
+
+    // Apply exponential smoothing to delta time
+    m_smoothedDeltaTime = m_options.smoothing * m_deltaTime + (1.0f - m_options.smoothing) * m_smoothedDeltaTime;
+
+    // FPS calculation, measured on the clock so it does not drift with rounding
+    m_frameCount++;
+    const int64_t elapsed = now - m_fpsWindowStart;
+    if (elapsed < 1'000'000'000)
+        return false;
+    m_currentFPS = float(m_frameCount / (double(elapsed) * 1e-9));
+    m_frameCount = 0;
+    m_fpsWindowStart = now;
+    return true;
+}
+
+FrameTimeSummary FrameTimer::Summarize(uint32_t maxFrames, float maxSeconds)
+{
+    m_history.Snapshot(maxFrames, m_scratch);
+    if (maxSeconds > 0.0f) {
+        // Keep the newest frames that fit in maxSeconds (at least one)
+        size_t keep = 0;
+        double total = 0.0;
+        while (keep < m_scratch.size()) {
+            total += m_scratch[m_scratch.size() - 1 - keep];
+            if (keep > 0 && total > maxSeconds)
+                break;
+            keep++;
+        }
+        m_scratch.erase(m_scratch.begin(), m_scratch.end() - keep);
+    }
+    return SummarizeFrameTimes(m_scratch, m_options.stutterFactor);
+}
+
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "FrameStats.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(FrameStatsTests, PercentilesUseNearestRank)
+{
+    // 1, 2, ..., 100 ms in shuffled order
+    std::vector<float> frames;
+    for (int i = 0; i < 100; i++)
+        frames.push_back(float((i * 37) % 100 + 1) / 1000.0f);
+
+    const qisx::FrameTimeSummary stats = qisx::SummarizeFrameTimes(frames);
+    EXPECT_EQ(stats.frames, 100u);
+    EXPECT_NEAR(stats.p50Ms, 50.0, 1e-4);
+    EXPECT_NEAR(stats.p95Ms, 95.0, 1e-4);
+    EXPECT_NEAR(stats.p99Ms, 99.0, 1e-4);
+    EXPECT_NEAR(stats.p999Ms, 100.0, 1e-4);
+    EXPECT_NEAR(stats.maxMs, 100.0, 1e-4);
+    EXPECT_NEAR(stats.meanMs, 50.5, 1e-3);
+    EXPECT_NEAR(stats.onePercentLowFps, 10.0, 1e-3);    // The slowest frame, 100 ms
+    EXPECT_EQ(stats.stutters, 0u);                      // Nothing above 2 * 50 ms
+
+    std::vector<float> empty;
+    EXPECT_EQ(qisx::SummarizeFrameTimes(empty).frames, 0u);
+}
+
+TEST(FrameStatsTests, SpikesShowInTailAndStutters)
+{
+    // 990 frames at 16 ms and ten 50 ms hitches
+    std::vector<float> frames(990, 0.016f);
+    frames.insert(frames.begin() + 500, 10, 0.050f);
+
+    const qisx::FrameTimeSummary stats = qisx::SummarizeFrameTimes(frames);
+    EXPECT_NEAR(stats.p50Ms, 16.0, 1e-4);
+    EXPECT_NEAR(stats.p99Ms, 16.0, 1e-4);
+    EXPECT_NEAR(stats.p999Ms, 50.0, 1e-4);
+    EXPECT_NEAR(stats.onePercentLowFps, 20.0, 1e-3);
+    EXPECT_EQ(stats.stutters, 10u);
+    EXPECT_NEAR(stats.averageFps, 1000.0 / (990 * 16.0 + 500.0) * 1000.0, 1e-3);
+}
+
+TEST(FrameStatsTests, RingKeepsNewestFramesInOrder)
+{
+    qisx::FrameTimeRing ring(6);
+    EXPECT_EQ(ring.GetCapacity(), 7u);
+
+    std::vector<float> out;
+    EXPECT_EQ(ring.Snapshot(100, out), 0u);
+
+    for (int i = 0; i < 20; i++)
+        ring.Push(float(i));
+    EXPECT_EQ(ring.GetFrameCount(), 20u);
+
+    ASSERT_EQ(ring.Snapshot(100, out), 7u);
+    for (size_t i = 0; i < out.size(); i++)
+        EXPECT_EQ(out[i], float(13 + i));
+
+    ASSERT_EQ(ring.Snapshot(3, out), 3u);
+    EXPECT_EQ(out[0], 17.0f);
+    EXPECT_EQ(out[2], 19.0f);
+}
+
+// A reader racing the writer may get fewer frames, but never a torn or
+// reordered window.
+TEST(FrameStatsTests, RingSnapshotsAreConsistentUnderConcurrentWrites)
+{
+    qisx::FrameTimeRing ring(63);
+    std::atomic<bool> done{ false };
+    std::thread writer([&] {
+        for (int i = 1; i <= 200000; i++)
+            ring.Push(float(i));
+        done = true;
+    });
+
+    std::vector<float> out;
+    out.reserve(ring.GetCapacity());
+    int snapshots = 0;
+    while (!done || snapshots < 10) {
+        ring.Snapshot(ring.GetCapacity(), out);
+        for (size_t i = 1; i < out.size(); i++)
+            ASSERT_EQ(out[i], out[i - 1] + 1.0f) << "snapshot " << snapshots << " entry " << i;
+        snapshots++;
+    }
+    writer.join();
+
+    ASSERT_EQ(ring.Snapshot(ring.GetCapacity(), out), 63u);
+    EXPECT_EQ(out.back(), 200000.0f);
+}
+
+TEST(FrameStatsTests, TimerMeasuresSimulatedClock)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.Set(5'000'000'000);
+    qisx::FrameTimer timer(&clock);
+
+    // 99 frames of 10 ms do not complete the one-second FPS window, the 100th does
+    for (int i = 0; i < 99; i++) {
+        clock.AdvanceSeconds(0.010);
+        EXPECT_FALSE(timer.Tick());
+    }
+    EXPECT_NEAR(timer.GetDeltaTime(), 0.010f, 1e-6f);
+    EXPECT_NEAR(timer.GetSmoothedDeltaTime(), 0.010f, 1e-4f);
+    clock.AdvanceSeconds(0.010);
+    EXPECT_TRUE(timer.Tick());
+    EXPECT_NEAR(timer.GetFPS(), 100.0f, 0.01f);
+    EXPECT_EQ(timer.GetFrameStart(), clock.Now());
+
+    // One 100 ms hitch in a rolling window
+    clock.AdvanceSeconds(0.100);
+    timer.Tick();
+    for (int i = 0; i < 49; i++) {
+        clock.AdvanceSeconds(0.010);
+        timer.Tick();
+    }
+
+    const qisx::FrameTimeSummary all = timer.Summarize(1000);
+    EXPECT_EQ(all.frames, 150u);
+    EXPECT_EQ(all.stutters, 1u);
+    EXPECT_NEAR(all.maxMs, 100.0, 1e-3);
+
+    // The newest 0.3 s holds only 10 ms frames
+    const qisx::FrameTimeSummary recent = timer.Summarize(1000, 0.3f);
+    EXPECT_EQ(recent.frames, 30u);
+    EXPECT_EQ(recent.stutters, 0u);
+    EXPECT_NEAR(recent.p999Ms, 10.0, 1e-3);
+
+    EXPECT_EQ(timer.Summarize(20).frames, 20u);
+}
@@ -0,0 +1,117 @@
+#include "GpuProfiler.h"
+
+namespace qisx {
+
+bool GpuProfiler::Init(ID3D11Device* device, ID3D11DeviceContext* context)
+{
+    Shutdown();
+    if (!device || !context)
+        return false;
+
+    D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+    D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+    for (FrameQueries& queries : m_frames) {
+        bool ok = SUCCEEDED(device->CreateQuery(&disjointDesc, &queries.disjoint))
+            && SUCCEEDED(device->CreateQuery(&timestampDesc, &queries.begin))
+            && SUCCEEDED(device->CreateQuery(&timestampDesc, &queries.end));
+        for (Pass& pass : queries.passes) {
+            ok = ok && SUCCEEDED(device->CreateQuery(&timestampDesc, &pass.begin))
+                && SUCCEEDED(device->CreateQuery(&timestampDesc, &pass.end));
+        }
+        if (!ok) {
+            Shutdown();
+            return false;
+        }
+    }
+    m_context = context;
+    return true;
+}
+
+void GpuProfiler::Shutdown()
+{
+    for (FrameQueries& queries : m_frames)
+        queries = FrameQueries();
+    m_context.Reset();
+    m_current = 0;
+    m_inFrame = false;
+}
+
+void GpuProfiler::BeginFrame()
+{
+    if (!m_context || m_inFrame)
+        return;
+
+    // Reading back the set issued kFramesInFlight - 1 frames ago
+    FrameQueries& queries = m_frames[m_current];
+    if (queries.pending)
+        Resolve(queries);
+
+    queries.passCount = 0;
+    queries.frame = m_profiler.GetFrameIndex();
+    queries.cpuStartNs = m_profiler.GetClock().Now();
+    m_context->Begin(queries.disjoint.Get());
+    m_context->End(queries.begin.Get());
+    m_inFrame = true;
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!m_inFrame)
+        return;
+    FrameQueries& queries = m_frames[m_current];
+    m_context->End(queries.end.Get());
+    m_context->End(queries.disjoint.Get());
+    queries.pending = true;
+    m_inFrame = false;
+    m_current = (m_current + 1) % kFramesInFlight;
+}
+
+uint32_t GpuProfiler::BeginPass(const char* name)
+{
+    FrameQueries& queries = m_frames[m_current];
+    if (!m_inFrame || queries.passCount == kMaxPasses)
+        return UINT32_MAX;
+    Pass& pass = queries.passes[queries.passCount];
+    pass.name = name;
+    m_context->End(pass.begin.Get());
+    return queries.passCount++;
+}
+
+void GpuProfiler::EndPass(uint32_t pass)
+{
+    FrameQueries& queries = m_frames[m_current];
+    if (m_inFrame && pass < queries.passCount)
+        m_context->End(queries.passes[pass].end.Get());
+}
+
+void GpuProfiler::Resolve(FrameQueries& queries)
+{
+    queries.pending = false;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    UINT64 frameBegin = 0, frameEnd = 0;
+    const UINT flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+    if (m_context->GetData(queries.disjoint.Get(), &disjoint, sizeof(disjoint), flags) != S_OK
+        || m_context->GetData(queries.begin.Get(), &frameBegin, sizeof(frameBegin), flags) != S_OK
+        || m_context->GetData(queries.end.Get(), &frameEnd, sizeof(frameEnd), flags) != S_OK
+        || disjoint.Disjoint || disjoint.Frequency == 0) {
+        m_dropped++;
+        return;
+    }
+
+    const double nsPerTick = 1e9 / double(disjoint.Frequency);
+    auto toCpu = [&](UINT64 ticks) { return queries.cpuStartNs + int64_t(double(ticks - frameBegin) * nsPerTick); };
+
+    m_profiler.AddGpuEvent(queries.frame, "GPU frame", toCpu(frameBegin), toCpu(frameEnd));
+    m_lastFrameMs = float(double(frameEnd - frameBegin) * nsPerTick * 1e-6);
+
+    for (uint32_t i = 0; i < queries.passCount; i++) {
+        const Pass& pass = queries.passes[i];
+        UINT64 begin = 0, end = 0;
+        if (m_context->GetData(pass.begin.Get(), &begin, sizeof(begin), flags) == S_OK
+            && m_context->GetData(pass.end.Get(), &end, sizeof(end), flags) == S_OK)
+            m_profiler.AddGpuEvent(queries.frame, pass.name, toCpu(begin), toCpu(end));
+    }
+}
+
+}
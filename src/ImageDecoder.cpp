@@ -0,0 +1,60 @@
+#include "ImageDecoder.h"
+#include <mutex>
+
+namespace qisx {
+
+namespace {
+
+    // Decoders are never removed, so the raw pointers handed out stay valid for
+    // the life of the process.
+    struct DecoderRegistry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ImageDecoder>> decoders;   // Oldest first
+
+        DecoderRegistry()
+        {
+            decoders.push_back(CreateNetpbmDecoder());
+            decoders.push_back(CreateJpegDecoder());
+            decoders.push_back(CreatePngDecoder());
+        }
+    };
+
+    DecoderRegistry& Registry()
+    {
+        static DecoderRegistry registry;
+        return registry;
+    }
+
+}
+
+void RegisterImageDecoder(std::unique_ptr<ImageDecoder> decoder)
+{
+    if (!decoder)
+        return;
+    DecoderRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.decoders.push_back(std::move(decoder));
+}
+
+const ImageDecoder* FindImageDecoder(const uint8_t* data, size_t size)
+{
+    DecoderRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto it = registry.decoders.rbegin(); it != registry.decoders.rend(); ++it) {
+        if ((*it)->CanDecode(data, size))
+            return it->get();
+    }
+    return nullptr;
+}
+
+std::vector<const ImageDecoder*> GetImageDecoders()
+{
+    DecoderRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<const ImageDecoder*> result;
+    for (auto it = registry.decoders.rbegin(); it != registry.decoders.rend(); ++it)
+        result.push_back(it->get());
+    return result;
+}
+
+}
@@ -0,0 +1,292 @@
+#include "gtest/gtest.h"
+#include "ImageDecoder.h"
+#include "ImageIO.h"
+#include "Zlib.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+    // 32x16 RGB gradient (R = 8x, G = 16y, B = 128), 4:2:0, quality 95, restart
+    // interval 1, written by libjpeg once as baseline and once as progressive.
+    const uint8_t kBaselineJpeg[] = {
+        0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+        0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02,
+        0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04,
+        0x04, 0x03, 0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06,
+        0x07, 0x09, 0x07, 0x06, 0x06, 0x08, 0x0B, 0x08, 0x09, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x06, 0x08,
+        0x0B, 0x0C, 0x0B, 0x0A, 0x0C, 0x09, 0x0A, 0x0A, 0x0A, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x05, 0x03, 0x03, 0x05, 0x0A, 0x07, 0x06, 0x07, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0xFF, 0xC0,
+        0x00, 0x11, 0x08, 0x00, 0x10, 0x00, 0x20, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+        0x01, 0xFF, 0xC4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x08, 0x09, 0xFF, 0xC4, 0x00, 0x1B, 0x10, 0x00, 0x01,
+        0x05, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,
+        0x08, 0x25, 0x32, 0xA2, 0x11, 0x12, 0xFF, 0xC4, 0x00, 0x17, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x06, 0x07, 0x08, 0xFF,
+        0xC4, 0x00, 0x1C, 0x11, 0x00, 0x01, 0x03, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x05, 0x23, 0x31, 0x32, 0x41, 0x51, 0xA1, 0xFF, 0xDD, 0x00,
+        0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F,
+        0x00, 0xCD, 0xF4, 0x9B, 0x54, 0xAC, 0x6E, 0x04, 0xC4, 0xA3, 0x54, 0xEF, 0x98, 0xDC, 0x17, 0x02,
+        0x51, 0xAA, 0x77, 0xCC, 0x6E, 0x04, 0xC4, 0x9B, 0x54, 0xAC, 0x6E, 0x07, 0x87, 0x93, 0x0D, 0x64,
+        0xEA, 0x82, 0x0D, 0x8F, 0x56, 0x4B, 0xAC, 0xAF, 0xFF, 0xD0, 0x9D, 0xD2, 0x6D, 0x52, 0xB1, 0xB8,
+        0x13, 0x52, 0x6D, 0x52, 0xB1, 0xB8, 0x2E, 0x04, 0x9B, 0x54, 0xAC, 0x6E, 0x04, 0xC4, 0xA3, 0x54,
+        0xAC, 0x6E, 0x00, 0x2F, 0x26, 0x1A, 0xC9, 0xD5, 0xA1, 0x86, 0xC7, 0xAB, 0x25, 0xD6, 0x57, 0xFF,
+        0xD9,
+    };
+
+    const uint8_t kProgressiveJpeg[] = {
+        0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+        0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02,
+        0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04,
+        0x04, 0x03, 0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06,
+        0x07, 0x09, 0x07, 0x06, 0x06, 0x08, 0x0B, 0x08, 0x09, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x06, 0x08,
+        0x0B, 0x0C, 0x0B, 0x0A, 0x0C, 0x09, 0x0A, 0x0A, 0x0A, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x05, 0x03, 0x03, 0x05, 0x0A, 0x07, 0x06, 0x07, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+        0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0xFF, 0xC2,
+        0x00, 0x11, 0x08, 0x00, 0x10, 0x00, 0x20, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+        0x01, 0xFF, 0xC4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x07, 0x08, 0xFF, 0xC4, 0x00, 0x17, 0x01, 0x00, 0x03,
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x05,
+        0x06, 0x07, 0xFF, 0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02,
+        0x10, 0x03, 0x10, 0x00, 0x00, 0x01, 0xCD, 0xE9, 0xAE, 0x09, 0x9E, 0x40, 0xFF, 0x00, 0xFF, 0xD0,
+        0x9D, 0xA6, 0xB8, 0x26, 0x03, 0x43, 0xFF, 0xC4, 0x00, 0x16, 0x10, 0x00, 0x03, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x06, 0xFF, 0xDA,
+        0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x05, 0x02, 0x52, 0x54, 0xFF, 0xD0, 0x56, 0x54, 0xFF, 0xD1,
+        0x52, 0x54, 0xFF, 0xD2, 0x52, 0x54, 0xFF, 0xD3, 0x56, 0x54, 0xFF, 0xD4, 0x52, 0x54, 0xFF, 0xD5,
+        0x52, 0x54, 0xFF, 0xD6, 0x56, 0x54, 0xFF, 0xC4, 0x00, 0x17, 0x11, 0x01, 0x00, 0x03, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x22, 0x31, 0xFF,
+        0xDA, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3F, 0x01, 0x36, 0xF7, 0x2D, 0x3F, 0xFF, 0xD0, 0x36,
+        0xF7, 0x2D, 0x3F, 0xFF, 0xC4, 0x00, 0x17, 0x11, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x06, 0x62, 0xFF, 0xDA, 0x00, 0x08,
+        0x01, 0x02, 0x01, 0x01, 0x3F, 0x01, 0x72, 0xC3, 0x47, 0xFF, 0xD0, 0x72, 0xC3, 0x47, 0xFF, 0xC4,
+        0x00, 0x15, 0x10, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x33, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x06, 0x3F, 0x02, 0x9B,
+        0xFF, 0xD0, 0x9B, 0xFF, 0xD1, 0x9B, 0xFF, 0xD2, 0x9B, 0xFF, 0xD3, 0x9B, 0xFF, 0xD4, 0x9B, 0xFF,
+        0xD5, 0x9B, 0xFF, 0xD6, 0x9B, 0xFF, 0xC4, 0x00, 0x16, 0x10, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0xC1, 0xFF, 0xDA, 0x00,
+        0x08, 0x01, 0x01, 0x00, 0x01, 0x3F, 0x21, 0x4C, 0x9F, 0xFF, 0xD0, 0x5C, 0x9F, 0xFF, 0xD1, 0x4C,
+        0x9F, 0xFF, 0xD2, 0x4C, 0x9F, 0xFF, 0xD3, 0x5C, 0x9F, 0xFF, 0xD4, 0x4C, 0x9F, 0xFF, 0xD5, 0x4C,
+        0x9F, 0xFF, 0xD6, 0x5C, 0x9F, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+        0x00, 0x00, 0x10, 0x07, 0xFF, 0xD0, 0x73, 0xFF, 0xC4, 0x00, 0x16, 0x11, 0x00, 0x03, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xA1, 0xFF,
+        0xDA, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3F, 0x10, 0x96, 0xCF, 0xFF, 0xD0, 0x96, 0xCF, 0xFF,
+        0xC4, 0x00, 0x16, 0x11, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0xC1, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x02, 0x01, 0x01, 0x3F,
+        0x10, 0x7D, 0x1F, 0xFF, 0xD0, 0x7D, 0x1F, 0xFF, 0xC4, 0x00, 0x15, 0x10, 0x01, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xFF, 0xDA,
+        0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3F, 0x10, 0x27, 0xFF, 0xD0, 0xB8, 0xFF, 0x00, 0xFF, 0xD1,
+        0x27, 0xFF, 0xD2, 0x27, 0xFF, 0xD3, 0xB8, 0xFF, 0x00, 0xFF, 0xD4, 0x27, 0xFF, 0xD5, 0x27, 0xFF,
+        0xD6, 0x67, 0xFF, 0xD9,
+    };
+
+    void PutBE32(std::vector<uint8_t>& out, uint32_t v)
+    {
+        out.push_back(uint8_t(v >> 24));
+        out.push_back(uint8_t(v >> 16));
+        out.push_back(uint8_t(v >> 8));
+        out.push_back(uint8_t(v));
+    }
+
+    void PutChunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& payload)
+    {
+        PutBE32(out, uint32_t(payload.size()));
+        const size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), payload.begin(), payload.end());
+        PutBE32(out, qisx::Crc32(&out[start], payload.size() + 4));
+    }
+
+    // PNG from an already filtered scanline stream, split over two IDAT chunks
+    std::vector<uint8_t> MakePng(uint32_t width, uint32_t height, uint8_t bitDepth, uint8_t colorType, bool interlaced,
+        const std::vector<uint8_t>& scanlines, const std::vector<uint8_t>& plte = {}, const std::vector<uint8_t>& trns = {})
+    {
+        std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        std::vector<uint8_t> ihdr;
+        PutBE32(ihdr, width);
+        PutBE32(ihdr, height);
+        ihdr.insert(ihdr.end(), { bitDepth, colorType, 0, 0, uint8_t(interlaced ? 1 : 0) });
+        PutChunk(png, "IHDR", ihdr);
+        if (!plte.empty())
+            PutChunk(png, "PLTE", plte);
+        if (!trns.empty())
+            PutChunk(png, "tRNS", trns);
+
+        std::vector<uint8_t> compressed;
+        qisx::ZlibCompress(scanlines.data(), scanlines.size(), compressed);
+        const size_t half = compressed.size() / 2;
+        PutChunk(png, "IDAT", std::vector<uint8_t>(compressed.begin(), compressed.begin() + half));
+        PutChunk(png, "IDAT", std::vector<uint8_t>(compressed.begin() + half, compressed.end()));
+        PutChunk(png, "IEND", {});
+        return png;
+    }
+
+    qisx::Image Decode(const uint8_t* data, size_t size)
+    {
+        qisx::Image image;
+        std::string error;
+        EXPECT_TRUE(qisx::DecodeImage(data, size, image, &error)) << error;
+        return image;
+    }
+
+}
+
+TEST(ImageDecoderTests, RegistryFindsBuiltInsAndPrefersLaterRegistrations)
+{
+    const std::vector<uint8_t> png = MakePng(1, 1, 8, 0, false, { 0, 7 });
+    const qisx::ImageDecoder* found = qisx::FindImageDecoder(png.data(), png.size());
+    ASSERT_NE(found, nullptr);
+    EXPECT_STREQ(found->Name(), "png");
+    EXPECT_STREQ(qisx::FindImageDecoder(kBaselineJpeg, sizeof(kBaselineJpeg))->Name(), "jpeg");
+    EXPECT_EQ(qisx::FindImageDecoder(png.data(), 4), nullptr);
+
+    // Claims only this test's buffer so other tests keep the built-in decoders
+    class Override final : public qisx::ImageDecoder {
+    public:
+        explicit Override(const uint8_t* claimed) : m_claimed(claimed) {}
+        const char* Name() const override { return "override"; }
+        bool CanDecode(const uint8_t* data, size_t) const override { return data == m_claimed; }
+        bool ReadInfo(const uint8_t*, size_t, qisx::ImageInfo&, std::string*) const override { return false; }
+        bool Decode(const uint8_t*, size_t, const qisx::MutableImageView&, std::string*) const override { return false; }
+
+    private:
+        const uint8_t* m_claimed;
+    };
+    // Static: the override matches this buffer's address for the rest of the run
+    static const std::vector<uint8_t> claimed = png;
+    const size_t before = qisx::GetImageDecoders().size();
+    qisx::RegisterImageDecoder(std::make_unique<Override>(claimed.data()));
+    EXPECT_EQ(qisx::GetImageDecoders().size(), before + 1);
+    EXPECT_STREQ(qisx::FindImageDecoder(claimed.data(), claimed.size())->Name(), "override");
+    EXPECT_STREQ(qisx::FindImageDecoder(png.data(), png.size())->Name(), "png");
+}
+
+TEST(ImageDecoderTests, PngEncoderOutputRoundTrips)
+{
+    qisx::Image image(37, 19);
+    uint32_t state = 1;
+    for (size_t i = 0; i < image.SizeInBytes(); i++) {
+        state = state * 1664525u + 1013904223u;
+        image.Data()[i] = (i / 4) % 3 ? uint8_t(state >> 24) : uint8_t(i);
+    }
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(qisx::EncodePng(image.View(), png));
+
+    // Decode into a padded view to check row pitch handling
+    const std::unique_ptr<qisx::ImageDecoder> decoder = qisx::CreatePngDecoder();
+    std::vector<uint8_t> padded(size_t(37 * 4 + 12) * 19, 0xCD);
+    const qisx::MutableImageView view{ padded.data(), 37, 19, 37 * 4 + 12 };
+    ASSERT_TRUE(decoder->Decode(png.data(), png.size(), view, nullptr));
+    for (uint32_t y = 0; y < 19; y++) {
+        EXPECT_EQ(0, std::memcmp(view.Row(y), image.View().Row(y), 37 * 4)) << "row " << y;
+        EXPECT_EQ(view.Row(y)[37 * 4], 0xCD);
+    }
+}
+
+TEST(ImageDecoderTests, PngExpandsLowBitDepthPaletteAndSixteenBit)
+{
+    // 1-bit grey, 3 pixels: 1 0 1
+    qisx::Image grey = [] {
+        const std::vector<uint8_t> png = MakePng(3, 1, 1, 0, false, { 0, 0xA0 });
+        return Decode(png.data(), png.size());
+    }();
+    const uint8_t greyExpected[] = { 255, 255, 255, 255, 0, 0, 0, 255, 255, 255, 255, 255 };
+    EXPECT_EQ(0, std::memcmp(grey.Data(), greyExpected, sizeof(greyExpected)));
+
+    // 2-bit palette with tRNS on entry 1
+    const std::vector<uint8_t> palette = MakePng(2, 1, 2, 3, false, { 0, 0x10 }, { 10, 20, 30, 40, 50, 60 }, { 255, 128 });
+    qisx::Image indexed = Decode(palette.data(), palette.size());
+    const uint8_t indexedExpected[] = { 10, 20, 30, 255, 40, 50, 60, 128 };
+    EXPECT_EQ(0, std::memcmp(indexed.Data(), indexedExpected, sizeof(indexedExpected)));
+
+    // 16-bit RGB keeps the high byte; Sub filter exercises the 6-byte stride
+    const std::vector<uint8_t> rgb16 = MakePng(2, 1, 16, 2, false,
+        { 1, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00 });
+    qisx::Image deep = Decode(rgb16.data(), rgb16.size());
+    const uint8_t deepExpected[] = { 0x12, 0x56, 0x9A, 255, 0x13, 0x58, 0x9D, 255 };
+    EXPECT_EQ(0, std::memcmp(deep.Data(), deepExpected, sizeof(deepExpected)));
+}
+
+TEST(ImageDecoderTests, PngDeinterlacesAdam7)
+{
+    const uint32_t width = 11, height = 9;
+    auto value = [](uint32_t x, uint32_t y) { return uint8_t(y * 16 + x); };
+
+    const uint32_t passes[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+        { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+    std::vector<uint8_t> scanlines;
+    for (const auto& p : passes) {
+        for (uint32_t y = p[1]; y < height; y += p[3]) {
+            if (p[0] >= width)
+                break;
+            scanlines.push_back(0);
+            for (uint32_t x = p[0]; x < width; x += p[2])
+                scanlines.push_back(value(x, y));
+        }
+    }
+
+    const std::vector<uint8_t> png = MakePng(width, height, 8, 0, true, scanlines);
+    qisx::Image image = Decode(png.data(), png.size());
+    ASSERT_EQ(image.Width(), width);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++)
+            ASSERT_EQ(image.View().Row(y)[x * 4], value(x, y)) << x << "," << y;
+    }
+}
+
+TEST(ImageDecoderTests, PngRejectsCorruptData)
+{
+    qisx::Image image(4, 4);
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(qisx::EncodePng(image.View(), png));
+    png[png.size() - 20] ^= 0x55;   // Inside the compressed data / Adler-32
+
+    std::string error;
+    qisx::Image decoded;
+    EXPECT_FALSE(qisx::DecodeImage(png.data(), png.size(), decoded, &error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(ImageDecoderTests, JpegBaselineAndProgressiveDecodeIdentically)
+{
+    qisx::Image baseline = Decode(kBaselineJpeg, sizeof(kBaselineJpeg));
+    qisx::Image progressive = Decode(kProgressiveJpeg, sizeof(kProgressiveJpeg));
+    ASSERT_EQ(baseline.Width(), 32u);
+    ASSERT_EQ(baseline.Height(), 16u);
+    ASSERT_EQ(progressive.Width(), 32u);
+
+    // Same quantised coefficients, only the entropy coding differs
+    EXPECT_EQ(0, std::memcmp(baseline.Data(), progressive.Data(), baseline.SizeInBytes()));
+
+    int worst = 0;
+    for (uint32_t y = 0; y < 16; y++) {
+        for (uint32_t x = 0; x < 32; x++) {
+            const uint8_t* p = baseline.View().Row(y) + x * 4;
+            worst = std::max({ worst, std::abs(p[0] - int(x * 8)), std::abs(p[1] - int(y * 16)), std::abs(p[2] - 128) });
+            EXPECT_EQ(p[3], 255);
+        }
+    }
+    EXPECT_LE(worst, 12);
+}
+
+TEST(ImageDecoderTests, JpegReadsInfoAndRejectsTruncation)
+{
+    const qisx::ImageDecoder* decoder = qisx::FindImageDecoder(kProgressiveJpeg, sizeof(kProgressiveJpeg));
+    ASSERT_NE(decoder, nullptr);
+    qisx::ImageInfo info;
+    ASSERT_TRUE(decoder->ReadInfo(kProgressiveJpeg, sizeof(kProgressiveJpeg), info, nullptr));
+    EXPECT_EQ(info.width, 32u);
+    EXPECT_EQ(info.height, 16u);
+
+    qisx::Image image;
+    std::string error;
+    EXPECT_FALSE(qisx::DecodeImage(kBaselineJpeg, 200, image, &error));
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,286 @@
+#include "ImageIO.h"
+#include "ImageDecoder.h"
+#include "MappedFile.h"
+#include "Zlib.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace qisx {
+
+namespace {
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+    void PutBE32(std::vector<uint8_t>& out, uint32_t v)
+    {
+        out.push_back(uint8_t(v >> 24));
+        out.push_back(uint8_t(v >> 16));
+        out.push_back(uint8_t(v >> 8));
+        out.push_back(uint8_t(v));
+    }
+
+    void PutChunk(std::vector<uint8_t>& out, const char type[4], const uint8_t* payload, size_t size)
+    {
+        PutBE32(out, uint32_t(size));
+        const size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), payload, payload + size);
+        PutBE32(out, Crc32(&out[start], size + 4));
+    }
+
+    inline uint8_t Paeth(int a, int b, int c)
+    {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return uint8_t(a);
+        return uint8_t(pb <= pc ? b : c);
+    }
+
+    // Filters one RGBA8 row with PNG filter `type` (0-4) into out.
+    void FilterRow(int type, const uint8_t* row, const uint8_t* above, size_t bytes, uint8_t* out)
+    {
+        for (size_t i = 0; i < bytes; i++) {
+            const int a = i >= 4 ? row[i - 4] : 0;
+            const int b = above ? above[i] : 0;
+            const int c = (above && i >= 4) ? above[i - 4] : 0;
+            int predicted = 0;
+            switch (type) {
+            case 1: predicted = a; break;
+            case 2: predicted = b; break;
+            case 3: predicted = (a + b) >> 1; break;
+            case 4: predicted = Paeth(a, b, c); break;
+            default: break;
+            }
+            out[i] = uint8_t(row[i] - predicted);
+        }
+    }
+
+}
+
+ImageFileFormat DetectImageFormat(const uint8_t* data, size_t size)
+{
+    static const uint8_t kPngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (size >= 8 && std::memcmp(data, kPngSignature, 8) == 0)
+        return ImageFileFormat::Png;
+    if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+        return ImageFileFormat::Jpeg;
+    if (size >= 3 && data[0] == 'P' && data[1] == '7' && std::isspace(data[2]))
+        return ImageFileFormat::Pam;
+    if (size >= 3 && data[0] == 'P' && data[1] == '6' && std::isspace(data[2]))
+        return ImageFileFormat::Ppm;
+    return ImageFileFormat::Unknown;
+}
+
+ImageFileFormat ImageFormatFromExtension(const std::string& path)
+{
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos)
+        return ImageFileFormat::Unknown;
+
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    if (ext == "png")
+        return ImageFileFormat::Png;
+    if (ext == "jpg" || ext == "jpeg")
+        return ImageFileFormat::Jpeg;
+    if (ext == "pam")
+        return ImageFileFormat::Pam;
+    if (ext == "ppm")
+        return ImageFileFormat::Ppm;
+    return ImageFileFormat::Unknown;
+}
+
+bool DecodeImage(const uint8_t* data, size_t size, Image& image, std::string* error)
+{
+    return DecodeImageInto(data, size, [&](const ImageInfo& info, MutableImageView& dst) {
+        image = Image(info.width, info.height);
+        dst = image.MutableView();
+        return true;
+    }, error);
+}
+
+bool LoadImageFile(const std::string& path, Image& image, std::string* error)
+{
+    return LoadImageFileInto(path, [&](const ImageInfo& info, MutableImageView& dst) {
+        image = Image(info.width, info.height);
+        dst = image.MutableView();
+        return true;
+    }, nullptr, error);
+}
+
+bool DecodeImageInto(const uint8_t* data, size_t size, const ImageDestination& destination, std::string* error)
+{
+    const ImageDecoder* decoder = FindImageDecoder(data, size);
+    if (!decoder) {
+        SetError(error, "unrecognised image format");
+        return false;
+    }
+
+    ImageInfo info;
+    if (!decoder->ReadInfo(data, size, info, error))
+        return false;
+    MutableImageView dst;
+    if (!destination(info, dst)) {
+        SetError(error, "no destination for the decoded image");
+        return false;
+    }
+    if (dst.width != info.width || dst.height != info.height || !dst.data || dst.rowPitch < size_t(info.width) * 4) {
+        SetError(error, "destination does not match the image size");
+        return false;
+    }
+    return decoder->Decode(data, size, dst, error);
+}
+
+bool LoadImageFileInto(const std::string& path, const ImageDestination& destination,
+    ImageLoadStats* stats, std::string* error)
+{
+    ImageLoadStats local;
+    ImageLoadStats& s = stats ? *stats : local;
+    s = ImageLoadStats{};
+
+    MappedFile file;
+    if (file.Open(path)) {
+        s.fileBytes = file.Size();
+        s.mapped = true;
+        return DecodeImageInto(file.Data(), file.Size(), destination, error);
+    }
+
+    std::vector<uint8_t> bytes;
+    if (!ReadFileBytes(path, bytes)) {
+        SetError(error, "cannot read file");
+        return false;
+    }
+    s.fileBytes = bytes.size();
+    s.bytesCopied = bytes.size();
+    return DecodeImageInto(bytes.data(), bytes.size(), destination, error);
+}
+
+bool EncodePng(const ImageView& image, std::vector<uint8_t>& out)
+{
+    if (image.Empty())
+        return false;
+
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.insert(out.end(), kSignature, kSignature + 8);
+
+    uint8_t ihdr[13];
+    ihdr[0] = uint8_t(image.width >> 24); ihdr[1] = uint8_t(image.width >> 16);
+    ihdr[2] = uint8_t(image.width >> 8);  ihdr[3] = uint8_t(image.width);
+    ihdr[4] = uint8_t(image.height >> 24); ihdr[5] = uint8_t(image.height >> 16);
+    ihdr[6] = uint8_t(image.height >> 8);  ihdr[7] = uint8_t(image.height);
+    ihdr[8] = 8;    // Bit depth
+    ihdr[9] = 6;    // RGBA
+    ihdr[10] = 0;   // Deflate
+    ihdr[11] = 0;   // Adaptive filtering
+    ihdr[12] = 0;   // No interlace
+    PutChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+    // Per row, keep the filter with the smallest sum of absolute residuals
+    const size_t rowBytes = size_t(image.width) * 4;
+    std::vector<uint8_t> filtered(size_t(image.height) * (rowBytes + 1));
+    std::vector<uint8_t> candidate(rowBytes);
+    for (uint32_t y = 0; y < image.height; y++) {
+        const uint8_t* row = image.Row(y);
+        const uint8_t* above = y > 0 ? image.Row(y - 1) : nullptr;
+        uint8_t* dst = &filtered[size_t(y) * (rowBytes + 1)];
+
+        uint64_t bestCost = UINT64_MAX;
+        for (int type = 0; type <= 4; type++) {
+            FilterRow(type, row, above, rowBytes, candidate.data());
+            uint64_t cost = 0;
+            for (uint8_t v : candidate)
+                cost += v < 128 ? v : 256 - v;
+            if (cost < bestCost) {
+                bestCost = cost;
+                dst[0] = uint8_t(type);
+                std::memcpy(dst + 1, candidate.data(), rowBytes);
+            }
+        }
+    }
+
+    std::vector<uint8_t> compressed;
+    ZlibCompress(filtered.data(), filtered.size(), compressed);
+    PutChunk(out, "IDAT", compressed.data(), compressed.size());
+    PutChunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
+bool EncodePam(const ImageView& image, std::vector<uint8_t>& out)
+{
+    if (image.Empty())
+        return false;
+
+    char header[128];
+    const int length = snprintf(header, sizeof(header),
+        "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", image.width, image.height);
+    out.insert(out.end(), header, header + length);
+    for (uint32_t y = 0; y < image.height; y++)
+        out.insert(out.end(), image.Row(y), image.Row(y) + size_t(image.width) * 4);
+    return true;
+}
+
+bool SaveImageFile(const std::string& path, const ImageView& image, std::string* error)
+{
+    std::vector<uint8_t> bytes;
+    bool encoded = false;
+    switch (ImageFormatFromExtension(path)) {
+    case ImageFileFormat::Png:
+        encoded = EncodePng(image, bytes);
+        break;
+    case ImageFileFormat::Pam:
+        encoded = EncodePam(image, bytes);
+        break;
+    default:
+        SetError(error, "unsupported output format (use .png or .pam)");
+        return false;
+    }
+
+    if (!encoded) {
+        SetError(error, "cannot encode an empty image");
+        return false;
+    }
+    if (!WriteFileBytes(path, bytes)) {
+        SetError(error, "cannot write file");
+        return false;
+    }
+    return true;
+}
+
+bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& bytes)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    const long size = ok ? ftell(f) : -1;
+    ok = ok && size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        bytes.resize(size_t(size));
+        ok = fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+bool WriteFileBytes(const std::string& path, const std::vector<uint8_t>& bytes)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    // An empty vector's data() may be null, which fwrite must not be given
+    const bool ok = bytes.empty() || fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return (fclose(f) == 0) && ok;
+}
+
+}
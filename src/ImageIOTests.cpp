@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+#include "ImageIO.h"
+#include "MappedFile.h"
+#include "Zlib.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+namespace {
+
+    std::vector<uint8_t> Bytes(const std::string& s)
+    {
+        return std::vector<uint8_t>(s.begin(), s.end());
+    }
+
+    uint32_t ReadBE32(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+}
+
+TEST(ImageIOTests, ChecksumsMatchKnownVectors)
+{
+    const std::vector<uint8_t> digits = Bytes("123456789");
+    EXPECT_EQ(qisx::Crc32(digits.data(), digits.size()), 0xCBF43926u);
+
+    const std::vector<uint8_t> word = Bytes("Wikipedia");
+    EXPECT_EQ(qisx::Adler32(word.data(), word.size()), 0x11E60398u);
+}
+
+TEST(ImageIOTests, DetectsFormats)
+{
+    const uint8_t png[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    const uint8_t jpeg[] = { 0xFF, 0xD8, 0xFF, 0xE0 };
+    const std::vector<uint8_t> pam = Bytes("P7\nWIDTH 1\n");
+    const std::vector<uint8_t> ppm = Bytes("P6 1 1 255\n");
+
+    EXPECT_EQ(qisx::DetectImageFormat(png, sizeof(png)), qisx::ImageFileFormat::Png);
+    EXPECT_EQ(qisx::DetectImageFormat(jpeg, sizeof(jpeg)), qisx::ImageFileFormat::Jpeg);
+    EXPECT_EQ(qisx::DetectImageFormat(pam.data(), pam.size()), qisx::ImageFileFormat::Pam);
+    EXPECT_EQ(qisx::DetectImageFormat(ppm.data(), ppm.size()), qisx::ImageFileFormat::Ppm);
+    EXPECT_EQ(qisx::DetectImageFormat(jpeg, 2), qisx::ImageFileFormat::Unknown);
+
+    EXPECT_EQ(qisx::ImageFormatFromExtension("dir.v2/out.PNG"), qisx::ImageFileFormat::Png);
+    EXPECT_EQ(qisx::ImageFormatFromExtension("grid.jpeg"), qisx::ImageFileFormat::Jpeg);
+    EXPECT_EQ(qisx::ImageFormatFromExtension("noext"), qisx::ImageFileFormat::Unknown);
+}
+
+TEST(ImageIOTests, PamRoundTrips)
+{
+    qisx::Image image(5, 3);
+    for (size_t i = 0; i < image.SizeInBytes(); i++)
+        image.Data()[i] = uint8_t(i * 13);
+
+    std::vector<uint8_t> encoded;
+    ASSERT_TRUE(qisx::EncodePam(image.View(), encoded));
+
+    qisx::Image decoded;
+    ASSERT_TRUE(qisx::DecodeImage(encoded.data(), encoded.size(), decoded));
+    ASSERT_EQ(decoded.Width(), 5u);
+    ASSERT_EQ(decoded.Height(), 3u);
+    EXPECT_EQ(0, std::memcmp(decoded.Data(), image.Data(), image.SizeInBytes()));
+}
+
+TEST(ImageIOTests, PpmExpandsToOpaqueRgba)
+{
+    std::vector<uint8_t> ppm = Bytes("P6\n# comment\n2 1\n255\n");
+    const uint8_t pixels[] = { 1, 2, 3, 250, 251, 252 };
+    ppm.insert(ppm.end(), pixels, pixels + sizeof(pixels));
+
+    qisx::Image image;
+    ASSERT_TRUE(qisx::DecodeImage(ppm.data(), ppm.size(), image));
+    ASSERT_EQ(image.Width(), 2u);
+    const uint8_t expected[] = { 1, 2, 3, 255, 250, 251, 252, 255 };
+    EXPECT_EQ(0, std::memcmp(image.Data(), expected, sizeof(expected)));
+}
+
+TEST(ImageIOTests, RejectsTruncatedInput)
+{
+    std::vector<uint8_t> ppm = Bytes("P6 4 4 255\n");
+    ppm.resize(ppm.size() + 10);
+
+    qisx::Image image;
+    std::string error;
+    EXPECT_FALSE(qisx::DecodeImage(ppm.data(), ppm.size(), image, &error));
+    EXPECT_FALSE(error.empty());
+}
+
+// Chunk framing and CRCs; pixel round trips are in ImageDecoderTests.
+TEST(ImageIOTests, PngChunksAreWellFormed)
+{
+    qisx::Image image(33, 17);
+    for (size_t i = 0; i < image.SizeInBytes(); i++)
+        image.Data()[i] = uint8_t((i / 4) % 7 * 30);
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(qisx::EncodePng(image.View(), png));
+    ASSERT_EQ(qisx::DetectImageFormat(png.data(), png.size()), qisx::ImageFileFormat::Png);
+
+    std::vector<std::string> chunks;
+    size_t pos = 8;
+    while (pos + 12 <= png.size()) {
+        const uint32_t length = ReadBE32(&png[pos]);
+        ASSERT_LE(pos + 12 + length, png.size());
+        chunks.emplace_back(reinterpret_cast<const char*>(&png[pos + 4]), 4);
+        EXPECT_EQ(qisx::Crc32(&png[pos + 4], length + 4), ReadBE32(&png[pos + 8 + length])) << chunks.back();
+        if (chunks.back() == "IHDR") {
+            EXPECT_EQ(ReadBE32(&png[pos + 8]), 33u);
+            EXPECT_EQ(ReadBE32(&png[pos + 12]), 17u);
+        }
+        pos += 12 + length;
+    }
+    EXPECT_EQ(pos, png.size());
+    EXPECT_EQ(chunks, (std::vector<std::string>{ "IHDR", "IDAT", "IEND" }));
+}
+
+TEST(ImageIOTests, LoadsMappedFileIntoCallerBuffer)
+{
+    qisx::Image image(21, 9);
+    for (size_t i = 0; i < image.SizeInBytes(); i++)
+        image.Data()[i] = uint8_t(i * 13 + 5);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "qisx_mapped_load.png";
+    ASSERT_TRUE(qisx::SaveImageFile(path.string(), image.View()));
+
+    // Padded rows, like an upload heap; the padding must be left alone
+    const size_t pitch = 21 * 4 + 12;
+    std::vector<uint8_t> buffer(pitch * 9, 0xEE);
+    qisx::ImageLoadStats stats;
+    std::string error;
+    ASSERT_TRUE(qisx::LoadImageFileInto(path.string(), [&](const qisx::ImageInfo& info, qisx::MutableImageView& dst) {
+        dst = { buffer.data(), info.width, info.height, pitch };
+        return true;
+    }, &stats, &error)) << error;
+
+    EXPECT_TRUE(stats.mapped);
+    EXPECT_EQ(stats.bytesCopied, 0u);
+    EXPECT_EQ(stats.fileBytes, std::filesystem::file_size(path));
+    for (uint32_t y = 0; y < 9; y++) {
+        EXPECT_EQ(0, std::memcmp(&buffer[y * pitch], image.View().Row(y), 21 * 4)) << "row " << y;
+        EXPECT_EQ(buffer[y * pitch + 21 * 4], 0xEE);
+        EXPECT_EQ(buffer[y * pitch + pitch - 1], 0xEE);
+    }
+
+    // A destination of the wrong size is refused rather than overrun
+    std::vector<uint8_t> small(20 * 9 * 4);
+    EXPECT_FALSE(qisx::LoadImageFileInto(path.string(), [&](const qisx::ImageInfo& info, qisx::MutableImageView& dst) {
+        dst = { small.data(), 20, info.height, 20 * 4 };
+        return true;
+    }, nullptr, &error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(ImageIOTests, MapsEmptyAndMissingFiles)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "qisx_mapped_empty.bin";
+    ASSERT_TRUE(qisx::WriteFileBytes(path.string(), {}));
+
+    qisx::MappedFile file;
+    ASSERT_TRUE(file.Open(path.string()));
+    EXPECT_EQ(file.Size(), 0u);
+    EXPECT_EQ(file.Data(), nullptr);
+
+    qisx::MappedFile moved = std::move(file);
+    EXPECT_TRUE(moved.IsOpen());
+    EXPECT_FALSE(file.IsOpen());
+
+    std::string error;
+    EXPECT_FALSE(file.Open((path.parent_path() / "qisx_no_such_file.bin").string(), &error));
+    EXPECT_FALSE(error.empty());
+
+    qisx::Image image;
+    EXPECT_FALSE(qisx::LoadImageFile(path.string(), image, &error));
+}
@@ -0,0 +1,57 @@
+#include "JitterSequence.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+void JitterSample::ProjectionDelta(const float projection[16], float delta[16]) const
+{
+    // (x, y, z, w) * (M + D) = clip + w' * (clipX, clipY, 0, 0), where w' is the
+    // clip w the fourth column of M produces
+    for (int r = 0; r < 4; r++) {
+        const float w = projection[r * 4 + 3];
+        delta[r * 4 + 0] = clipX * w;
+        delta[r * 4 + 1] = clipY * w;
+        delta[r * 4 + 2] = 0.0f;
+        delta[r * 4 + 3] = 0.0f;
+    }
+}
+
+float Halton(uint32_t index, uint32_t base)
+{
+    float result = 0.0f;
+    float f = 1.0f;
+    while (index > 0) {
+        f /= float(base);
+        result += f * float(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+uint32_t JitterSequence::PhaseCount(uint32_t renderWidth, uint32_t displayWidth)
+{
+    const float ratio = float(std::max(displayWidth, 1u)) / float(std::max(renderWidth, 1u));
+    return std::max(8u, uint32_t(std::ceil(8.0f * ratio * ratio)));
+}
+
+void JitterSequence::Configure(uint32_t renderWidth, uint32_t renderHeight, uint32_t displayWidth)
+{
+    m_renderWidth = std::max(renderWidth, 1u);
+    m_renderHeight = std::max(renderHeight, 1u);
+    m_phaseCount = PhaseCount(renderWidth, displayWidth);
+    m_frame = 0;
+}
+
+JitterSample JitterSequence::Get(uint64_t frame) const
+{
+    JitterSample sample;
+    sample.phase = uint32_t(frame % m_phaseCount);
+    sample.x = Halton(sample.phase + 1, 2) - 0.5f;
+    sample.y = Halton(sample.phase + 1, 3) - 0.5f;
+    sample.clipX = 2.0f * sample.x / float(m_renderWidth);
+    sample.clipY = -2.0f * sample.y / float(m_renderHeight);
+    return sample;
+}
+
+}
@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "JitterSequence.h"
+
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace {
+
+    // Row vector times row-major matrix
+    void Transform(const float v[4], const float m[16], float out[4])
+    {
+        for (int c = 0; c < 4; c++)
+            out[c] = v[0] * m[c] + v[1] * m[4 + c] + v[2] * m[8 + c] + v[3] * m[12 + c];
+    }
+
+}
+
+TEST(JitterSequenceTests, HaltonValues)
+{
+    EXPECT_FLOAT_EQ(qisx::Halton(1, 2), 0.5f);
+    EXPECT_FLOAT_EQ(qisx::Halton(2, 2), 0.25f);
+    EXPECT_FLOAT_EQ(qisx::Halton(3, 2), 0.75f);
+    EXPECT_FLOAT_EQ(qisx::Halton(6, 2), 0.375f);
+    EXPECT_FLOAT_EQ(qisx::Halton(1, 3), 1.0f / 3.0f);
+    EXPECT_FLOAT_EQ(qisx::Halton(2, 3), 2.0f / 3.0f);
+    EXPECT_FLOAT_EQ(qisx::Halton(3, 3), 1.0f / 9.0f);
+    EXPECT_FLOAT_EQ(qisx::Halton(0, 3), 0.0f);
+}
+
+TEST(JitterSequenceTests, PhaseCountFollowsScaleRatio)
+{
+    EXPECT_EQ(qisx::JitterSequence::PhaseCount(1280, 1280), 8u);
+    EXPECT_EQ(qisx::JitterSequence::PhaseCount(854, 1280), 18u);    // 1.5x
+    EXPECT_EQ(qisx::JitterSequence::PhaseCount(960, 1920), 32u);    // 2x
+    EXPECT_EQ(qisx::JitterSequence::PhaseCount(640, 1920), 72u);    // 3x
+    EXPECT_EQ(qisx::JitterSequence::PhaseCount(1920, 1280), 8u);    // Downscaling keeps the minimum
+}
+
+TEST(JitterSequenceTests, SequenceCyclesThroughDistinctOffsets)
+{
+    qisx::JitterSequence sequence(960, 540, 1920);
+    const uint32_t phases = sequence.GetPhaseCount();
+
+    std::set<std::pair<float, float>> seen;
+    uint32_t quadrants[4] = {};
+    for (uint32_t i = 0; i < phases; i++) {
+        const qisx::JitterSample sample = sequence.Next();
+        EXPECT_EQ(sample.phase, i);
+        EXPECT_GE(sample.x, -0.5f);
+        EXPECT_LT(sample.x, 0.5f);
+        EXPECT_GE(sample.y, -0.5f);
+        EXPECT_LT(sample.y, 0.5f);
+        EXPECT_FLOAT_EQ(sample.clipX, 2.0f * sample.x / 960.0f);
+        EXPECT_FLOAT_EQ(sample.clipY, -2.0f * sample.y / 540.0f);
+        seen.insert({ sample.x, sample.y });
+        // At 2x each render pixel covers 2x2 display pixels; all four get samples
+        quadrants[(sample.x >= 0.0f) + 2 * (sample.y >= 0.0f)]++;
+    }
+    EXPECT_EQ(seen.size(), phases);
+    for (uint32_t count : quadrants)
+        EXPECT_GE(count, phases / 8) << "quadrant starved";
+
+    // The next frame starts the cycle again
+    const qisx::JitterSample wrapped = sequence.Next();
+    EXPECT_EQ(wrapped.phase, 0u);
+    EXPECT_EQ(wrapped.x, sequence.Get(0).x);
+    EXPECT_EQ(wrapped.y, sequence.Get(0).y);
+
+    sequence.Reset();
+    EXPECT_EQ(sequence.GetFrameIndex(), 0u);
+}
+
+TEST(JitterSequenceTests, ProjectionDeltaShiftsNdcByTheClipOffset)
+{
+    // DirectX left-handed perspective (fov 60 degrees, 16:9, near 0.1, far 100)
+    // and orthographic projections
+    const float yScale = 1.0f / std::tan(0.5236f);
+    const float xScale = yScale / (16.0f / 9.0f);
+    const float range = 100.0f / (100.0f - 0.1f);
+    const float perspective[16] = {
+        xScale, 0, 0, 0,
+        0, yScale, 0, 0,
+        0, 0, range, 1,
+        0, 0, -range * 0.1f, 0,
+    };
+    const float orthographic[16] = {
+        2.0f / 16.0f, 0, 0, 0,
+        0, 2.0f / 9.0f, 0, 0,
+        0, 0, 1.0f / 100.0f, 0,
+        0, 0, 0, 1,
+    };
+
+    const qisx::JitterSequence sequence(854, 480, 1280);
+    const float points[][4] = { { 0, 0, 1, 1 }, { 3, -2, 10, 1 }, { -1, 0.5f, 50, 1 } };
+    for (const float* projection : { perspective, orthographic }) {
+        for (uint32_t frame = 0; frame < 4; frame++) {
+            const qisx::JitterSample sample = sequence.Get(frame);
+            float delta[16], jittered[16];
+            sample.ProjectionDelta(projection, delta);
+            for (int i = 0; i < 16; i++)
+                jittered[i] = projection[i] + delta[i];
+
+            for (const float* point : points) {
+                float before[4], after[4];
+                Transform(point, projection, before);
+                Transform(point, jittered, after);
+                EXPECT_NEAR(after[0] / after[3] - before[0] / before[3], sample.clipX, 1e-6f);
+                EXPECT_NEAR(after[1] / after[3] - before[1] / before[3], sample.clipY, 1e-6f);
+                EXPECT_FLOAT_EQ(after[2], before[2]);
+                EXPECT_FLOAT_EQ(after[3], before[3]);
+            }
+        }
+    }
+}
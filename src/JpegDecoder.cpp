@@ -0,0 +1,1037 @@
+#include "ImageDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace qisx {
+
+namespace {
+
+    // Natural index of the k-th coefficient in zig-zag order
+    const uint8_t kZigZag[64] = {
+        0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    };
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+    inline uint8_t Clamp8(int64_t v)
+    {
+        return uint8_t(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    // Entropy-coded segment reader: MSB-first bits, 0xFF00 unstuffing, and a stop
+    // at the first marker (after which it feeds zeros).
+    class JpegBitReader {
+    public:
+        void Reset(const uint8_t* data, size_t size, size_t pos)
+        {
+            m_data = data;
+            m_size = size;
+            m_pos = pos;
+            m_bits = 0;
+            m_count = 0;
+            m_marker = 0;
+        }
+
+        void Fill()
+        {
+            while (m_count <= 24) {
+                uint32_t byte = 0;
+                if (!m_marker && m_pos < m_size) {
+                    byte = m_data[m_pos++];
+                    if (byte == 0xFF) {
+                        size_t next = m_pos;
+                        while (next < m_size && m_data[next] == 0xFF)
+                            next++;
+                        const uint8_t code = next < m_size ? m_data[next] : 0xD9;
+                        if (code == 0x00) {
+                            m_pos = next + 1;
+                        }
+                        else {
+                            // Leave m_pos on the marker's 0xFF for the segment parser
+                            m_marker = code;
+                            m_pos = next - 1;
+                            byte = 0;
+                        }
+                    }
+                }
+                m_bits |= byte << (24 - m_count);
+                m_count += 8;
+            }
+        }
+
+        int Bits(int n)
+        {
+            if (n == 0)
+                return 0;
+            if (m_count < n)
+                Fill();
+            const int v = int(m_bits >> (32 - n));
+            m_bits <<= n;
+            m_count -= n;
+            return v;
+        }
+
+        int Bit() { return Bits(1); }
+
+        // Next n bits as a signed coefficient (JPEG "receive + extend")
+        int Signed(int n)
+        {
+            if (n == 0)
+                return 0;
+            const int v = Bits(n);
+            return v < (1 << (n - 1)) ? v - (1 << n) + 1 : v;
+        }
+
+        uint32_t Peek16()
+        {
+            if (m_count < 16)
+                Fill();
+            return m_bits >> 16;
+        }
+
+        uint32_t BitBuffer() const { return m_bits; }
+        int Count() const { return m_count; }
+        void Consume(int n)
+        {
+            m_bits <<= n;
+            m_count -= n;
+        }
+
+        // Discards buffered bits and consumes an RSTn marker at the current position
+        bool Restart()
+        {
+            m_bits = 0;
+            m_count = 0;
+            if (!m_marker) {
+                // Skip to the next marker (corrupt data or padding before RST)
+                while (m_pos + 1 < m_size && !(m_data[m_pos] == 0xFF && m_data[m_pos + 1] != 0 && m_data[m_pos + 1] != 0xFF))
+                    m_pos++;
+                if (m_pos + 1 >= m_size)
+                    return false;
+                m_marker = m_data[m_pos + 1];
+            }
+            if (m_marker < 0xD0 || m_marker > 0xD7)
+                return false;
+            m_pos += 2;
+            m_marker = 0;
+            return true;
+        }
+
+        // Position of the marker that ended the segment
+        size_t MarkerPosition()
+        {
+            if (!m_marker) {
+                while (m_pos + 1 < m_size && !(m_data[m_pos] == 0xFF && m_data[m_pos + 1] != 0
+                    && m_data[m_pos + 1] != 0xFF && (m_data[m_pos + 1] < 0xD0 || m_data[m_pos + 1] > 0xD7)))
+                    m_pos++;
+            }
+            return m_pos;
+        }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_pos = 0;
+        uint32_t m_bits = 0;
+        int m_count = 0;
+        uint8_t m_marker = 0;
+    };
+
+    class JpegHuffman {
+    public:
+        static constexpr int kFastBits = 9;
+
+        bool Build(const uint8_t counts[16], const uint8_t* symbols, int total)
+        {
+            std::memcpy(m_values, symbols, size_t(total));
+            int k = 0;
+            for (int len = 1; len <= 16; len++) {
+                for (int i = 0; i < counts[len - 1]; i++)
+                    m_size[k++] = uint8_t(len);
+            }
+            m_size[k] = 0;
+
+            int code = 0;
+            k = 0;
+            for (int len = 1; len <= 16; len++) {
+                m_delta[len] = k - code;
+                while (m_size[k] == len)
+                    m_code[k++] = uint16_t(code++);
+                if (code - 1 >= (1 << len))
+                    return false;
+                m_maxCode[len] = uint32_t(code) << (16 - len);
+                code <<= 1;
+            }
+            m_maxCode[17] = 0xFFFFFFFFu;
+
+            std::memset(m_fast, 0xFF, sizeof(m_fast));
+            for (int i = 0; i < k; i++) {
+                const int len = m_size[i];
+                if (len <= kFastBits) {
+                    const int first = m_code[i] << (kFastBits - len);
+                    const int span = 1 << (kFastBits - len);
+                    for (int j = 0; j < span; j++)
+                        m_fast[first + j] = uint8_t(i);
+                }
+            }
+            m_present = true;
+            return true;
+        }
+
+        bool Present() const { return m_present; }
+
+        // Returns the decoded symbol or -1
+        int Decode(JpegBitReader& reader) const
+        {
+            const uint32_t peek = reader.Peek16();
+            const int fast = m_fast[peek >> (16 - kFastBits)];
+            if (fast != 0xFF) {
+                const int len = m_size[fast];
+                if (len > reader.Count())
+                    return -1;
+                reader.Consume(len);
+                return m_values[fast];
+            }
+
+            int len = kFastBits + 1;
+            while (peek >= m_maxCode[len])
+                len++;
+            if (len > 16 || len > reader.Count())
+                return -1;
+            const int index = int(peek >> (16 - len)) + m_delta[len];
+            if (index < 0 || index >= 256)
+                return -1;
+            reader.Consume(len);
+            return m_values[index];
+        }
+
+    private:
+        uint8_t m_fast[1 << kFastBits];
+        uint16_t m_code[256];
+        uint8_t m_values[256];
+        uint8_t m_size[257];
+        uint32_t m_maxCode[18];
+        int m_delta[17];
+        bool m_present = false;
+    };
+
+    // Integer 8x8 inverse DCT: the Loeffler/Ligtenberg/Moschytz "islow" algorithm
+    // with 13-bit constants and 2 extra bits between passes, so the rounding is
+    // the same as libjpeg's default IDCT. Dequantises in int as it goes.
+    constexpr int kConstBits = 13;
+    constexpr int kPass1Bits = 2;
+    constexpr int Fix(double x) { return x < 0 ? -int(-x * (1 << kConstBits) + 0.5) : int(x * (1 << kConstBits) + 0.5); }
+
+    // 64-bit intermediates: valid streams fit in 32 bits (as in libjpeg), but
+    // corrupt coefficients must not overflow.
+    using IdctInt = int64_t;
+
+    #define QISX_IDCT_1D(s0, s1, s2, s3, s4, s5, s6, s7)                     \
+        IdctInt p2 = s2, p3 = s6;                                           \
+        IdctInt p1 = (p2 + p3) * Fix(0.5411961);                            \
+        IdctInt t2 = p1 + p3 * Fix(-1.847759065);                           \
+        IdctInt t3 = p1 + p2 * Fix(0.765366865);                            \
+        p2 = s0;                                                            \
+        p3 = s4;                                                            \
+        IdctInt t0 = (p2 + p3) * (1 << kConstBits);                         \
+        IdctInt t1 = (p2 - p3) * (1 << kConstBits);                         \
+        const IdctInt x0 = t0 + t3, x3 = t0 - t3, x1 = t1 + t2, x2 = t1 - t2; \
+        t0 = s7; t1 = s5; t2 = s3; t3 = s1;                                 \
+        p3 = t0 + t2;                                                       \
+        IdctInt p4 = t1 + t3;                                               \
+        p1 = t0 + t3;                                                       \
+        p2 = t1 + t2;                                                       \
+        const IdctInt p5 = (p3 + p4) * Fix(1.175875602);                    \
+        t0 *= Fix(0.298631336);                                             \
+        t1 *= Fix(2.053119869);                                             \
+        t2 *= Fix(3.072711026);                                             \
+        t3 *= Fix(1.501321110);                                             \
+        p1 = p5 + p1 * Fix(-0.899976223);                                   \
+        p2 = p5 + p2 * Fix(-2.562915447);                                   \
+        p3 *= Fix(-1.961570560);                                            \
+        p4 *= Fix(-0.390180644);                                            \
+        t3 += p1 + p4;                                                      \
+        t2 += p2 + p3;                                                      \
+        t1 += p2 + p4;                                                      \
+        t0 += p1 + p3;
+
+    void InverseDct(const int16_t in[64], const uint16_t quant[64], uint8_t* out, size_t stride)
+    {
+        IdctInt tmp[64];
+        for (int i = 0; i < 8; i++) {
+            const int16_t* c = in + i;
+            const uint16_t* q = quant + i;
+            IdctInt* v = tmp + i;
+            if (!c[8] && !c[16] && !c[24] && !c[32] && !c[40] && !c[48] && !c[56]) {
+                const IdctInt dc = IdctInt(c[0]) * q[0] * (1 << kPass1Bits);
+                v[0] = v[8] = v[16] = v[24] = v[32] = v[40] = v[48] = v[56] = dc;
+                continue;
+            }
+            QISX_IDCT_1D(c[0] * q[0], c[8] * q[8], c[16] * q[16], c[24] * q[24], c[32] * q[32], c[40] * q[40], c[48] * q[48],
+                c[56] * q[56])
+            constexpr int shift = kConstBits - kPass1Bits;
+            constexpr int round = 1 << (shift - 1);
+            const IdctInt r0 = x0 + round, r1 = x1 + round, r2 = x2 + round, r3 = x3 + round;
+            v[0] = (r0 + t3) >> shift;
+            v[56] = (r0 - t3) >> shift;
+            v[8] = (r1 + t2) >> shift;
+            v[48] = (r1 - t2) >> shift;
+            v[16] = (r2 + t1) >> shift;
+            v[40] = (r2 - t1) >> shift;
+            v[24] = (r3 + t0) >> shift;
+            v[32] = (r3 - t0) >> shift;
+        }
+
+        for (int i = 0; i < 8; i++, out += stride) {
+            const IdctInt* v = tmp + i * 8;
+            if (!v[1] && !v[2] && !v[3] && !v[4] && !v[5] && !v[6] && !v[7]) {
+                // Flat row: same rounding as the full pass below
+                std::memset(out, Clamp8(((v[0] + (1 << (kPass1Bits + 2))) >> (kPass1Bits + 3)) + 128), 8);
+                continue;
+            }
+            QISX_IDCT_1D(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7])
+            // Constant bits + carried bits + 3 from the two sqrt(8) scalings; +128 level shift
+            constexpr int shift = kConstBits + kPass1Bits + 3;
+            constexpr int bias = (1 << (shift - 1)) + (128 << shift);
+            const IdctInt r0 = x0 + bias, r1 = x1 + bias, r2 = x2 + bias, r3 = x3 + bias;
+            out[0] = Clamp8((r0 + t3) >> shift);
+            out[7] = Clamp8((r0 - t3) >> shift);
+            out[1] = Clamp8((r1 + t2) >> shift);
+            out[6] = Clamp8((r1 - t2) >> shift);
+            out[2] = Clamp8((r2 + t1) >> shift);
+            out[5] = Clamp8((r2 - t1) >> shift);
+            out[3] = Clamp8((r3 + t0) >> shift);
+            out[4] = Clamp8((r3 - t0) >> shift);
+        }
+    }
+
+    #undef QISX_IDCT_1D
+
+    struct JpegComponent {
+        int id = 0;
+        int h = 1;
+        int v = 1;
+        int quant = 0;
+        int dcTable = 0;
+        int acTable = 0;
+
+        uint32_t width = 0;         // Samples actually covered by the image
+        uint32_t height = 0;
+        uint32_t blocksWide = 0;    // Padded to whole MCUs
+        uint32_t blocksHigh = 0;
+
+        int dcPred = 0;
+        std::vector<uint8_t> plane;     // blocksWide*8 x blocksHigh*8 samples
+        std::vector<int16_t> coeffs;    // Progressive only: 64 per block
+
+        size_t Stride() const { return size_t(blocksWide) * 8; }
+        int16_t* Block(uint32_t bx, uint32_t by) { return &coeffs[(size_t(by) * blocksWide + bx) * 64]; }
+    };
+
+    // One decode. Holds all per-image state so the decoder object stays stateless.
+    class JpegDecodeState {
+    public:
+        JpegDecodeState(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        bool ReadHeaders(ImageInfo& info, std::string* error)
+        {
+            if (!ParseUntil(true, error))
+                return false;
+            info.width = m_width;
+            info.height = m_height;
+            return true;
+        }
+
+        bool Decode(const MutableImageView& dst, std::string* error)
+        {
+            if (!ParseUntil(false, error))
+                return false;
+            if (dst.width != m_width || dst.height != m_height) {
+                SetError(error, "destination size does not match the image");
+                return false;
+            }
+            if (m_progressive)
+                FinishProgressive();
+            WriteRgba(dst);
+            return true;
+        }
+
+    private:
+        int Read8() { return m_pos < m_size ? m_data[m_pos++] : 0; }
+        int Read16() { const int hi = Read8(); return (hi << 8) | Read8(); }
+
+        bool ParseUntil(bool headerOnly, std::string* error)
+        {
+            if (m_size < 4 || m_data[0] != 0xFF || m_data[1] != 0xD8) {
+                SetError(error, "not a JPEG file");
+                return false;
+            }
+            m_pos = 2;
+
+            for (;;) {
+                // Markers may be preceded by any number of 0xFF fill bytes
+                if (Read8() != 0xFF) {
+                    SetError(error, "corrupt JPEG marker stream");
+                    return false;
+                }
+                int marker = Read8();
+                while (marker == 0xFF)
+                    marker = Read8();
+                if (m_pos >= m_size && marker != 0xD9) {
+                    SetError(error, "truncated JPEG");
+                    return false;
+                }
+
+                if (marker == 0xD9)     // EOI
+                    break;
+                if (marker >= 0xD0 && marker <= 0xD7)
+                    continue;           // Stray RST
+
+                const size_t segmentStart = m_pos;
+                const int length = Read16();
+                if (length < 2 || segmentStart + size_t(length) > m_size) {
+                    SetError(error, "truncated JPEG segment");
+                    return false;
+                }
+                const size_t segmentEnd = segmentStart + size_t(length);
+
+                bool ok = true;
+                switch (marker) {
+                case 0xC0:
+                case 0xC1:
+                case 0xC2:
+                    ok = ReadFrame(marker == 0xC2, error);
+                    if (ok && headerOnly)
+                        return true;
+                    break;
+                case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+                case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                    SetError(error, "unsupported JPEG process (lossless/hierarchical/arithmetic)");
+                    return false;
+                case 0xC4:
+                    ok = ReadHuffmanTables(segmentEnd, error);
+                    break;
+                case 0xDB:
+                    ok = ReadQuantTables(segmentEnd, error);
+                    break;
+                case 0xDD:
+                    m_restartInterval = Read16();
+                    break;
+                case 0xEE:
+                    if (length >= 14 && !std::memcmp(m_data + m_pos, "Adobe", 5)) {
+                        m_adobe = true;
+                        m_adobeTransform = m_data[m_pos + 11];
+                    }
+                    break;
+                case 0xDA:
+                    if (headerOnly) {
+                        SetError(error, "scan before frame header");
+                        return false;
+                    }
+                    ok = ReadScan(error);
+                    if (ok)
+                        continue;   // m_pos already sits on the next marker
+                    break;
+                default:
+                    break;
+                }
+                if (!ok)
+                    return false;
+                m_pos = segmentEnd;
+            }
+
+            if (!m_frame || !m_scans) {
+                SetError(error, "JPEG has no image data");
+                return false;
+            }
+            return !headerOnly;
+        }
+
+        bool ReadFrame(bool progressive, std::string* error)
+        {
+            if (m_frame) {
+                SetError(error, "multiple frames");
+                return false;
+            }
+            m_progressive = progressive;
+            if (Read8() != 8) {
+                SetError(error, "only 8-bit JPEG is supported");
+                return false;
+            }
+            m_height = uint32_t(Read16());
+            m_width = uint32_t(Read16());
+            const int count = Read8();
+            if (m_width == 0 || m_height == 0) {
+                SetError(error, "JPEG with zero or deferred (DNL) height");
+                return false;
+            }
+            if (count != 1 && count != 3) {
+                SetError(error, "only greyscale and 3-component JPEG are supported");
+                return false;
+            }
+            if (uint64_t(m_width) * m_height > (uint64_t(1) << 29)) {
+                SetError(error, "JPEG too large");
+                return false;
+            }
+
+            m_components.resize(size_t(count));
+            for (JpegComponent& c : m_components) {
+                c.id = Read8();
+                const int sampling = Read8();
+                c.h = sampling >> 4;
+                c.v = sampling & 15;
+                c.quant = Read8();
+                if (c.h < 1 || c.h > 4 || c.v < 1 || c.v > 4 || c.quant > 3) {
+                    SetError(error, "bad JPEG component parameters");
+                    return false;
+                }
+                m_hMax = std::max(m_hMax, c.h);
+                m_vMax = std::max(m_vMax, c.v);
+            }
+
+            m_mcusWide = (m_width + 8 * m_hMax - 1) / (8 * m_hMax);
+            m_mcusHigh = (m_height + 8 * m_vMax - 1) / (8 * m_vMax);
+            for (JpegComponent& c : m_components) {
+                c.width = (m_width * c.h + m_hMax - 1) / m_hMax;
+                c.height = (m_height * c.v + m_vMax - 1) / m_vMax;
+                c.blocksWide = m_mcusWide * c.h;
+                c.blocksHigh = m_mcusHigh * c.v;
+                c.plane.assign(size_t(c.blocksWide) * c.blocksHigh * 64, 0);
+                if (m_progressive)
+                    c.coeffs.assign(size_t(c.blocksWide) * c.blocksHigh * 64, 0);
+            }
+            m_frame = true;
+            return true;
+        }
+
+        bool ReadHuffmanTables(size_t end, std::string* error)
+        {
+            while (m_pos < end) {
+                const int info = Read8();
+                const int cls = info >> 4;
+                const int index = info & 15;
+                uint8_t counts[16];
+                int total = 0;
+                for (int i = 0; i < 16; i++) {
+                    counts[i] = uint8_t(Read8());
+                    total += counts[i];
+                }
+                if (cls > 1 || index > 3 || total > 256 || m_pos + size_t(total) > end) {
+                    SetError(error, "bad JPEG Huffman table");
+                    return false;
+                }
+                JpegHuffman& table = cls == 0 ? m_dc[index] : m_ac[index];
+                if (!table.Build(counts, m_data + m_pos, total)) {
+                    SetError(error, "bad JPEG Huffman table");
+                    return false;
+                }
+                m_pos += size_t(total);
+            }
+            return true;
+        }
+
+        bool ReadQuantTables(size_t end, std::string* error)
+        {
+            while (m_pos < end) {
+                const int info = Read8();
+                const int precision = info >> 4;
+                const int index = info & 15;
+                if (precision > 1 || index > 3) {
+                    SetError(error, "bad JPEG quantisation table");
+                    return false;
+                }
+                for (int k = 0; k < 64; k++)
+                    m_quant[index][kZigZag[k]] = uint16_t(precision ? Read16() : Read8());
+            }
+            return true;
+        }
+
+        bool ReadScan(std::string* error)
+        {
+            if (!m_frame) {
+                SetError(error, "scan before frame header");
+                return false;
+            }
+
+            const int count = Read8();
+            if (count < 1 || count > int(m_components.size())) {
+                SetError(error, "bad JPEG scan header");
+                return false;
+            }
+            m_scan.clear();
+            for (int i = 0; i < count; i++) {
+                const int id = Read8();
+                const int tables = Read8();
+                auto it = std::find_if(m_components.begin(), m_components.end(),
+                    [id](const JpegComponent& c) { return c.id == id; });
+                if (it == m_components.end()) {
+                    SetError(error, "scan references an unknown component");
+                    return false;
+                }
+                it->dcTable = tables >> 4;
+                it->acTable = tables & 15;
+                if (it->dcTable > 3 || it->acTable > 3) {
+                    SetError(error, "bad JPEG scan header");
+                    return false;
+                }
+                m_scan.push_back(&*it);
+            }
+            m_specStart = Read8();
+            m_specEnd = Read8();
+            const int approx = Read8();
+            m_succHigh = approx >> 4;
+            m_succLow = approx & 15;
+
+            if (m_progressive) {
+                const bool dcScan = m_specStart == 0;
+                if (m_specStart > 63 || m_specEnd > 63 || m_specStart > m_specEnd || m_succLow > 13
+                    || (dcScan && m_specEnd != 0) || (!dcScan && count != 1)) {
+                    SetError(error, "bad progressive JPEG scan");
+                    return false;
+                }
+            }
+            else if (m_specStart != 0 || m_specEnd != 63 || approx != 0) {
+                SetError(error, "bad baseline JPEG scan");
+                return false;
+            }
+
+            for (JpegComponent* c : m_scan) {
+                const bool needDc = !m_progressive || (m_specStart == 0 && m_succHigh == 0);
+                const bool needAc = !m_progressive || m_specStart != 0;
+                if ((needDc && !m_dc[c->dcTable].Present()) || (needAc && !m_ac[c->acTable].Present())) {
+                    SetError(error, "scan uses an undefined Huffman table");
+                    return false;
+                }
+            }
+
+            if (!DecodeScan()) {
+                SetError(error, "corrupt JPEG entropy data");
+                return false;
+            }
+            m_scans++;
+            return true;
+        }
+
+        // Visits every block of the current scan in coding order, handling
+        // interleaved MCUs, non-interleaved component grids and restart markers.
+        template <typename BlockFn>
+        bool ForEachBlock(BlockFn&& block)
+        {
+            for (JpegComponent* c : m_scan)
+                c->dcPred = 0;
+            m_eobRun = 0;
+
+            uint32_t untilRestart = m_restartInterval;
+            auto restart = [&]() {
+                if (!m_restartInterval)
+                    return true;
+                if (--untilRestart > 0)
+                    return true;
+                untilRestart = m_restartInterval;
+                if (!m_reader.Restart())
+                    return false;
+                for (JpegComponent* c : m_scan)
+                    c->dcPred = 0;
+                m_eobRun = 0;
+                return true;
+            };
+
+            if (m_scan.size() == 1) {
+                // Non-interleaved: one block per MCU over the component's own grid
+                JpegComponent& c = *m_scan[0];
+                const uint32_t wide = (c.width + 7) / 8;
+                const uint32_t high = (c.height + 7) / 8;
+                for (uint32_t by = 0; by < high; by++) {
+                    for (uint32_t bx = 0; bx < wide; bx++) {
+                        if (!block(c, bx, by))
+                            return false;
+                        const bool last = by + 1 == high && bx + 1 == wide;
+                        if (!last && !restart())
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            for (uint32_t my = 0; my < m_mcusHigh; my++) {
+                for (uint32_t mx = 0; mx < m_mcusWide; mx++) {
+                    for (JpegComponent* c : m_scan) {
+                        for (int y = 0; y < c->v; y++) {
+                            for (int x = 0; x < c->h; x++) {
+                                if (!block(*c, mx * c->h + x, my * c->v + y))
+                                    return false;
+                            }
+                        }
+                    }
+                    const bool last = my + 1 == m_mcusHigh && mx + 1 == m_mcusWide;
+                    if (!last && !restart())
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        bool DecodeScan()
+        {
+            m_reader.Reset(m_data, m_size, m_pos);
+
+            bool ok = false;
+            if (!m_progressive) {
+                ok = ForEachBlock([this](JpegComponent& c, uint32_t bx, uint32_t by) {
+                    int16_t coeffs[64];
+                    if (!DecodeBaselineBlock(c, coeffs))
+                        return false;
+                    InverseDct(coeffs, m_quant[c.quant], &c.plane[size_t(by) * 8 * c.Stride() + size_t(bx) * 8], c.Stride());
+                    return true;
+                });
+            }
+            else if (m_specStart == 0) {
+                ok = ForEachBlock([this](JpegComponent& c, uint32_t bx, uint32_t by) {
+                    return DecodeDcProgressive(c, c.Block(bx, by));
+                });
+            }
+            else {
+                ok = ForEachBlock([this](JpegComponent& c, uint32_t bx, uint32_t by) {
+                    return m_succHigh == 0 ? DecodeAcFirst(c, c.Block(bx, by)) : DecodeAcRefine(c, c.Block(bx, by));
+                });
+            }
+
+            m_pos = m_reader.MarkerPosition();
+            return ok;
+        }
+
+        bool DecodeBaselineBlock(JpegComponent& c, int16_t coeffs[64])
+        {
+            std::memset(coeffs, 0, 64 * sizeof(int16_t));
+
+            const int size = m_dc[c.dcTable].Decode(m_reader);
+            if (size < 0 || size > 11)
+                return false;
+            c.dcPred += m_reader.Signed(size);
+            coeffs[0] = int16_t(c.dcPred);
+
+            const JpegHuffman& ac = m_ac[c.acTable];
+            for (int k = 1; k < 64;) {
+                const int rs = ac.Decode(m_reader);
+                if (rs < 0)
+                    return false;
+                const int run = rs >> 4;
+                const int s = rs & 15;
+                if (s == 0) {
+                    if (run != 15)
+                        break;      // EOB
+                    k += 16;
+                    continue;
+                }
+                k += run;
+                if (k > 63)
+                    return false;
+                coeffs[kZigZag[k++]] = int16_t(m_reader.Signed(s));
+            }
+            return true;
+        }
+
+        bool DecodeDcProgressive(JpegComponent& c, int16_t* coeffs)
+        {
+            if (m_succHigh == 0) {
+                const int size = m_dc[c.dcTable].Decode(m_reader);
+                if (size < 0 || size > 11)
+                    return false;
+                c.dcPred += m_reader.Signed(size);
+                coeffs[0] = int16_t(c.dcPred * (1 << m_succLow));
+            }
+            else if (m_reader.Bit()) {
+                coeffs[0] = int16_t(coeffs[0] | (1 << m_succLow));
+            }
+            return true;
+        }
+
+        bool DecodeAcFirst(JpegComponent& c, int16_t* coeffs)
+        {
+            if (m_eobRun > 0) {
+                m_eobRun--;
+                return true;
+            }
+
+            const JpegHuffman& ac = m_ac[c.acTable];
+            for (int k = m_specStart; k <= m_specEnd;) {
+                const int rs = ac.Decode(m_reader);
+                if (rs < 0)
+                    return false;
+                const int run = rs >> 4;
+                const int s = rs & 15;
+                if (s == 0) {
+                    if (run < 15) {
+                        m_eobRun = (1 << run) - 1 + m_reader.Bits(run);
+                        break;
+                    }
+                    k += 16;
+                    continue;
+                }
+                k += run;
+                if (k > 63)
+                    return false;
+                coeffs[kZigZag[k++]] = int16_t(m_reader.Signed(s) * (1 << m_succLow));
+            }
+            return true;
+        }
+
+        // Refinement: one correction bit for every already-nonzero coefficient in
+        // the band, interleaved with newly nonzero +-1 coefficients.
+        bool DecodeAcRefine(JpegComponent& c, int16_t* coeffs)
+        {
+            const int bit = 1 << m_succLow;
+            auto refine = [&](int16_t& coef) {
+                if (m_reader.Bit() && !(coef & bit))
+                    coef = int16_t(coef >= 0 ? coef + bit : coef - bit);
+            };
+
+            if (m_eobRun > 0) {
+                m_eobRun--;
+                for (int k = m_specStart; k <= m_specEnd; k++) {
+                    int16_t& coef = coeffs[kZigZag[k]];
+                    if (coef)
+                        refine(coef);
+                }
+                return true;
+            }
+
+            const JpegHuffman& ac = m_ac[c.acTable];
+            int k = m_specStart;
+            while (k <= m_specEnd) {
+                const int rs = ac.Decode(m_reader);
+                if (rs < 0)
+                    return false;
+                int run = rs >> 4;
+                const int s = rs & 15;
+                int value = 0;
+                if (s == 0) {
+                    if (run < 15) {
+                        m_eobRun = (1 << run) + m_reader.Bits(run);
+                        run = 64;   // Refine the rest of the band, then stop
+                    }
+                    // run == 15: skip 16 zero-history coefficients
+                }
+                else {
+                    if (s != 1)
+                        return false;
+                    value = m_reader.Bit() ? bit : -bit;
+                }
+
+                while (k <= m_specEnd) {
+                    int16_t& coef = coeffs[kZigZag[k++]];
+                    if (coef) {
+                        refine(coef);
+                    }
+                    else {
+                        if (run == 0) {
+                            coef = int16_t(value);
+                            break;
+                        }
+                        run--;
+                    }
+                }
+
+                if (m_eobRun > 0) {
+                    // This block ended the band; it counts as the first of the run
+                    m_eobRun--;
+                    break;
+                }
+            }
+            return true;
+        }
+
+        void FinishProgressive()
+        {
+            for (JpegComponent& c : m_components) {
+                const uint16_t* q = m_quant[c.quant];
+                for (uint32_t by = 0; by < c.blocksHigh; by++) {
+                    for (uint32_t bx = 0; bx < c.blocksWide; bx++) {
+                        InverseDct(c.Block(bx, by), q, &c.plane[size_t(by) * 8 * c.Stride() + size_t(bx) * 8], c.Stride());
+                    }
+                }
+            }
+        }
+
+        // Produces one full-width row of component samples for output row y,
+        // upsampling chroma with the same triangle filter libjpeg uses by default
+        // for 2x1 and 2x2 ("fancy upsampling"); other ratios replicate.
+        void UpsampleRow(const JpegComponent& c, uint32_t y, uint8_t* out, std::vector<int>& sums) const
+        {
+            const int sx = m_hMax / c.h;
+            const int sy = m_vMax / c.v;
+            const bool exact = m_hMax % c.h == 0 && m_vMax % c.v == 0;
+            const size_t stride = c.Stride();
+
+            if (sx == 1 && sy == 1 && exact) {
+                std::memcpy(out, &c.plane[size_t(y) * stride], m_width);
+                return;
+            }
+
+            if (exact && sx == 2 && (sy == 1 || sy == 2)) {
+                const uint32_t last = c.width - 1;
+                sums.resize(c.width);
+                if (sy == 2) {
+                    // Nearer input row weighs 3, the farther one 1
+                    const uint32_t near = std::min(y / 2, c.height - 1);
+                    const uint32_t far = (y & 1) ? std::min(near + 1, c.height - 1) : (near ? near - 1 : 0);
+                    const uint8_t* a = &c.plane[size_t(near) * stride];
+                    const uint8_t* b = &c.plane[size_t(far) * stride];
+                    for (uint32_t i = 0; i <= last; i++)
+                        sums[i] = a[i] * 3 + b[i];
+
+                    if (last == 0) {
+                        for (uint32_t x = 0; x < m_width; x++)
+                            out[x] = uint8_t((sums[0] * 4 + 8) >> 4);
+                        return;
+                    }
+                    out[0] = uint8_t((sums[0] * 4 + 8) >> 4);
+                    for (uint32_t i = 0; i <= last; i++) {
+                        const int prev = sums[i ? i - 1 : 0];
+                        const int next = sums[i < last ? i + 1 : last];
+                        if (2 * i < m_width && i > 0)
+                            out[2 * i] = uint8_t((sums[i] * 3 + prev + 8) >> 4);
+                        if (2 * i + 1 < m_width)
+                            out[2 * i + 1] = uint8_t(i < last ? (sums[i] * 3 + next + 7) >> 4 : (sums[i] * 4 + 7) >> 4);
+                    }
+                    return;
+                }
+
+                const uint8_t* in = &c.plane[size_t(std::min(y, c.height - 1)) * stride];
+                if (last == 0) {
+                    std::memset(out, in[0], m_width);
+                    return;
+                }
+                out[0] = in[0];
+                for (uint32_t i = 0; i <= last; i++) {
+                    if (2 * i < m_width && i > 0)
+                        out[2 * i] = uint8_t((in[i] * 3 + in[i - 1] + 1) >> 2);
+                    if (2 * i + 1 < m_width)
+                        out[2 * i + 1] = i < last ? uint8_t((in[i] * 3 + in[i + 1] + 2) >> 2) : in[i];
+                }
+                return;
+            }
+
+            // Generic nearest-sample replication
+            const uint32_t row = std::min(uint32_t(uint64_t(y) * c.v / m_vMax), c.height - 1);
+            const uint8_t* in = &c.plane[size_t(row) * stride];
+            for (uint32_t x = 0; x < m_width; x++)
+                out[x] = in[std::min(uint32_t(uint64_t(x) * c.h / m_hMax), c.width - 1)];
+        }
+
+        void WriteRgba(const MutableImageView& dst) const
+        {
+            // Adobe transform 0 or component ids 'R','G','B' mean no colour transform
+            const bool ycc = m_components.size() == 3
+                && !(m_adobe && m_adobeTransform == 0)
+                && !(m_components[0].id == 'R' && m_components[1].id == 'G' && m_components[2].id == 'B');
+
+            std::vector<uint8_t> rows(size_t(m_width) * m_components.size());
+            std::vector<int> sums;
+            for (uint32_t y = 0; y < m_height; y++) {
+                uint8_t* out = dst.Row(y);
+                for (size_t i = 0; i < m_components.size(); i++)
+                    UpsampleRow(m_components[i], y, &rows[i * m_width], sums);
+
+                const uint8_t* c0 = rows.data();
+                if (m_components.size() == 1) {
+                    for (uint32_t x = 0; x < m_width; x++, out += 4) {
+                        out[0] = out[1] = out[2] = c0[x];
+                        out[3] = 255;
+                    }
+                    continue;
+                }
+
+                const uint8_t* c1 = c0 + m_width;
+                const uint8_t* c2 = c1 + m_width;
+                if (!ycc) {
+                    for (uint32_t x = 0; x < m_width; x++, out += 4) {
+                        out[0] = c0[x];
+                        out[1] = c1[x];
+                        out[2] = c2[x];
+                        out[3] = 255;
+                    }
+                    continue;
+                }
+
+                // JFIF YCbCr -> RGB in 16.16 fixed point (libjpeg's jdcolor constants)
+                for (uint32_t x = 0; x < m_width; x++, out += 4) {
+                    const int luma = c0[x];
+                    const int cb = c1[x] - 128;
+                    const int cr = c2[x] - 128;
+                    out[0] = Clamp8(luma + ((91881 * cr + 32768) >> 16));
+                    out[1] = Clamp8(luma + ((-22554 * cb - 46802 * cr + 32768) >> 16));
+                    out[2] = Clamp8(luma + ((116130 * cb + 32768) >> 16));
+                    out[3] = 255;
+                }
+            }
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+
+        bool m_frame = false;
+        bool m_progressive = false;
+        int m_scans = 0;
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        int m_hMax = 1;
+        int m_vMax = 1;
+        uint32_t m_mcusWide = 0;
+        uint32_t m_mcusHigh = 0;
+        uint32_t m_restartInterval = 0;
+        bool m_adobe = false;
+        int m_adobeTransform = 1;
+
+        std::vector<JpegComponent> m_components;
+        std::vector<JpegComponent*> m_scan;
+        int m_specStart = 0;
+        int m_specEnd = 63;
+        int m_succHigh = 0;
+        int m_succLow = 0;
+        int m_eobRun = 0;
+
+        JpegHuffman m_dc[4];
+        JpegHuffman m_ac[4];
+        uint16_t m_quant[4][64] = {};
+        JpegBitReader m_reader;
+    };
+
+    class JpegDecoder final : public ImageDecoder {
+    public:
+        const char* Name() const override { return "jpeg"; }
+
+        bool CanDecode(const uint8_t* data, size_t size) const override
+        {
+            return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+        }
+
+        bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info, std::string* error) const override
+        {
+            JpegDecodeState state(data, size);
+            return state.ReadHeaders(info, error);
+        }
+
+        bool Decode(const uint8_t* data, size_t size, const MutableImageView& dst, std::string* error) const override
+        {
+            JpegDecodeState state(data, size);
+            return state.Decode(dst, error);
+        }
+    };
+
+}
+
+std::unique_ptr<ImageDecoder> CreateJpegDecoder()
+{
+    return std::make_unique<JpegDecoder>();
+}
+
+}
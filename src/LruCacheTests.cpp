@@ -0,0 +1,129 @@
+#include "gtest/gtest.h"
+#include "LruCache.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Cache = qisx::LruCache<std::string, std::shared_ptr<int>>;
+
+    std::shared_ptr<int> Value(int v)
+    {
+        return std::make_shared<int>(v);
+    }
+
+}
+
+TEST(LruCacheTests, CountsHitsAndMisses)
+{
+    Cache cache(100);
+    std::shared_ptr<int> out;
+    EXPECT_FALSE(cache.Find("a", out));
+    EXPECT_TRUE(cache.Insert("a", Value(1), 10));
+    ASSERT_TRUE(cache.Find("a", out));
+    EXPECT_EQ(*out, 1);
+    EXPECT_TRUE(cache.Find("a", out));
+
+    const qisx::LruCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.bytes, 10u);
+    EXPECT_EQ(stats.budgetBytes, 100u);
+}
+
+// Alternating between two assets must keep both resident
+TEST(LruCacheTests, EvictsLeastRecentlyUsedWithinBudget)
+{
+    Cache cache(30);
+    cache.Insert("a", Value(1), 10);
+    cache.Insert("b", Value(2), 10);
+    cache.Insert("c", Value(3), 10);
+
+    std::shared_ptr<int> out;
+    ASSERT_TRUE(cache.Find("a", out));  // "b" is now the oldest
+    cache.Insert("d", Value(4), 10);
+
+    EXPECT_FALSE(cache.Find("b", out));
+    EXPECT_TRUE(cache.Find("a", out));
+    EXPECT_TRUE(cache.Find("c", out));
+    EXPECT_TRUE(cache.Find("d", out));
+    EXPECT_EQ(cache.GetStats().evictions, 1u);
+    EXPECT_EQ(cache.GetStats().bytes, 30u);
+
+    // One large entry can push out several
+    cache.Insert("e", Value(5), 25);
+    EXPECT_EQ(cache.GetStats().entries, 1u);
+    EXPECT_EQ(cache.GetStats().evictions, 4u);
+}
+
+TEST(LruCacheTests, ReplacesOversizedAndErasedEntries)
+{
+    Cache cache(50);
+    cache.Insert("a", Value(1), 20);
+    cache.Insert("a", Value(2), 30);
+    std::shared_ptr<int> out;
+    ASSERT_TRUE(cache.Find("a", out));
+    EXPECT_EQ(*out, 2);
+    EXPECT_EQ(cache.GetStats().bytes, 30u);
+
+    // Too big for the whole budget: not cached, and the old entry is gone
+    EXPECT_FALSE(cache.Insert("a", Value(3), 51));
+    EXPECT_FALSE(cache.Find("a", out));
+    EXPECT_EQ(cache.GetStats().bytes, 0u);
+
+    cache.Insert("b", Value(4), 10);
+    EXPECT_TRUE(cache.Erase("b"));
+    EXPECT_FALSE(cache.Erase("b"));
+    EXPECT_EQ(cache.GetStats().entries, 0u);
+}
+
+TEST(LruCacheTests, ReleasesValuesOnEvictionAndShrink)
+{
+    Cache cache(100);
+    std::weak_ptr<int> a, b;
+    {
+        std::shared_ptr<int> va = Value(1), vb = Value(2);
+        a = va;
+        b = vb;
+        cache.Insert("a", va, 40);
+        cache.Insert("b", vb, 40);
+    }
+    EXPECT_FALSE(a.expired());
+
+    cache.SetBudget(50);
+    EXPECT_TRUE(a.expired());
+    EXPECT_FALSE(b.expired());
+
+    cache.Clear();
+    EXPECT_TRUE(b.expired());
+    EXPECT_EQ(cache.GetStats().bytes, 0u);
+}
+
+TEST(LruCacheTests, ConcurrentLookupsStayConsistent)
+{
+    Cache cache(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t] {
+            std::shared_ptr<int> out;
+            for (int i = 0; i < 2000; i++) {
+                const std::string key = std::to_string((i * 7 + t) % 16);
+                if (cache.Find(key, out))
+                    EXPECT_EQ(std::to_string(*out), key);
+                else
+                    cache.Insert(key, Value(std::stoi(key)), 8);
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+
+    const qisx::LruCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.hits + stats.misses, 8000u);
+    EXPECT_LE(stats.bytes, 64u);
+    EXPECT_EQ(stats.bytes, stats.entries * 8);
+}
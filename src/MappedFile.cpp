@@ -0,0 +1,146 @@
+#include "MappedFile.h"
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+#if defined(_WIN32)
+    // The view keeps the mapping alive, so both handles can be closed right away
+    bool MapHandle(HANDLE file, const uint8_t*& data, size_t& size, std::string* error)
+    {
+        if (file == INVALID_HANDLE_VALUE) {
+            SetError(error, "cannot open file");
+            return false;
+        }
+
+        LARGE_INTEGER length = {};
+        bool ok = GetFileSizeEx(file, &length) != 0 && uint64_t(length.QuadPart) <= SIZE_MAX;
+        if (!ok)
+            SetError(error, "cannot stat file");
+        else if (length.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (mapping)
+                CloseHandle(mapping);
+            ok = view != nullptr;
+            if (ok) {
+                data = static_cast<const uint8_t*>(view);
+                size = size_t(length.QuadPart);
+            } else
+                SetError(error, "cannot map file");
+        }
+        CloseHandle(file);
+        return ok;
+    }
+#endif
+
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_open(std::exchange(other.m_open, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_open = std::exchange(other.m_open, false);
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const std::string& path, std::string* error)
+{
+    Close();
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    m_open = MapHandle(file, m_data, m_size, error);
+    return m_open;
+}
+
+bool MappedFile::Open(const std::wstring& path, std::string* error)
+{
+    Close();
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    m_open = MapHandle(file, m_data, m_size, error);
+    return m_open;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, std::string* error)
+{
+    Close();
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SetError(error, "cannot open file");
+        return false;
+    }
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (!ok)
+        SetError(error, "not a regular file");
+    else if (st.st_size > 0) {
+        void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = view != MAP_FAILED;
+        if (ok) {
+            // Decoders read front to back
+            madvise(view, size_t(st.st_size), MADV_SEQUENTIAL);
+            m_data = static_cast<const uint8_t*>(view);
+            m_size = size_t(st.st_size);
+        } else
+            SetError(error, "cannot map file");
+    }
+    close(fd);  // The mapping holds its own reference
+    m_open = ok;
+    return ok;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#endif
+
+}
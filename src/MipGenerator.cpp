@@ -0,0 +1,53 @@
+#include "MipGenerator.h"
+#include <algorithm>
+
+namespace qisx {
+
+uint32_t MipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+        levels++;
+    return levels;
+}
+
+bool MipGenerator::GenerateLevel(const ImageView& parent, const MutableImageView& child)
+{
+    if (child.width != std::max(1u, parent.width / 2) || child.height != std::max(1u, parent.height / 2))
+        return false;
+
+    Resampler::Options options;
+    options.filter = m_options.filter == MipFilter::Kaiser ? ResampleFilter::Kaiser : ResampleFilter::Box;
+    options.srgb = m_options.srgb;
+    options.simd = m_options.simd;
+    options.threadCount = m_options.threadCount;
+    options.bandHeight = m_options.bandHeight;
+    m_resampler.SetOptions(options);
+    return m_resampler.Resample(parent, child);
+}
+
+bool MipGenerator::Generate(const ImageView& base, std::vector<Image>& mips)
+{
+    if (base.Empty())
+        return false;
+
+    uint32_t levels = MipLevelCount(base.width, base.height);
+    if (m_options.maxLevels)
+        levels = std::min(levels, m_options.maxLevels);
+    mips.resize(levels - 1);
+
+    ImageView parent = base;
+    for (uint32_t level = 1; level < levels; level++) {
+        Image& child = mips[level - 1];
+        const uint32_t w = std::max(1u, parent.width / 2);
+        const uint32_t h = std::max(1u, parent.height / 2);
+        if (child.Width() != w || child.Height() != h)
+            child = Image(w, h);
+        if (!GenerateLevel(parent, child.MutableView()))
+            return false;
+        parent = child.View();
+    }
+    return true;
+}
+
+}
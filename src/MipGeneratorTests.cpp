@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+#include "ColorSpace.h"
+#include "MipGenerator.h"
+#include "TestImages.h"
+
+#include <cstdlib>
+#include <cstring>
+
+TEST(MipGeneratorTests, ChainSizesFollowD3D)
+{
+    EXPECT_EQ(qisx::MipLevelCount(1, 1), 1u);
+    EXPECT_EQ(qisx::MipLevelCount(256, 256), 9u);
+    EXPECT_EQ(qisx::MipLevelCount(640, 427), 10u);
+    EXPECT_EQ(qisx::MipLevelCount(1, 5), 3u);
+
+    const qisx::Image base = qisx::test::RandomImage(13, 7, 1);
+    std::vector<qisx::Image> mips;
+    qisx::MipGenerator generator;
+    ASSERT_TRUE(generator.Generate(base.View(), mips));
+    ASSERT_EQ(mips.size(), 3u);
+    EXPECT_EQ(mips[0].Width(), 6u);
+    EXPECT_EQ(mips[0].Height(), 3u);
+    EXPECT_EQ(mips[1].Width(), 3u);
+    EXPECT_EQ(mips[1].Height(), 1u);
+    EXPECT_EQ(mips[2].Width(), 1u);
+    EXPECT_EQ(mips[2].Height(), 1u);
+
+    qisx::MipGenerator limited({ qisx::MipFilter::Box, false, 2 });
+    ASSERT_TRUE(limited.Generate(base.View(), mips));
+    EXPECT_EQ(mips.size(), 1u);
+}
+
+TEST(MipGeneratorTests, BoxAveragesInGammaOrLinearSpace)
+{
+    // Black/white checkerboard: the stored average is 128, the light average
+    // is linear 0.5, which encodes to 187.5 (either neighbour is correct)
+    qisx::Image base(2, 2);
+    const uint8_t pixels[] = { 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 0, 0 };
+    std::memcpy(base.Data(), pixels, sizeof(pixels));
+
+    std::vector<qisx::Image> mips;
+    qisx::MipGenerator gamma;
+    ASSERT_TRUE(gamma.Generate(base.View(), mips));
+    EXPECT_EQ(mips[0].Data()[0], 128);
+    EXPECT_EQ(mips[0].Data()[3], 128);
+
+    qisx::MipGenerator linear({ qisx::MipFilter::Box, true });
+    ASSERT_TRUE(linear.Generate(base.View(), mips));
+    EXPECT_NEAR(mips[0].Data()[0], 187.5, 0.5);
+    EXPECT_NEAR(mips[0].Data()[1], 187.5, 0.5);
+    EXPECT_EQ(mips[0].Data()[3], 128) << "alpha is never gamma corrected";
+}
+
+TEST(MipGeneratorTests, FlatColourSurvivesEveryLevel)
+{
+    for (qisx::MipFilter filter : { qisx::MipFilter::Box, qisx::MipFilter::Kaiser }) {
+        for (bool srgb : { false, true }) {
+            qisx::Image base(37, 22);
+            for (size_t i = 0; i < base.SizeInBytes(); i += 4) {
+                base.Data()[i] = 200; base.Data()[i + 1] = 17; base.Data()[i + 2] = 90; base.Data()[i + 3] = 133;
+            }
+            std::vector<qisx::Image> mips;
+            qisx::MipGenerator generator({ filter, srgb });
+            ASSERT_TRUE(generator.Generate(base.View(), mips));
+            for (const qisx::Image& mip : mips) {
+                for (size_t i = 0; i < mip.SizeInBytes(); i += 4) {
+                    ASSERT_EQ(mip.Data()[i], 200);
+                    ASSERT_EQ(mip.Data()[i + 1], 17);
+                    ASSERT_EQ(mip.Data()[i + 2], 90);
+                    ASSERT_EQ(mip.Data()[i + 3], 133);
+                }
+            }
+        }
+    }
+}
+
+TEST(MipGeneratorTests, SimdAndThreadsMatchScalar)
+{
+    const qisx::Image base = qisx::test::RandomImage(301, 157, 9);
+    for (qisx::MipFilter filter : { qisx::MipFilter::Box, qisx::MipFilter::Kaiser }) {
+        for (bool srgb : { false, true }) {
+            qisx::MipGenerator::Options options{ filter, srgb };
+            options.simd = qisx::SimdLevel::Scalar;
+            options.threadCount = 1;
+            std::vector<qisx::Image> expected;
+            ASSERT_TRUE(qisx::MipGenerator(options).Generate(base.View(), expected));
+
+            options.simd = qisx::SimdLevel::Auto;
+            std::vector<qisx::Image> single;
+            ASSERT_TRUE(qisx::MipGenerator(options).Generate(base.View(), single));
+
+            options.threadCount = 4;
+            options.bandHeight = 5;
+            std::vector<qisx::Image> threaded;
+            ASSERT_TRUE(qisx::MipGenerator(options).Generate(base.View(), threaded));
+
+            ASSERT_EQ(expected.size(), threaded.size());
+            for (size_t level = 0; level < expected.size(); level++) {
+                // Vector kernels keep the scalar summation order; FMA contraction
+                // of the scalar code on some targets can still move a rounding
+                EXPECT_LE(qisx::test::MaxDifference(expected[level], single[level]), 1) << "level " << level + 1;
+                EXPECT_EQ(qisx::test::MaxDifference(single[level], threaded[level]), 0) << "level " << level + 1;
+            }
+        }
+    }
+}
+
+TEST(MipGeneratorTests, SrgbTablesRoundTrip)
+{
+    const qisx::SrgbTables& tables = qisx::GetSrgbTables();
+    for (int i = 0; i < 256; i++)
+        EXPECT_EQ(qisx::LinearToSrgb8(tables, tables.toLinear[i]), i);
+
+    for (int i = 0; i <= 1000; i++) {
+        const float linear = i / 1000.0f;
+        const int exact = int(qisx::LinearToSrgb(linear) * 255.0f + 0.5f);
+        EXPECT_LE(std::abs(qisx::LinearToSrgb8(tables, linear) - exact), 1) << linear;
+    }
+    EXPECT_EQ(qisx::LinearToSrgb8(tables, -1.0f), 0);
+    EXPECT_EQ(qisx::LinearToSrgb8(tables, 2.0f), 255);
+}
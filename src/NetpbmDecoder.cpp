@@ -0,0 +1,227 @@
+#include "ImageDecoder.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace qisx {
+
+namespace {
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+    // Header tokenizer shared by PPM and PAM: skips whitespace and # comments.
+    class HeaderReader {
+    public:
+        HeaderReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        bool Token(std::string& token)
+        {
+            SkipSpace();
+            token.clear();
+            while (m_pos < m_size && !std::isspace(m_data[m_pos]))
+                token.push_back(char(m_data[m_pos++]));
+            return !token.empty();
+        }
+
+        bool Number(uint32_t& value)
+        {
+            std::string token;
+            if (!Token(token))
+                return false;
+            char* end = nullptr;
+            const unsigned long v = std::strtoul(token.c_str(), &end, 10);
+            if (*end != '\0' || v > 0xFFFFFFFFul)
+                return false;
+            value = uint32_t(v);
+            return true;
+        }
+
+        // Consumes the single whitespace byte that ends a header
+        bool EndHeader()
+        {
+            if (m_pos >= m_size || !std::isspace(m_data[m_pos]))
+                return false;
+            m_pos++;
+            return true;
+        }
+
+        size_t Position() const { return m_pos; }
+
+    private:
+        void SkipSpace()
+        {
+            while (m_pos < m_size) {
+                if (m_data[m_pos] == '#') {
+                    while (m_pos < m_size && m_data[m_pos] != '\n')
+                        m_pos++;
+                }
+                else if (std::isspace(m_data[m_pos])) {
+                    m_pos++;
+                }
+                else {
+                    break;
+                }
+            }
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+    };
+
+    struct NetpbmHeader {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 0;  // 1 = grey, 2 = grey+alpha, 3 = RGB, 4 = RGBA
+        size_t dataOffset = 0;
+    };
+
+    bool ReadPpmHeader(const uint8_t* data, size_t size, NetpbmHeader& out, std::string* error)
+    {
+        HeaderReader header(data, size);
+        std::string magic;
+        uint32_t maxval = 0;
+        if (!header.Token(magic) || magic != "P6" || !header.Number(out.width) || !header.Number(out.height)
+            || !header.Number(maxval) || !header.EndHeader()) {
+            SetError(error, "malformed PPM header");
+            return false;
+        }
+        if (out.width == 0 || out.height == 0 || maxval != 255) {
+            SetError(error, "unsupported PPM (need maxval 255)");
+            return false;
+        }
+        out.channels = 3;
+        out.dataOffset = header.Position();
+        return true;
+    }
+
+    bool ReadPamHeader(const uint8_t* data, size_t size, NetpbmHeader& out, std::string* error)
+    {
+        HeaderReader header(data, size);
+        std::string token;
+        if (!header.Token(token) || token != "P7") {
+            SetError(error, "malformed PAM header");
+            return false;
+        }
+
+        uint32_t maxval = 0;
+        for (;;) {
+            if (!header.Token(token)) {
+                SetError(error, "malformed PAM header");
+                return false;
+            }
+            if (token == "ENDHDR")
+                break;
+
+            bool ok = true;
+            if (token == "WIDTH")
+                ok = header.Number(out.width);
+            else if (token == "HEIGHT")
+                ok = header.Number(out.height);
+            else if (token == "DEPTH")
+                ok = header.Number(out.channels);
+            else if (token == "MAXVAL")
+                ok = header.Number(maxval);
+            else if (token == "TUPLTYPE")
+                ok = header.Token(token);
+            if (!ok) {
+                SetError(error, "malformed PAM header");
+                return false;
+            }
+        }
+
+        if (!header.EndHeader() || out.width == 0 || out.height == 0 || out.channels < 1 || out.channels > 4
+            || maxval != 255) {
+            SetError(error, "unsupported PAM (need depth 1-4, maxval 255)");
+            return false;
+        }
+        out.dataOffset = header.Position();
+        return true;
+    }
+
+    bool ReadNetpbmHeader(const uint8_t* data, size_t size, NetpbmHeader& out, std::string* error)
+    {
+        if (size >= 2 && data[0] == 'P' && data[1] == '7')
+            return ReadPamHeader(data, size, out, error);
+        return ReadPpmHeader(data, size, out, error);
+    }
+
+    class NetpbmDecoder final : public ImageDecoder {
+    public:
+        const char* Name() const override { return "netpbm"; }
+
+        bool CanDecode(const uint8_t* data, size_t size) const override
+        {
+            return size >= 3 && data[0] == 'P' && (data[1] == '6' || data[1] == '7') && std::isspace(data[2]);
+        }
+
+        bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info, std::string* error) const override
+        {
+            NetpbmHeader header;
+            if (!ReadNetpbmHeader(data, size, header, error))
+                return false;
+            info.width = header.width;
+            info.height = header.height;
+            return true;
+        }
+
+        bool Decode(const uint8_t* data, size_t size, const MutableImageView& dst, std::string* error) const override
+        {
+            NetpbmHeader header;
+            if (!ReadNetpbmHeader(data, size, header, error))
+                return false;
+            if (dst.width != header.width || dst.height != header.height) {
+                SetError(error, "destination size does not match the image");
+                return false;
+            }
+
+            const uint32_t channels = header.channels;
+            const size_t rowBytes = size_t(header.width) * channels;
+            if (size - header.dataOffset < rowBytes * header.height) {
+                SetError(error, "truncated pixel data");
+                return false;
+            }
+
+            const uint8_t* samples = data + header.dataOffset;
+            for (uint32_t y = 0; y < header.height; y++) {
+                uint8_t* out = dst.Row(y);
+                if (channels == 4) {
+                    std::memcpy(out, samples, rowBytes);
+                    samples += rowBytes;
+                    continue;
+                }
+                for (uint32_t x = 0; x < header.width; x++, out += 4, samples += channels) {
+                    switch (channels) {
+                    case 1:
+                        out[0] = out[1] = out[2] = samples[0];
+                        out[3] = 255;
+                        break;
+                    case 2:
+                        out[0] = out[1] = out[2] = samples[0];
+                        out[3] = samples[1];
+                        break;
+                    default:
+                        out[0] = samples[0];
+                        out[1] = samples[1];
+                        out[2] = samples[2];
+                        out[3] = 255;
+                        break;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+}
+
+std::unique_ptr<ImageDecoder> CreateNetpbmDecoder()
+{
+    return std::make_unique<NetpbmDecoder>();
+}
+
+}
@@ -0,0 +1,944 @@
+#include "PixelConvert.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    struct FormatInfo {
+        PixelFormat format;
+        const char* name;
+        uint32_t bitsPerPixel;
+        PixelFormat nearest;
+        bool writable;
+    };
+
+    // In enum order
+    constexpr FormatInfo kFormats[] = {
+        { PixelFormat::Unknown,     "unknown",      0,   PixelFormat::Unknown,     false },
+        { PixelFormat::RGBA8,       "rgba8",        32,  PixelFormat::RGBA8,       true },
+        { PixelFormat::BGRA8,       "bgra8",        32,  PixelFormat::BGRA8,       true },
+        { PixelFormat::RGBX8,       "rgbx8",        32,  PixelFormat::RGBA8,       true },
+        { PixelFormat::BGRX8,       "bgrx8",        32,  PixelFormat::BGRX8,       true },
+        { PixelFormat::PRGBA8,      "prgba8",       32,  PixelFormat::RGBA8,       true },
+        { PixelFormat::PBGRA8,      "pbgra8",       32,  PixelFormat::RGBA8,       true },
+        { PixelFormat::RGB8,        "rgb8",         24,  PixelFormat::RGBA8,       true },
+        { PixelFormat::BGR8,        "bgr8",         24,  PixelFormat::RGBA8,       true },
+        { PixelFormat::Gray8,       "gray8",        8,   PixelFormat::Gray8,       true },
+        { PixelFormat::Alpha8,      "alpha8",       8,   PixelFormat::Alpha8,      true },
+        { PixelFormat::Gray1,       "gray1",        1,   PixelFormat::Gray8,       false },
+        { PixelFormat::Gray2,       "gray2",        2,   PixelFormat::Gray8,       false },
+        { PixelFormat::Gray4,       "gray4",        4,   PixelFormat::Gray8,       false },
+        { PixelFormat::CMYK8,       "cmyk8",        32,  PixelFormat::RGBA8,       false },
+        { PixelFormat::BGR565,      "bgr565",       16,  PixelFormat::BGR565,      true },
+        { PixelFormat::BGR555,      "bgr555",       16,  PixelFormat::BGRA5551,    true },
+        { PixelFormat::BGRA5551,    "bgra5551",     16,  PixelFormat::BGRA5551,    true },
+        { PixelFormat::RGBA1010102, "rgba1010102",  32,  PixelFormat::RGBA1010102, true },
+        { PixelFormat::BGR101010,   "bgr101010",    32,  PixelFormat::RGBA1010102, true },
+        { PixelFormat::Gray16,      "gray16",       16,  PixelFormat::Gray16,      true },
+        { PixelFormat::RGB16,       "rgb16",        48,  PixelFormat::RGBA16,      true },
+        { PixelFormat::BGR16,       "bgr16",        48,  PixelFormat::RGBA16,      true },
+        { PixelFormat::RGBA16,      "rgba16",       64,  PixelFormat::RGBA16,      true },
+        { PixelFormat::BGRA16,      "bgra16",       64,  PixelFormat::RGBA16,      true },
+        { PixelFormat::RGBX16,      "rgbx16",       64,  PixelFormat::RGBA16,      true },
+        { PixelFormat::PRGBA16,     "prgba16",      64,  PixelFormat::RGBA16,      true },
+        { PixelFormat::PBGRA16,     "pbgra16",      64,  PixelFormat::RGBA16,      true },
+        { PixelFormat::GrayHalf,    "grayhalf",     16,  PixelFormat::GrayHalf,    true },
+        { PixelFormat::RGBHalf,     "rgbhalf",      48,  PixelFormat::RGBAHalf,    true },
+        { PixelFormat::RGBXHalf,    "rgbxhalf",     64,  PixelFormat::RGBAHalf,    true },
+        { PixelFormat::RGBAHalf,    "rgbahalf",     64,  PixelFormat::RGBAHalf,    true },
+        { PixelFormat::PRGBAHalf,   "prgbahalf",    64,  PixelFormat::RGBAHalf,    true },
+        { PixelFormat::GrayFloat,   "grayfloat",    32,  PixelFormat::GrayFloat,   true },
+        { PixelFormat::RGBFloat,    "rgbfloat",     96,  PixelFormat::RGBFloat,    true },
+        { PixelFormat::RGBXFloat,   "rgbxfloat",    128, PixelFormat::RGBAFloat,   true },
+        { PixelFormat::RGBAFloat,   "rgbafloat",    128, PixelFormat::RGBAFloat,   true },
+        { PixelFormat::PRGBAFloat,  "prgbafloat",   128, PixelFormat::RGBAFloat,   true },
+    };
+    static_assert(sizeof(kFormats) / sizeof(kFormats[0]) == size_t(PixelFormat::PRGBAFloat) + 1, "kFormats out of sync");
+
+    const FormatInfo& Info(PixelFormat format)
+    {
+        const size_t i = size_t(format);
+        return i < sizeof(kFormats) / sizeof(kFormats[0]) ? kFormats[i] : kFormats[0];
+    }
+
+    // Float RGBA path: pixels are converted in chunks through this buffer
+    constexpr uint32_t kChunk = 256;
+
+    // Multiplying by the reciprocal is not always the correctly rounded
+    // quotient, but is within an ulp, so quantising back is still exact
+    constexpr float kInv3 = 1.0f / 3.0f;
+    constexpr float kInv31 = 1.0f / 31.0f;
+    constexpr float kInv63 = 1.0f / 63.0f;
+    constexpr float kInv255 = 1.0f / 255.0f;
+    constexpr float kInv1023 = 1.0f / 1023.0f;
+    constexpr float kInv65535 = 1.0f / 65535.0f;
+
+    float HalfBitsToFloat(uint16_t half)
+    {
+        // Shift exponent and mantissa into place and rebias; subnormals are
+        // fixed up by letting the FPU normalise them
+        uint32_t bits = uint32_t(half & 0x7FFF) << 13;
+        const uint32_t exponent = bits & 0x0F800000u;
+        bits += (127 - 15) << 23;
+        float value;
+        if (exponent == 0x0F800000u) {
+            bits += (128 - 16) << 23;                           // Inf / NaN
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+        else if (exponent == 0) {
+            bits += 1 << 23;
+            std::memcpy(&value, &bits, sizeof(value));
+            value -= 6.103515625e-05f;                          // 2^-14
+        }
+        else
+            std::memcpy(&value, &bits, sizeof(value));
+        return half & 0x8000 ? -value : value;
+    }
+
+    // Every half value, decoded once: 256 KB, and a load per channel instead
+    // of a few dependent branches
+    struct HalfTable {
+        float value[65536];
+        HalfTable()
+        {
+            for (uint32_t h = 0; h < 65536; h++)
+                value[h] = HalfBitsToFloat(uint16_t(h));
+        }
+    };
+
+    const HalfTable& GetHalfTable()
+    {
+        static const HalfTable table;
+        return table;
+    }
+
+    inline uint16_t Load16(const uint8_t* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+    inline uint32_t Load32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    inline float LoadFloat(const uint8_t* p) { float v; std::memcpy(&v, p, 4); return v; }
+    inline void Store16(uint8_t* p, uint16_t v) { std::memcpy(p, &v, 2); }
+    inline void Store32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, 4); }
+    inline void StoreFloat(uint8_t* p, float v) { std::memcpy(p, &v, 4); }
+
+    inline uint32_t Quantize(float v, uint32_t max)
+    {
+        // max(0, v) first so NaN becomes 0; both compile to minss/maxss
+        v = std::min(std::max(0.0f, v), 1.0f);
+        return uint32_t(int32_t(v * float(max) + 0.5f));
+    }
+
+    // Channel order of a 3 or 4 channel format: index of R, G, B, A in memory
+    struct Order {
+        int r, g, b, a;
+    };
+    constexpr Order kRGBA = { 0, 1, 2, 3 };
+    constexpr Order kBGRA = { 2, 1, 0, 3 };
+
+    bool IsPremultiplied(PixelFormat f)
+    {
+        return f == PixelFormat::PRGBA8 || f == PixelFormat::PBGRA8 || f == PixelFormat::PRGBA16
+            || f == PixelFormat::PBGRA16 || f == PixelFormat::PRGBAHalf || f == PixelFormat::PRGBAFloat;
+    }
+
+    Order ChannelOrder(PixelFormat f)
+    {
+        switch (f) {
+        case PixelFormat::BGRA8: case PixelFormat::BGRX8: case PixelFormat::PBGRA8: case PixelFormat::BGR8:
+        case PixelFormat::BGR16: case PixelFormat::BGRA16: case PixelFormat::PBGRA16:
+            return kBGRA;
+        default:
+            return kRGBA;
+        }
+    }
+
+    // Unorm channels per pixel (3 = padded or no alpha) for the 8/16-bit RGB(A) family
+    int StoredChannels(PixelFormat f)
+    {
+        switch (f) {
+        case PixelFormat::RGB8: case PixelFormat::BGR8: case PixelFormat::RGB16: case PixelFormat::BGR16:
+        case PixelFormat::RGBHalf: case PixelFormat::RGBFloat:
+            return 3;
+        default:
+            return 4;
+        }
+    }
+
+    void UnpackRow(PixelFormat f, const uint8_t* src, uint32_t count, float* out)
+    {
+        const Order o = ChannelOrder(f);
+        const float* halves = GetHalfTable().value;
+        switch (f) {
+        case PixelFormat::RGBA8: case PixelFormat::BGRA8: case PixelFormat::PRGBA8: case PixelFormat::PBGRA8:
+        case PixelFormat::RGBX8: case PixelFormat::BGRX8: case PixelFormat::RGB8: case PixelFormat::BGR8: {
+            const int stride = StoredChannels(f);
+            const bool opaque = stride == 3 || f == PixelFormat::RGBX8 || f == PixelFormat::BGRX8;
+            for (uint32_t x = 0; x < count; x++, src += stride, out += 4) {
+                out[0] = src[o.r] * kInv255;
+                out[1] = src[o.g] * kInv255;
+                out[2] = src[o.b] * kInv255;
+                out[3] = opaque ? 1.0f : src[o.a] * kInv255;
+            }
+            break;
+        }
+        case PixelFormat::Gray8:
+            for (uint32_t x = 0; x < count; x++, out += 4) {
+                out[0] = out[1] = out[2] = src[x] * kInv255;
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::Alpha8:
+            for (uint32_t x = 0; x < count; x++, out += 4) {
+                out[0] = out[1] = out[2] = 0.0f;
+                out[3] = src[x] * kInv255;
+            }
+            break;
+        case PixelFormat::Gray1: case PixelFormat::Gray2: case PixelFormat::Gray4: {
+            // Most significant bits first, as in PNG and WIC
+            const uint32_t bits = Info(f).bitsPerPixel;
+            const uint32_t max = (1u << bits) - 1;
+            for (uint32_t x = 0; x < count; x++, out += 4) {
+                const uint32_t bit = x * bits;
+                const uint32_t v = (src[bit / 8] >> (8 - bits - bit % 8)) & max;
+                out[0] = out[1] = out[2] = float(v) / float(max);
+                out[3] = 1.0f;
+            }
+            break;
+        }
+        case PixelFormat::CMYK8:
+            for (uint32_t x = 0; x < count; x++, src += 4, out += 4) {
+                const float k = 1.0f - src[3] * kInv255;
+                out[0] = (1.0f - src[0] * kInv255) * k;
+                out[1] = (1.0f - src[1] * kInv255) * k;
+                out[2] = (1.0f - src[2] * kInv255) * k;
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::BGR565:
+            for (uint32_t x = 0; x < count; x++, src += 2, out += 4) {
+                const uint16_t v = Load16(src);
+                out[0] = (v >> 11) * kInv31;
+                out[1] = ((v >> 5) & 63) * kInv63;
+                out[2] = (v & 31) * kInv31;
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::BGR555: case PixelFormat::BGRA5551:
+            for (uint32_t x = 0; x < count; x++, src += 2, out += 4) {
+                const uint16_t v = Load16(src);
+                out[0] = ((v >> 10) & 31) * kInv31;
+                out[1] = ((v >> 5) & 31) * kInv31;
+                out[2] = (v & 31) * kInv31;
+                out[3] = f == PixelFormat::BGR555 ? 1.0f : float(v >> 15);
+            }
+            break;
+        case PixelFormat::RGBA1010102: case PixelFormat::BGR101010: {
+            const bool bgr = f == PixelFormat::BGR101010;
+            for (uint32_t x = 0; x < count; x++, src += 4, out += 4) {
+                const uint32_t v = Load32(src);
+                out[bgr ? 2 : 0] = (v & 1023) * kInv1023;
+                out[1] = ((v >> 10) & 1023) * kInv1023;
+                out[bgr ? 0 : 2] = ((v >> 20) & 1023) * kInv1023;
+                out[3] = bgr ? 1.0f : (v >> 30) * kInv3;
+            }
+            break;
+        }
+        case PixelFormat::Gray16:
+            for (uint32_t x = 0; x < count; x++, src += 2, out += 4) {
+                out[0] = out[1] = out[2] = Load16(src) * kInv65535;
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::RGB16: case PixelFormat::BGR16: case PixelFormat::RGBA16: case PixelFormat::BGRA16:
+        case PixelFormat::RGBX16: case PixelFormat::PRGBA16: case PixelFormat::PBGRA16: {
+            const int channels = StoredChannels(f);
+            const bool opaque = channels == 3 || f == PixelFormat::RGBX16;
+            for (uint32_t x = 0; x < count; x++, src += channels * 2, out += 4) {
+                out[0] = Load16(src + o.r * 2) * kInv65535;
+                out[1] = Load16(src + o.g * 2) * kInv65535;
+                out[2] = Load16(src + o.b * 2) * kInv65535;
+                out[3] = opaque ? 1.0f : Load16(src + o.a * 2) * kInv65535;
+            }
+            break;
+        }
+        case PixelFormat::GrayHalf:
+            for (uint32_t x = 0; x < count; x++, src += 2, out += 4) {
+                out[0] = out[1] = out[2] = halves[Load16(src)];
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::RGBHalf: case PixelFormat::RGBXHalf: case PixelFormat::RGBAHalf: case PixelFormat::PRGBAHalf: {
+            const bool opaque = f == PixelFormat::RGBHalf || f == PixelFormat::RGBXHalf;
+            const int stride = f == PixelFormat::RGBHalf ? 6 : 8;
+            for (uint32_t x = 0; x < count; x++, src += stride, out += 4) {
+                out[0] = halves[Load16(src)];
+                out[1] = halves[Load16(src + 2)];
+                out[2] = halves[Load16(src + 4)];
+                out[3] = opaque ? 1.0f : halves[Load16(src + 6)];
+            }
+            break;
+        }
+        case PixelFormat::GrayFloat:
+            for (uint32_t x = 0; x < count; x++, src += 4, out += 4) {
+                out[0] = out[1] = out[2] = LoadFloat(src);
+                out[3] = 1.0f;
+            }
+            break;
+        case PixelFormat::RGBFloat: case PixelFormat::RGBXFloat: case PixelFormat::RGBAFloat: case PixelFormat::PRGBAFloat: {
+            const bool opaque = f == PixelFormat::RGBFloat || f == PixelFormat::RGBXFloat;
+            const int stride = f == PixelFormat::RGBFloat ? 12 : 16;
+            for (uint32_t x = 0; x < count; x++, src += stride, out += 4) {
+                out[0] = LoadFloat(src);
+                out[1] = LoadFloat(src + 4);
+                out[2] = LoadFloat(src + 8);
+                out[3] = opaque ? 1.0f : LoadFloat(src + 12);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (IsPremultiplied(f)) {
+            out -= size_t(count) * 4;
+            for (uint32_t x = 0; x < count; x++, out += 4) {
+                const float a = out[3];
+                const float scale = a > 0.0f ? 1.0f / a : 0.0f;
+                for (int c = 0; c < 3; c++)
+                    out[c] = std::min(1.0f, out[c] * scale);
+            }
+        }
+    }
+
+    // Modifies in (premultiplication) for the premultiplied targets
+    void PackRow(PixelFormat f, float* in, uint32_t count, uint8_t* dst)
+    {
+        if (IsPremultiplied(f)) {
+            for (uint32_t x = 0; x < count; x++)
+                for (int c = 0; c < 3; c++)
+                    in[size_t(x) * 4 + c] *= in[size_t(x) * 4 + 3];
+        }
+
+        const Order o = ChannelOrder(f);
+        switch (f) {
+        case PixelFormat::RGBA8: case PixelFormat::BGRA8: case PixelFormat::PRGBA8: case PixelFormat::PBGRA8:
+        case PixelFormat::RGBX8: case PixelFormat::BGRX8: case PixelFormat::RGB8: case PixelFormat::BGR8: {
+            const int stride = StoredChannels(f);
+            const bool opaque = f == PixelFormat::RGBX8 || f == PixelFormat::BGRX8;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += stride) {
+                dst[o.r] = uint8_t(Quantize(in[0], 255));
+                dst[o.g] = uint8_t(Quantize(in[1], 255));
+                dst[o.b] = uint8_t(Quantize(in[2], 255));
+                if (stride == 4)
+                    dst[o.a] = opaque ? 255 : uint8_t(Quantize(in[3], 255));
+            }
+            break;
+        }
+        case PixelFormat::Gray8:
+            for (uint32_t x = 0; x < count; x++, in += 4)
+                dst[x] = uint8_t(Quantize(0.2126f * in[0] + 0.7152f * in[1] + 0.0722f * in[2], 255));
+            break;
+        case PixelFormat::Alpha8:
+            for (uint32_t x = 0; x < count; x++, in += 4)
+                dst[x] = uint8_t(Quantize(in[3], 255));
+            break;
+        case PixelFormat::BGR565:
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 2)
+                Store16(dst, uint16_t((Quantize(in[0], 31) << 11) | (Quantize(in[1], 63) << 5) | Quantize(in[2], 31)));
+            break;
+        case PixelFormat::BGR555: case PixelFormat::BGRA5551: {
+            const bool alpha = f == PixelFormat::BGRA5551;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 2)
+                Store16(dst, uint16_t(((alpha ? Quantize(in[3], 1) : 1u) << 15) | (Quantize(in[0], 31) << 10)
+                    | (Quantize(in[1], 31) << 5) | Quantize(in[2], 31)));
+            break;
+        }
+        case PixelFormat::RGBA1010102: case PixelFormat::BGR101010: {
+            const bool bgr = f == PixelFormat::BGR101010;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 4)
+                Store32(dst, Quantize(in[bgr ? 2 : 0], 1023) | (Quantize(in[1], 1023) << 10)
+                    | (Quantize(in[bgr ? 0 : 2], 1023) << 20) | ((bgr ? 3u : Quantize(in[3], 3)) << 30));
+            break;
+        }
+        case PixelFormat::Gray16:
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 2)
+                Store16(dst, uint16_t(Quantize(0.2126f * in[0] + 0.7152f * in[1] + 0.0722f * in[2], 65535)));
+            break;
+        case PixelFormat::RGB16: case PixelFormat::BGR16: case PixelFormat::RGBA16: case PixelFormat::BGRA16:
+        case PixelFormat::RGBX16: case PixelFormat::PRGBA16: case PixelFormat::PBGRA16: {
+            const int channels = StoredChannels(f);
+            const bool opaque = f == PixelFormat::RGBX16;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += channels * 2) {
+                Store16(dst + o.r * 2, uint16_t(Quantize(in[0], 65535)));
+                Store16(dst + o.g * 2, uint16_t(Quantize(in[1], 65535)));
+                Store16(dst + o.b * 2, uint16_t(Quantize(in[2], 65535)));
+                if (channels == 4)
+                    Store16(dst + o.a * 2, opaque ? uint16_t(65535) : uint16_t(Quantize(in[3], 65535)));
+            }
+            break;
+        }
+        case PixelFormat::GrayHalf:
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 2)
+                Store16(dst, FloatToHalf(0.2126f * in[0] + 0.7152f * in[1] + 0.0722f * in[2]));
+            break;
+        case PixelFormat::RGBHalf: case PixelFormat::RGBXHalf: case PixelFormat::RGBAHalf: case PixelFormat::PRGBAHalf: {
+            const int stride = f == PixelFormat::RGBHalf ? 6 : 8;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += stride) {
+                Store16(dst, FloatToHalf(in[0]));
+                Store16(dst + 2, FloatToHalf(in[1]));
+                Store16(dst + 4, FloatToHalf(in[2]));
+                if (stride == 8)
+                    Store16(dst + 6, FloatToHalf(f == PixelFormat::RGBXHalf ? 1.0f : in[3]));
+            }
+            break;
+        }
+        case PixelFormat::GrayFloat:
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += 4)
+                StoreFloat(dst, 0.2126f * in[0] + 0.7152f * in[1] + 0.0722f * in[2]);
+            break;
+        case PixelFormat::RGBFloat: case PixelFormat::RGBXFloat: case PixelFormat::RGBAFloat: case PixelFormat::PRGBAFloat: {
+            const int stride = f == PixelFormat::RGBFloat ? 12 : 16;
+            for (uint32_t x = 0; x < count; x++, in += 4, dst += stride) {
+                StoreFloat(dst, in[0]);
+                StoreFloat(dst + 4, in[1]);
+                StoreFloat(dst + 8, in[2]);
+                if (stride == 16)
+                    StoreFloat(dst + 12, f == PixelFormat::RGBXFloat ? 1.0f : in[3]);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Direct integer kernels for the common pairs. count is in pixels.
+    using RowKernel = void (*)(const uint8_t* src, uint8_t* dst, uint32_t count);
+
+    void SwapRB32Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 4, dst += 4) {
+            const uint8_t r = src[0], g = src[1], b = src[2], a = src[3];
+            dst[0] = b; dst[1] = g; dst[2] = r; dst[3] = a;
+        }
+    }
+
+    void SwapRBOpaque32Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 4, dst += 4) {
+            const uint8_t r = src[0], g = src[1], b = src[2];
+            dst[0] = b; dst[1] = g; dst[2] = r; dst[3] = 255;
+        }
+    }
+
+    void Opaque32Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 4, dst += 4)
+            Store32(dst, Load32(src) | 0xFF000000u);
+    }
+
+    void Expand24Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 3, dst += 4) {
+            dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255;
+        }
+    }
+
+    void Expand24SwapScalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 3, dst += 4) {
+            dst[0] = src[2]; dst[1] = src[1]; dst[2] = src[0]; dst[3] = 255;
+        }
+    }
+
+    void GrayToRgba8Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, dst += 4)
+            Store32(dst, src[x] * 0x010101u | 0xFF000000u);
+    }
+
+    void Expand48Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 6, dst += 8) {
+            std::memcpy(dst, src, 6);
+            Store16(dst + 6, 0xFFFF);
+        }
+    }
+
+    void Expand48SwapScalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 6, dst += 8) {
+            Store16(dst, Load16(src + 4));
+            Store16(dst + 2, Load16(src + 2));
+            Store16(dst + 4, Load16(src));
+            Store16(dst + 6, 0xFFFF);
+        }
+    }
+
+    void SwapRB64Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 8, dst += 8) {
+            const uint16_t r = Load16(src), g = Load16(src + 2), b = Load16(src + 4), a = Load16(src + 6);
+            Store16(dst, b); Store16(dst + 2, g); Store16(dst + 4, r); Store16(dst + 6, a);
+        }
+    }
+
+    void Opaque64Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 8, dst += 8) {
+            std::memcpy(dst, src, 6);
+            Store16(dst + 6, 0xFFFF);
+        }
+    }
+
+    void Set5551AlphaScalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        for (uint32_t x = 0; x < count; x++, src += 2, dst += 2)
+            Store16(dst, uint16_t(Load16(src) | 0x8000));
+    }
+
+    // ceil(2^32 / a): n * table[a] >> 32 == n / a for every n < 2^17
+    struct ReciprocalTable {
+        uint64_t value[256];
+        ReciprocalTable()
+        {
+            value[0] = 0;
+            for (uint32_t a = 1; a < 256; a++)
+                value[a] = ((uint64_t(1) << 32) + a - 1) / a;
+        }
+    };
+
+    // Straight = round(premultiplied * 255 / alpha), as the float path computes it
+    template <bool Swap>
+    void Unpremultiply8Scalar(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        static const ReciprocalTable reciprocal;
+        for (uint32_t x = 0; x < count; x++, src += 4, dst += 4) {
+            const uint32_t a = src[3];
+            const uint64_t r = reciprocal.value[a];
+            uint8_t c[3];
+            for (int i = 0; i < 3; i++)
+                c[i] = uint8_t(std::min<uint64_t>(255, ((src[i] * 255u + a / 2) * r) >> 32));
+            dst[0] = c[Swap ? 2 : 0]; dst[1] = c[1]; dst[2] = c[Swap ? 0 : 2]; dst[3] = uint8_t(a);
+        }
+    }
+
+#if defined(QISX_ARCH_X86)
+
+    QISX_TARGET("sse4.1")
+    void Shuffle32SSE41(const uint8_t* src, uint8_t* dst, uint32_t count, __m128i mask, __m128i fill, RowKernel tail)
+    {
+        uint32_t x = 0;
+        for (; x + 4 <= count; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(x) * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), fill));
+        }
+        tail(src + size_t(x) * 4, dst + size_t(x) * 4, count - x);
+    }
+
+    QISX_TARGET("sse4.1")
+    void SwapRB32SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Shuffle32SSE41(src, dst, count, _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15),
+            _mm_setzero_si128(), SwapRB32Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void SwapRBOpaque32SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Shuffle32SSE41(src, dst, count, _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15),
+            _mm_set1_epi32(int(0xFF000000u)), SwapRBOpaque32Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Opaque32SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Shuffle32SSE41(src, dst, count, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm_set1_epi32(int(0xFF000000u)), Opaque32Scalar);
+    }
+
+    // Four pixels from each 16-byte load, which reads 4 bytes past the 12 it
+    // uses: the loop stops while two more source pixels remain.
+    QISX_TARGET("sse4.1")
+    void Expand24SSE41(const uint8_t* src, uint8_t* dst, uint32_t count, __m128i mask, RowKernel tail)
+    {
+        const __m128i alpha = _mm_set1_epi32(int(0xFF000000u));
+        uint32_t x = 0;
+        for (; x + 6 <= count; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(x) * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+        }
+        tail(src + size_t(x) * 3, dst + size_t(x) * 4, count - x);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Expand24SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Expand24SSE41(src, dst, count, _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1), Expand24Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Expand24SwapSSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Expand24SSE41(src, dst, count, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1), Expand24SwapScalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void GrayToRgba8SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        const __m128i alpha = _mm_set1_epi32(int(0xFF000000u));
+        const __m128i masks[4] = {
+            _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+            _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+            _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+            _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1),
+        };
+        uint32_t x = 0;
+        for (; x + 16 <= count; x += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+            __m128i* out = reinterpret_cast<__m128i*>(dst + size_t(x) * 4);
+            _mm_storeu_si128(out, _mm_or_si128(_mm_shuffle_epi8(v, masks[0]), alpha));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(v, masks[1]), alpha));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(v, masks[2]), alpha));
+            _mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(v, masks[3]), alpha));
+        }
+        GrayToRgba8Scalar(src + x, dst + size_t(x) * 4, count - x);
+    }
+
+    // Two 16-bit pixels per load (12 of 16 bytes used; stops with a pixel to spare)
+    QISX_TARGET("sse4.1")
+    void Expand48SSE41(const uint8_t* src, uint8_t* dst, uint32_t count, __m128i mask, RowKernel tail)
+    {
+        const __m128i alpha = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+        uint32_t x = 0;
+        for (; x + 3 <= count; x += 2) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(x) * 6));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 8), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+        }
+        tail(src + size_t(x) * 6, dst + size_t(x) * 8, count - x);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Expand48SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Expand48SSE41(src, dst, count, _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1), Expand48Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Expand48SwapSSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Expand48SSE41(src, dst, count, _mm_setr_epi8(4, 5, 2, 3, 0, 1, -1, -1, 10, 11, 8, 9, 6, 7, -1, -1), Expand48SwapScalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Shuffle64SSE41(const uint8_t* src, uint8_t* dst, uint32_t count, __m128i mask, __m128i fill, RowKernel tail)
+    {
+        uint32_t x = 0;
+        for (; x + 2 <= count; x += 2) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(x) * 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 8), _mm_or_si128(_mm_shuffle_epi8(v, mask), fill));
+        }
+        tail(src + size_t(x) * 8, dst + size_t(x) * 8, count - x);
+    }
+
+    QISX_TARGET("sse4.1")
+    void SwapRB64SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Shuffle64SSE41(src, dst, count, _mm_setr_epi8(4, 5, 2, 3, 0, 1, 6, 7, 12, 13, 10, 11, 8, 9, 14, 15),
+            _mm_setzero_si128(), SwapRB64Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Opaque64SSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        Shuffle64SSE41(src, dst, count, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1), Opaque64Scalar);
+    }
+
+    QISX_TARGET("sse4.1")
+    void Set5551AlphaSSE41(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        const __m128i alpha = _mm_set1_epi16(short(0x8000));
+        uint32_t x = 0;
+        for (; x + 8 <= count; x += 8) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(x) * 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 2), _mm_or_si128(v, alpha));
+        }
+        Set5551AlphaScalar(src + size_t(x) * 2, dst + size_t(x) * 2, count - x);
+    }
+
+#elif defined(QISX_ARCH_ARM64)
+
+    // NEON's structured loads de-interleave channels, so every swizzle is a
+    // register rename between vld3/vld4 and vst4.
+    void SwapRB32NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 16 <= count; x += 16) {
+            uint8x16x4_t v = vld4q_u8(src + size_t(x) * 4);
+            std::swap(v.val[0], v.val[2]);
+            vst4q_u8(dst + size_t(x) * 4, v);
+        }
+        SwapRB32Scalar(src + size_t(x) * 4, dst + size_t(x) * 4, count - x);
+    }
+
+    void SwapRBOpaque32NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 16 <= count; x += 16) {
+            uint8x16x4_t v = vld4q_u8(src + size_t(x) * 4);
+            std::swap(v.val[0], v.val[2]);
+            v.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dst + size_t(x) * 4, v);
+        }
+        SwapRBOpaque32Scalar(src + size_t(x) * 4, dst + size_t(x) * 4, count - x);
+    }
+
+    void Opaque32NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+        uint32_t x = 0;
+        for (; x + 4 <= count; x += 4)
+            vst1q_u8(dst + size_t(x) * 4, vreinterpretq_u8_u32(vorrq_u32(vreinterpretq_u32_u8(vld1q_u8(src + size_t(x) * 4)), alpha)));
+        Opaque32Scalar(src + size_t(x) * 4, dst + size_t(x) * 4, count - x);
+    }
+
+    template <bool Swap>
+    void Expand24NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 16 <= count; x += 16) {
+            const uint8x16x3_t v = vld3q_u8(src + size_t(x) * 3);
+            uint8x16x4_t out;
+            out.val[0] = v.val[Swap ? 2 : 0];
+            out.val[1] = v.val[1];
+            out.val[2] = v.val[Swap ? 0 : 2];
+            out.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dst + size_t(x) * 4, out);
+        }
+        (Swap ? Expand24SwapScalar : Expand24Scalar)(src + size_t(x) * 3, dst + size_t(x) * 4, count - x);
+    }
+
+    void GrayToRgba8NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 16 <= count; x += 16) {
+            const uint8x16_t g = vld1q_u8(src + x);
+            uint8x16x4_t out;
+            out.val[0] = out.val[1] = out.val[2] = g;
+            out.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dst + size_t(x) * 4, out);
+        }
+        GrayToRgba8Scalar(src + x, dst + size_t(x) * 4, count - x);
+    }
+
+    template <bool Swap>
+    void Expand48NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 8 <= count; x += 8) {
+            const uint16x8x3_t v = vld3q_u16(reinterpret_cast<const uint16_t*>(src + size_t(x) * 6));
+            uint16x8x4_t out;
+            out.val[0] = v.val[Swap ? 2 : 0];
+            out.val[1] = v.val[1];
+            out.val[2] = v.val[Swap ? 0 : 2];
+            out.val[3] = vdupq_n_u16(0xFFFF);
+            vst4q_u16(reinterpret_cast<uint16_t*>(dst + size_t(x) * 8), out);
+        }
+        (Swap ? Expand48SwapScalar : Expand48Scalar)(src + size_t(x) * 6, dst + size_t(x) * 8, count - x);
+    }
+
+    void SwapRB64NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        uint32_t x = 0;
+        for (; x + 8 <= count; x += 8) {
+            uint16x8x4_t v = vld4q_u16(reinterpret_cast<const uint16_t*>(src + size_t(x) * 8));
+            std::swap(v.val[0], v.val[2]);
+            vst4q_u16(reinterpret_cast<uint16_t*>(dst + size_t(x) * 8), v);
+        }
+        SwapRB64Scalar(src + size_t(x) * 8, dst + size_t(x) * 8, count - x);
+    }
+
+    void Opaque64NEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        const uint64x2_t alpha = vdupq_n_u64(0xFFFF000000000000ull);
+        uint32_t x = 0;
+        for (; x + 2 <= count; x += 2)
+            vst1q_u8(dst + size_t(x) * 8, vreinterpretq_u8_u64(vorrq_u64(vreinterpretq_u64_u8(vld1q_u8(src + size_t(x) * 8)), alpha)));
+        Opaque64Scalar(src + size_t(x) * 8, dst + size_t(x) * 8, count - x);
+    }
+
+    void Set5551AlphaNEON(const uint8_t* src, uint8_t* dst, uint32_t count)
+    {
+        const uint16x8_t alpha = vdupq_n_u16(0x8000);
+        uint32_t x = 0;
+        for (; x + 8 <= count; x += 8) {
+            const uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t*>(src + size_t(x) * 2));
+            vst1q_u16(reinterpret_cast<uint16_t*>(dst + size_t(x) * 2), vorrq_u16(v, alpha));
+        }
+        Set5551AlphaScalar(src + size_t(x) * 2, dst + size_t(x) * 2, count - x);
+    }
+
+#endif
+
+    struct DirectKernel {
+        PixelFormat src;
+        PixelFormat dst;
+        RowKernel scalar;
+        RowKernel simd;     // nullptr = scalar only
+    };
+
+#if defined(QISX_ARCH_X86)
+#define QISX_SIMD_KERNEL(x86, arm) x86
+#elif defined(QISX_ARCH_ARM64)
+#define QISX_SIMD_KERNEL(x86, arm) arm
+#else
+#define QISX_SIMD_KERNEL(x86, arm) nullptr
+#endif
+
+    const DirectKernel kDirectKernels[] = {
+        { PixelFormat::BGRA8,  PixelFormat::RGBA8,    SwapRB32Scalar,       QISX_SIMD_KERNEL(SwapRB32SSE41, SwapRB32NEON) },
+        { PixelFormat::RGBA8,  PixelFormat::BGRA8,    SwapRB32Scalar,       QISX_SIMD_KERNEL(SwapRB32SSE41, SwapRB32NEON) },
+        { PixelFormat::BGRX8,  PixelFormat::RGBA8,    SwapRBOpaque32Scalar, QISX_SIMD_KERNEL(SwapRBOpaque32SSE41, SwapRBOpaque32NEON) },
+        { PixelFormat::RGBX8,  PixelFormat::BGRA8,    SwapRBOpaque32Scalar, QISX_SIMD_KERNEL(SwapRBOpaque32SSE41, SwapRBOpaque32NEON) },
+        { PixelFormat::RGBX8,  PixelFormat::RGBA8,    Opaque32Scalar,       QISX_SIMD_KERNEL(Opaque32SSE41, Opaque32NEON) },
+        { PixelFormat::BGRX8,  PixelFormat::BGRA8,    Opaque32Scalar,       QISX_SIMD_KERNEL(Opaque32SSE41, Opaque32NEON) },
+        { PixelFormat::RGB8,   PixelFormat::RGBA8,    Expand24Scalar,       QISX_SIMD_KERNEL(Expand24SSE41, Expand24NEON<false>) },
+        { PixelFormat::BGR8,   PixelFormat::BGRA8,    Expand24Scalar,       QISX_SIMD_KERNEL(Expand24SSE41, Expand24NEON<false>) },
+        { PixelFormat::BGR8,   PixelFormat::RGBA8,    Expand24SwapScalar,   QISX_SIMD_KERNEL(Expand24SwapSSE41, Expand24NEON<true>) },
+        { PixelFormat::RGB8,   PixelFormat::BGRA8,    Expand24SwapScalar,   QISX_SIMD_KERNEL(Expand24SwapSSE41, Expand24NEON<true>) },
+        { PixelFormat::Gray8,  PixelFormat::RGBA8,    GrayToRgba8Scalar,    QISX_SIMD_KERNEL(GrayToRgba8SSE41, GrayToRgba8NEON) },
+        { PixelFormat::Gray8,  PixelFormat::BGRA8,    GrayToRgba8Scalar,    QISX_SIMD_KERNEL(GrayToRgba8SSE41, GrayToRgba8NEON) },
+        { PixelFormat::RGB16,  PixelFormat::RGBA16,   Expand48Scalar,       QISX_SIMD_KERNEL(Expand48SSE41, Expand48NEON<false>) },
+        { PixelFormat::BGR16,  PixelFormat::RGBA16,   Expand48SwapScalar,   QISX_SIMD_KERNEL(Expand48SwapSSE41, Expand48NEON<true>) },
+        { PixelFormat::BGRA16, PixelFormat::RGBA16,   SwapRB64Scalar,       QISX_SIMD_KERNEL(SwapRB64SSE41, SwapRB64NEON) },
+        { PixelFormat::RGBA16, PixelFormat::BGRA16,   SwapRB64Scalar,       QISX_SIMD_KERNEL(SwapRB64SSE41, SwapRB64NEON) },
+        { PixelFormat::RGBX16, PixelFormat::RGBA16,   Opaque64Scalar,       QISX_SIMD_KERNEL(Opaque64SSE41, Opaque64NEON) },
+        { PixelFormat::BGR555, PixelFormat::BGRA5551, Set5551AlphaScalar,   QISX_SIMD_KERNEL(Set5551AlphaSSE41, Set5551AlphaNEON) },
+        { PixelFormat::PRGBA8, PixelFormat::RGBA8,    Unpremultiply8Scalar<false>, nullptr },
+        { PixelFormat::PBGRA8, PixelFormat::BGRA8,    Unpremultiply8Scalar<false>, nullptr },
+        { PixelFormat::PBGRA8, PixelFormat::RGBA8,    Unpremultiply8Scalar<true>,  nullptr },
+        { PixelFormat::PRGBA8, PixelFormat::BGRA8,    Unpremultiply8Scalar<true>,  nullptr },
+    };
+
+#undef QISX_SIMD_KERNEL
+
+    RowKernel FindDirectKernel(PixelFormat src, PixelFormat dst, SimdLevel simd)
+    {
+        if (simd == SimdLevel::Auto)
+            simd = DetectSimdLevel();
+        const bool vector = simd != SimdLevel::Scalar && IsSimdLevelSupported(simd);
+        for (const DirectKernel& k : kDirectKernels) {
+            if (k.src == src && k.dst == dst)
+                return vector && k.simd ? k.simd : k.scalar;
+        }
+        return nullptr;
+    }
+
+}
+
+const char* PixelFormatName(PixelFormat format)
+{
+    return Info(format).name;
+}
+
+uint32_t PixelFormatBitsPerPixel(PixelFormat format)
+{
+    return Info(format).bitsPerPixel;
+}
+
+PixelFormat NearestTargetFormat(PixelFormat format)
+{
+    return Info(format).nearest;
+}
+
+bool CanConvertPixels(PixelFormat src, PixelFormat dst)
+{
+    return src != PixelFormat::Unknown && Info(dst).writable;
+}
+
+bool ConvertPixels(const void* src, size_t srcRowPitch, PixelFormat srcFormat,
+    void* dst, size_t dstRowPitch, PixelFormat dstFormat,
+    uint32_t width, uint32_t height, ThreadPool* pool, SimdLevel simd)
+{
+    if (!src || !dst || width == 0 || height == 0 || !CanConvertPixels(srcFormat, dstFormat))
+        return false;
+
+    const RowKernel direct = FindDirectKernel(srcFormat, dstFormat, simd);
+    const size_t copyBytes = srcFormat == dstFormat ? (size_t(width) * Info(srcFormat).bitsPerPixel + 7) / 8 : 0;
+
+    auto convertRows = [&](uint32_t y0, uint32_t y1) {
+        alignas(16) float rgba[kChunk * 4];
+        for (uint32_t y = y0; y < y1; y++) {
+            const uint8_t* s = static_cast<const uint8_t*>(src) + y * srcRowPitch;
+            uint8_t* d = static_cast<uint8_t*>(dst) + y * dstRowPitch;
+            if (copyBytes)
+                std::memcpy(d, s, copyBytes);
+            else if (direct)
+                direct(s, d, width);
+            else {
+                // Chunks start on multiples of 256 pixels, so sub-byte rows stay byte aligned
+                for (uint32_t x = 0; x < width; x += kChunk) {
+                    const uint32_t n = std::min(kChunk, width - x);
+                    UnpackRow(srcFormat, s + size_t(x) * Info(srcFormat).bitsPerPixel / 8, n, rgba);
+                    PackRow(dstFormat, rgba, n, d + size_t(x) * Info(dstFormat).bitsPerPixel / 8);
+                }
+            }
+        }
+    };
+
+    if (!pool || pool->GetThreadCount() <= 1 || height < 2) {
+        convertRows(0, height);
+        return true;
+    }
+    const uint32_t bands = std::min(height, pool->GetThreadCount() * 4);
+    pool->ParallelFor(bands, [&](uint32_t band, unsigned) {
+        convertRows(uint32_t(uint64_t(height) * band / bands), uint32_t(uint64_t(height) * (band + 1) / bands));
+    });
+    return true;
+}
+
+float HalfToFloat(uint16_t half)
+{
+    return GetHalfTable().value[half];
+}
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = uint16_t((bits >> 16) & 0x8000);
+    const uint32_t abs = bits & 0x7FFFFFFFu;
+
+    if (abs >= 0x7F800000u)                                     // Inf / NaN
+        return uint16_t(sign | 0x7C00 | (abs > 0x7F800000u ? 0x200 : 0));
+    if (abs >= 0x477FF000u)                                     // Rounds past 65504
+        return uint16_t(sign | 0x7C00);
+    if (abs < 0x38800000u) {
+        // Subnormal half (or zero): align the implicit bit, round to nearest even
+        if (abs < 0x33000000u)
+            return sign;
+        const uint32_t shift = 126 - (abs >> 23);
+        const uint32_t mantissa = (abs & 0x7FFFFFu) | 0x800000u;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return uint16_t(sign | half);
+    }
+    // Normal: rebias, round to nearest even on the 13 dropped bits
+    uint32_t half = ((abs >> 13) - (112u << 10));
+    const uint32_t rest = abs & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    return uint16_t(sign | half);
+}
+
+}
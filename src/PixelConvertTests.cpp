@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+#include "PixelConvert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    std::vector<uint8_t> RandomBytes(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& b : bytes) {
+            seed = seed * 1664525u + 1013904223u;
+            b = uint8_t(seed >> 24);
+        }
+        return bytes;
+    }
+
+    size_t RowBytes(qisx::PixelFormat format, uint32_t width)
+    {
+        return (size_t(width) * qisx::PixelFormatBitsPerPixel(format) + 7) / 8;
+    }
+
+    const qisx::PixelFormat kIntegerFormats[] = {
+        qisx::PixelFormat::RGBA8, qisx::PixelFormat::BGRA8, qisx::PixelFormat::RGBX8, qisx::PixelFormat::BGRX8,
+        qisx::PixelFormat::RGB8, qisx::PixelFormat::BGR8, qisx::PixelFormat::Gray8, qisx::PixelFormat::Alpha8,
+        qisx::PixelFormat::BGR565, qisx::PixelFormat::BGR555, qisx::PixelFormat::BGRA5551,
+        qisx::PixelFormat::RGBA1010102, qisx::PixelFormat::BGR101010, qisx::PixelFormat::Gray16,
+        qisx::PixelFormat::RGB16, qisx::PixelFormat::BGR16, qisx::PixelFormat::RGBA16, qisx::PixelFormat::BGRA16,
+    };
+
+}
+
+TEST(PixelConvertTests, RoundTripsThroughFloatAreExact)
+{
+    // Every unorm format survives a trip through RGBA float and back, except
+    // for its padding bits
+    const uint32_t width = 300, height = 3;
+    for (qisx::PixelFormat format : kIntegerFormats) {
+        std::vector<uint8_t> src = RandomBytes(RowBytes(format, width) * height, 7);
+        std::vector<float> rgba(size_t(width) * height * 4);
+        std::vector<uint8_t> back(src.size());
+
+        ASSERT_TRUE(qisx::ConvertPixels(src.data(), RowBytes(format, width), format,
+            rgba.data(), size_t(width) * 16, qisx::PixelFormat::RGBAFloat, width, height));
+        ASSERT_TRUE(qisx::ConvertPixels(rgba.data(), size_t(width) * 16, qisx::PixelFormat::RGBAFloat,
+            back.data(), RowBytes(format, width), format, width, height));
+
+        std::vector<uint8_t> expected = src;
+        if (format == qisx::PixelFormat::RGBX8 || format == qisx::PixelFormat::BGRX8) {
+            for (size_t i = 3; i < expected.size(); i += 4)
+                expected[i] = 255;
+        }
+        else if (format == qisx::PixelFormat::BGR555) {
+            for (size_t i = 1; i < expected.size(); i += 2)
+                expected[i] |= 0x80;
+        }
+        else if (format == qisx::PixelFormat::BGR101010) {
+            for (size_t i = 3; i < expected.size(); i += 4)
+                expected[i] |= 0xC0;
+        }
+        EXPECT_EQ(back, expected) << qisx::PixelFormatName(format);
+    }
+}
+
+TEST(PixelConvertTests, DirectKernelsMatchTheFloatPath)
+{
+    // Odd widths exercise every vector tail
+    const std::pair<qisx::PixelFormat, qisx::PixelFormat> pairs[] = {
+        { qisx::PixelFormat::BGRA8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::RGBA8, qisx::PixelFormat::BGRA8 },
+        { qisx::PixelFormat::BGRX8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::RGBX8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::RGB8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::BGR8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::BGR8, qisx::PixelFormat::BGRA8 },
+        { qisx::PixelFormat::Gray8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::RGB16, qisx::PixelFormat::RGBA16 },
+        { qisx::PixelFormat::BGR16, qisx::PixelFormat::RGBA16 },
+        { qisx::PixelFormat::BGRA16, qisx::PixelFormat::RGBA16 },
+        { qisx::PixelFormat::RGBX16, qisx::PixelFormat::RGBA16 },
+        { qisx::PixelFormat::BGR555, qisx::PixelFormat::BGRA5551 },
+        { qisx::PixelFormat::PBGRA8, qisx::PixelFormat::RGBA8 },
+        { qisx::PixelFormat::PRGBA8, qisx::PixelFormat::RGBA8 },
+    };
+    for (uint32_t width : { 1u, 5u, 17u, 64u, 67u }) {
+        for (const auto& [from, to] : pairs) {
+            const uint32_t height = 4;
+            const size_t srcPitch = RowBytes(from, width) + 3;
+            const size_t dstPitch = RowBytes(to, width);
+            const std::vector<uint8_t> src = RandomBytes(srcPitch * height, width);
+
+            // Reference: through float explicitly
+            std::vector<float> rgba(size_t(width) * height * 4);
+            std::vector<uint8_t> expected(dstPitch * height);
+            ASSERT_TRUE(qisx::ConvertPixels(src.data(), srcPitch, from, rgba.data(), size_t(width) * 16,
+                qisx::PixelFormat::RGBAFloat, width, height));
+            ASSERT_TRUE(qisx::ConvertPixels(rgba.data(), size_t(width) * 16, qisx::PixelFormat::RGBAFloat,
+                expected.data(), dstPitch, to, width, height));
+
+            for (qisx::SimdLevel simd : { qisx::SimdLevel::Scalar, qisx::SimdLevel::Auto }) {
+                std::vector<uint8_t> actual(dstPitch * height);
+                ASSERT_TRUE(qisx::ConvertPixels(src.data(), srcPitch, from, actual.data(), dstPitch, to,
+                    width, height, nullptr, simd));
+                // Un-premultiplying in integers rounds exact ties up; float division
+                // can land just below them
+                const int tolerance = from == qisx::PixelFormat::PBGRA8 || from == qisx::PixelFormat::PRGBA8 ? 1 : 0;
+                int worst = 0;
+                for (size_t i = 0; i < actual.size(); i++)
+                    worst = std::max(worst, std::abs(int(actual[i]) - int(expected[i])));
+                EXPECT_LE(worst, tolerance) << qisx::PixelFormatName(from) << " -> " << qisx::PixelFormatName(to)
+                    << " width " << width << (simd == qisx::SimdLevel::Scalar ? " scalar" : " simd");
+            }
+        }
+    }
+}
+
+TEST(PixelConvertTests, ThreadedMatchesSingleThreaded)
+{
+    const uint32_t width = 129, height = 77;
+    const std::vector<uint8_t> src = RandomBytes(size_t(width) * 3 * height, 3);
+    std::vector<uint8_t> single(size_t(width) * 2 * height), threaded(single.size());
+
+    ASSERT_TRUE(qisx::ConvertPixels(src.data(), width * 3, qisx::PixelFormat::BGR8,
+        single.data(), width * 2, qisx::PixelFormat::BGR565, width, height));
+    qisx::ThreadPool pool(4);
+    ASSERT_TRUE(qisx::ConvertPixels(src.data(), width * 3, qisx::PixelFormat::BGR8,
+        threaded.data(), width * 2, qisx::PixelFormat::BGR565, width, height, &pool));
+    EXPECT_EQ(single, threaded);
+}
+
+TEST(PixelConvertTests, ReadsPackedAndSpecialFormats)
+{
+    uint8_t rgba[4 * 4];
+
+    // Gray2, most significant bits first: 0, 1, 2, 3
+    const uint8_t gray2 = 0x1B;
+    ASSERT_TRUE(qisx::ConvertPixels(&gray2, 1, qisx::PixelFormat::Gray2, rgba, 16, qisx::PixelFormat::RGBA8, 4, 1));
+    EXPECT_EQ(rgba[0], 0);
+    EXPECT_EQ(rgba[4], 85);
+    EXPECT_EQ(rgba[8], 170);
+    EXPECT_EQ(rgba[12], 255);
+    EXPECT_EQ(rgba[15], 255);
+
+    // CMYK: 50% cyan, no key
+    const uint8_t cmyk[4] = { 128, 0, 0, 0 };
+    ASSERT_TRUE(qisx::ConvertPixels(cmyk, 4, qisx::PixelFormat::CMYK8, rgba, 4, qisx::PixelFormat::RGBA8, 1, 1));
+    EXPECT_EQ(rgba[0], 127);
+    EXPECT_EQ(rgba[1], 255);
+    EXPECT_EQ(rgba[2], 255);
+
+    // Premultiplied half alpha white un-premultiplies to white
+    const uint8_t pbgra[4] = { 128, 128, 128, 128 };
+    ASSERT_TRUE(qisx::ConvertPixels(pbgra, 4, qisx::PixelFormat::PBGRA8, rgba, 4, qisx::PixelFormat::RGBA8, 1, 1));
+    EXPECT_EQ(rgba[0], 255);
+    EXPECT_EQ(rgba[3], 128);
+
+    // Grey is written as luma
+    const uint8_t green[4] = { 0, 255, 0, 255 };
+    uint8_t gray = 0;
+    ASSERT_TRUE(qisx::ConvertPixels(green, 4, qisx::PixelFormat::RGBA8, &gray, 1, qisx::PixelFormat::Gray8, 1, 1));
+    EXPECT_EQ(gray, 182);
+
+    EXPECT_FALSE(qisx::CanConvertPixels(qisx::PixelFormat::RGBA8, qisx::PixelFormat::CMYK8));
+    EXPECT_FALSE(qisx::ConvertPixels(green, 4, qisx::PixelFormat::RGBA8, rgba, 4, qisx::PixelFormat::Gray1, 1, 1));
+    EXPECT_FALSE(qisx::ConvertPixels(green, 4, qisx::PixelFormat::Unknown, rgba, 4, qisx::PixelFormat::RGBA8, 1, 1));
+}
+
+TEST(PixelConvertTests, NearestTargetFormatsMatchTheLoaderTable)
+{
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::BGR8), qisx::PixelFormat::RGBA8);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::BGRX8), qisx::PixelFormat::BGRX8);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::Gray4), qisx::PixelFormat::Gray8);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::BGR555), qisx::PixelFormat::BGRA5551);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::BGR101010), qisx::PixelFormat::RGBA1010102);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::RGB16), qisx::PixelFormat::RGBA16);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::RGBXHalf), qisx::PixelFormat::RGBAHalf);
+    EXPECT_EQ(qisx::NearestTargetFormat(qisx::PixelFormat::CMYK8), qisx::PixelFormat::RGBA8);
+}
+
+TEST(PixelConvertTests, HalfConversionRoundsToNearestEven)
+{
+    EXPECT_EQ(qisx::FloatToHalf(0.0f), 0x0000);
+    EXPECT_EQ(qisx::FloatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(qisx::FloatToHalf(1.0f), 0x3C00);
+    EXPECT_EQ(qisx::FloatToHalf(-2.0f), 0xC000);
+    EXPECT_EQ(qisx::FloatToHalf(65504.0f), 0x7BFF);
+    EXPECT_EQ(qisx::FloatToHalf(65520.0f), 0x7C00);
+    EXPECT_EQ(qisx::FloatToHalf(1e-8f), 0x0000);
+    EXPECT_EQ(qisx::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+    EXPECT_EQ(qisx::FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00) << "tie rounds to even";
+    EXPECT_EQ(qisx::FloatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02) << "tie rounds to even";
+    EXPECT_TRUE(std::isnan(qisx::HalfToFloat(qisx::FloatToHalf(NAN))));
+
+    // Every finite half survives the round trip
+    for (uint32_t h = 0; h < 0x10000; h++) {
+        if ((h & 0x7C00) == 0x7C00)
+            continue;
+        ASSERT_EQ(qisx::FloatToHalf(qisx::HalfToFloat(uint16_t(h))), h) << std::hex << h;
+    }
+    EXPECT_EQ(qisx::HalfToFloat(0x0001), std::ldexp(1.0f, -24));
+    EXPECT_EQ(qisx::HalfToFloat(0x3555), 0.333251953125f);
+}
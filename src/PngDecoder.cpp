@@ -0,0 +1,393 @@
+#include "ImageDecoder.h"
+#include "Zlib.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace qisx {
+
+namespace {
+
+    const uint8_t kPngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+    uint32_t ReadBE32(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    struct PngHeader {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        int bitDepth = 0;
+        int colorType = 0;
+        bool interlaced = false;
+
+        int Channels() const
+        {
+            switch (colorType) {
+            case 0: return 1;   // Grey
+            case 2: return 3;   // RGB
+            case 3: return 1;   // Palette
+            case 4: return 2;   // Grey + alpha
+            default: return 4;  // RGBA
+            }
+        }
+
+        size_t BitsPerPixel() const { return size_t(Channels()) * bitDepth; }
+        size_t RowBytes(uint32_t w) const { return (size_t(w) * BitsPerPixel() + 7) / 8; }
+        // Filter distance in bytes (at least 1 for sub-byte formats)
+        size_t FilterStride() const { return std::max<size_t>(1, BitsPerPixel() / 8); }
+    };
+
+    // Everything needed from the chunk stream. IDAT payloads are referenced in
+    // place and handed to the inflater as spans, so they are never concatenated.
+    struct PngChunks {
+        PngHeader header;
+        uint8_t palette[256][4];
+        int paletteSize = 0;
+        bool hasColorKey = false;
+        uint16_t colorKey[3] = {};
+        std::vector<ByteSpan> idat;
+    };
+
+    bool ValidHeader(const PngHeader& h)
+    {
+        if (h.width == 0 || h.height == 0 || h.width > (1u << 24) || h.height > (1u << 24))
+            return false;
+        switch (h.colorType) {
+        case 0: return h.bitDepth == 1 || h.bitDepth == 2 || h.bitDepth == 4 || h.bitDepth == 8 || h.bitDepth == 16;
+        case 3: return h.bitDepth == 1 || h.bitDepth == 2 || h.bitDepth == 4 || h.bitDepth == 8;
+        case 2:
+        case 4:
+        case 6: return h.bitDepth == 8 || h.bitDepth == 16;
+        default: return false;
+        }
+    }
+
+    bool ReadChunks(const uint8_t* data, size_t size, bool headerOnly, PngChunks& chunks, std::string* error)
+    {
+        if (size < 8 || std::memcmp(data, kPngSignature, 8) != 0) {
+            SetError(error, "not a PNG file");
+            return false;
+        }
+
+        bool haveHeader = false;
+        size_t pos = 8;
+        for (;;) {
+            if (pos + 12 > size) {
+                SetError(error, "truncated PNG");
+                return false;
+            }
+            const uint32_t length = ReadBE32(data + pos);
+            const uint8_t* type = data + pos + 4;
+            const uint8_t* payload = data + pos + 8;
+            if (length > size - pos - 12) {
+                SetError(error, "truncated PNG chunk");
+                return false;
+            }
+            pos += size_t(length) + 12;
+
+            if (!std::memcmp(type, "IHDR", 4)) {
+                // Header CRC is checked so garbage never drives allocation sizes;
+                // pixel data integrity is covered by the zlib Adler-32
+                if (length != 13 || Crc32(type, 17) != ReadBE32(payload + 13)) {
+                    SetError(error, "bad PNG header");
+                    return false;
+                }
+                PngHeader& h = chunks.header;
+                h.width = ReadBE32(payload);
+                h.height = ReadBE32(payload + 4);
+                h.bitDepth = payload[8];
+                h.colorType = payload[9];
+                h.interlaced = payload[12] == 1;
+                if (!ValidHeader(h) || payload[10] != 0 || payload[11] != 0 || payload[12] > 1) {
+                    SetError(error, "unsupported PNG header");
+                    return false;
+                }
+                haveHeader = true;
+                if (headerOnly)
+                    return true;
+            }
+            else if (!haveHeader) {
+                SetError(error, "PNG does not start with IHDR");
+                return false;
+            }
+            else if (!std::memcmp(type, "PLTE", 4)) {
+                if (length % 3 || length > 768) {
+                    SetError(error, "bad PNG palette");
+                    return false;
+                }
+                chunks.paletteSize = int(length / 3);
+                for (int i = 0; i < chunks.paletteSize; i++) {
+                    chunks.palette[i][0] = payload[i * 3];
+                    chunks.palette[i][1] = payload[i * 3 + 1];
+                    chunks.palette[i][2] = payload[i * 3 + 2];
+                    chunks.palette[i][3] = 255;
+                }
+            }
+            else if (!std::memcmp(type, "tRNS", 4)) {
+                const int colorType = chunks.header.colorType;
+                if (colorType == 3) {
+                    for (uint32_t i = 0; i < length && int(i) < chunks.paletteSize; i++)
+                        chunks.palette[i][3] = payload[i];
+                }
+                else if (colorType == 0 && length >= 2) {
+                    chunks.hasColorKey = true;
+                    chunks.colorKey[0] = uint16_t((payload[0] << 8) | payload[1]);
+                }
+                else if (colorType == 2 && length >= 6) {
+                    chunks.hasColorKey = true;
+                    for (int c = 0; c < 3; c++)
+                        chunks.colorKey[c] = uint16_t((payload[c * 2] << 8) | payload[c * 2 + 1]);
+                }
+            }
+            else if (!std::memcmp(type, "IDAT", 4)) {
+                if (length)
+                    chunks.idat.push_back({ payload, length });
+            }
+            else if (!std::memcmp(type, "IEND", 4)) {
+                break;
+            }
+            else if (!(type[0] & 0x20)) {
+                SetError(error, "PNG uses an unknown critical chunk");
+                return false;
+            }
+        }
+
+        if (!haveHeader || chunks.idat.empty()) {
+            SetError(error, "PNG has no image data");
+            return false;
+        }
+        if (chunks.header.colorType == 3 && chunks.paletteSize == 0) {
+            SetError(error, "palette PNG without PLTE");
+            return false;
+        }
+        return true;
+    }
+
+    inline uint8_t Paeth(int a, int b, int c)
+    {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return uint8_t(a);
+        return uint8_t(pb <= pc ? b : c);
+    }
+
+    // Reverses one row's filter. in and out may alias; above is the previous
+    // reconstructed row or null for the first row of a (sub-)image.
+    bool Unfilter(int type, const uint8_t* in, const uint8_t* above, uint8_t* out, size_t bytes, size_t stride)
+    {
+        switch (type) {
+        case 0:
+            if (in != out)
+                std::memcpy(out, in, bytes);
+            return true;
+        case 1:
+            for (size_t i = 0; i < bytes; i++)
+                out[i] = uint8_t(in[i] + (i >= stride ? out[i - stride] : 0));
+            return true;
+        case 2:
+            for (size_t i = 0; i < bytes; i++)
+                out[i] = uint8_t(in[i] + (above ? above[i] : 0));
+            return true;
+        case 3:
+            for (size_t i = 0; i < bytes; i++) {
+                const int a = i >= stride ? out[i - stride] : 0;
+                const int b = above ? above[i] : 0;
+                out[i] = uint8_t(in[i] + ((a + b) >> 1));
+            }
+            return true;
+        case 4:
+            for (size_t i = 0; i < bytes; i++) {
+                const int a = i >= stride ? out[i - stride] : 0;
+                const int b = above ? above[i] : 0;
+                const int c = (above && i >= stride) ? above[i - stride] : 0;
+                out[i] = uint8_t(in[i] + Paeth(a, b, c));
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Converts `count` pixels of an unfiltered row to RGBA8, writing every
+    // `step`-th pixel of out (step > 1 for Adam7 passes).
+    void ExpandRow(const PngChunks& chunks, const uint8_t* row, uint32_t count, uint8_t* out, size_t step)
+    {
+        const PngHeader& h = chunks.header;
+        const size_t advance = step * 4;
+
+        if (h.bitDepth < 8) {
+            const int depth = h.bitDepth;
+            const int mask = (1 << depth) - 1;
+            const int scale = 255 / mask;
+            for (uint32_t x = 0; x < count; x++, out += advance) {
+                const size_t bit = size_t(x) * depth;
+                const int v = (row[bit >> 3] >> (8 - depth - int(bit & 7))) & mask;
+                if (h.colorType == 3) {
+                    std::memcpy(out, chunks.palette[v < chunks.paletteSize ? v : 0], 4);
+                }
+                else {
+                    out[0] = out[1] = out[2] = uint8_t(v * scale);
+                    out[3] = (chunks.hasColorKey && v == chunks.colorKey[0]) ? 0 : 255;
+                }
+            }
+            return;
+        }
+
+        // 16-bit samples keep their high byte; colour keys compare at full depth
+        const int bytes = h.bitDepth / 8;
+        auto sample = [&](const uint8_t* p) { return bytes == 2 ? (p[0] << 8) | p[1] : p[0]; };
+        const int channels = h.Channels();
+        const size_t pixelBytes = size_t(channels) * bytes;
+        for (uint32_t x = 0; x < count; x++, out += advance, row += pixelBytes) {
+            switch (h.colorType) {
+            case 0:
+                out[0] = out[1] = out[2] = row[0];
+                out[3] = (chunks.hasColorKey && sample(row) == chunks.colorKey[0]) ? 0 : 255;
+                break;
+            case 2:
+                out[0] = row[0];
+                out[1] = row[bytes];
+                out[2] = row[2 * bytes];
+                out[3] = (chunks.hasColorKey && sample(row) == chunks.colorKey[0]
+                    && sample(row + bytes) == chunks.colorKey[1] && sample(row + 2 * bytes) == chunks.colorKey[2]) ? 0 : 255;
+                break;
+            case 3:
+                std::memcpy(out, chunks.palette[row[0] < chunks.paletteSize ? row[0] : 0], 4);
+                break;
+            case 4:
+                out[0] = out[1] = out[2] = row[0];
+                out[3] = row[bytes];
+                break;
+            default:
+                out[0] = row[0];
+                out[1] = row[bytes];
+                out[2] = row[2 * bytes];
+                out[3] = row[3 * bytes];
+                break;
+            }
+        }
+    }
+
+    struct Adam7Pass {
+        uint32_t x0, y0, dx, dy;
+    };
+
+    const Adam7Pass kAdam7[7] = {
+        { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+        { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 },
+    };
+
+    class PngDecoder final : public ImageDecoder {
+    public:
+        const char* Name() const override { return "png"; }
+
+        bool CanDecode(const uint8_t* data, size_t size) const override
+        {
+            return size >= 8 && std::memcmp(data, kPngSignature, 8) == 0;
+        }
+
+        bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info, std::string* error) const override
+        {
+            PngChunks chunks;
+            if (!ReadChunks(data, size, true, chunks, error))
+                return false;
+            info.width = chunks.header.width;
+            info.height = chunks.header.height;
+            return true;
+        }
+
+        bool Decode(const uint8_t* data, size_t size, const MutableImageView& dst, std::string* error) const override
+        {
+            PngChunks chunks;
+            if (!ReadChunks(data, size, false, chunks, error))
+                return false;
+            const PngHeader& h = chunks.header;
+            if (dst.width != h.width || dst.height != h.height) {
+                SetError(error, "destination size does not match the image");
+                return false;
+            }
+
+            // Size of the filtered stream: one filter byte per row of every pass
+            size_t streamSize = 0;
+            if (h.interlaced) {
+                for (const Adam7Pass& p : kAdam7) {
+                    const uint32_t w = h.width > p.x0 ? (h.width - p.x0 + p.dx - 1) / p.dx : 0;
+                    const uint32_t rows = h.height > p.y0 ? (h.height - p.y0 + p.dy - 1) / p.dy : 0;
+                    if (w && rows)
+                        streamSize += size_t(rows) * (h.RowBytes(w) + 1);
+                }
+            }
+            else {
+                streamSize = size_t(h.height) * (h.RowBytes(h.width) + 1);
+            }
+
+            // The inflated stream is unavoidable scratch; reuse it per thread
+            thread_local std::vector<uint8_t> stream;
+            stream.resize(streamSize);
+            if (!ZlibDecompress(chunks.idat.data(), chunks.idat.size(), stream.data(), stream.size())) {
+                SetError(error, "corrupt PNG image data");
+                return false;
+            }
+
+            const size_t stride = h.FilterStride();
+            const bool direct = !h.interlaced && h.colorType == 6 && h.bitDepth == 8;
+            if (direct) {
+                // RGBA8: unfilter straight into the destination rows, using the
+                // previous destination row as the prediction source
+                const size_t rowBytes = h.RowBytes(h.width);
+                for (uint32_t y = 0; y < h.height; y++) {
+                    const uint8_t* in = &stream[size_t(y) * (rowBytes + 1)];
+                    if (!Unfilter(in[0], in + 1, y ? dst.Row(y - 1) : nullptr, dst.Row(y), rowBytes, stride)) {
+                        SetError(error, "bad PNG filter type");
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // Other formats: unfilter in place in the stream, then expand each row
+            size_t offset = 0;
+            const int passes = h.interlaced ? 7 : 1;
+            for (int pass = 0; pass < passes; pass++) {
+                const Adam7Pass p = h.interlaced ? kAdam7[pass] : Adam7Pass{ 0, 0, 1, 1 };
+                const uint32_t w = h.width > p.x0 ? (h.width - p.x0 + p.dx - 1) / p.dx : 0;
+                const uint32_t rows = h.height > p.y0 ? (h.height - p.y0 + p.dy - 1) / p.dy : 0;
+                if (!w || !rows)
+                    continue;
+
+                const size_t rowBytes = h.RowBytes(w);
+                const uint8_t* above = nullptr;
+                for (uint32_t r = 0; r < rows; r++) {
+                    uint8_t* row = &stream[offset];
+                    if (!Unfilter(row[0], row + 1, above, row + 1, rowBytes, stride)) {
+                        SetError(error, "bad PNG filter type");
+                        return false;
+                    }
+                    ExpandRow(chunks, row + 1, w, dst.Row(p.y0 + r * p.dy) + size_t(p.x0) * 4, p.dx);
+                    above = row + 1;
+                    offset += rowBytes + 1;
+                }
+            }
+            return true;
+        }
+    };
+
+}
+
+std::unique_ptr<ImageDecoder> CreatePngDecoder()
+{
+    return std::make_unique<PngDecoder>();
+}
+
+}
@@ -0,0 +1,449 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+namespace qisx {
+
+namespace {
+
+    const uint8_t kLogMagic[4] = { 'Q', 'P', 'R', 'F' };
+    const uint8_t kLogVersion = 2;
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(uint8_t(value));
+    }
+
+    void PutSigned(std::vector<uint8_t>& out, int64_t value)
+    {
+        PutVarint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));   // Zigzag
+    }
+
+    struct LogReader {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool ok = true;
+
+        uint64_t Varint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos == end)
+                    break;
+                const uint8_t byte = *pos++;
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            ok = false;
+            return 0;
+        }
+
+        int64_t Signed()
+        {
+            const uint64_t value = Varint();
+            return int64_t(value >> 1) ^ -int64_t(value & 1);
+        }
+
+        // Each record takes at least one byte, so larger counts are corrupt
+        // and would only make the reader allocate
+        size_t Count()
+        {
+            const uint64_t count = Varint();
+            if (count > uint64_t(end - pos))
+                ok = false;
+            return ok ? size_t(count) : 0;
+        }
+    };
+
+    void AppendJsonString(std::string& out, const std::string& text)
+    {
+        out += '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            }
+            else if (uint8_t(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+                out += escaped;
+            }
+            else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    void AppendCompleteEvent(std::string& out, const std::string& name, const char* category,
+        int pid, uint32_t tid, int64_t startNs, int64_t endNs, int64_t baseNs, uint64_t frame)
+    {
+        char fields[160];
+        snprintf(fields, sizeof(fields), ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}},\n",
+            category, pid, tid, double(startNs - baseNs) * 1e-3, double(std::max<int64_t>(endNs - startNs, 0)) * 1e-3,
+            static_cast<unsigned long long>(frame));
+        out += "{\"name\":";
+        AppendJsonString(out, name);
+        out += fields;
+    }
+
+}
+
+std::vector<PassSummary> SummarizePasses(const ProfileCapture& capture)
+{
+    struct Accumulator {
+        uint64_t frame = UINT64_MAX;
+        float frameMs = 0.0f;
+    };
+
+    std::vector<PassSummary> passes;
+    std::vector<Accumulator> accumulators;
+    std::map<std::pair<ProfileTrack, uint32_t>, size_t> index;
+
+    auto flush = [&](size_t i) {
+        if (accumulators[i].frame == UINT64_MAX)
+            return;
+        PassSummary& pass = passes[i];
+        pass.frames++;
+        pass.totalMs += accumulators[i].frameMs;
+        pass.maxMs = std::max(pass.maxMs, accumulators[i].frameMs);
+        accumulators[i] = Accumulator();
+    };
+
+    for (const ProfileEvent& event : capture.events) {
+        if (event.name >= capture.names.size())
+            continue;
+        const auto key = std::make_pair(event.track, event.name);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            it = index.emplace(key, passes.size()).first;
+            PassSummary pass;
+            pass.name = capture.names[event.name];
+            pass.track = event.track;
+            passes.push_back(pass);
+            accumulators.emplace_back();
+        }
+
+        const size_t i = it->second;
+        if (accumulators[i].frame != event.frame) {
+            flush(i);
+            accumulators[i].frame = event.frame;
+        }
+        accumulators[i].frameMs += float(event.endNs - event.startNs) * 1e-6f;
+        passes[i].calls++;
+    }
+
+    for (size_t i = 0; i < passes.size(); i++) {
+        flush(i);
+        passes[i].meanMs = passes[i].frames ? passes[i].totalMs / float(passes[i].frames) : 0.0f;
+    }
+    std::stable_partition(passes.begin(), passes.end(),
+        [](const PassSummary& pass) { return pass.track == ProfileTrack::Cpu; });
+    return passes;
+}
+
+std::string ToChromeTrace(const ProfileCapture& capture)
+{
+    int64_t baseNs = INT64_MAX;
+    for (const ProfileFrame& frame : capture.frames)
+        baseNs = std::min(baseNs, frame.startNs);
+    for (const ProfileEvent& event : capture.events)
+        baseNs = std::min(baseNs, event.startNs);
+    if (baseNs == INT64_MAX)
+        baseNs = 0;
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU\"}},\n";
+    for (const ProfileFrame& frame : capture.frames)
+        AppendCompleteEvent(out, "Frame", "frame", 1, frame.thread, frame.startNs, frame.endNs, baseNs, frame.index);
+    for (const ProfileEvent& event : capture.events) {
+        if (event.name >= capture.names.size())
+            continue;
+        const bool gpu = event.track == ProfileTrack::Gpu;
+        AppendCompleteEvent(out, capture.names[event.name], gpu ? "gpu" : "cpu", gpu ? 2 : 1,
+            gpu ? 0 : event.thread, event.startNs, event.endNs, baseNs, event.frame);
+    }
+
+    // Every event line ends in ",\n"; the metadata lines guarantee there is one
+    out.resize(out.size() - 2);
+    out += "\n]}\n";
+    return out;
+}
+
+std::vector<uint8_t> ToBinaryLog(const ProfileCapture& capture)
+{
+    std::vector<uint8_t> out(kLogMagic, kLogMagic + 4);
+    out.reserve(64 + capture.events.size() * 10 + capture.frames.size() * 10);
+    out.push_back(kLogVersion);
+
+    PutVarint(out, capture.names.size());
+    for (const std::string& name : capture.names) {
+        PutVarint(out, name.size());
+        out.insert(out.end(), name.begin(), name.end());
+    }
+
+    uint64_t previousIndex = 0;
+    int64_t previousStart = 0;
+    PutVarint(out, capture.frames.size());
+    for (const ProfileFrame& frame : capture.frames) {
+        PutSigned(out, int64_t(frame.index - previousIndex));
+        PutSigned(out, frame.startNs - previousStart);
+        PutVarint(out, uint64_t(std::max<int64_t>(frame.endNs - frame.startNs, 0)));
+        PutVarint(out, frame.thread);
+        previousIndex = frame.index;
+        previousStart = frame.startNs;
+    }
+
+    previousIndex = 0;
+    previousStart = 0;
+    PutVarint(out, capture.events.size());
+    for (const ProfileEvent& event : capture.events) {
+        PutVarint(out, event.name);
+        PutVarint(out, (uint64_t(event.thread) << 1) | uint64_t(event.track == ProfileTrack::Gpu));
+        PutSigned(out, int64_t(event.frame - previousIndex));
+        PutSigned(out, event.startNs - previousStart);
+        PutVarint(out, uint64_t(std::max<int64_t>(event.endNs - event.startNs, 0)));
+        previousIndex = event.frame;
+        previousStart = event.startNs;
+    }
+    return out;
+}
+
+bool FromBinaryLog(const uint8_t* data, size_t size, ProfileCapture& capture)
+{
+    capture = ProfileCapture();
+    if (size < 5 || memcmp(data, kLogMagic, 4) != 0 || data[4] != kLogVersion)
+        return false;
+
+    LogReader in{ data + 5, data + size };
+    capture.names.resize(in.Count());
+    for (std::string& name : capture.names) {
+        const size_t length = in.Count();
+        if (!in.ok)
+            return false;
+        name.assign(reinterpret_cast<const char*>(in.pos), length);
+        in.pos += length;
+    }
+
+    uint64_t previousIndex = 0;
+    int64_t previousStart = 0;
+    capture.frames.resize(in.Count());
+    for (ProfileFrame& frame : capture.frames) {
+        frame.index = previousIndex + uint64_t(in.Signed());
+        frame.startNs = previousStart + in.Signed();
+        frame.endNs = frame.startNs + int64_t(in.Varint());
+        const uint64_t thread = in.Varint();
+        if (thread > UINT32_MAX)
+            in.ok = false;
+        frame.thread = uint32_t(thread);
+        previousIndex = frame.index;
+        previousStart = frame.startNs;
+    }
+
+    previousIndex = 0;
+    previousStart = 0;
+    capture.events.resize(in.Count());
+    for (ProfileEvent& event : capture.events) {
+        const uint64_t name = in.Varint();
+        const uint64_t thread = in.Varint();
+        if (name >= capture.names.size() || (thread >> 1) > UINT32_MAX)
+            in.ok = false;
+        event.name = uint32_t(name);
+        event.thread = uint32_t(thread >> 1);
+        event.track = (thread & 1) ? ProfileTrack::Gpu : ProfileTrack::Cpu;
+        event.frame = previousIndex + uint64_t(in.Signed());
+        event.startNs = previousStart + in.Signed();
+        event.endNs = event.startNs + int64_t(in.Varint());
+        previousIndex = event.frame;
+        previousStart = event.startNs;
+    }
+
+    if (!in.ok || in.pos != in.end) {
+        capture = ProfileCapture();
+        return false;
+    }
+    return true;
+}
+
+Profiler::Profiler(FrameClock* clock, const Options& options)
+    : m_clock(clock ? clock : &DefaultFrameClock()),
+      m_options(options)
+{
+    m_current.frame = { 0, 0, 0, 0 };
+}
+
+void Profiler::BeginFrame()
+{
+    if (m_inFrame)
+        EndFrame();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Events recorded between frames stay with the frame that follows
+    m_current.frame.startNs = m_clock->Now();
+    m_current.frame.thread = ThreadId();
+    m_inFrame = true;
+}
+
+void Profiler::EndFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_inFrame)
+        return;
+    m_current.frame.endNs = m_clock->Now();
+    m_inFrame = false;
+
+    const uint64_t next = m_current.frame.index + 1;
+    m_frames.push_back(std::move(m_current));
+    while (m_frames.size() > std::max(m_options.maxFrames, 1u))
+        m_frames.pop_front();
+    m_current = FrameData();
+    m_current.frame = { next, 0, 0, 0 };
+}
+
+Profiler::Scope Profiler::BeginScope(const char* name)
+{
+    const int64_t now = m_clock->Now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ProfileEvent event;
+    event.name = NameId(name);
+    event.thread = ThreadId();
+    event.track = ProfileTrack::Cpu;
+    event.frame = m_current.frame.index;
+    event.startNs = now;
+    event.endNs = now;
+    m_current.events.push_back(event);
+    return { event.frame, uint32_t(m_current.events.size() - 1) };
+}
+
+void Profiler::EndScope(const Scope& scope)
+{
+    const int64_t now = m_clock->Now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FrameData* frame = FindFrame(scope.frame);
+    if (frame && scope.slot < frame->events.size())
+        frame->events[scope.slot].endNs = now;
+}
+
+void Profiler::AddGpuEvent(uint64_t frame, const char* name, int64_t startNs, int64_t endNs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FrameData* data = FindFrame(frame);
+    if (!data)
+        return;
+    ProfileEvent event;
+    event.name = NameId(name);
+    event.thread = 0;
+    event.track = ProfileTrack::Gpu;
+    event.frame = frame;
+    event.startNs = startNs;
+    event.endNs = std::max(endNs, startNs);
+    data->events.push_back(event);
+}
+
+float Profiler::GetPassMs(uint64_t frame, const char* name, ProfileTrack track) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const FrameData* data = FindFrame(frame);
+    const auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (!data || it == m_names.end())
+        return -1.0f;
+
+    const uint32_t id = uint32_t(it - m_names.begin());
+    int64_t totalNs = 0;
+    bool found = false;
+    for (const ProfileEvent& event : data->events) {
+        if (event.name == id && event.track == track) {
+            totalNs += event.endNs - event.startNs;
+            found = true;
+        }
+    }
+    return found ? float(totalNs) * 1e-6f : -1.0f;
+}
+
+uint64_t Profiler::GetFrameIndex() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_current.frame.index;
+}
+
+ProfileCapture Profiler::Capture(uint32_t maxFrames) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ProfileCapture capture;
+    capture.names = m_names;
+
+    auto append = [&](const FrameData& data) {
+        const size_t first = capture.events.size();
+        capture.events.insert(capture.events.end(), data.events.begin(), data.events.end());
+        std::stable_sort(capture.events.begin() + first, capture.events.end(),
+            [](const ProfileEvent& a, const ProfileEvent& b) { return a.startNs < b.startNs; });
+    };
+
+    const bool current = m_inFrame || !m_current.events.empty();
+    const size_t kept = std::min<size_t>(m_frames.size(), current && maxFrames ? maxFrames - 1 : maxFrames);
+    for (size_t i = m_frames.size() - kept; i < m_frames.size(); i++) {
+        capture.frames.push_back(m_frames[i].frame);
+        append(m_frames[i]);
+    }
+    if (current && maxFrames) {
+        // Only events recorded between frames: no frame record
+        if (m_inFrame) {
+            capture.frames.push_back(m_current.frame);
+            capture.frames.back().endNs = m_clock->Now();
+        }
+        append(m_current);
+    }
+    return capture;
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames.clear();
+    m_current.events.clear();
+}
+
+uint32_t Profiler::NameId(const char* name)
+{
+    const auto it = m_nameIds.find(name);
+    if (it != m_nameIds.end())
+        return it->second;
+
+    // A new pointer may still be a known name (the same literal in another
+    // translation unit, or a copy)
+    const uint32_t id = uint32_t(std::find(m_names.begin(), m_names.end(), name) - m_names.begin());
+    if (id == m_names.size())
+        m_names.emplace_back(name);
+    m_nameIds.emplace(name, id);
+    return id;
+}
+
+uint32_t Profiler::ThreadId()
+{
+    return m_threadIds.emplace(std::this_thread::get_id(), uint32_t(m_threadIds.size())).first->second;
+}
+
+Profiler::FrameData* Profiler::FindFrame(uint64_t frame)
+{
+    return const_cast<FrameData*>(static_cast<const Profiler*>(this)->FindFrame(frame));
+}
+
+const Profiler::FrameData* Profiler::FindFrame(uint64_t frame) const
+{
+    if (frame == m_current.frame.index)
+        return &m_current;
+    if (m_frames.empty() || frame < m_frames.front().frame.index)
+        return nullptr;
+    const uint64_t i = frame - m_frames.front().frame.index;
+    return i < m_frames.size() ? &m_frames[size_t(i)] : nullptr;
+}
+
+}
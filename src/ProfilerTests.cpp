@@ -0,0 +1,231 @@
+#include "gtest/gtest.h"
+#include "Profiler.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr int64_t kMs = 1'000'000;
+
+    // Frames of a viewer-like loop: scene 2 ms, upscale 3 ms (two calls of
+    // 1.5 ms on odd frames), present 1 ms.
+    void RecordFrames(qisx::Profiler& profiler, qisx::SimulatedFrameClock& clock, int frames)
+    {
+        for (int i = 0; i < frames; i++) {
+            profiler.BeginFrame();
+            {
+                qisx::ProfileScope scope(profiler, "Scene");
+                clock.Advance(2 * kMs);
+            }
+            if (i % 2) {
+                for (int call = 0; call < 2; call++) {
+                    qisx::ProfileScope scope(profiler, "Upscale");
+                    clock.Advance(3 * kMs / 2);
+                }
+            }
+            else {
+                qisx::ProfileScope scope(profiler, "Upscale");
+                clock.Advance(3 * kMs);
+            }
+            {
+                qisx::ProfileScope scope(profiler, "Present");
+                clock.Advance(1 * kMs);
+            }
+            profiler.EndFrame();
+        }
+    }
+
+}
+
+TEST(ProfilerTests, AggregatesPassesPerFrame)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.Set(5000 * kMs);
+    qisx::Profiler profiler(&clock);
+    RecordFrames(profiler, clock, 10);
+
+    EXPECT_EQ(profiler.GetFrameIndex(), 10u);
+    EXPECT_FLOAT_EQ(profiler.GetPassMs(9, "Upscale"), 3.0f);
+    EXPECT_FLOAT_EQ(profiler.GetPassMs(9, "Scene"), 2.0f);
+    EXPECT_EQ(profiler.GetPassMs(9, "Upscale", qisx::ProfileTrack::Gpu), -1.0f);
+    EXPECT_EQ(profiler.GetPassMs(9, "Missing"), -1.0f);
+
+    const qisx::ProfileCapture capture = profiler.Capture();
+    ASSERT_EQ(capture.frames.size(), 10u);
+    EXPECT_EQ(capture.frames[3].endNs - capture.frames[3].startNs, 6 * kMs);
+
+    const std::vector<qisx::PassSummary> passes = qisx::SummarizePasses(capture);
+    ASSERT_EQ(passes.size(), 3u);
+    EXPECT_EQ(passes[0].name, "Scene");
+    EXPECT_EQ(passes[1].name, "Upscale");
+    EXPECT_EQ(passes[1].frames, 10u);
+    EXPECT_EQ(passes[1].calls, 15u);
+    EXPECT_NEAR(passes[1].meanMs, 3.0f, 1e-4f);
+    EXPECT_NEAR(passes[1].maxMs, 3.0f, 1e-4f);
+    EXPECT_NEAR(passes[2].totalMs, 10.0f, 1e-4f);
+}
+
+// GPU results arrive frames late; they attach to their frame while it is
+// kept, and older frames are evicted.
+TEST(ProfilerTests, KeepsNewestFramesAndAttachesLateGpuEvents)
+{
+    qisx::SimulatedFrameClock clock;
+    qisx::Profiler::Options options;
+    options.maxFrames = 4;
+    qisx::Profiler profiler(&clock, options);
+    RecordFrames(profiler, clock, 6);
+
+    profiler.AddGpuEvent(4, "Upscale", 100 * kMs, 104 * kMs);
+    profiler.AddGpuEvent(1, "Upscale", 100 * kMs, 104 * kMs);  // Evicted: dropped
+    EXPECT_FLOAT_EQ(profiler.GetPassMs(4, "Upscale", qisx::ProfileTrack::Gpu), 4.0f);
+    EXPECT_EQ(profiler.GetPassMs(1, "Upscale"), -1.0f);
+
+    // A scope still open when its frame ends is closed in that frame
+    profiler.BeginFrame();
+    const qisx::Profiler::Scope open = profiler.BeginScope("Load");
+    clock.Advance(2 * kMs);
+    profiler.EndFrame();
+    clock.Advance(3 * kMs);
+    profiler.EndScope(open);
+    EXPECT_FLOAT_EQ(profiler.GetPassMs(6, "Load"), 5.0f);
+
+    const qisx::ProfileCapture capture = profiler.Capture(3);
+    ASSERT_EQ(capture.frames.size(), 3u);
+    EXPECT_EQ(capture.frames.front().index, 4u);
+    const std::vector<qisx::PassSummary> passes = qisx::SummarizePasses(capture);
+    ASSERT_FALSE(passes.empty());
+    EXPECT_EQ(passes.back().track, qisx::ProfileTrack::Gpu);
+    EXPECT_EQ(passes.back().frames, 1u);
+}
+
+TEST(ProfilerTests, BinaryLogRoundTripsAndIsCompact)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.Set(1'700'000'000'000'000'000);
+    qisx::Profiler profiler(&clock);
+    RecordFrames(profiler, clock, 50);
+    profiler.AddGpuEvent(49, "Upscale", clock.Now() - 5 * kMs, clock.Now() - kMs);
+    const qisx::ProfileCapture capture = profiler.Capture();
+
+    const std::vector<uint8_t> log = qisx::ToBinaryLog(capture);
+    EXPECT_LT(log.size(), capture.events.size() * 10 + capture.frames.size() * 10 + 64);
+
+    qisx::ProfileCapture read;
+    ASSERT_TRUE(qisx::FromBinaryLog(log.data(), log.size(), read));
+    EXPECT_EQ(read.names, capture.names);
+    ASSERT_EQ(read.frames.size(), capture.frames.size());
+    ASSERT_EQ(read.events.size(), capture.events.size());
+    for (size_t i = 0; i < read.frames.size(); i++) {
+        EXPECT_EQ(read.frames[i].index, capture.frames[i].index);
+        EXPECT_EQ(read.frames[i].startNs, capture.frames[i].startNs);
+        EXPECT_EQ(read.frames[i].endNs, capture.frames[i].endNs);
+        EXPECT_EQ(read.frames[i].thread, capture.frames[i].thread);
+    }
+    for (size_t i = 0; i < read.events.size(); i++) {
+        const qisx::ProfileEvent& a = read.events[i];
+        const qisx::ProfileEvent& b = capture.events[i];
+        EXPECT_TRUE(a.name == b.name && a.thread == b.thread && a.track == b.track && a.frame == b.frame
+            && a.startNs == b.startNs && a.endNs == b.endNs) << "event " << i;
+    }
+
+    // Truncated or corrupt logs are rejected
+    EXPECT_FALSE(qisx::FromBinaryLog(log.data(), log.size() - 1, read));
+    EXPECT_TRUE(read.events.empty());
+    std::vector<uint8_t> corrupt = log;
+    corrupt[0] = 'X';
+    EXPECT_FALSE(qisx::FromBinaryLog(corrupt.data(), corrupt.size(), read));
+}
+
+TEST(ProfilerTests, ChromeTraceHasFramesPassesAndEscapedNames)
+{
+    qisx::SimulatedFrameClock clock;
+    clock.Set(10 * kMs);
+    qisx::Profiler profiler(&clock);
+    RecordFrames(profiler, clock, 2);
+    profiler.BeginFrame();
+    {
+        qisx::ProfileScope scope(profiler, "Load \"grid\"\n");
+        clock.Advance(kMs / 4);
+    }
+    profiler.AddGpuEvent(2, "Upscale", clock.Now(), clock.Now() + kMs);
+    profiler.EndFrame();
+
+    const std::string json = qisx::ToChromeTrace(profiler.Capture());
+    auto count = [&](const std::string& text) {
+        size_t n = 0;
+        for (size_t pos = json.find(text); pos != std::string::npos; pos = json.find(text, pos + 1))
+            n++;
+        return n;
+    };
+
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    EXPECT_EQ(count("\"ph\":\"X\""), 3u + 7u + 2u);    // Frames, CPU passes, the load and the GPU pass
+    EXPECT_EQ(count("\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":2"), 1u);
+    EXPECT_NE(json.find("{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":0.000,\"dur\":6000.000"), std::string::npos);
+    EXPECT_NE(json.find("\"ts\":6000.000,\"dur\":2000.000,\"args\":{\"frame\":1}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Load \\\"grid\\\"\\u000a\""), std::string::npos);
+    EXPECT_EQ(json.find(",\n]"), std::string::npos);
+}
+
+// Frames are drawn on the track of the thread that began them, not the one
+// that constructed the profiler.
+TEST(ProfilerTests, FramesUseTheThreadThatBeganThem)
+{
+    qisx::Profiler profiler;
+    {
+        qisx::ProfileScope scope(profiler, "Setup");
+    }
+    std::thread render([&profiler] {
+        profiler.BeginFrame();
+        {
+            qisx::ProfileScope scope(profiler, "Draw");
+        }
+        profiler.EndFrame();
+    });
+    render.join();
+
+    const qisx::ProfileCapture capture = profiler.Capture();
+    ASSERT_EQ(capture.frames.size(), 1u);
+    ASSERT_EQ(capture.events.size(), 2u);
+    EXPECT_EQ(capture.events[0].thread, 0u);
+    EXPECT_EQ(capture.events[1].thread, 1u);
+    EXPECT_EQ(capture.frames[0].thread, 1u);
+    EXPECT_NE(qisx::ToChromeTrace(capture).find("{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"),
+        std::string::npos);
+}
+
+// Workers record into the current frame from their own threads, each with
+// its own thread id.
+TEST(ProfilerTests, RecordsScopesFromManyThreads)
+{
+    qisx::Profiler profiler;
+    profiler.BeginFrame();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&profiler] {
+            for (int i = 0; i < 250; i++) {
+                qisx::ProfileScope outer(profiler, "Decode");
+                qisx::ProfileScope inner(profiler, "Inflate");
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    profiler.EndFrame();
+
+    const qisx::ProfileCapture capture = profiler.Capture();
+    ASSERT_EQ(capture.events.size(), 2000u);
+    std::set<uint32_t> threads;
+    for (const qisx::ProfileEvent& event : capture.events) {
+        threads.insert(event.thread);
+        EXPECT_GE(event.endNs, event.startNs);
+    }
+    EXPECT_EQ(threads.size(), 4u);
+    EXPECT_EQ(threads.count(0), 0u);    // 0 is the thread that created the profiler
+    ASSERT_EQ(capture.names.size(), 2u);
+}
@@ -0,0 +1,466 @@
+#include "Resampler.h"
+#include "ColorSpace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kWindowRadius = 3.0;   // Kaiser and Lanczos, in output texels when shrinking
+    constexpr double kKaiserBeta = 4.0;
+
+    // Taps for one axis of a src -> dst resample. Every output texel has the
+    // same number of taps; short footprints are padded with zero weights.
+    struct ResampleAxis {
+        uint32_t taps = 0;
+        std::vector<int32_t> index;     // dstSize * taps, clamped to the source
+        std::vector<float> weight;
+
+        const int32_t* Index(uint32_t i) const { return &index[size_t(i) * taps]; }
+        const float* Weight(uint32_t i) const { return &weight[size_t(i) * taps]; }
+    };
+
+    double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    double Sinc(double t)
+    {
+        return t == 0.0 ? 1.0 : std::sin(kPi * t) / (kPi * t);
+    }
+
+    double WindowedSinc(ResampleFilter filter, double t)
+    {
+        const double r = t / kWindowRadius;
+        if (r <= -1.0 || r >= 1.0)
+            return 0.0;
+        if (filter == ResampleFilter::Lanczos3)
+            return Sinc(t) * Sinc(r);
+        return Sinc(t) * BesselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / BesselI0(kKaiserBeta);
+    }
+
+    void BuildAxis(uint32_t srcSize, uint32_t dstSize, ResampleFilter filter, ResampleAxis& axis)
+    {
+        const double scale = double(srcSize) / dstSize;
+        std::vector<std::vector<std::pair<int32_t, double>>> footprints(dstSize);
+        for (uint32_t x = 0; x < dstSize; x++) {
+            auto& taps = footprints[x];
+            if (filter == ResampleFilter::Box) {
+                const double lo = x * scale;
+                const double hi = (x + 1) * scale;
+                for (int32_t i = int32_t(std::floor(lo)); i < int32_t(std::ceil(hi)); i++) {
+                    const double overlap = std::min(hi, i + 1.0) - std::max(lo, double(i));
+                    if (overlap > 1e-9)
+                        taps.emplace_back(i, overlap);
+                }
+            }
+            else {
+                // Texel centres at i + 0.5; when shrinking, the kernel is stretched
+                // to output texels
+                const double centre = (x + 0.5) * scale;
+                const double reach = kWindowRadius * std::max(1.0, scale);
+                const int32_t first = int32_t(std::ceil(centre - reach - 0.5));
+                const int32_t last = int32_t(std::floor(centre + reach - 0.5));
+                for (int32_t i = first; i <= last; i++) {
+                    const double w = WindowedSinc(filter, (i + 0.5 - centre) / std::max(1.0, scale));
+                    if (w != 0.0)
+                        taps.emplace_back(i, w);
+                }
+            }
+        }
+
+        axis.taps = 1;
+        for (const auto& taps : footprints)
+            axis.taps = std::max(axis.taps, uint32_t(taps.size()));
+        axis.index.assign(size_t(dstSize) * axis.taps, 0);
+        axis.weight.assign(size_t(dstSize) * axis.taps, 0.0f);
+
+        const int32_t maxIndex = int32_t(srcSize) - 1;
+        for (uint32_t x = 0; x < dstSize; x++) {
+            const auto& taps = footprints[x];
+            double total = 0.0;
+            for (const auto& tap : taps)
+                total += tap.second;
+            int32_t* index = &axis.index[size_t(x) * axis.taps];
+            float* weight = &axis.weight[size_t(x) * axis.taps];
+            for (uint32_t t = 0; t < axis.taps; t++) {
+                // Padding repeats an in-range index so loads stay valid
+                const int32_t i = t < taps.size() ? taps[t].first : (taps.empty() ? 0 : taps[0].first);
+                index[t] = std::clamp(i, 0, maxIndex);
+                weight[t] = t < taps.size() ? float(taps[t].second / total) : 0.0f;
+            }
+        }
+    }
+
+    // Source row to linear float RGBA (colour through the transfer LUT)
+    void DecodeRow(const uint8_t* src, uint32_t width, const float* colourLut, const float* alphaLut, float* out)
+    {
+        for (uint32_t x = 0; x < width; x++, src += 4, out += 4) {
+            out[0] = colourLut[src[0]];
+            out[1] = colourLut[src[1]];
+            out[2] = colourLut[src[2]];
+            out[3] = alphaLut[src[3]];
+        }
+    }
+
+    using ResampleHorizontalFn = void (*)(const float* src, const ResampleAxis& axis, float* out);
+    using ResampleVerticalFn = void (*)(const float* const* rows, const float* weights, uint32_t taps, uint32_t count, float* out);
+    using ResampleEncodeFn = void (*)(const float* in, uint32_t width, const SrgbTables* srgb, uint8_t* dst);
+    using ResampleDecodeFn = void (*)(const uint8_t* src, uint32_t width, float* out);
+
+    struct ResampleKernelTable {
+        SimdLevel level;
+        ResampleHorizontalFn horizontal;
+        ResampleVerticalFn vertical;
+        ResampleEncodeFn encode;
+        ResampleDecodeFn decodeUnorm;
+    };
+
+    void DecodeUnormScalar(const uint8_t* src, uint32_t width, float* out)
+    {
+        for (uint32_t i = 0; i < width * 4; i++)
+            out[i] = src[i] / 255.0f;
+    }
+
+    void HorizontalScalar(const float* src, const ResampleAxis& axis, float* out)
+    {
+        const uint32_t count = uint32_t(axis.index.size() / axis.taps);
+        for (uint32_t x = 0; x < count; x++, out += 4) {
+            const int32_t* index = axis.Index(x);
+            const float* weight = axis.Weight(x);
+            float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+            for (uint32_t t = 0; t < axis.taps; t++) {
+                const float* p = src + size_t(index[t]) * 4;
+                r += weight[t] * p[0];
+                g += weight[t] * p[1];
+                b += weight[t] * p[2];
+                a += weight[t] * p[3];
+            }
+            out[0] = r; out[1] = g; out[2] = b; out[3] = a;
+        }
+    }
+
+    // count is in floats (4 per pixel)
+    void VerticalScalar(const float* const* rows, const float* weights, uint32_t taps, uint32_t count, float* out)
+    {
+        for (uint32_t i = 0; i < count; i++) {
+            float sum = 0.0f;
+            for (uint32_t t = 0; t < taps; t++)
+                sum += weights[t] * rows[t][i];
+            out[i] = sum;
+        }
+    }
+
+    void EncodeScalar(const float* in, uint32_t width, const SrgbTables* srgb, uint8_t* dst)
+    {
+        for (uint32_t x = 0; x < width; x++, in += 4, dst += 4) {
+            for (int c = 0; c < 3; c++)
+                dst[c] = srgb ? LinearToSrgb8(*srgb, in[c]) : LinearToUnorm8(in[c]);
+            dst[3] = LinearToUnorm8(in[3]);
+        }
+    }
+
+#if defined(QISX_ARCH_X86)
+
+    // Four output pixels per iteration: independent accumulators hide the add
+    // latency, and each pixel still sums its taps in the scalar order.
+    QISX_TARGET("sse4.1")
+    void HorizontalSSE41(const float* src, const ResampleAxis& axis, float* out)
+    {
+        const uint32_t count = uint32_t(axis.index.size() / axis.taps);
+        const uint32_t taps = axis.taps;
+        uint32_t x = 0;
+        for (; x + 4 <= count; x += 4) {
+            const int32_t* index = axis.Index(x);
+            const float* weight = axis.Weight(x);
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            __m128 acc2 = _mm_setzero_ps();
+            __m128 acc3 = _mm_setzero_ps();
+            for (uint32_t t = 0; t < taps; t++) {
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(src + size_t(index[t]) * 4)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_set1_ps(weight[taps + t]), _mm_loadu_ps(src + size_t(index[taps + t]) * 4)));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_set1_ps(weight[2 * taps + t]), _mm_loadu_ps(src + size_t(index[2 * taps + t]) * 4)));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_set1_ps(weight[3 * taps + t]), _mm_loadu_ps(src + size_t(index[3 * taps + t]) * 4)));
+            }
+            _mm_storeu_ps(out + size_t(x) * 4, acc0);
+            _mm_storeu_ps(out + size_t(x) * 4 + 4, acc1);
+            _mm_storeu_ps(out + size_t(x) * 4 + 8, acc2);
+            _mm_storeu_ps(out + size_t(x) * 4 + 12, acc3);
+        }
+        for (; x < count; x++) {
+            const int32_t* index = axis.Index(x);
+            const float* weight = axis.Weight(x);
+            __m128 acc = _mm_setzero_ps();
+            for (uint32_t t = 0; t < taps; t++)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(src + size_t(index[t]) * 4)));
+            _mm_storeu_ps(out + size_t(x) * 4, acc);
+        }
+    }
+
+    // Unorm rows only; sRGB decoding is a table lookup per channel
+    QISX_TARGET("sse4.1")
+    void DecodeUnormSSE41(const uint8_t* src, uint32_t width, float* out)
+    {
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for (uint32_t x = 0; x < width; x++) {
+            int32_t bits;
+            std::memcpy(&bits, src + size_t(x) * 4, sizeof(bits));
+            const __m128 v = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bits)));
+            _mm_storeu_ps(out + size_t(x) * 4, _mm_div_ps(v, scale));
+        }
+    }
+
+    QISX_TARGET("sse4.1")
+    void VerticalSSE41(const float* const* rows, const float* weights, uint32_t taps, uint32_t count, float* out)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128 lo = _mm_setzero_ps();
+            __m128 hi = _mm_setzero_ps();
+            for (uint32_t t = 0; t < taps; t++) {
+                const __m128 w = _mm_set1_ps(weights[t]);
+                lo = _mm_add_ps(lo, _mm_mul_ps(w, _mm_loadu_ps(rows[t] + i)));
+                hi = _mm_add_ps(hi, _mm_mul_ps(w, _mm_loadu_ps(rows[t] + i + 4)));
+            }
+            _mm_storeu_ps(out + i, lo);
+            _mm_storeu_ps(out + i + 4, hi);
+        }
+        for (; i < count; i += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (uint32_t t = 0; t < taps; t++)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(rows[t] + i)));
+            _mm_storeu_ps(out + i, acc);
+        }
+    }
+
+    // Unorm: four pixels per iteration through the saturating packs. sRGB: the
+    // sqrt and table index are vectorised, the lookup itself is scalar.
+    QISX_TARGET("sse4.1")
+    void EncodeSSE41(const float* in, uint32_t width, const SrgbTables* srgb, uint8_t* dst)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 unorm = _mm_set1_ps(255.0f);
+        uint32_t x = 0;
+        if (!srgb) {
+            for (; x + 4 <= width; x += 4) {
+                __m128i p[4];
+                for (int k = 0; k < 4; k++) {
+                    const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + size_t(x + k) * 4), zero), one);
+                    p[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, unorm), half));
+                }
+                const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(p[0], p[1]), _mm_packus_epi32(p[2], p[3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 4), packed);
+            }
+        }
+        else {
+            const __m128 scale = _mm_set1_ps(float(kSrgbEncodeTableSize));
+            alignas(16) int32_t idx[4];
+            for (; x < width; x++) {
+                const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + size_t(x) * 4), zero), one);
+                _mm_store_si128(reinterpret_cast<__m128i*>(idx), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_sqrt_ps(v), scale), half)));
+                uint8_t* d = dst + size_t(x) * 4;
+                d[0] = srgb->fromSqrtLinear[idx[0]];
+                d[1] = srgb->fromSqrtLinear[idx[1]];
+                d[2] = srgb->fromSqrtLinear[idx[2]];
+                d[3] = LinearToUnorm8(in[size_t(x) * 4 + 3]);
+            }
+        }
+        EncodeScalar(in + size_t(x) * 4, width - x, srgb, dst + size_t(x) * 4);
+    }
+
+#elif defined(QISX_ARCH_ARM64)
+
+    void HorizontalNEON(const float* src, const ResampleAxis& axis, float* out)
+    {
+        const uint32_t count = uint32_t(axis.index.size() / axis.taps);
+        for (uint32_t x = 0; x < count; x++, out += 4) {
+            const int32_t* index = axis.Index(x);
+            const float* weight = axis.Weight(x);
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (uint32_t t = 0; t < axis.taps; t++)
+                acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(src + size_t(index[t]) * 4), weight[t]));
+            vst1q_f32(out, acc);
+        }
+    }
+
+    void DecodeUnormNEON(const uint8_t* src, uint32_t width, float* out)
+    {
+        const float32x4_t scale = vdupq_n_f32(255.0f);
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8x8_t bytes = vreinterpret_u8_u32(vld1_dup_u32(reinterpret_cast<const uint32_t*>(src + size_t(x) * 4)));
+            const uint32x4_t wide = vmovl_u16(vget_low_u16(vmovl_u8(bytes)));
+            vst1q_f32(out + size_t(x) * 4, vdivq_f32(vcvtq_f32_u32(wide), scale));
+        }
+    }
+
+    void VerticalNEON(const float* const* rows, const float* weights, uint32_t taps, uint32_t count, float* out)
+    {
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            float32x4_t lo = vdupq_n_f32(0.0f);
+            float32x4_t hi = vdupq_n_f32(0.0f);
+            for (uint32_t t = 0; t < taps; t++) {
+                lo = vaddq_f32(lo, vmulq_n_f32(vld1q_f32(rows[t] + i), weights[t]));
+                hi = vaddq_f32(hi, vmulq_n_f32(vld1q_f32(rows[t] + i + 4), weights[t]));
+            }
+            vst1q_f32(out + i, lo);
+            vst1q_f32(out + i + 4, hi);
+        }
+        for (; i < count; i += 4) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (uint32_t t = 0; t < taps; t++)
+                acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(rows[t] + i), weights[t]));
+            vst1q_f32(out + i, acc);
+        }
+    }
+
+    void EncodeNEON(const float* in, uint32_t width, const SrgbTables* srgb, uint8_t* dst)
+    {
+        uint32_t x = 0;
+        if (!srgb) {
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            for (; x + 4 <= width; x += 4) {
+                uint16x4_t p[4];
+                for (int k = 0; k < 4; k++) {
+                    const float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(in + size_t(x + k) * 4), zero), one);
+                    p[k] = vmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(v, 255.0f), vdupq_n_f32(0.5f))));
+                }
+                const uint8x16_t packed = vcombine_u8(vmovn_u16(vcombine_u16(p[0], p[1])), vmovn_u16(vcombine_u16(p[2], p[3])));
+                vst1q_u8(dst + size_t(x) * 4, packed);
+            }
+        }
+        EncodeScalar(in + size_t(x) * 4, width - x, srgb, dst + size_t(x) * 4);
+    }
+
+#endif
+
+    const ResampleKernelTable* GetResampleKernels(SimdLevel level)
+    {
+        static const ResampleKernelTable kScalar = { SimdLevel::Scalar, HorizontalScalar, VerticalScalar, EncodeScalar, DecodeUnormScalar };
+#if defined(QISX_ARCH_X86)
+        static const ResampleKernelTable kSSE41 = { SimdLevel::SSE41, HorizontalSSE41, VerticalSSE41, EncodeSSE41, DecodeUnormSSE41 };
+#elif defined(QISX_ARCH_ARM64)
+        static const ResampleKernelTable kNEON = { SimdLevel::NEON, HorizontalNEON, VerticalNEON, EncodeNEON, DecodeUnormNEON };
+#endif
+
+        if (level == SimdLevel::Auto)
+            level = DetectSimdLevel();
+        if (!IsSimdLevelSupported(level))
+            return nullptr;
+
+        switch (level) {
+        case SimdLevel::Scalar:
+            return &kScalar;
+#if defined(QISX_ARCH_X86)
+        case SimdLevel::SSE41:
+        case SimdLevel::AVX2:   // Row work is load-bound; AVX2 adds nothing over SSE4.1 here
+            return &kSSE41;
+#elif defined(QISX_ARCH_ARM64)
+        case SimdLevel::NEON:
+            return &kNEON;
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+}
+
+bool Resampler::Resample(const ImageView& src, const MutableImageView& dst)
+{
+    if (src.Empty() || dst.Empty() || src.data == dst.data)
+        return false;
+
+    const ResampleKernelTable* kernels = GetResampleKernels(m_options.simd);
+    if (!kernels)
+        kernels = GetResampleKernels(SimdLevel::Scalar);
+
+    ResampleAxis axisX, axisY;
+    BuildAxis(src.width, dst.width, m_options.filter, axisX);
+    BuildAxis(src.height, dst.height, m_options.filter, axisY);
+
+    static const struct UnormTable {
+        float values[256];
+        UnormTable() { for (int i = 0; i < 256; i++) values[i] = i / 255.0f; }
+    } kUnorm;
+    const SrgbTables* srgb = m_options.srgb ? &GetSrgbTables() : nullptr;
+
+    const unsigned threads = m_options.threadCount ? m_options.threadCount : PhysicalCoreCount();
+    if (threads > 1 && (!m_pool || m_pool->GetThreadCount() != threads))
+        m_pool = std::make_unique<ThreadPool>(threads);
+    else if (threads <= 1)
+        m_pool.reset();
+    m_scratch.resize(GetThreadCount());
+
+    const uint32_t bandHeight = std::max(1u, m_options.bandHeight);
+    const uint32_t bands = (dst.height + bandHeight - 1) / bandHeight;
+    const size_t srcFloats = size_t(src.width) * 4;
+    const size_t dstFloats = size_t(dst.width) * 4;
+
+    auto runBand = [&](uint32_t band, unsigned slot) {
+        // Scratch: one decoded source row, a ring of horizontally filtered rows
+        // keyed by source row (the taps of one output row are consecutive source
+        // rows, so taps slots never collide), and the output row.
+        std::vector<float>& scratch = m_scratch[slot];
+        scratch.resize(srcFloats + dstFloats * (axisY.taps + 1));
+        float* decoded = scratch.data();
+        float* ring = decoded + srcFloats;
+        float* out = ring + dstFloats * axisY.taps;
+        std::vector<int32_t> ringRow(axisY.taps, -1);
+        std::vector<const float*> rows(axisY.taps);
+
+        const uint32_t y0 = band * bandHeight;
+        const uint32_t y1 = std::min(dst.height, y0 + bandHeight);
+        for (uint32_t y = y0; y < y1; y++) {
+            const int32_t* index = axisY.Index(y);
+            for (uint32_t t = 0; t < axisY.taps; t++) {
+                const int32_t row = index[t];
+                const uint32_t entry = uint32_t(row) % axisY.taps;
+                float* filtered = ring + dstFloats * entry;
+                if (ringRow[entry] != row) {
+                    if (srgb)
+                        DecodeRow(src.Row(uint32_t(row)), src.width, srgb->toLinear, kUnorm.values, decoded);
+                    else
+                        kernels->decodeUnorm(src.Row(uint32_t(row)), src.width, decoded);
+                    kernels->horizontal(decoded, axisX, filtered);
+                    ringRow[entry] = row;
+                }
+                rows[t] = filtered;
+            }
+            kernels->vertical(rows.data(), axisY.Weight(y), axisY.taps, uint32_t(dstFloats), out);
+            kernels->encode(out, dst.width, srgb, dst.Row(y));
+        }
+    };
+
+    if (m_pool)
+        m_pool->ParallelFor(bands, runBand);
+    else {
+        for (uint32_t band = 0; band < bands; band++)
+            runBand(band, 0);
+    }
+    return true;
+}
+
+}
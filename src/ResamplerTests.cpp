@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "Resampler.h"
+#include "TestImages.h"
+
+#include <utility>
+
+namespace {
+
+    const qisx::ResampleFilter kFilters[] = {
+        qisx::ResampleFilter::Box, qisx::ResampleFilter::Kaiser, qisx::ResampleFilter::Lanczos3,
+    };
+
+}
+
+TEST(ResamplerTests, FlatColourSurvivesAnyResize)
+{
+    qisx::Image src(97, 61);
+    for (size_t i = 0; i < src.SizeInBytes(); i += 4) {
+        src.Data()[i] = 200; src.Data()[i + 1] = 17; src.Data()[i + 2] = 90; src.Data()[i + 3] = 133;
+    }
+    // Shrinking, growing and one of each (MAKE_SQUARE grows the short axis)
+    const std::pair<uint32_t, uint32_t> sizes[] = { { 31, 20 }, { 1, 1 }, { 160, 97 }, { 97, 97 }, { 40, 200 } };
+    for (qisx::ResampleFilter filter : kFilters) {
+        for (bool srgb : { false, true }) {
+            for (const auto& [w, h] : sizes) {
+                qisx::Image dst(w, h);
+                qisx::Resampler resampler({ filter, srgb });
+                ASSERT_TRUE(resampler.Resample(src.View(), dst.MutableView()));
+                for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+                    ASSERT_EQ(dst.Data()[i], 200) << w << "x" << h;
+                    ASSERT_EQ(dst.Data()[i + 1], 17);
+                    ASSERT_EQ(dst.Data()[i + 2], 90);
+                    ASSERT_EQ(dst.Data()[i + 3], 133);
+                }
+            }
+        }
+    }
+}
+
+TEST(ResamplerTests, BoxAveragesWholeFootprints)
+{
+    // 4:1 reduction of 1-texel stripes: every output covers two black and two
+    // white texels, so point sampling would alias to black or white
+    qisx::Image src(64, 8);
+    for (uint32_t y = 0; y < src.Height(); y++) {
+        for (uint32_t x = 0; x < src.Width(); x++) {
+            uint8_t* p = src.Data() + y * src.RowPitch() + x * 4;
+            p[0] = p[1] = p[2] = (x & 1) ? 255 : 0;
+            p[3] = 255;
+        }
+    }
+    qisx::Image dst(16, 2);
+    ASSERT_TRUE(qisx::Resampler().Resample(src.View(), dst.MutableView()));
+    for (size_t i = 0; i < dst.SizeInBytes(); i += 4)
+        ASSERT_EQ(dst.Data()[i], 128);
+
+    // Lanczos on a non-integer ratio stays near grey as well, away from the
+    // edges, where clamping repeats the outermost stripe
+    qisx::Image odd(21, 3);
+    ASSERT_TRUE(qisx::Resampler({ qisx::ResampleFilter::Lanczos3 }).Resample(src.View(), odd.MutableView()));
+    for (uint32_t y = 0; y < odd.Height(); y++) {
+        for (uint32_t x = 1; x + 1 < odd.Width(); x++)
+            EXPECT_NEAR(odd.Data()[y * odd.RowPitch() + x * 4], 128, 12) << x;
+    }
+}
+
+TEST(ResamplerTests, SimdAndThreadsMatchScalar)
+{
+    const qisx::Image src = qisx::test::RandomImage(517, 263, 5);
+    for (qisx::ResampleFilter filter : kFilters) {
+        for (bool srgb : { false, true }) {
+            qisx::Resampler::Options options{ filter, srgb };
+            options.simd = qisx::SimdLevel::Scalar;
+            options.threadCount = 1;
+            qisx::Image expected(131, 200);
+            ASSERT_TRUE(qisx::Resampler(options).Resample(src.View(), expected.MutableView()));
+
+            options.simd = qisx::SimdLevel::Auto;
+            qisx::Image single(131, 200);
+            ASSERT_TRUE(qisx::Resampler(options).Resample(src.View(), single.MutableView()));
+
+            options.threadCount = 4;
+            options.bandHeight = 7;
+            qisx::Image threaded(131, 200);
+            ASSERT_TRUE(qisx::Resampler(options).Resample(src.View(), threaded.MutableView()));
+
+            EXPECT_LE(qisx::test::MaxDifference(expected, single), 1);
+            EXPECT_EQ(qisx::test::MaxDifference(single, threaded), 0);
+        }
+    }
+}
+
+TEST(ResamplerTests, RejectsEmptyAndAliasingViews)
+{
+    qisx::Image image(8, 8);
+    qisx::Resampler resampler;
+    EXPECT_FALSE(resampler.Resample(image.View(), image.MutableView()));
+    EXPECT_FALSE(resampler.Resample(qisx::ImageView{}, image.MutableView()));
+}
@@ -0,0 +1,340 @@
+#include "SharpenRcas.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+// The SIMD kernels hold one colour channel of 4 (8 with AVX2) neighbouring
+// pixels per register, so the per-channel limits and the max over channels
+// are plain lane-wise operations. All arithmetic is exact-IEEE and in the
+// scalar order, so every ISA produces identical output.
+
+namespace qisx {
+
+namespace {
+
+    // Strongest lobe for one channel that keeps the result within range
+    inline float ChannelLobe(float b, float d, float e, float f, float h)
+    {
+        const float mn = std::min(std::min(b, d), std::min(f, h));
+        const float mx = std::max(std::max(b, d), std::max(f, h));
+        const float hitMin = std::min(mn, e) / std::max(4.0f * mx, 1.0f);
+        const float hitMax = (255.0f - std::max(mx, e)) / std::min(4.0f * mn - 1020.0f, -1.0f);
+        return std::max(-hitMin, hitMax);
+    }
+
+    inline void RcasPixel(const uint8_t* b, const uint8_t* d, const uint8_t* e, const uint8_t* f, const uint8_t* h,
+        float sharpness, uint8_t* out)
+    {
+        float lobe = ChannelLobe(b[0], d[0], e[0], f[0], h[0]);
+        lobe = std::max(lobe, ChannelLobe(b[1], d[1], e[1], f[1], h[1]));
+        lobe = std::max(lobe, ChannelLobe(b[2], d[2], e[2], f[2], h[2]));
+        lobe = std::max(-kRcasLimit, std::min(lobe, 0.0f)) * sharpness;
+
+        const float rcp = 1.0f / (4.0f * lobe + 1.0f);
+        for (int c = 0; c < 3; c++) {
+            const float cross = (float(b[c]) + float(d[c])) + (float(f[c]) + float(h[c]));
+            const float v = std::clamp((lobe * cross + float(e[c])) * rcp, 0.0f, 255.0f);
+            out[c] = static_cast<uint8_t>(v + 0.5f);
+        }
+        out[3] = e[3];
+    }
+
+    // One pixel with the horizontal neighbours clamped to the row
+    inline void RcasColumn(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint32_t width,
+        uint32_t x, float sharpness, uint8_t* dst)
+    {
+        const uint32_t left = x > 0 ? x - 1 : 0;
+        const uint32_t right = x + 1 < width ? x + 1 : x;
+        RcasPixel(above + size_t(x) * 4, row + size_t(left) * 4, row + size_t(x) * 4, row + size_t(right) * 4,
+            below + size_t(x) * 4, sharpness, dst + size_t(x) * 4);
+    }
+
+}
+
+void RcasRowScalar(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+    uint32_t width, float sharpness, uint8_t* dst)
+{
+    for (uint32_t x = 0; x < width; x++)
+        RcasColumn(above, row, below, width, x, sharpness, dst);
+}
+
+#if defined(QISX_ARCH_X86)
+
+namespace {
+
+    struct ChannelsSSE41 {
+        __m128 c[3];
+    };
+
+    QISX_TARGET("sse4.1")
+    inline ChannelsSSE41 LoadChannelsSSE41(const uint8_t* p)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i mask = _mm_set1_epi32(0xff);
+        return { { _mm_cvtepi32_ps(_mm_and_si128(v, mask)),
+            _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 8), mask)),
+            _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 16), mask)) } };
+    }
+
+    QISX_TARGET("sse4.1")
+    inline __m128 ChannelLobeSSE41(__m128 b, __m128 d, __m128 e, __m128 f, __m128 h)
+    {
+        const __m128 mn = _mm_min_ps(_mm_min_ps(b, d), _mm_min_ps(f, h));
+        const __m128 mx = _mm_max_ps(_mm_max_ps(b, d), _mm_max_ps(f, h));
+        const __m128 four = _mm_set1_ps(4.0f);
+        const __m128 hitMin = _mm_div_ps(_mm_min_ps(mn, e), _mm_max_ps(_mm_mul_ps(four, mx), _mm_set1_ps(1.0f)));
+        const __m128 hitMax = _mm_div_ps(_mm_sub_ps(_mm_set1_ps(255.0f), _mm_max_ps(mx, e)),
+            _mm_min_ps(_mm_sub_ps(_mm_mul_ps(four, mn), _mm_set1_ps(1020.0f)), _mm_set1_ps(-1.0f)));
+        return _mm_max_ps(_mm_xor_ps(hitMin, _mm_set1_ps(-0.0f)), hitMax);
+    }
+
+    QISX_TARGET("sse4.1")
+    inline __m128i ResolveChannelSSE41(__m128 b, __m128 d, __m128 e, __m128 f, __m128 h, __m128 lobe, __m128 rcp)
+    {
+        const __m128 cross = _mm_add_ps(_mm_add_ps(b, d), _mm_add_ps(f, h));
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(lobe, cross), e), rcp);
+        v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+        return _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+    }
+
+    struct ChannelsAVX2 {
+        __m256 c[3];
+    };
+
+    QISX_TARGET("avx2")
+    inline ChannelsAVX2 LoadChannelsAVX2(const uint8_t* p)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        return { { _mm256_cvtepi32_ps(_mm256_and_si256(v, mask)),
+            _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 8), mask)),
+            _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask)) } };
+    }
+
+    QISX_TARGET("avx2")
+    inline __m256 ChannelLobeAVX2(__m256 b, __m256 d, __m256 e, __m256 f, __m256 h)
+    {
+        const __m256 mn = _mm256_min_ps(_mm256_min_ps(b, d), _mm256_min_ps(f, h));
+        const __m256 mx = _mm256_max_ps(_mm256_max_ps(b, d), _mm256_max_ps(f, h));
+        const __m256 four = _mm256_set1_ps(4.0f);
+        const __m256 hitMin = _mm256_div_ps(_mm256_min_ps(mn, e), _mm256_max_ps(_mm256_mul_ps(four, mx), _mm256_set1_ps(1.0f)));
+        const __m256 hitMax = _mm256_div_ps(_mm256_sub_ps(_mm256_set1_ps(255.0f), _mm256_max_ps(mx, e)),
+            _mm256_min_ps(_mm256_sub_ps(_mm256_mul_ps(four, mn), _mm256_set1_ps(1020.0f)), _mm256_set1_ps(-1.0f)));
+        return _mm256_max_ps(_mm256_xor_ps(hitMin, _mm256_set1_ps(-0.0f)), hitMax);
+    }
+
+    QISX_TARGET("avx2")
+    inline __m256i ResolveChannelAVX2(__m256 b, __m256 d, __m256 e, __m256 f, __m256 h, __m256 lobe, __m256 rcp)
+    {
+        const __m256 cross = _mm256_add_ps(_mm256_add_ps(b, d), _mm256_add_ps(f, h));
+        __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(lobe, cross), e), rcp);
+        v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+        return _mm256_cvttps_epi32(_mm256_add_ps(v, _mm256_set1_ps(0.5f)));
+    }
+
+}
+
+QISX_TARGET("sse4.1")
+void RcasRowSSE41(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+    uint32_t width, float sharpness, uint8_t* dst)
+{
+    if (width < 6) {
+        RcasRowScalar(above, row, below, width, sharpness, dst);
+        return;
+    }
+
+    RcasColumn(above, row, below, width, 0, sharpness, dst);
+    const __m128 limit = _mm_set1_ps(-kRcasLimit);
+    const __m128 scale = _mm_set1_ps(sharpness);
+    const __m128i alphaMask = _mm_set1_epi32(int32_t(0xff000000u));
+
+    // Pixels x .. x+3; their right neighbours end at x+4 <= width-1
+    uint32_t x = 1;
+    for (; x + 4 < width; x += 4) {
+        const size_t offset = size_t(x) * 4;
+        const ChannelsSSE41 b = LoadChannelsSSE41(above + offset);
+        const ChannelsSSE41 d = LoadChannelsSSE41(row + offset - 4);
+        const ChannelsSSE41 e = LoadChannelsSSE41(row + offset);
+        const ChannelsSSE41 f = LoadChannelsSSE41(row + offset + 4);
+        const ChannelsSSE41 h = LoadChannelsSSE41(below + offset);
+
+        __m128 lobe = ChannelLobeSSE41(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0]);
+        lobe = _mm_max_ps(lobe, ChannelLobeSSE41(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1]));
+        lobe = _mm_max_ps(lobe, ChannelLobeSSE41(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2]));
+        lobe = _mm_mul_ps(_mm_max_ps(limit, _mm_min_ps(lobe, _mm_setzero_ps())), scale);
+        const __m128 rcp = _mm_div_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(4.0f), lobe), _mm_set1_ps(1.0f)));
+
+        const __m128i r = ResolveChannelSSE41(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0], lobe, rcp);
+        const __m128i g = ResolveChannelSSE41(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1], lobe, rcp);
+        const __m128i bl = ResolveChannelSSE41(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2], lobe, rcp);
+        const __m128i alpha = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + offset)), alphaMask);
+        const __m128i packed = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(bl, 16), alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), packed);
+    }
+
+    for (; x < width; x++)
+        RcasColumn(above, row, below, width, x, sharpness, dst);
+}
+
+QISX_TARGET("avx2")
+void RcasRowAVX2(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+    uint32_t width, float sharpness, uint8_t* dst)
+{
+    if (width < 10) {
+        RcasRowScalar(above, row, below, width, sharpness, dst);
+        return;
+    }
+
+    RcasColumn(above, row, below, width, 0, sharpness, dst);
+    const __m256 limit = _mm256_set1_ps(-kRcasLimit);
+    const __m256 scale = _mm256_set1_ps(sharpness);
+    const __m256i alphaMask = _mm256_set1_epi32(int32_t(0xff000000u));
+
+    uint32_t x = 1;
+    for (; x + 8 < width; x += 8) {
+        const size_t offset = size_t(x) * 4;
+        const ChannelsAVX2 b = LoadChannelsAVX2(above + offset);
+        const ChannelsAVX2 d = LoadChannelsAVX2(row + offset - 4);
+        const ChannelsAVX2 e = LoadChannelsAVX2(row + offset);
+        const ChannelsAVX2 f = LoadChannelsAVX2(row + offset + 4);
+        const ChannelsAVX2 h = LoadChannelsAVX2(below + offset);
+
+        __m256 lobe = ChannelLobeAVX2(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0]);
+        lobe = _mm256_max_ps(lobe, ChannelLobeAVX2(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1]));
+        lobe = _mm256_max_ps(lobe, ChannelLobeAVX2(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2]));
+        lobe = _mm256_mul_ps(_mm256_max_ps(limit, _mm256_min_ps(lobe, _mm256_setzero_ps())), scale);
+        const __m256 rcp = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), lobe), _mm256_set1_ps(1.0f)));
+
+        const __m256i r = ResolveChannelAVX2(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0], lobe, rcp);
+        const __m256i g = ResolveChannelAVX2(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1], lobe, rcp);
+        const __m256i bl = ResolveChannelAVX2(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2], lobe, rcp);
+        const __m256i alpha = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + offset)), alphaMask);
+        const __m256i packed = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+            _mm256_or_si256(_mm256_slli_epi32(bl, 16), alpha));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset), packed);
+    }
+
+    for (; x < width; x++)
+        RcasColumn(above, row, below, width, x, sharpness, dst);
+}
+
+#elif defined(QISX_ARCH_ARM64)
+
+namespace {
+
+    struct ChannelsNEON {
+        float32x4_t c[3];
+    };
+
+    inline ChannelsNEON LoadChannelsNEON(const uint8_t* p)
+    {
+        const uint32x4_t v = vreinterpretq_u32_u8(vld1q_u8(p));
+        const uint32x4_t mask = vdupq_n_u32(0xff);
+        return { { vcvtq_f32_u32(vandq_u32(v, mask)),
+            vcvtq_f32_u32(vandq_u32(vshrq_n_u32(v, 8), mask)),
+            vcvtq_f32_u32(vandq_u32(vshrq_n_u32(v, 16), mask)) } };
+    }
+
+    inline float32x4_t ChannelLobeNEON(float32x4_t b, float32x4_t d, float32x4_t e, float32x4_t f, float32x4_t h)
+    {
+        const float32x4_t mn = vminq_f32(vminq_f32(b, d), vminq_f32(f, h));
+        const float32x4_t mx = vmaxq_f32(vmaxq_f32(b, d), vmaxq_f32(f, h));
+        const float32x4_t hitMin = vdivq_f32(vminq_f32(mn, e), vmaxq_f32(vmulq_n_f32(mx, 4.0f), vdupq_n_f32(1.0f)));
+        const float32x4_t hitMax = vdivq_f32(vsubq_f32(vdupq_n_f32(255.0f), vmaxq_f32(mx, e)),
+            vminq_f32(vsubq_f32(vmulq_n_f32(mn, 4.0f), vdupq_n_f32(1020.0f)), vdupq_n_f32(-1.0f)));
+        return vmaxq_f32(vnegq_f32(hitMin), hitMax);
+    }
+
+    inline uint32x4_t ResolveChannelNEON(float32x4_t b, float32x4_t d, float32x4_t e, float32x4_t f, float32x4_t h,
+        float32x4_t lobe, float32x4_t rcp)
+    {
+        const float32x4_t cross = vaddq_f32(vaddq_f32(b, d), vaddq_f32(f, h));
+        float32x4_t v = vmulq_f32(vaddq_f32(vmulq_f32(lobe, cross), e), rcp);
+        v = vminq_f32(vmaxq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+        return vcvtq_u32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)));
+    }
+
+}
+
+void RcasRowNEON(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+    uint32_t width, float sharpness, uint8_t* dst)
+{
+    if (width < 6) {
+        RcasRowScalar(above, row, below, width, sharpness, dst);
+        return;
+    }
+
+    RcasColumn(above, row, below, width, 0, sharpness, dst);
+    const float32x4_t limit = vdupq_n_f32(-kRcasLimit);
+    const uint32x4_t alphaMask = vdupq_n_u32(0xff000000u);
+
+    uint32_t x = 1;
+    for (; x + 4 < width; x += 4) {
+        const size_t offset = size_t(x) * 4;
+        const ChannelsNEON b = LoadChannelsNEON(above + offset);
+        const ChannelsNEON d = LoadChannelsNEON(row + offset - 4);
+        const ChannelsNEON e = LoadChannelsNEON(row + offset);
+        const ChannelsNEON f = LoadChannelsNEON(row + offset + 4);
+        const ChannelsNEON h = LoadChannelsNEON(below + offset);
+
+        float32x4_t lobe = ChannelLobeNEON(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0]);
+        lobe = vmaxq_f32(lobe, ChannelLobeNEON(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1]));
+        lobe = vmaxq_f32(lobe, ChannelLobeNEON(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2]));
+        lobe = vmulq_n_f32(vmaxq_f32(limit, vminq_f32(lobe, vdupq_n_f32(0.0f))), sharpness);
+        const float32x4_t rcp = vdivq_f32(vdupq_n_f32(1.0f), vaddq_f32(vmulq_n_f32(lobe, 4.0f), vdupq_n_f32(1.0f)));
+
+        const uint32x4_t r = ResolveChannelNEON(b.c[0], d.c[0], e.c[0], f.c[0], h.c[0], lobe, rcp);
+        const uint32x4_t g = ResolveChannelNEON(b.c[1], d.c[1], e.c[1], f.c[1], h.c[1], lobe, rcp);
+        const uint32x4_t bl = ResolveChannelNEON(b.c[2], d.c[2], e.c[2], f.c[2], h.c[2], lobe, rcp);
+        const uint32x4_t alpha = vandq_u32(vreinterpretq_u32_u8(vld1q_u8(row + offset)), alphaMask);
+        const uint32x4_t packed = vorrq_u32(vorrq_u32(r, vshlq_n_u32(g, 8)), vorrq_u32(vshlq_n_u32(bl, 16), alpha));
+        vst1q_u8(dst + offset, vreinterpretq_u8_u32(packed));
+    }
+
+    for (; x < width; x++)
+        RcasColumn(above, row, below, width, x, sharpness, dst);
+}
+
+#endif
+
+const RcasKernelTable* GetRcasKernels(SimdLevel level)
+{
+    static const RcasKernelTable kScalar = { SimdLevel::Scalar, RcasRowScalar };
+#if defined(QISX_ARCH_X86)
+    static const RcasKernelTable kSSE41 = { SimdLevel::SSE41, RcasRowSSE41 };
+    static const RcasKernelTable kAVX2 = { SimdLevel::AVX2, RcasRowAVX2 };
+#elif defined(QISX_ARCH_ARM64)
+    static const RcasKernelTable kNEON = { SimdLevel::NEON, RcasRowNEON };
+#endif
+
+    if (level == SimdLevel::Auto)
+        level = DetectSimdLevel();
+
+#if defined(QISX_ARCH_X86)
+    if (level == SimdLevel::AVX2 && IsSimdLevelSupported(SimdLevel::AVX2))
+        return &kAVX2;
+    if ((level == SimdLevel::SSE41 || level == SimdLevel::AVX2) && IsSimdLevelSupported(SimdLevel::SSE41))
+        return &kSSE41;
+#elif defined(QISX_ARCH_ARM64)
+    if (level == SimdLevel::NEON && IsSimdLevelSupported(SimdLevel::NEON))
+        return &kNEON;
+#endif
+    return &kScalar;
+}
+
+void SharpenRcas(const ImageView& src, const MutableImageView& dst, uint32_t y0, uint32_t y1,
+    float sharpness, const RcasKernelTable& kernels)
+{
+    for (uint32_t y = y0; y < y1; y++) {
+        const uint8_t* above = src.Row(y > 0 ? y - 1 : 0);
+        const uint8_t* below = src.Row(y + 1 < src.height ? y + 1 : y);
+        kernels.row(above, src.Row(y), below, src.width, sharpness, dst.Row(y));
+    }
+}
+
+}
@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "SharpenRcas.h"
+#include "TestImages.h"
+
+#include <cstring>
+
+namespace {
+
+    void Sharpen(const qisx::Image& src, qisx::Image& dst, float sharpness, qisx::SimdLevel level)
+    {
+        qisx::SharpenRcas(src.View(), dst.MutableView(), 0, src.Height(), sharpness, *qisx::GetRcasKernels(level));
+    }
+
+    // Horizontal ramp from lo to hi over columns [x0, x0 + steps]
+    qisx::Image Ramp(uint32_t width, uint32_t height, uint32_t x0, uint32_t steps, int lo, int hi)
+    {
+        qisx::Image image(width, height);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const int t = x <= x0 ? 0 : (x >= x0 + steps ? int(steps) : int(x - x0));
+                uint8_t* p = image.Data() + y * image.RowPitch() + x * 4;
+                p[0] = p[1] = p[2] = uint8_t(lo + (hi - lo) * t / int(steps));
+                p[3] = 200;
+            }
+        }
+        return image;
+    }
+
+}
+
+TEST(SharpenRcasTests, FlatColourIsPreserved)
+{
+    qisx::Image src(37, 9);
+    for (size_t i = 0; i < src.SizeInBytes(); i += 4) {
+        src.Data()[i + 0] = 0;
+        src.Data()[i + 1] = 77;
+        src.Data()[i + 2] = 254;
+        src.Data()[i + 3] = 13;
+    }
+    for (float sharpness : { 0.25f, 1.0f }) {
+        qisx::Image dst(37, 9);
+        Sharpen(src, dst, sharpness, qisx::SimdLevel::Auto);
+        EXPECT_EQ(memcmp(src.Data(), dst.Data(), src.SizeInBytes()), 0) << sharpness;
+    }
+}
+
+// The SIMD kernels keep the scalar operation order, so any width (including
+// the scalar edge columns and tails) is bit-identical.
+TEST(SharpenRcasTests, SimdMatchesScalar)
+{
+    for (uint32_t width : { 1u, 2u, 5u, 6u, 9u, 10u, 17u, 64u, 1283u }) {
+        qisx::Image src(width, 5);
+        qisx::test::FillRandom(src, width);
+        qisx::Image expected(width, 5);
+        qisx::Image actual(width, 5);
+        Sharpen(src, expected, 0.8f, qisx::SimdLevel::Scalar);
+        for (qisx::SimdLevel level : { qisx::SimdLevel::SSE41, qisx::SimdLevel::AVX2, qisx::SimdLevel::NEON }) {
+            if (!qisx::IsSimdLevelSupported(level))
+                continue;
+            Sharpen(src, actual, 0.8f, level);
+            EXPECT_EQ(memcmp(expected.Data(), actual.Data(), expected.SizeInBytes()), 0)
+                << qisx::SimdLevelName(level) << " width " << width;
+        }
+    }
+}
+
+TEST(SharpenRcasTests, SharpensCornersOfSoftEdges)
+{
+    const qisx::Image src = Ramp(32, 3, 12, 6, 60, 180);
+    qisx::Image weak(32, 3);
+    qisx::Image strong(32, 3);
+    Sharpen(src, weak, 0.25f, qisx::SimdLevel::Auto);
+    Sharpen(src, strong, 1.0f, qisx::SimdLevel::Auto);
+
+    // The corners of the ramp overshoot outwards, more with more sharpness.
+    // The linear part in between and the plateaus have no curvature and
+    // stay as they are; alpha is copied.
+    const uint8_t* in = src.Data() + src.RowPitch();
+    const uint8_t* a = weak.Data() + weak.RowPitch();
+    const uint8_t* b = strong.Data() + strong.RowPitch();
+    EXPECT_LT(a[4 * 12], in[4 * 12]);
+    EXPECT_LT(b[4 * 12], a[4 * 12]);
+    EXPECT_GT(a[4 * 18], in[4 * 18]);
+    EXPECT_GT(b[4 * 18], a[4 * 18]);
+    for (uint32_t x : { 0u, 5u, 15u, 25u, 31u }) {
+        EXPECT_EQ(b[4 * x], in[4 * x]) << x;
+        EXPECT_EQ(b[4 * x + 3], 200);
+    }
+    for (uint32_t x = 0; x < 32; x++) {
+        EXPECT_GE(b[4 * x], 40) << x;
+        EXPECT_LE(b[4 * x], 200) << x;
+    }
+}
+
+TEST(SharpenRcasTests, LeavesFullRangeEdgesAlone)
+{
+    // Black/white stripes: any negative lobe would clip, so the limit is zero
+    qisx::Image src(24, 4);
+    for (uint32_t y = 0; y < 4; y++) {
+        for (uint32_t x = 0; x < 24; x++) {
+            uint8_t* p = src.Data() + y * src.RowPitch() + x * 4;
+            p[0] = p[1] = p[2] = (x / 3) & 1 ? 255 : 0;
+            p[3] = 255;
+        }
+    }
+    qisx::Image dst(24, 4);
+    Sharpen(src, dst, 1.0f, qisx::SimdLevel::Auto);
+    EXPECT_EQ(memcmp(src.Data(), dst.Data(), src.SizeInBytes()), 0);
+}
+
+// The upscaler replaces its unsharp mask by the RCAS pass, and banding the
+// pass over threads does not change the result.
+TEST(SharpenRcasTests, UpscalerRunsRcasInsteadOfUnsharpMask)
+{
+    qisx::Image src(97, 61);
+    qisx::test::FillRandom(src, 3);
+
+    qisx::Image plain(211, 130);
+    ASSERT_TRUE(qisx::CpuUpscaler({ 0.0f, false, qisx::UpscalePath::Separable, qisx::SimdLevel::Auto, 1 })
+        .Upscale(src.View(), plain.MutableView()));
+    qisx::Image expected(211, 130);
+    Sharpen(plain, expected, 0.6f, qisx::SimdLevel::Auto);
+
+    for (qisx::UpscalePath path : { qisx::UpscalePath::Separable, qisx::UpscalePath::FixedPoint }) {
+        qisx::CpuUpscaler::Options options{ 1.5f, false, path, qisx::SimdLevel::Auto, 3 };
+        options.tileHeight = 13;
+        options.rcasSharpness = 0.6f;
+        qisx::Image actual(211, 130);
+        ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), actual.MutableView()));
+
+        int worst = 0;
+        for (size_t i = 0; i < actual.SizeInBytes(); i++)
+            worst = std::max(worst, std::abs(int(actual.Data()[i]) - int(expected.Data()[i])));
+        // FixedPoint is within 1 LSB of the float path, which RCAS can stretch a little
+        EXPECT_LE(worst, path == qisx::UpscalePath::Separable ? 0 : 2) << int(path);
+    }
+}
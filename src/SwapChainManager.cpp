@@ -0,0 +1,76 @@
+#include "SwapChainManager.h"
+
+namespace qisx {
+
+SwapChainManager::SwapChainManager(SwapChainBackend& backend, uint32_t width, uint32_t height)
+    : m_backend(backend),
+      m_width(width),
+      m_height(height)
+{
+}
+
+SwapChainManager::~SwapChainManager()
+{
+    ReleaseTargets();
+}
+
+bool SwapChainManager::BeginFrame()
+{
+    if (m_pendingWidth) {
+        // Every view of the buffers has to go before they can be resized
+        ReleaseTargets();
+        if (m_backend.ResizeBuffers(m_pendingWidth, m_pendingHeight)) {
+            m_width = m_pendingWidth;
+            m_height = m_pendingHeight;
+            m_stats.resizes++;
+        }
+        m_pendingWidth = m_pendingHeight = 0;
+    }
+
+    if (!m_haveTargets) {
+        m_haveTargets = m_backend.CreateTargets();
+        m_stats.targetCreations++;
+        if (!m_haveTargets)
+            return false;
+    }
+
+    m_inFrame = true;
+    m_stats.frames++;
+    return true;
+}
+
+bool SwapChainManager::Present(uint32_t syncInterval)
+{
+    if (!m_inFrame) {
+        m_stats.refusedPresents++;
+        return false;
+    }
+    m_inFrame = false;
+    m_stats.presents++;
+    if (m_backend.Present(syncInterval))
+        return true;
+    m_stats.failedPresents++;
+    return false;
+}
+
+void SwapChainManager::RequestResize(uint32_t width, uint32_t height)
+{
+    if (!width || !height)
+        return;
+    if (width == m_width && height == m_height) {
+        m_pendingWidth = m_pendingHeight = 0;   // Resized back before it took effect
+        return;
+    }
+    m_pendingWidth = width;
+    m_pendingHeight = height;
+}
+
+void SwapChainManager::ReleaseTargets()
+{
+    if (!m_haveTargets)
+        return;
+    m_backend.ReleaseTargets();
+    m_haveTargets = false;
+}
+
+}
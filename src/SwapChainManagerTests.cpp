@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "SwapChainManager.h"
+
+// The viewer loop: one BeginFrame and one Present per frame, views created once.
+TEST(SwapChainManagerTests, PresentsOncePerFrameWithoutRecreatingViews)
+{
+    qisx::MockSwapChain swapChain(3);
+    qisx::SwapChainManager manager(swapChain, 1280, 720);
+
+    for (int frame = 0; frame < 120; frame++) {
+        ASSERT_TRUE(manager.BeginFrame());
+        EXPECT_EQ(manager.GetCurrentTarget(), uint32_t(frame % 3));
+        ASSERT_TRUE(manager.Present(1));
+    }
+
+    EXPECT_EQ(swapChain.GetPresents(), 120u);
+    EXPECT_EQ(swapChain.GetTargetsCreated(), 3u);
+    EXPECT_EQ(manager.GetStats().targetCreations, 1u);
+    EXPECT_EQ(manager.GetStats().frames, 120u);
+}
+
+// A second Present in the same frame (the old UpscaleToBackbuffer + main
+// loop pair) is refused instead of halving the frame rate.
+TEST(SwapChainManagerTests, RefusesASecondPresentInTheSameFrame)
+{
+    qisx::MockSwapChain swapChain;
+    qisx::SwapChainManager manager(swapChain, 1280, 720);
+
+    for (int frame = 0; frame < 60; frame++) {
+        ASSERT_TRUE(manager.BeginFrame());
+        EXPECT_TRUE(manager.Present(1));
+        EXPECT_FALSE(manager.Present(1));
+    }
+    EXPECT_FALSE(manager.Present(1));   // No frame open at all
+
+    EXPECT_EQ(swapChain.GetPresents(), 60u);
+    EXPECT_EQ(manager.GetStats().presents, 60u);
+    EXPECT_EQ(manager.GetStats().refusedPresents, 61u);
+}
+
+// Resizes wait for the next frame, release the views before ResizeBuffers
+// (the mock fails otherwise) and recreate them once.
+TEST(SwapChainManagerTests, ResizesBetweenFramesAndRecreatesViewsOnce)
+{
+    qisx::MockSwapChain swapChain(2);
+    qisx::SwapChainManager manager(swapChain, 1280, 720);
+    ASSERT_TRUE(manager.BeginFrame());
+
+    manager.RequestResize(1920, 1080);
+    EXPECT_EQ(manager.GetWidth(), 1280u);   // Not mid-frame
+    ASSERT_TRUE(manager.Present(1));
+
+    manager.RequestResize(0, 0);            // Minimised: ignored
+    for (int frame = 0; frame < 10; frame++) {
+        ASSERT_TRUE(manager.BeginFrame());
+        ASSERT_TRUE(manager.Present(1));
+    }
+    EXPECT_EQ(manager.GetWidth(), 1920u);
+    EXPECT_EQ(manager.GetHeight(), 1080u);
+    EXPECT_EQ(swapChain.GetWidth(), 1920u);
+    EXPECT_EQ(swapChain.GetResizes(), 1u);
+    EXPECT_EQ(manager.GetStats().targetCreations, 2u);
+    EXPECT_EQ(swapChain.GetLiveTargets(), 2u);
+
+    // Dragging back to the current size before a frame cancels the resize
+    manager.RequestResize(1600, 900);
+    manager.RequestResize(1920, 1080);
+    ASSERT_TRUE(manager.BeginFrame());
+    EXPECT_EQ(swapChain.GetResizes(), 1u);
+    EXPECT_EQ(manager.GetStats().targetCreations, 2u);
+
+    manager.ReleaseTargets();
+    EXPECT_EQ(swapChain.GetLiveTargets(), 0u);
+}
+
+TEST(SwapChainManagerTests, RetriesViewCreationAfterAFailure)
+{
+    qisx::MockSwapChain swapChain;
+    qisx::SwapChainManager manager(swapChain, 640, 360);
+
+    swapChain.SetFailCreate(true);
+    EXPECT_FALSE(manager.BeginFrame());
+    EXPECT_FALSE(manager.Present(1));
+    EXPECT_EQ(swapChain.GetPresents(), 0u);
+
+    swapChain.SetFailCreate(false);
+    EXPECT_TRUE(manager.BeginFrame());
+    EXPECT_TRUE(manager.Present(1));
+    EXPECT_EQ(manager.GetStats().targetCreations, 2u);
+}
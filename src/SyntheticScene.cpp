@@ -0,0 +1,113 @@
+#include "SyntheticScene.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+namespace {
+
+    constexpr float kPi = 3.14159265f;
+
+    // Zone plate phase k * r^2 reaches 80 cycles per UV unit at r = 0.5.
+    constexpr float kZonePlateK = 2.0f * kPi * 80.0f;
+    // Stripes at 60 cycles per UV unit, 20 degrees off vertical.
+    constexpr float kStripeFrequency = 2.0f * kPi * 60.0f;
+    constexpr float kStripeCos = 0.93969262f;
+    constexpr float kStripeSin = 0.34202014f;
+    constexpr float kCheckerCellsX = 20.0f;
+    constexpr float kCheckerCellsY = 14.0f;
+
+    const float kDiscColor[3] = { 230.0f, 60.0f, 40.0f };
+
+    uint8_t ToByte(float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+    }
+
+}
+
+bool SyntheticScene::InsideDisc(uint32_t frame, float u, float v) const
+{
+    if (!m_options.disc)
+        return false;
+    const float dx = u - (m_options.discX + m_options.velocityX * float(frame));
+    const float dy = v - (m_options.discY + m_options.velocityY * float(frame));
+    return dx * dx + dy * dy < m_options.discRadius * m_options.discRadius;
+}
+
+void SyntheticScene::Sample(uint32_t frame, float u, float v, float rgb[3]) const
+{
+    if (InsideDisc(frame, u, v)) {
+        rgb[0] = kDiscColor[0];
+        rgb[1] = kDiscColor[1];
+        rgb[2] = kDiscColor[2];
+        return;
+    }
+
+    const float du = u - 0.5f;
+    const float dv = v - 0.5f;
+    rgb[0] = 128.0f + 100.0f * std::cos(kZonePlateK * (du * du + dv * dv));
+    rgb[1] = 128.0f + 100.0f * std::sin(kStripeFrequency * (u * kStripeCos + v * kStripeSin));
+    const int cell = int(std::floor(u * kCheckerCellsX)) + int(std::floor(v * kCheckerCellsY));
+    rgb[2] = (cell & 1) ? 200.0f : 50.0f;
+}
+
+void SyntheticScene::Render(uint32_t frame, float jitterX, float jitterY, const MutableImageView& color, float* motion) const
+{
+    const float invW = 1.0f / float(color.width);
+    const float invH = 1.0f / float(color.height);
+    for (uint32_t y = 0; y < color.height; y++) {
+        uint8_t* row = color.Row(y);
+        const float v = (float(y) + 0.5f + jitterY) * invH;
+        for (uint32_t x = 0; x < color.width; x++) {
+            const float u = (float(x) + 0.5f + jitterX) * invW;
+            float rgb[3];
+            Sample(frame, u, v, rgb);
+            row[x * 4 + 0] = ToByte(rgb[0]);
+            row[x * 4 + 1] = ToByte(rgb[1]);
+            row[x * 4 + 2] = ToByte(rgb[2]);
+            row[x * 4 + 3] = 255;
+
+            if (motion) {
+                // The background is static; the disc surface was -velocity away
+                // in the previous frame.
+                float* mv = motion + (size_t(y) * color.width + x) * 2;
+                const bool disc = InsideDisc(frame, u, v);
+                mv[0] = disc ? -m_options.velocityX : 0.0f;
+                mv[1] = disc ? -m_options.velocityY : 0.0f;
+            }
+        }
+    }
+}
+
+void SyntheticScene::RenderReference(uint32_t frame, const MutableImageView& color, uint32_t samples) const
+{
+    samples = std::max(1u, samples);
+    const float invW = 1.0f / float(color.width);
+    const float invH = 1.0f / float(color.height);
+    const float step = 1.0f / float(samples);
+    const float norm = 1.0f / float(samples * samples);
+    for (uint32_t y = 0; y < color.height; y++) {
+        uint8_t* row = color.Row(y);
+        for (uint32_t x = 0; x < color.width; x++) {
+            float sum[3] = {};
+            for (uint32_t sy = 0; sy < samples; sy++) {
+                const float v = (float(y) + (float(sy) + 0.5f) * step) * invH;
+                for (uint32_t sx = 0; sx < samples; sx++) {
+                    const float u = (float(x) + (float(sx) + 0.5f) * step) * invW;
+                    float rgb[3];
+                    Sample(frame, u, v, rgb);
+                    sum[0] += rgb[0];
+                    sum[1] += rgb[1];
+                    sum[2] += rgb[2];
+                }
+            }
+            row[x * 4 + 0] = ToByte(sum[0] * norm);
+            row[x * 4 + 1] = ToByte(sum[1] * norm);
+            row[x * 4 + 2] = ToByte(sum[2] * norm);
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+}
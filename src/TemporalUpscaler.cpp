@@ -0,0 +1,218 @@
+#include "TemporalUpscaler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+namespace {
+
+    // Per-axis splat footprint for one frame: the nearest jittered input sample
+    // to each output pixel, clamped so its three neighbours exist where the
+    // input is wide enough, and the Gaussian weight of each of the three.
+    // Weights are zero for taps outside the input.
+    struct SplatAxis {
+        std::vector<int32_t> first;     // Index of the first of three taps
+        std::vector<float> weight;      // Three per output pixel
+        std::vector<float> spatial;     // Bilinear fallback position, in input pixels
+    };
+
+    // exp(-2 d^2): a Gaussian with a standard deviation of half an output pixel.
+    constexpr float kSplatSharpness = 2.0f;
+
+    void BuildSplatAxis(uint32_t srcSize, uint32_t dstSize, float jitter, SplatAxis& axis)
+    {
+        axis.first.resize(dstSize);
+        axis.weight.resize(size_t(dstSize) * 3);
+        axis.spatial.resize(dstSize);
+
+        const float scale = float(srcSize) / float(dstSize);
+        for (uint32_t o = 0; o < dstSize; o++) {
+            const float p = (float(o) + 0.5f) * scale;
+            const int32_t nearest = std::clamp(int32_t(std::floor(p - jitter)), 0, int32_t(srcSize) - 1);
+            axis.first[o] = nearest - 1;
+            for (int32_t t = 0; t < 3; t++) {
+                const int32_t i = nearest - 1 + t;
+                float w = 0.0f;
+                if (i >= 0 && i < int32_t(srcSize)) {
+                    const float d = (float(i) + 0.5f + jitter - p) / scale;
+                    w = std::exp(-kSplatSharpness * d * d);
+                }
+                axis.weight[size_t(o) * 3 + t] = w;
+            }
+            axis.spatial[o] = std::clamp(p - 0.5f - jitter, 0.0f, float(srcSize - 1));
+        }
+    }
+
+    // Bilinear fetch of four floats per texel from a width x height plane,
+    // clamped to the edges.
+    void FetchBilinear4(const float* plane, uint32_t width, uint32_t height, float x, float y, float out[4])
+    {
+        x = std::clamp(x, 0.0f, float(width - 1));
+        y = std::clamp(y, 0.0f, float(height - 1));
+        const uint32_t x0 = uint32_t(x), y0 = uint32_t(y);
+        const uint32_t x1 = std::min(x0 + 1, width - 1), y1 = std::min(y0 + 1, height - 1);
+        const float fx = x - float(x0), fy = y - float(y0);
+        const float* a = plane + (size_t(y0) * width + x0) * 4;
+        const float* b = plane + (size_t(y0) * width + x1) * 4;
+        const float* c = plane + (size_t(y1) * width + x0) * 4;
+        const float* d = plane + (size_t(y1) * width + x1) * 4;
+        for (int ch = 0; ch < 4; ch++) {
+            const float top = a[ch] + (b[ch] - a[ch]) * fx;
+            const float bottom = c[ch] + (d[ch] - c[ch]) * fx;
+            out[ch] = top + (bottom - top) * fy;
+        }
+    }
+
+    float FetchBilinear1(const float* plane, uint32_t width, uint32_t height, float x, float y)
+    {
+        x = std::clamp(x, 0.0f, float(width - 1));
+        y = std::clamp(y, 0.0f, float(height - 1));
+        const uint32_t x0 = uint32_t(x), y0 = uint32_t(y);
+        const uint32_t x1 = std::min(x0 + 1, width - 1), y1 = std::min(y0 + 1, height - 1);
+        const float fx = x - float(x0), fy = y - float(y0);
+        const float top = plane[size_t(y0) * width + x0] * (1.0f - fx) + plane[size_t(y0) * width + x1] * fx;
+        const float bottom = plane[size_t(y1) * width + x0] * (1.0f - fx) + plane[size_t(y1) * width + x1] * fx;
+        return top + (bottom - top) * fy;
+    }
+
+}
+
+bool TemporalUpscaler::Accumulate(const TemporalFrame& frame, const MutableImageView& dst)
+{
+    const ImageView& src = frame.color;
+    if (src.Empty() || dst.Empty() || dst.width < src.width || dst.height < src.height)
+        return false;
+
+    const size_t dstPixels = size_t(dst.width) * dst.height;
+    if (frame.reset || src.width != m_srcWidth || src.height != m_srcHeight
+        || dst.width != m_dstWidth || dst.height != m_dstHeight) {
+        m_historyValid = false;
+        m_srcWidth = src.width;
+        m_srcHeight = src.height;
+        m_dstWidth = dst.width;
+        m_dstHeight = dst.height;
+    }
+    for (unsigned i = 0; i < 2; i++) {
+        m_color[i].resize(dstPixels * 4);
+        m_weight[i].resize(dstPixels);
+    }
+
+    SplatAxis axisX, axisY;
+    BuildSplatAxis(src.width, dst.width, frame.jitterX, axisX);
+    BuildSplatAxis(src.height, dst.height, frame.jitterY, axisY);
+
+    const float* historyColor = m_color[m_current].data();
+    const float* historyWeight = m_weight[m_current].data();
+    float* outColor = m_color[m_current ^ 1].data();
+    float* outWeight = m_weight[m_current ^ 1].data();
+    const bool historyValid = m_historyValid;
+    const float maxWeight = std::max(1.0f, m_options.maxHistoryWeight);
+
+    // The splat reads each input pixel up to nine times per covered output
+    // pixel, so decode the frame to float once
+    m_input.resize(size_t(src.width) * src.height * 4);
+    for (uint32_t y = 0; y < src.height; y++) {
+        const uint8_t* row = src.Row(y);
+        float* out = &m_input[size_t(y) * src.width * 4];
+        for (uint32_t i = 0; i < src.width * 4; i++)
+            out[i] = float(row[i]);
+    }
+    const float* input = m_input.data();
+
+    const unsigned threads = m_options.threadCount ? m_options.threadCount : PhysicalCoreCount();
+    if (threads > 1 && (!m_pool || m_pool->GetThreadCount() != threads))
+        m_pool = std::make_unique<ThreadPool>(threads);
+    else if (threads <= 1)
+        m_pool.reset();
+
+    const uint32_t bandHeight = std::max(1u, m_options.bandHeight);
+    const uint32_t bands = (dst.height + bandHeight - 1) / bandHeight;
+
+    auto runBand = [&](uint32_t band, unsigned) {
+        const uint32_t y0 = band * bandHeight;
+        const uint32_t y1 = std::min(dst.height, y0 + bandHeight);
+        for (uint32_t y = y0; y < y1; y++) {
+            const int32_t firstY = axisY.first[y];
+            const float* weightY = &axisY.weight[size_t(y) * 3];
+            uint8_t* dstRow = dst.Row(y);
+
+            for (uint32_t x = 0; x < dst.width; x++) {
+                const int32_t firstX = axisX.first[x];
+                const float* weightX = &axisX.weight[size_t(x) * 3];
+
+                // 1. Splat the 3x3 nearest samples and bound the neighbourhood
+                float sum[4] = {}, lo[4], hi[4];
+                float total = 0.0f;
+                for (int ch = 0; ch < 4; ch++) {
+                    lo[ch] = 255.0f;
+                    hi[ch] = 0.0f;
+                }
+                for (int32_t ty = 0; ty < 3; ty++) {
+                    if (weightY[ty] == 0.0f)
+                        continue;
+                    const float* row = input + size_t(firstY + ty) * src.width * 4;
+                    for (int32_t tx = 0; tx < 3; tx++) {
+                        if (weightX[tx] == 0.0f)
+                            continue;
+                        const float* p = row + size_t(firstX + tx) * 4;
+                        const float w = weightX[tx] * weightY[ty];
+                        for (int ch = 0; ch < 4; ch++) {
+                            const float c = p[ch];
+                            sum[ch] += w * c;
+                            lo[ch] = std::min(lo[ch], c);
+                            hi[ch] = std::max(hi[ch], c);
+                        }
+                        total += w;
+                    }
+                }
+
+                // 2. Reproject through the motion of the nearest sample
+                float history[4];
+                float historyW = 0.0f;
+                if (historyValid) {
+                    float hx = float(x), hy = float(y);
+                    if (frame.motion) {
+                        const uint32_t sx = uint32_t(firstX + 1), sy = uint32_t(firstY + 1);
+                        const float* mv = frame.motion + (size_t(sy) * src.width + sx) * 2;
+                        hx += mv[0] * float(dst.width);
+                        hy += mv[1] * float(dst.height);
+                    }
+                    if (hx >= -0.5f && hx <= float(dst.width) - 0.5f && hy >= -0.5f && hy <= float(dst.height) - 0.5f) {
+                        FetchBilinear4(historyColor, dst.width, dst.height, hx, hy, history);
+                        historyW = std::min(FetchBilinear1(historyWeight, dst.width, dst.height, hx, hy), maxWeight);
+                        // 3. Rectify against the current neighbourhood
+                        for (int ch = 0; ch < 4; ch++)
+                            history[ch] = std::clamp(history[ch], lo[ch], hi[ch]);
+                    }
+                }
+                if (historyW == 0.0f) {
+                    FetchBilinear4(input, src.width, src.height, axisX.spatial[x], axisY.spatial[y], history);
+                    historyW = 1.0f;
+                }
+
+                // 4. Blend
+                const float norm = 1.0f / (historyW + total);
+                const size_t index = size_t(y) * dst.width + x;
+                float* out = outColor + index * 4;
+                for (int ch = 0; ch < 4; ch++) {
+                    out[ch] = (history[ch] * historyW + sum[ch]) * norm;
+                    dstRow[x * 4 + ch] = static_cast<uint8_t>(out[ch] + 0.5f);
+                }
+                outWeight[index] = std::min(historyW + total, maxWeight);
+            }
+        }
+    };
+
+    if (m_pool)
+        m_pool->ParallelFor(bands, runBand);
+    else {
+        for (uint32_t band = 0; band < bands; band++)
+            runBand(band, 0);
+    }
+
+    m_current ^= 1;
+    m_historyValid = true;
+    return true;
+}
+
+}
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "JitterSequence.h"
+#include "SyntheticScene.h"
+#include "TemporalUpscaler.h"
+#include "TestImages.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    // Renders `frames` frames of scene with the Halton jitter for the
+    // srcW -> dst.Width() ratio and accumulates them into dst, returning the
+    // frame index the output corresponds to.
+    uint32_t RunSequence(const qisx::SyntheticScene& scene, qisx::TemporalUpscaler& upscaler,
+        uint32_t srcW, uint32_t srcH, uint32_t frames, bool motion, qisx::Image& dst)
+    {
+        qisx::Image color(srcW, srcH);
+        std::vector<float> vectors(size_t(srcW) * srcH * 2);
+        qisx::JitterSequence jitter(srcW, srcH, dst.Width());
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            const qisx::JitterSample sample = jitter.Next();
+            qisx::TemporalFrame input;
+            input.color = color.View();
+            input.jitterX = sample.x;
+            input.jitterY = sample.y;
+            input.motion = motion ? vectors.data() : nullptr;
+            scene.Render(frame, input.jitterX, input.jitterY, color.MutableView(), vectors.data());
+            EXPECT_TRUE(upscaler.Accumulate(input, dst.MutableView()));
+        }
+        return frames - 1;
+    }
+
+}
+
+TEST(TemporalUpscalerTests, FlatColourIsPreserved)
+{
+    qisx::Image src(37, 23);
+    for (size_t i = 0; i < src.SizeInBytes(); i += 4) {
+        src.Data()[i + 0] = 0;
+        src.Data()[i + 1] = 77;
+        src.Data()[i + 2] = 254;
+        src.Data()[i + 3] = 255;
+    }
+
+    qisx::Image dst(80, 51);
+    qisx::TemporalUpscaler upscaler;
+    qisx::JitterSequence jitter(37, 23, 80);
+    for (uint32_t frame = 0; frame < 4; frame++) {
+        const qisx::JitterSample sample = jitter.Next();
+        qisx::TemporalFrame input;
+        input.color = src.View();
+        input.jitterX = sample.x;
+        input.jitterY = sample.y;
+        ASSERT_TRUE(upscaler.Accumulate(input, dst.MutableView()));
+        for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+            ASSERT_EQ(dst.Data()[i + 0], 0) << "frame " << frame << " pixel " << i / 4;
+            ASSERT_EQ(dst.Data()[i + 1], 77) << "frame " << frame << " pixel " << i / 4;
+            ASSERT_EQ(dst.Data()[i + 2], 254) << "frame " << frame << " pixel " << i / 4;
+            ASSERT_EQ(dst.Data()[i + 3], 255) << "frame " << frame << " pixel " << i / 4;
+        }
+    }
+}
+
+TEST(TemporalUpscalerTests, RejectsBadViews)
+{
+    qisx::Image src(16, 16);
+    qisx::Image small(8, 8);
+    qisx::TemporalUpscaler upscaler;
+    qisx::TemporalFrame input;
+    EXPECT_FALSE(upscaler.Accumulate(input, small.MutableView()));
+    input.color = src.View();
+    EXPECT_FALSE(upscaler.Accumulate(input, small.MutableView()));
+}
+
+// A static scene at 2x: the accumulated frames resolve detail a single
+// low-res frame aliases, so the result beats a spatial upscale of the last frame.
+TEST(TemporalUpscalerTests, StaticSceneConverges)
+{
+    const qisx::SyntheticScene scene;
+    qisx::Image reference(192, 128);
+    scene.RenderReference(0, reference.MutableView());
+
+    qisx::Image spatial(192, 128);
+    qisx::Image lowRes(96, 64);
+    scene.Render(0, 0.0f, 0.0f, lowRes.MutableView(), nullptr);
+    ASSERT_TRUE(qisx::CpuUpscaler({ 0.0f, false, qisx::UpscalePath::Separable }).Upscale(lowRes.View(), spatial.MutableView()));
+
+    qisx::TemporalUpscaler upscaler;
+    qisx::Image first(192, 128), converged(192, 128);
+    RunSequence(scene, upscaler, 96, 64, 1, false, first);
+    upscaler.Reset();
+    RunSequence(scene, upscaler, 96, 64, 32, false, converged);
+
+    const double spatialError = qisx::test::MeanSquaredError(reference, spatial);
+    const double firstError = qisx::test::MeanSquaredError(reference, first);
+    const double temporalError = qisx::test::MeanSquaredError(reference, converged);
+    EXPECT_LT(temporalError, firstError * 0.25) << "first frame " << firstError << ", converged " << temporalError;
+    EXPECT_LT(temporalError, spatialError * 0.25) << "spatial " << spatialError << ", converged " << temporalError;
+}
+
+// A disc moving over the static background: reprojecting through the motion
+// vectors keeps its history, ignoring them smears it. Compared around the
+// disc's final position, which includes the trail it leaves.
+TEST(TemporalUpscalerTests, MotionVectorsTrackMovingObjects)
+{
+    qisx::SyntheticScene::Options options;
+    options.disc = true;
+    options.velocityX = 0.004f;
+    options.velocityY = 0.0015f;
+    const qisx::SyntheticScene scene(options);
+
+    qisx::Image withMotion(192, 128), withoutMotion(192, 128), reference(192, 128);
+    qisx::TemporalUpscaler upscaler;
+    const uint32_t last = RunSequence(scene, upscaler, 96, 64, 32, true, withMotion);
+    upscaler.Reset();
+    RunSequence(scene, upscaler, 96, 64, 32, false, withoutMotion);
+    scene.RenderReference(last, reference.MutableView());
+
+    // Disc bounds in output pixels at the last frame, widened by the distance
+    // travelled over the last eight frames
+    const float cx = options.discX + options.velocityX * last, cy = options.discY + options.velocityY * last;
+    const float rx = options.discRadius + options.velocityX * 8, ry = options.discRadius + options.velocityY * 8;
+    const uint32_t x0 = uint32_t((cx - rx) * 192), x1 = uint32_t((cx + options.discRadius) * 192) + 1;
+    const uint32_t y0 = uint32_t((cy - ry) * 128), y1 = uint32_t((cy + options.discRadius) * 128) + 1;
+
+    const double trackedError = qisx::test::MeanSquaredError(reference, withMotion, x0, y0, x1, y1);
+    const double staticError = qisx::test::MeanSquaredError(reference, withoutMotion, x0, y0, x1, y1);
+    EXPECT_LT(trackedError, staticError * 0.9) << "without motion " << staticError << ", with motion " << trackedError;
+}
+
+TEST(TemporalUpscalerTests, ThreadsMatchSingleThread)
+{
+    qisx::SyntheticScene::Options options;
+    options.disc = true;
+    options.velocityX = -0.01f;
+    const qisx::SyntheticScene scene(options);
+
+    qisx::Image expected(150, 97), actual(150, 97);
+    qisx::TemporalUpscaler single({ 16.0f, 1 });
+    qisx::TemporalUpscaler threaded({ 16.0f, 3, 7 });
+    RunSequence(scene, single, 64, 41, 6, true, expected);
+    RunSequence(scene, threaded, 64, 41, 6, true, actual);
+    EXPECT_EQ(memcmp(expected.Data(), actual.Data(), expected.SizeInBytes()), 0);
+}
+
+TEST(TemporalUpscalerTests, ResetDiscardsHistory)
+{
+    const qisx::SyntheticScene scene;
+    qisx::Image fresh(128, 96), reset(128, 96);
+
+    qisx::TemporalUpscaler a;
+    RunSequence(scene, a, 64, 48, 1, false, fresh);
+
+    // Accumulate a different image first, then a reset frame
+    qisx::TemporalUpscaler b;
+    qisx::Image other(64, 48);
+    std::memset(other.Data(), 90, other.SizeInBytes());
+    qisx::TemporalFrame input;
+    input.color = other.View();
+    ASSERT_TRUE(b.Accumulate(input, reset.MutableView()));
+
+    qisx::Image color(64, 48);
+    const qisx::JitterSample sample = qisx::JitterSequence(64, 48, 128).Get(0);
+    scene.Render(0, sample.x, sample.y, color.MutableView(), nullptr);
+    input = { color.View(), nullptr, sample.x, sample.y, true };
+    ASSERT_TRUE(b.Accumulate(input, reset.MutableView()));
+    EXPECT_EQ(memcmp(fresh.Data(), reset.Data(), fresh.SizeInBytes()), 0);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Image.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+// Image helpers shared by the unit tests.
+namespace qisx {
+namespace test {
+
+    // Fills every byte (alpha included) from a 32-bit LCG seeded with state.
+    inline void FillRandom(Image& image, uint32_t state)
+    {
+        for (size_t i = 0; i < image.SizeInBytes(); i++) {
+            state = state * 1664525u + 1013904223u;
+            image.Data()[i] = static_cast<uint8_t>(state >> 24);
+        }
+    }
+
+    inline Image RandomImage(uint32_t width, uint32_t height, uint32_t seed)
+    {
+        Image image(width, height);
+        FillRandom(image, seed);
+        return image;
+    }
+
+    // Largest per-byte difference, alpha included.
+    inline int MaxDifference(const Image& a, const Image& b)
+    {
+        int worst = 0;
+        for (size_t i = 0; i < a.SizeInBytes(); i++)
+            worst = std::max(worst, std::abs(int(a.Data()[i]) - int(b.Data()[i])));
+        return worst;
+    }
+
+    // Colour-channel MSE over columns [x0, x1) of rows [y0, y1); alpha is ignored.
+    inline double MeanSquaredError(const Image& a, const Image& b,
+        uint32_t x0 = 0, uint32_t y0 = 0, uint32_t x1 = ~0u, uint32_t y1 = ~0u)
+    {
+        x1 = std::min(x1, a.Width());
+        y1 = std::min(y1, a.Height());
+        double sum = 0.0;
+        for (uint32_t y = y0; y < y1; y++) {
+            for (uint32_t x = x0; x < x1; x++) {
+                for (size_t ch = 0; ch < 3; ch++) {
+                    const size_t i = y * a.RowPitch() + x * 4 + ch;
+                    const double d = double(a.Data()[i]) - double(b.Data()[i]);
+                    sum += d * d;
+                }
+            }
+        }
+        return sum / (double(x1 - x0) * double(y1 - y0) * 3.0);
+    }
+
+}
+}
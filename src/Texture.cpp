@@ -1,10 +1,149 @@
 #include "Texture.h"
+#include "ImageDecoder.h"
+#include "MappedFile.h"
+#include "MipGenerator.h"
 #include<WICTextureLoader.h>
+#include<algorithm>
+#include<filesystem>
 #include<string>
+#include<vector>
 #include<wincodec.h>
+#include<wrl/client.h>
 #pragma comment(lib, "DirectXTK.lib")
 
 
+namespace {
+
+	using Microsoft::WRL::ComPtr;
+
+	// Cached views are per device: the same file loaded on two devices is two textures
+	struct TextureKey {
+		ID3D11Device* device;
+		std::wstring path;
+		uint32_t loadFlags;
+
+		bool operator==(const TextureKey& other) const
+		{
+			return device == other.device && loadFlags == other.loadFlags && path == other.path;
+		}
+	};
+
+	struct TextureKeyHash {
+		size_t operator()(const TextureKey& key) const
+		{
+			size_t h = std::hash<std::wstring>()(key.path);
+			h ^= std::hash<const void*>()(key.device) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+			return h ^ (size_t(key.loadFlags) * 0x9E3779B97F4A7C15ull);
+		}
+	};
+
+	using TextureCache = qisx::LruCache<TextureKey, ComPtr<ID3D11ShaderResourceView>, TextureKeyHash>;
+
+	TextureCache& GetTextureCache()
+	{
+		static TextureCache cache(kDefaultTextureCacheBudget);
+		return cache;
+	}
+
+	size_t BitsPerPixel(DXGI_FORMAT format)
+	{
+		switch (format) {
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			return 128;
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+			return 64;
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_A8_UNORM:
+			return 8;
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+			return 16;
+		default:
+			return 32;  // RGBA8/BGRA8 variants, R10G10B10A2, R32_FLOAT
+		}
+	}
+
+	// Decoded size of the view's texture across all mips; what the budget counts
+	size_t TextureBytes(ID3D11ShaderResourceView* srv)
+	{
+		ComPtr<ID3D11Resource> resource;
+		srv->GetResource(resource.GetAddressOf());
+		ComPtr<ID3D11Texture2D> texture;
+		if (FAILED(resource.As(&texture)))
+			return 0;
+
+		D3D11_TEXTURE2D_DESC desc = {};
+		texture->GetDesc(&desc);
+		size_t bytes = 0;
+		for (UINT mip = 0; mip < desc.MipLevels; mip++) {
+			const size_t w = std::max<size_t>(1, desc.Width >> mip);
+			const size_t h = std::max<size_t>(1, desc.Height >> mip);
+			bytes += w * h * BitsPerPixel(desc.Format) / 8;
+		}
+		return bytes * desc.ArraySize;
+	}
+
+	// Decodes with the portable decoders from a mapping of the file (no copy of
+	// the file) into memory, then hands the pixels to one immutable
+	// CreateTexture2D. Only the device is touched, so this is safe off the render
+	// thread. With generateMips the chain is built on the CPU (gamma-correct when
+	// forceSRGB) and uploaded with the base level.
+	HRESULT CreatePortableTextureFromFile(ID3D11Device* device, const wchar_t* filename, bool forceSRGB,
+		bool generateMips, ID3D11ShaderResourceView** textureSRV)
+	{
+		qisx::MappedFile file;
+		if (!file.Open(std::wstring(filename)))
+			return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+		const uint8_t* data = file.Data();
+		const size_t size = file.Size();
+
+		const qisx::ImageDecoder* decoder = qisx::FindImageDecoder(data, size);
+		qisx::ImageInfo info;
+		if (!decoder || !decoder->ReadInfo(data, size, info, nullptr))
+			return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+		if (info.width > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || info.height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+			return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+		qisx::Image base(info.width, info.height);
+		if (!decoder->Decode(data, size, base.MutableView(), nullptr))
+			return E_FAIL;
+
+		std::vector<qisx::Image> mips;
+		if (generateMips) {
+			qisx::MipGenerator::Options mipOptions;
+			mipOptions.srgb = forceSRGB;
+			if (!qisx::MipGenerator(mipOptions).Generate(base.View(), mips))
+				return E_FAIL;
+		}
+
+		std::vector<D3D11_SUBRESOURCE_DATA> levels;
+		levels.push_back({ base.Data(), UINT(base.RowPitch()), 0 });
+		for (const qisx::Image& mip : mips)
+			levels.push_back({ mip.Data(), UINT(mip.RowPitch()), 0 });
+
+		D3D11_TEXTURE2D_DESC desc = {};
+		desc.Width = info.width;
+		desc.Height = info.height;
+		desc.MipLevels = UINT(levels.size());
+		desc.ArraySize = 1;
+		desc.Format = forceSRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc.SampleDesc.Count = 1;
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		ComPtr<ID3D11Texture2D> texture;
+		HRESULT hr = device->CreateTexture2D(&desc, levels.data(), texture.GetAddressOf());
+		if (SUCCEEDED(hr))
+			hr = device->CreateShaderResourceView(texture.Get(), nullptr, textureSRV);
+		return hr;
+	}
+
+}
+
+
 
 void ReleaseTexture(ID3D11ShaderResourceView*& textureSRV)
 {
@@ -14,33 +153,110 @@ void ReleaseTexture(ID3D11ShaderResourceView*& textureSRV)
 	}
 }
 
-ID3D11ShaderResourceView* LoadTextureFromFile(ID3D11Device* device, const wchar_t* filename, bool forceReload)
+ID3D11ShaderResourceView* LoadTextureFromFile(ID3D11Device* device, const wchar_t* filename, bool forceReload,
+	DirectX::WIC_LOADER_FLAGS loadFlags)
 {
+	const TextureKey key{ device, filename, loadFlags };
+	TextureCache& cache = GetTextureCache();
 
-	static std::wstring lastLoadedFile;
-	static ID3D11ShaderResourceView* cachedSRV = nullptr;
-
+	ComPtr<ID3D11ShaderResourceView> srv;
+	if (forceReload)
+		cache.Erase(key);
+	else if (cache.Find(key, srv))
+		return srv.Detach();
 
-	if (forceReload || filename != lastLoadedFile) {
-		ReleaseTexture(cachedSRV);
-		lastLoadedFile = filename;
-	}
-
-
-	if (!cachedSRV) {
-		HRESULT hr = DirectX::CreateWICTextureFromFile(
+	// Loaded outside the cache lock, so other threads' lookups never wait on disk
+	HRESULT hr = E_FAIL;
+	if ((loadFlags & ~(DirectX::WIC_LOADER_FORCE_SRGB | DirectX::WIC_LOADER_MIP_AUTOGEN)) == 0)
+		hr = CreatePortableTextureFromFile(device, filename, (loadFlags & DirectX::WIC_LOADER_FORCE_SRGB) != 0,
+			(loadFlags & DirectX::WIC_LOADER_MIP_AUTOGEN) != 0, srv.ReleaseAndGetAddressOf());
+	if (FAILED(hr)) {
+		// Formats without a portable decoder (BMP, TIFF, ...) and other loader flags still go through WIC
+		hr = DirectX::CreateWICTextureFromFileEx(
 			device,
 			filename,
+			0,
+			D3D11_USAGE_DEFAULT,
+			D3D11_BIND_SHADER_RESOURCE,
+			0,
+			0,
+			loadFlags,
 			nullptr,
-			&cachedSRV
+			srv.ReleaseAndGetAddressOf()
 		);
-		if (FAILED(hr)) {
-			OutputDebugString(L"Failed to load Texture Error Code : ");
-			OutputDebugString(std::to_wstring(hr).c_str());
-		}
+	}
+	if (FAILED(hr)) {
+		OutputDebugString(L"Failed to load Texture Error Code : ");
+		OutputDebugString(std::to_wstring(hr).c_str());
+		return nullptr;
 	}
 
-	return cachedSRV;
+	cache.Insert(key, srv, TextureBytes(srv.Get()));
+	return srv.Detach();
 }
 
+qisx::AsyncLoadHandle LoadTextureAsync(qisx::AsyncImageLoader& loader, ID3D11Device* device, const wchar_t* filename,
+	std::function<void(ID3D11ShaderResourceView* textureSRV)> done, bool forceSRGB)
+{
+	struct Target {
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		ComPtr<ID3D11Texture2D> texture;
+		TextureKey key;
+	};
+	auto target = std::make_shared<Target>();
+	target->device = device;
+	device->GetImmediateContext(target->context.GetAddressOf());
+	target->key = { device, filename, uint32_t(forceSRGB ? DirectX::WIC_LOADER_FORCE_SRGB : DirectX::WIC_LOADER_DEFAULT) };
 
+	qisx::AsyncLoadCallbacks callbacks;
+	callbacks.begin = [target, forceSRGB](uint32_t width, uint32_t height) {
+		if (width > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || height > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+			return false;
+		D3D11_TEXTURE2D_DESC desc = {};
+		desc.Width = width;
+		desc.Height = height;
+		desc.MipLevels = 1;
+		desc.ArraySize = 1;
+		desc.Format = forceSRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc.SampleDesc.Count = 1;
+		desc.Usage = D3D11_USAGE_DEFAULT;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		return SUCCEEDED(target->device->CreateTexture2D(&desc, nullptr, target->texture.GetAddressOf()));
+	};
+	callbacks.upload = [target](const qisx::ImageView& band, uint32_t firstRow) {
+		const D3D11_BOX box = { 0, firstRow, 0, band.width, firstRow + band.height, 1 };
+		target->context->UpdateSubresource(target->texture.Get(), 0, &box, band.data, UINT(band.rowPitch), 0);
+		return true;
+	};
+	callbacks.complete = [target, done](qisx::AsyncLoadStatus status, const std::string& error, qisx::Image&) {
+		ComPtr<ID3D11ShaderResourceView> srv;
+		if (status == qisx::AsyncLoadStatus::Complete)
+			target->device->CreateShaderResourceView(target->texture.Get(), nullptr, srv.GetAddressOf());
+		if (srv)
+			GetTextureCache().Insert(target->key, srv, TextureBytes(srv.Get()));
+		else {
+			OutputDebugStringA("Failed to load Texture asynchronously : ");
+			OutputDebugStringA(error.c_str());
+			OutputDebugStringA("\n");
+		}
+		if (done)
+			done(srv.Detach());
+	};
+	return loader.Load(std::filesystem::path(filename), std::move(callbacks));
+}
+
+void SetTextureCacheBudget(size_t bytes)
+{
+	GetTextureCache().SetBudget(bytes);
+}
+
+void ClearTextureCache()
+{
+	GetTextureCache().Clear();
+}
+
+qisx::LruCacheStats GetTextureCacheStats()
+{
+	return GetTextureCache().GetStats();
+}
@@ -0,0 +1,210 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <set>
+#include <utility>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+namespace qisx {
+
+unsigned PhysicalCoreCount()
+{
+    static const unsigned count = [] {
+        const unsigned logical = std::max(1u, std::thread::hardware_concurrency());
+#if defined(_WIN32)
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (info.empty() || !GetLogicalProcessorInformation(info.data(), &length))
+            return logical;
+
+        unsigned cores = 0;
+        for (const auto& entry : info) {
+            if (entry.Relationship == RelationProcessorCore)
+                cores++;
+        }
+        return cores ? cores : logical;
+#else
+        // Unique (package, core) pairs from sysfs
+        std::set<std::pair<int, int>> cores;
+        for (unsigned cpu = 0; cpu < logical; cpu++) {
+            char path[128];
+            int package = 0;
+            int core = 0;
+
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+            FILE* f = fopen(path, "r");
+            if (!f)
+                return logical;
+            const bool havePackage = fscanf(f, "%d", &package) == 1;
+            fclose(f);
+
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+            f = fopen(path, "r");
+            if (!f)
+                return logical;
+            const bool haveCore = fscanf(f, "%d", &core) == 1;
+            fclose(f);
+
+            if (!havePackage || !haveCore)
+                return logical;
+            cores.insert({ package, core });
+        }
+        return cores.empty() ? logical : unsigned(cores.size());
+#endif
+    }();
+    return count;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+    : m_threadCount(std::max(1u, threadCount ? threadCount : PhysicalCoreCount()))
+{
+    for (unsigned i = 0; i < m_threadCount; i++)
+        m_queues.push_back(std::make_unique<WorkQueue>());
+
+    // The last slot belongs to whichever thread calls ParallelFor
+    for (unsigned slot = 0; slot + 1 < m_threadCount; slot++)
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, slot);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::Push(unsigned queue, Task&& task)
+{
+    WorkQueue& q = *m_queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.push_back(std::move(task));
+    m_queued.fetch_add(1);
+}
+
+bool ThreadPool::TryRunOne(unsigned slot, bool rangeTasksOnly)
+{
+    for (unsigned k = 0; k < m_threadCount; k++) {
+        WorkQueue& q = *m_queues[(slot + k) % m_threadCount];
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty())
+                continue;
+
+            // Own queue: oldest first (sequential locality). Victims: steal the newest.
+            auto it = (k == 0) ? q.tasks.begin() : std::prev(q.tasks.end());
+            if (rangeTasksOnly && k != 0) {
+                // ParallelFor callers skip over Submit() tasks to the newest range task
+                auto rit = std::find_if(q.tasks.rbegin(), q.tasks.rend(), [](const Task& t) { return t.body != nullptr; });
+                if (rit == q.tasks.rend())
+                    continue;
+                it = std::prev(rit.base());
+            }
+
+            task = std::move(*it);
+            q.tasks.erase(it);
+            m_queued.fetch_sub(1);
+            if (task.body)
+                m_queuedRange.fetch_sub(1);
+        }
+        Run(task, slot);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::Run(Task& task, unsigned slot)
+{
+    if (task.body) {
+        (*task.body)(task.index, slot);
+        if (task.remaining->fetch_sub(1) == 1) {
+            { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+            m_done.notify_all();
+        }
+    }
+    else {
+        task.fn(slot);
+    }
+}
+
+void ThreadPool::WorkerLoop(unsigned slot)
+{
+    for (;;) {
+        if (TryRunOne(slot, false))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() == 0)
+            return;
+    }
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t index, unsigned slot)>& body)
+{
+    if (count == 0)
+        return;
+
+    std::lock_guard<std::mutex> serialise(m_parallelForMutex);
+    const unsigned callerSlot = m_threadCount - 1;
+
+    if (m_workers.empty()) {
+        for (uint32_t i = 0; i < count; i++)
+            body(i, callerSlot);
+        return;
+    }
+
+    std::atomic<uint32_t> remaining{ count };
+
+    // Contiguous blocks per participant
+    m_queuedRange.fetch_add(count);
+    for (unsigned q = 0; q < m_threadCount; q++) {
+        const uint32_t begin = uint32_t(uint64_t(count) * q / m_threadCount);
+        const uint32_t end = uint32_t(uint64_t(count) * (q + 1) / m_threadCount);
+        for (uint32_t i = begin; i < end; i++) {
+            Task task;
+            task.body = &body;
+            task.index = i;
+            task.remaining = &remaining;
+            Push(q, std::move(task));
+        }
+    }
+    { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+    m_wake.notify_all();
+
+    // Help out until every index has run; never pick up Submit() tasks here
+    while (remaining.load() > 0) {
+        if (TryRunOne(callerSlot, true))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_done.wait(lock, [&] { return remaining.load() == 0 || m_queuedRange.load() > 0; });
+    }
+}
+
+void ThreadPool::Submit(std::function<void(unsigned slot)> task)
+{
+    if (m_workers.empty()) {
+        task(0);
+        return;
+    }
+
+    Task t;
+    t.fn = std::move(task);
+    Push(m_nextSubmit.fetch_add(1) % unsigned(m_workers.size()), std::move(t));
+
+    { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+    m_wake.notify_one();
+}
+
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+TEST(ThreadPoolTests, ParallelForRunsEveryIndexOnce)
+{
+    for (unsigned threads : { 1u, 2u, 5u }) {
+        qisx::ThreadPool pool(threads);
+        std::vector<std::atomic<int>> hits(1000);
+        pool.ParallelFor(1000, [&](uint32_t index, unsigned slot) {
+            EXPECT_LT(slot, pool.GetThreadCount());
+            hits[index].fetch_add(1);
+        });
+
+        for (size_t i = 0; i < hits.size(); i++)
+            ASSERT_EQ(hits[i].load(), 1) << "index " << i << " threads " << threads;
+    }
+}
+
+// Slots index per-thread scratch, so two running tasks must never share one.
+TEST(ThreadPoolTests, SlotsAreExclusiveWhileRunning)
+{
+    qisx::ThreadPool pool(4);
+    std::vector<std::atomic<int>> busy(pool.GetThreadCount());
+    std::atomic<int> collisions{ 0 };
+
+    pool.ParallelFor(400, [&](uint32_t, unsigned slot) {
+        if (busy[slot].fetch_add(1) != 0)
+            collisions++;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        busy[slot].fetch_sub(1);
+    });
+
+    EXPECT_EQ(collisions.load(), 0);
+}
+
+TEST(ThreadPoolTests, SubmitRunsOnWorkers)
+{
+    std::atomic<int> done{ 0 };
+    {
+        qisx::ThreadPool pool(3);
+        for (int i = 0; i < 50; i++)
+            pool.Submit([&](unsigned) { done++; });
+
+        // ParallelFor must still complete while Submit() work is queued
+        std::atomic<int> ranged{ 0 };
+        pool.ParallelFor(64, [&](uint32_t, unsigned) { ranged++; });
+        EXPECT_EQ(ranged.load(), 64);
+    }
+    // Destruction drains the queues
+    EXPECT_EQ(done.load(), 50);
+}
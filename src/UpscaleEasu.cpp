@@ -0,0 +1,495 @@
+#include "UpscaleEasu.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+// The SIMD kernels use the 4-lane structure of the footprint: the four
+// analysis texels f, g, j, k, the 12 taps as three groups and RGBA
+// accumulation. Every reduction runs in the same order as the scalar kernel
+// and there is no reciprocal estimate, so all ISAs produce identical output
+// on targets without FMA contraction.
+
+namespace qisx {
+
+namespace {
+
+    // Tap offsets from f in the order b c e f | g h i j | k l n o.
+    const float kTapX[kEasuTaps] = { 0, 1, -1, 0, 1, 2, -1, 0, 1, 2, 0, 1 };
+    const float kTapY[kEasuTaps] = { -1, -1, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2 };
+
+    // Lower bound on the local contrast a gradient is divided by.
+    constexpr float kMinContrast = 1.0f / 32768.0f;
+
+    // Kernel shape for one output pixel from the summed edge analysis.
+    struct EasuShape {
+        float dirX, dirY;       // Unit edge direction
+        float len2X, len2Y;     // Kernel scale along and across the edge
+        float lobe;             // Negative lobe strength
+        float clip;             // Largest squared distance evaluated
+    };
+
+    inline EasuShape ShapeFromAnalysis(float dirX, float dirY, float len)
+    {
+        EasuShape shape;
+        const float dirR = dirX * dirX + dirY * dirY;
+        if (dirR < 1.0f / 32768.0f) {
+            shape.dirX = 1.0f;
+            shape.dirY = 0.0f;
+        }
+        else {
+            const float inv = 1.0f / std::sqrt(dirR);
+            shape.dirX = dirX * inv;
+            shape.dirY = dirY * inv;
+        }
+
+        // len sums two 0..1 terms per axis: map to 0..1 and shape it
+        len = len * 0.5f;
+        len *= len;
+
+        // 1 for axis-aligned edges, sqrt(2) for diagonals
+        const float stretch = 1.0f / std::max(std::abs(shape.dirX), std::abs(shape.dirY));
+        shape.len2X = 1.0f + (stretch - 1.0f) * len;
+        shape.len2Y = 1.0f - 0.5f * len;
+        shape.lobe = 0.5f + ((1.0f / 4.0f - 0.04f) - 0.5f) * len;
+        shape.clip = 1.0f / shape.lobe;
+        return shape;
+    }
+
+    inline float Sum4(const float v[4])
+    {
+        return (v[0] + v[1]) + (v[2] + v[3]);
+    }
+
+}
+
+void BuildEasuAxis(uint32_t srcSize, uint32_t dstSize, EasuAxis& axis)
+{
+    if (axis.srcSize == srcSize && axis.dstSize == dstSize)
+        return;
+
+    axis.srcSize = srcSize;
+    axis.dstSize = dstSize;
+    axis.index.resize(size_t(dstSize) * 4);
+    axis.frac.resize(dstSize);
+
+    const int maxIndex = int(srcSize) - 1;
+    for (uint32_t o = 0; o < dstSize; o++) {
+        // Same expression as BuildAxisFilter
+        const float pos = ((o + 0.5f) / dstSize) * srcSize - 0.5f;
+        const float base = std::floor(pos);
+        axis.frac[o] = pos - base;
+        for (int t = 0; t < 4; t++)
+            axis.index[size_t(o) * 4 + t] = std::clamp(int(base) + t - 1, 0, maxIndex);
+    }
+}
+
+void EasuLumaRow(const uint8_t* srcRow, uint32_t width, float* out)
+{
+    for (uint32_t x = 0; x < width; x++, srcRow += 4)
+        out[x] = (0.5f * srcRow[0] + srcRow[1] + 0.5f * srcRow[2]) * (1.0f / 510.0f);
+}
+
+void EasuRowScalar(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst)
+{
+    const float fy = rows.fracY;
+    for (uint32_t x = x0; x < x1; x++, dst += 4) {
+        const int32_t* cols = axisX.Index(x);
+        const float fx = axisX.frac[x];
+
+        // Luma of the 4x4 block around f; the corners are never used
+        float q[4][4];
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++)
+                q[r][c] = rows.luma[r][cols[c]];
+        }
+
+        // Edge analysis at f, g, j, k, weighted by the bilinear weights of p
+        const float up[4] = { q[0][1], q[0][2], q[1][1], q[1][2] };
+        const float left[4] = { q[1][0], q[1][1], q[2][0], q[2][1] };
+        const float centre[4] = { q[1][1], q[1][2], q[2][1], q[2][2] };
+        const float right[4] = { q[1][2], q[1][3], q[2][2], q[2][3] };
+        const float down[4] = { q[2][1], q[2][2], q[3][1], q[3][2] };
+        const float wx[4] = { 1.0f - fx, fx, 1.0f - fx, fx };
+        const float wy[4] = { 1.0f - fy, 1.0f - fy, fy, fy };
+
+        float dirX[4], dirY[4], len[4];
+        for (int i = 0; i < 4; i++) {
+            const float w = wx[i] * wy[i];
+            const float dx = right[i] - left[i];
+            const float ex = std::max(std::abs(right[i] - centre[i]), std::abs(centre[i] - left[i]));
+            float lx = std::min(std::abs(dx) / std::max(ex, kMinContrast), 1.0f);
+            lx *= lx;
+            const float dy = down[i] - up[i];
+            const float ey = std::max(std::abs(down[i] - centre[i]), std::abs(centre[i] - up[i]));
+            float ly = std::min(std::abs(dy) / std::max(ey, kMinContrast), 1.0f);
+            ly *= ly;
+            dirX[i] = dx * w;
+            dirY[i] = dy * w;
+            len[i] = (lx + ly) * w;
+        }
+        const EasuShape shape = ShapeFromAnalysis(Sum4(dirX), Sum4(dirY), Sum4(len));
+
+        float weight[kEasuTaps];
+        for (int t = 0; t < kEasuTaps; t++) {
+            const float offX = kTapX[t] - fx;
+            const float offY = kTapY[t] - fy;
+            const float vx = (offX * shape.dirX + offY * shape.dirY) * shape.len2X;
+            const float vy = (offY * shape.dirX - offX * shape.dirY) * shape.len2Y;
+            const float d2 = std::min(vx * vx + vy * vy, shape.clip);
+            float wB = 0.4f * d2 - 1.0f;
+            float wA = shape.lobe * d2 - 1.0f;
+            wB *= wB;
+            wA *= wA;
+            wB = 1.5625f * wB - 0.5625f;
+            weight[t] = wB * wA;
+        }
+
+        float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int t = 0; t < kEasuTaps; t++) {
+            const uint8_t* p = rows.color[int(kTapY[t]) + 1] + size_t(cols[int(kTapX[t]) + 1]) * 4;
+            for (int c = 0; c < 4; c++)
+                acc[c] += p[c] * weight[t];
+        }
+        const float lanes[4] = {
+            (weight[0] + weight[4]) + weight[8], (weight[1] + weight[5]) + weight[9],
+            (weight[2] + weight[6]) + weight[10], (weight[3] + weight[7]) + weight[11],
+        };
+        const float total = Sum4(lanes);
+
+        // Dering: stay within the range of the four nearest texels
+        const uint8_t* f = rows.color[1] + size_t(cols[1]) * 4;
+        const uint8_t* g = rows.color[1] + size_t(cols[2]) * 4;
+        const uint8_t* j = rows.color[2] + size_t(cols[1]) * 4;
+        const uint8_t* k = rows.color[2] + size_t(cols[2]) * 4;
+        for (int c = 0; c < 4; c++) {
+            const float lo = float(std::min(std::min(f[c], g[c]), std::min(j[c], k[c])));
+            const float hi = float(std::max(std::max(f[c], g[c]), std::max(j[c], k[c])));
+            const float v = std::clamp(acc[c] / total, lo, hi);
+            dst[c] = static_cast<uint8_t>(v + 0.5f);
+        }
+    }
+}
+
+#if defined(QISX_ARCH_X86)
+
+namespace {
+
+    QISX_TARGET("sse4.1")
+    inline __m128 LoadPixelSSE41(const uint8_t* row, int32_t index)
+    {
+        int32_t bits;
+        memcpy(&bits, row + size_t(index) * 4, sizeof(bits));
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bits)));
+    }
+
+    // Luma at the four footprint columns; one load away from the image edges.
+    QISX_TARGET("sse4.1")
+    inline __m128 LoadLumaSSE41(const float* row, const int32_t* cols)
+    {
+        if (cols[3] - cols[0] == 3)
+            return _mm_loadu_ps(row + cols[0]);
+        return _mm_setr_ps(row[cols[0]], row[cols[1]], row[cols[2]], row[cols[3]]);
+    }
+
+    QISX_TARGET("sse4.1")
+    inline __m128 AbsSSE41(__m128 v)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+
+    // Squared, saturated gradient-to-contrast ratio of one axis
+    QISX_TARGET("sse4.1")
+    inline __m128 EdgeLengthSSE41(__m128 before, __m128 centre, __m128 after)
+    {
+        const __m128 contrast = _mm_max_ps(AbsSSE41(_mm_sub_ps(after, centre)), AbsSSE41(_mm_sub_ps(centre, before)));
+        const __m128 ratio = _mm_min_ps(_mm_div_ps(AbsSSE41(_mm_sub_ps(after, before)),
+            _mm_max_ps(contrast, _mm_set1_ps(kMinContrast))), _mm_set1_ps(1.0f));
+        return _mm_mul_ps(ratio, ratio);
+    }
+
+    // Edge analysis of one of f, g, j, k for four pixels
+    struct EdgeSSE41 {
+        __m128 dirX, dirY, len;
+    };
+
+    QISX_TARGET("sse4.1")
+    inline EdgeSSE41 AnalyseSSE41(__m128 up, __m128 left, __m128 centre, __m128 right, __m128 down, __m128 w)
+    {
+        const __m128 len = _mm_add_ps(EdgeLengthSSE41(left, centre, right), EdgeLengthSSE41(up, centre, down));
+        return { _mm_mul_ps(_mm_sub_ps(right, left), w), _mm_mul_ps(_mm_sub_ps(down, up), w), _mm_mul_ps(len, w) };
+    }
+
+    template <int Lane>
+    QISX_TARGET("sse4.1")
+    inline __m128 Broadcast(__m128 v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+    }
+
+    // Weighted sum of the 12 taps of one pixel (w0..w2 hold its weights in
+    // tap order), normalised, deringed and stored as RGBA8
+    QISX_TARGET("sse4.1")
+    inline void ResolvePixelSSE41(const EasuRows& rows, const int32_t* cols, __m128 w0, __m128 w1, __m128 w2,
+        float total, uint8_t* dst)
+    {
+        const __m128 f = LoadPixelSSE41(rows.color[1], cols[1]);
+        const __m128 g = LoadPixelSSE41(rows.color[1], cols[2]);
+        const __m128 j = LoadPixelSSE41(rows.color[2], cols[1]);
+        const __m128 k = LoadPixelSSE41(rows.color[2], cols[2]);
+
+        __m128 acc = _mm_mul_ps(LoadPixelSSE41(rows.color[0], cols[1]), Broadcast<0>(w0));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[0], cols[2]), Broadcast<1>(w0)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[1], cols[0]), Broadcast<2>(w0)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(f, Broadcast<3>(w0)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(g, Broadcast<0>(w1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[1], cols[3]), Broadcast<1>(w1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[2], cols[0]), Broadcast<2>(w1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(j, Broadcast<3>(w1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(k, Broadcast<0>(w2)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[2], cols[3]), Broadcast<1>(w2)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[3], cols[1]), Broadcast<2>(w2)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(LoadPixelSSE41(rows.color[3], cols[2]), Broadcast<3>(w2)));
+
+        const __m128 lo = _mm_min_ps(_mm_min_ps(f, g), _mm_min_ps(j, k));
+        const __m128 hi = _mm_max_ps(_mm_max_ps(f, g), _mm_max_ps(j, k));
+        const __m128 v = _mm_min_ps(_mm_max_ps(_mm_div_ps(acc, _mm_set1_ps(total)), lo), hi);
+
+        const __m128i bytes = _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+        const int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packus_epi32(bytes, bytes), bytes));
+        memcpy(dst, &packed, sizeof(packed));
+    }
+
+}
+
+// Four output pixels per iteration, one per lane, from the analysis through
+// the tap weights; the weights are then transposed so each pixel accumulates
+// its RGBA as one vector. Columns left over at the end run the scalar kernel,
+// which computes the same values.
+QISX_TARGET("sse4.1")
+void EasuRowSSE41(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst)
+{
+    const float fyScalar = rows.fracY;
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 fy = _mm_set1_ps(fyScalar);
+    const __m128 wyTop = _mm_set1_ps(1.0f - fyScalar);
+
+    uint32_t x = x0;
+    for (; x + 4 <= x1; x += 4, dst += 16) {
+        const int32_t* cols = axisX.Index(x);
+        const __m128 fx = _mm_loadu_ps(&axisX.frac[x]);
+
+        // q[r][c]: luma at footprint row r, column c of each of the four pixels
+        __m128 q[4][4];
+        for (int r = 0; r < 4; r++) {
+            q[r][0] = LoadLumaSSE41(rows.luma[r], cols);
+            q[r][1] = LoadLumaSSE41(rows.luma[r], cols + 4);
+            q[r][2] = LoadLumaSSE41(rows.luma[r], cols + 8);
+            q[r][3] = LoadLumaSSE41(rows.luma[r], cols + 12);
+            _MM_TRANSPOSE4_PS(q[r][0], q[r][1], q[r][2], q[r][3]);
+        }
+
+        const __m128 wxLeft = _mm_sub_ps(one, fx);
+        const EdgeSSE41 ef = AnalyseSSE41(q[0][1], q[1][0], q[1][1], q[1][2], q[2][1], _mm_mul_ps(wxLeft, wyTop));
+        const EdgeSSE41 eg = AnalyseSSE41(q[0][2], q[1][1], q[1][2], q[1][3], q[2][2], _mm_mul_ps(fx, wyTop));
+        const EdgeSSE41 ej = AnalyseSSE41(q[1][1], q[2][0], q[2][1], q[2][2], q[3][1], _mm_mul_ps(wxLeft, fy));
+        const EdgeSSE41 ek = AnalyseSSE41(q[1][2], q[2][1], q[2][2], q[2][3], q[3][2], _mm_mul_ps(fx, fy));
+        __m128 dirX = _mm_add_ps(_mm_add_ps(ef.dirX, eg.dirX), _mm_add_ps(ej.dirX, ek.dirX));
+        __m128 dirY = _mm_add_ps(_mm_add_ps(ef.dirY, eg.dirY), _mm_add_ps(ej.dirY, ek.dirY));
+        __m128 len = _mm_add_ps(_mm_add_ps(ef.len, eg.len), _mm_add_ps(ej.len, ek.len));
+
+        // ShapeFromAnalysis, four pixels at a time
+        const __m128 dirR = _mm_add_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY));
+        const __m128 flat = _mm_cmplt_ps(dirR, _mm_set1_ps(1.0f / 32768.0f));
+        const __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(dirR));
+        dirX = _mm_blendv_ps(_mm_mul_ps(dirX, inv), one, flat);
+        dirY = _mm_blendv_ps(_mm_mul_ps(dirY, inv), _mm_setzero_ps(), flat);
+        len = _mm_mul_ps(len, _mm_set1_ps(0.5f));
+        len = _mm_mul_ps(len, len);
+        const __m128 stretch = _mm_div_ps(one, _mm_max_ps(AbsSSE41(dirX), AbsSSE41(dirY)));
+        const __m128 len2X = _mm_add_ps(one, _mm_mul_ps(_mm_sub_ps(stretch, one), len));
+        const __m128 len2Y = _mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(0.5f), len));
+        const __m128 lobe = _mm_add_ps(_mm_set1_ps(0.5f), _mm_mul_ps(_mm_set1_ps((1.0f / 4.0f - 0.04f) - 0.5f), len));
+        const __m128 clip = _mm_div_ps(one, lobe);
+
+        __m128 weight[kEasuTaps];
+        for (int t = 0; t < kEasuTaps; t++) {
+            const __m128 offX = _mm_sub_ps(_mm_set1_ps(kTapX[t]), fx);
+            const __m128 offY = _mm_set1_ps(kTapY[t] - fyScalar);
+            const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(offX, dirX), _mm_mul_ps(offY, dirY)), len2X);
+            const __m128 vy = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(offY, dirX), _mm_mul_ps(offX, dirY)), len2Y);
+            const __m128 d2 = _mm_min_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), clip);
+            __m128 wB = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(0.4f), d2), one);
+            __m128 wA = _mm_sub_ps(_mm_mul_ps(lobe, d2), one);
+            wB = _mm_mul_ps(wB, wB);
+            wA = _mm_mul_ps(wA, wA);
+            wB = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.5625f), wB), _mm_set1_ps(0.5625f));
+            weight[t] = _mm_mul_ps(wB, wA);
+        }
+
+        const __m128 lanes0 = _mm_add_ps(_mm_add_ps(weight[0], weight[4]), weight[8]);
+        const __m128 lanes1 = _mm_add_ps(_mm_add_ps(weight[1], weight[5]), weight[9]);
+        const __m128 lanes2 = _mm_add_ps(_mm_add_ps(weight[2], weight[6]), weight[10]);
+        const __m128 lanes3 = _mm_add_ps(_mm_add_ps(weight[3], weight[7]), weight[11]);
+        alignas(16) float total[4];
+        _mm_store_ps(total, _mm_add_ps(_mm_add_ps(lanes0, lanes1), _mm_add_ps(lanes2, lanes3)));
+
+        // weight[g * 4 + p] now holds taps 4g .. 4g+3 of pixel p
+        _MM_TRANSPOSE4_PS(weight[0], weight[1], weight[2], weight[3]);
+        _MM_TRANSPOSE4_PS(weight[4], weight[5], weight[6], weight[7]);
+        _MM_TRANSPOSE4_PS(weight[8], weight[9], weight[10], weight[11]);
+        for (int p = 0; p < 4; p++)
+            ResolvePixelSSE41(rows, cols + p * 4, weight[p], weight[4 + p], weight[8 + p], total[p], dst + p * 4);
+    }
+
+    if (x < x1)
+        EasuRowScalar(rows, axisX, x, x1, dst);
+}
+
+#elif defined(QISX_ARCH_ARM64)
+
+namespace {
+
+    inline float32x4_t LoadPixelNEON(const uint8_t* row, int32_t index)
+    {
+        uint32_t bits;
+        memcpy(&bits, row + size_t(index) * 4, sizeof(bits));
+        return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bits))))));
+    }
+
+    inline float32x4_t LoadLumaNEON(const float* row, const int32_t* cols)
+    {
+        if (cols[3] - cols[0] == 3)
+            return vld1q_f32(row + cols[0]);
+        const float lanes[4] = { row[cols[0]], row[cols[1]], row[cols[2]], row[cols[3]] };
+        return vld1q_f32(lanes);
+    }
+
+    // Lanes 1, 2 of a and 1, 2 of b
+    inline float32x4_t Middles(float32x4_t a, float32x4_t b)
+    {
+        return vcombine_f32(vget_low_f32(vextq_f32(a, a, 1)), vget_low_f32(vextq_f32(b, b, 1)));
+    }
+
+    inline float Sum4NEON(float32x4_t v)
+    {
+        return (vgetq_lane_f32(v, 0) + vgetq_lane_f32(v, 1)) + (vgetq_lane_f32(v, 2) + vgetq_lane_f32(v, 3));
+    }
+
+    inline float32x4_t EdgeLengthNEON(float32x4_t before, float32x4_t centre, float32x4_t after)
+    {
+        const float32x4_t contrast = vmaxq_f32(vabdq_f32(after, centre), vabdq_f32(centre, before));
+        const float32x4_t ratio = vminq_f32(vdivq_f32(vabdq_f32(after, before),
+            vmaxq_f32(contrast, vdupq_n_f32(kMinContrast))), vdupq_n_f32(1.0f));
+        return vmulq_f32(ratio, ratio);
+    }
+
+    inline float32x4_t TapWeightsNEON(const EasuShape& shape, int group, float32x4_t fx, float32x4_t fy)
+    {
+        const float32x4_t offX = vsubq_f32(vld1q_f32(kTapX + group * 4), fx);
+        const float32x4_t offY = vsubq_f32(vld1q_f32(kTapY + group * 4), fy);
+        const float32x4_t vx = vmulq_n_f32(vaddq_f32(vmulq_n_f32(offX, shape.dirX), vmulq_n_f32(offY, shape.dirY)), shape.len2X);
+        const float32x4_t vy = vmulq_n_f32(vsubq_f32(vmulq_n_f32(offY, shape.dirX), vmulq_n_f32(offX, shape.dirY)), shape.len2Y);
+        const float32x4_t d2 = vminq_f32(vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)), vdupq_n_f32(shape.clip));
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        float32x4_t wB = vsubq_f32(vmulq_n_f32(d2, 0.4f), one);
+        float32x4_t wA = vsubq_f32(vmulq_n_f32(d2, shape.lobe), one);
+        wB = vmulq_f32(wB, wB);
+        wA = vmulq_f32(wA, wA);
+        wB = vsubq_f32(vmulq_n_f32(wB, 1.5625f), vdupq_n_f32(0.5625f));
+        return vmulq_f32(wB, wA);
+    }
+
+}
+
+void EasuRowNEON(const EasuRows& rows, const EasuAxis& axisX, uint32_t x0, uint32_t x1, uint8_t* dst)
+{
+    const float fyScalar = rows.fracY;
+    const float32x4_t fy = vdupq_n_f32(fyScalar);
+    const float wyLanes[4] = { 1.0f - fyScalar, 1.0f - fyScalar, fyScalar, fyScalar };
+    const float32x4_t wy = vld1q_f32(wyLanes);
+
+    for (uint32_t x = x0; x < x1; x++, dst += 4) {
+        const int32_t* cols = axisX.Index(x);
+        const float fxScalar = axisX.frac[x];
+        const float32x4_t fx = vdupq_n_f32(fxScalar);
+
+        const float32x4_t q0 = LoadLumaNEON(rows.luma[0], cols);
+        const float32x4_t q1 = LoadLumaNEON(rows.luma[1], cols);
+        const float32x4_t q2 = LoadLumaNEON(rows.luma[2], cols);
+        const float32x4_t q3 = LoadLumaNEON(rows.luma[3], cols);
+        const float32x4_t up = Middles(q0, q1);
+        const float32x4_t left = vcombine_f32(vget_low_f32(q1), vget_low_f32(q2));
+        const float32x4_t centre = Middles(q1, q2);
+        const float32x4_t right = vcombine_f32(vget_high_f32(q1), vget_high_f32(q2));
+        const float32x4_t down = Middles(q2, q3);
+
+        const float wxLanes[4] = { 1.0f - fxScalar, fxScalar, 1.0f - fxScalar, fxScalar };
+        const float32x4_t w = vmulq_f32(vld1q_f32(wxLanes), wy);
+        const float32x4_t len = vmulq_f32(vaddq_f32(EdgeLengthNEON(left, centre, right), EdgeLengthNEON(up, centre, down)), w);
+        const EasuShape shape = ShapeFromAnalysis(Sum4NEON(vmulq_f32(vsubq_f32(right, left), w)),
+            Sum4NEON(vmulq_f32(vsubq_f32(down, up), w)), Sum4NEON(len));
+
+        const float32x4_t w0 = TapWeightsNEON(shape, 0, fx, fy);
+        const float32x4_t w1 = TapWeightsNEON(shape, 1, fx, fy);
+        const float32x4_t w2 = TapWeightsNEON(shape, 2, fx, fy);
+
+        const float32x4_t f = LoadPixelNEON(rows.color[1], cols[1]);
+        const float32x4_t g = LoadPixelNEON(rows.color[1], cols[2]);
+        const float32x4_t j = LoadPixelNEON(rows.color[2], cols[1]);
+        const float32x4_t k = LoadPixelNEON(rows.color[2], cols[2]);
+
+        float32x4_t acc = vmulq_laneq_f32(LoadPixelNEON(rows.color[0], cols[1]), w0, 0);
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[0], cols[2]), w0, 1));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[1], cols[0]), w0, 2));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(f, w0, 3));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(g, w1, 0));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[1], cols[3]), w1, 1));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[2], cols[0]), w1, 2));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(j, w1, 3));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(k, w2, 0));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[2], cols[3]), w2, 1));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[3], cols[1]), w2, 2));
+        acc = vaddq_f32(acc, vmulq_laneq_f32(LoadPixelNEON(rows.color[3], cols[2]), w2, 3));
+
+        const float total = Sum4NEON(vaddq_f32(vaddq_f32(w0, w1), w2));
+        const float32x4_t lo = vminq_f32(vminq_f32(f, g), vminq_f32(j, k));
+        const float32x4_t hi = vmaxq_f32(vmaxq_f32(f, g), vmaxq_f32(j, k));
+        const float32x4_t v = vminq_f32(vmaxq_f32(vdivq_f32(acc, vdupq_n_f32(total)), lo), hi);
+
+        const uint16x4_t narrow = vmovn_u32(vcvtq_u32_f32(vaddq_f32(v, vdupq_n_f32(0.5f))));
+        const uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+        memcpy(dst, &packed, sizeof(packed));
+    }
+}
+
+#endif
+
+const EasuKernelTable* GetEasuKernels(SimdLevel level)
+{
+    static const EasuKernelTable kScalar = { SimdLevel::Scalar, EasuRowScalar };
+#if defined(QISX_ARCH_X86)
+    static const EasuKernelTable kSSE41 = { SimdLevel::SSE41, EasuRowSSE41 };
+#elif defined(QISX_ARCH_ARM64)
+    static const EasuKernelTable kNEON = { SimdLevel::NEON, EasuRowNEON };
+#endif
+
+    if (level == SimdLevel::Auto)
+        level = DetectSimdLevel();
+
+#if defined(QISX_ARCH_X86)
+    if ((level == SimdLevel::SSE41 || level == SimdLevel::AVX2) && IsSimdLevelSupported(SimdLevel::SSE41))
+        return &kSSE41;
+#elif defined(QISX_ARCH_ARM64)
+    if (level == SimdLevel::NEON && IsSimdLevelSupported(SimdLevel::NEON))
+        return &kNEON;
+#endif
+    return &kScalar;
+}
+
+}
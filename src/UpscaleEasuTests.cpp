@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "Resampler.h"
+#include "TestImages.h"
+#include "UpscaleEasu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    // Anti-aliased dark disc on a light background, rendered at 8x8 samples per pixel
+    qisx::Image Disc(uint32_t size)
+    {
+        qisx::Image image(size, size);
+        const float centre = size * 0.5f;
+        const float radius = size * 0.37f;
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                int inside = 0;
+                for (int sy = 0; sy < 8; sy++) {
+                    for (int sx = 0; sx < 8; sx++) {
+                        const float dx = x + (sx + 0.5f) / 8.0f - centre;
+                        const float dy = y + (sy + 0.5f) / 8.0f - centre;
+                        inside += dx * dx + dy * dy < radius * radius;
+                    }
+                }
+                uint8_t* p = image.Data() + y * image.RowPitch() + x * 4;
+                p[0] = p[1] = p[2] = static_cast<uint8_t>(220 - (180 * inside + 32) / 64);
+                p[3] = 255;
+            }
+        }
+        return image;
+    }
+
+}
+
+TEST(UpscaleEasuTests, FlatColourIsPreserved)
+{
+    qisx::Image src(97, 61);
+    for (size_t i = 0; i < src.SizeInBytes(); i += 4) {
+        src.Data()[i + 0] = 0;
+        src.Data()[i + 1] = 77;
+        src.Data()[i + 2] = 254;
+        src.Data()[i + 3] = 255;
+    }
+
+    qisx::Image dst(211, 100);
+    qisx::CpuUpscaler upscaler({ 1.5f, false, qisx::UpscalePath::EdgeAdaptive });
+    ASSERT_TRUE(upscaler.Upscale(src.View(), dst.MutableView()));
+
+    for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+        ASSERT_EQ(dst.Data()[i + 0], 0) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 1], 77) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 2], 254) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 3], 255) << "pixel " << i / 4;
+    }
+}
+
+// The SIMD kernels keep the scalar summation order, and tiling only changes
+// which columns a call covers, so every configuration is bit-identical.
+TEST(UpscaleEasuTests, SimdAndTilesMatchScalar)
+{
+    const uint32_t sizes[][4] = {
+        { 854, 480, 1280, 720 },
+        { 64, 48, 173, 91 },
+        { 3, 2, 17, 9 },
+    };
+
+    for (const auto& s : sizes) {
+        qisx::Image src(s[0], s[1]);
+        qisx::test::FillRandom(src, s[0] * 13 + s[1]);
+
+        qisx::CpuUpscaler::Options options{ 1.5f, false, qisx::UpscalePath::EdgeAdaptive, qisx::SimdLevel::Scalar, 1 };
+        qisx::Image expected(s[2], s[3]);
+        ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), expected.MutableView()));
+
+        options.simd = qisx::SimdLevel::Auto;
+        options.threadCount = 3;
+        options.tileWidth = 37;
+        options.tileHeight = 11;
+        qisx::Image actual(s[2], s[3]);
+        ASSERT_TRUE(qisx::CpuUpscaler(options).Upscale(src.View(), actual.MutableView()));
+
+        EXPECT_EQ(memcmp(expected.Data(), actual.Data(), expected.SizeInBytes()), 0) << s[0] << "x" << s[1];
+    }
+}
+
+TEST(UpscaleEasuTests, EdgesDoNotRing)
+{
+    // Vertical, horizontal and diagonal steps between 100 and 150: the clamp
+    // to the nearest four texels keeps every output inside that range
+    qisx::Image src(48, 48);
+    for (uint32_t y = 0; y < src.Height(); y++) {
+        for (uint32_t x = 0; x < src.Width(); x++) {
+            uint8_t* p = src.Data() + y * src.RowPitch() + x * 4;
+            const bool high = (x < 16) ? x < 8 : (x < 32 ? y < 24 : x + y < 64);
+            p[0] = p[1] = p[2] = high ? 150 : 100;
+            p[3] = 255;
+        }
+    }
+
+    qisx::Image dst(113, 113);
+    ASSERT_TRUE(qisx::CpuUpscaler({ 1.5f, false, qisx::UpscalePath::EdgeAdaptive }).Upscale(src.View(), dst.MutableView()));
+    for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+        ASSERT_GE(dst.Data()[i], 100) << "pixel " << i / 4;
+        ASSERT_LE(dst.Data()[i], 150) << "pixel " << i / 4;
+    }
+}
+
+TEST(UpscaleEasuTests, CurvedEdgesBeatBicubic)
+{
+    // Downscale a sharp disc, upscale it back and compare with the original.
+    // Plain Catmull-Rom (no sharpening) is the baseline EASU should improve on.
+    const qisx::Image original = Disc(384);
+    qisx::Image small(144, 144);
+    ASSERT_TRUE(qisx::Resampler({ qisx::ResampleFilter::Box }).Resample(original.View(), small.MutableView()));
+
+    qisx::Image bicubic(384, 384);
+    qisx::Image easu(384, 384);
+    ASSERT_TRUE(qisx::CpuUpscaler({ 0.0f, false, qisx::UpscalePath::Separable }).Upscale(small.View(), bicubic.MutableView()));
+    ASSERT_TRUE(qisx::CpuUpscaler({ 0.0f, false, qisx::UpscalePath::EdgeAdaptive }).Upscale(small.View(), easu.MutableView()));
+
+    const double bicubicError = qisx::test::MeanSquaredError(original, bicubic);
+    const double easuError = qisx::test::MeanSquaredError(original, easu);
+    EXPECT_LT(easuError, bicubicError) << "bicubic " << bicubicError << ", easu " << easuError;
+}
@@ -0,0 +1,268 @@
+#include "UpscaleFixed.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    // Largest |row| the horizontal pass can produce: 255 * ~1.2 (worst-case sum of
+    // |Catmull-Rom| weights after edge renormalisation) in Q6, rounded up.
+    constexpr double kRowMagnitude = 20000.0;
+
+    // Rounds scale * weights to integers and pushes the rounding residue onto the
+    // largest tap so the quantised sum is exactly `target`.
+    void QuantiseTaps(const float* weights, double scale, int target, int16_t* out)
+    {
+        int sum = 0;
+        int largest = 0;
+        for (int t = 0; t < kFilterTaps; t++) {
+            out[t] = static_cast<int16_t>(std::lround(weights[t] * scale));
+            sum += out[t];
+            if (std::abs(weights[t]) > std::abs(weights[largest]))
+                largest = t;
+        }
+        out[largest] = static_cast<int16_t>(out[largest] + (target - sum));
+    }
+
+    inline uint8_t SaturateFixed(int32_t acc, int shift)
+    {
+        const int32_t v = (acc + (1 << (shift - 1))) >> shift;
+        return static_cast<uint8_t>(std::clamp(v, 0, 255));
+    }
+
+}
+
+void BuildFixedAxisFilter(const AxisFilter& src, FixedAxisFilter& filter)
+{
+    if (filter.srcSize == src.srcSize && filter.dstSize == src.dstSize)
+        return;
+
+    filter.srcSize = src.srcSize;
+    filter.dstSize = src.dstSize;
+    filter.index = src.index;
+    filter.bicubic.resize(src.bicubic.size());
+    filter.blur.resize(src.blur.size());
+
+    const double one = double(1 << kFixedWeightBits);
+    for (uint32_t o = 0; o < src.dstSize; o++) {
+        QuantiseTaps(src.Bicubic(o), one, 1 << kFixedWeightBits, &filter.bicubic[size_t(o) * kFilterTaps]);
+        QuantiseTaps(src.Blur(o), one, 1 << kFixedWeightBits, &filter.blur[size_t(o) * kFilterTaps]);
+    }
+}
+
+void QuantiseVerticalWeights(const float* bicubicWeights, const float* blurWeights, float strength,
+    FixedVerticalWeights& weights)
+{
+    const float keep = 1.0f + strength;
+    float scaledBicubic[kFilterTaps];
+    float scaledBlur[kFilterTaps];
+    double maxAbs = 0.0;
+    double sumAbs = 0.0;
+    for (int t = 0; t < kFilterTaps; t++) {
+        scaledBicubic[t] = keep * bicubicWeights[t];
+        scaledBlur[t] = -strength * blurWeights[t];
+        maxAbs = std::max({ maxAbs, double(std::abs(scaledBicubic[t])), double(std::abs(scaledBlur[t])) });
+        sumAbs += std::abs(scaledBicubic[t]) + std::abs(scaledBlur[t]);
+    }
+
+    // Most fraction bits such that every tap fits int16 (with headroom for the
+    // residue fix-up) and the 8-tap sum of Q6 rows cannot overflow int32
+    int bits = kFixedWeightBits;
+    while (bits > 0 && (maxAbs * (1 << bits) > 32000.0 || sumAbs * (1 << bits) * kRowMagnitude > double(INT_MAX) * 0.5))
+        bits--;
+
+    const double scale = double(1 << bits);
+    int sum = 0;
+    for (int t = 0; t < kFilterTaps; t++) {
+        weights.blur[t] = static_cast<int16_t>(std::lround(scaledBlur[t] * scale));
+        sum += weights.blur[t];
+    }
+
+    // keep - strength == 1: bicubic + blur taps sum to exactly 1 << bits
+    QuantiseTaps(scaledBicubic, scale, (1 << bits) - sum, weights.bicubic);
+    weights.shift = bits + kFixedRowBits;
+}
+
+void HorizontalPassFixedScalar(const uint8_t* srcRow, const FixedAxisFilter& filter,
+    uint32_t x0, uint32_t x1, int16_t* bicubicOut, int16_t* blurOut)
+{
+    const int shift = kFixedWeightBits - kFixedRowBits;
+    const int32_t round = 1 << (shift - 1);
+    for (uint32_t x = x0; x < x1; x++, bicubicOut += 4, blurOut += 4) {
+        const int32_t* index = filter.Index(x);
+        const int16_t* wb = filter.Bicubic(x);
+        const int16_t* wl = filter.Blur(x);
+
+        int32_t b[4] = { 0, 0, 0, 0 };
+        int32_t l[4] = { 0, 0, 0, 0 };
+        for (int t = 0; t < kFilterTaps; t++) {
+            const uint8_t* p = srcRow + size_t(index[t]) * 4;
+            for (int c = 0; c < 4; c++) {
+                b[c] += p[c] * wb[t];
+                l[c] += p[c] * wl[t];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            bicubicOut[c] = static_cast<int16_t>((b[c] + round) >> shift);
+            blurOut[c] = static_cast<int16_t>((l[c] + round) >> shift);
+        }
+    }
+}
+
+void VerticalPassFixedScalar(const int16_t* const bicubicRows[kFilterTaps],
+    const int16_t* const blurRows[kFilterTaps], const FixedVerticalWeights& weights,
+    uint32_t count, uint8_t* dst)
+{
+    for (uint32_t i = 0; i < count * 4; i++) {
+        int32_t acc = 0;
+        for (int t = 0; t < kFilterTaps; t++)
+            acc += bicubicRows[t][i] * weights.bicubic[t] + blurRows[t][i] * weights.blur[t];
+        dst[i] = SaturateFixed(acc, weights.shift);
+    }
+}
+
+#if defined(QISX_ARCH_X86)
+
+namespace {
+
+    // Broadcasts the int16 tap pair (w[0], w[1]) to every 32-bit lane for pmaddwd.
+    QISX_TARGET("sse4.1")
+    inline __m128i TapPair(const int16_t* w)
+    {
+        int32_t pair;
+        std::memcpy(&pair, w, sizeof(pair));
+        return _mm_set1_epi32(pair);
+    }
+
+    QISX_TARGET("sse4.1")
+    inline __m128i LoadTexel(const uint8_t* srcRow, int32_t index)
+    {
+        int32_t texel;
+        std::memcpy(&texel, srcRow + size_t(index) * 4, sizeof(texel));
+        return _mm_cvtsi32_si128(texel);
+    }
+
+    QISX_TARGET("sse4.1")
+    inline __m128i LoadRow(const int16_t* row, uint32_t i)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+    }
+
+    // One output pixel: returns (bicubic, blur) as 4 x int32 in Q14.
+    QISX_TARGET("sse4.1")
+    inline void FilterPixelFixedSSE41(const uint8_t* srcRow, const FixedAxisFilter& filter, uint32_t x,
+        __m128i& bicubic, __m128i& blur)
+    {
+        const int32_t* index = filter.Index(x);
+        const int16_t* wb = filter.Bicubic(x);
+        const int16_t* wl = filter.Blur(x);
+
+        // r0 r1 g0 g1 b0 b1 a0 a1 as int16: channel-major tap pairs for pmaddwd
+        const __m128i p01 = _mm_cvtepu8_epi16(_mm_unpacklo_epi8(LoadTexel(srcRow, index[0]), LoadTexel(srcRow, index[1])));
+        const __m128i p23 = _mm_cvtepu8_epi16(_mm_unpacklo_epi8(LoadTexel(srcRow, index[2]), LoadTexel(srcRow, index[3])));
+
+        bicubic = _mm_add_epi32(_mm_madd_epi16(p01, TapPair(wb)), _mm_madd_epi16(p23, TapPair(wb + 2)));
+        blur = _mm_add_epi32(_mm_madd_epi16(p01, TapPair(wl)), _mm_madd_epi16(p23, TapPair(wl + 2)));
+    }
+
+}
+
+QISX_TARGET("sse4.1")
+void HorizontalPassFixedSSE41(const uint8_t* srcRow, const FixedAxisFilter& filter,
+    uint32_t x0, uint32_t x1, int16_t* bicubicOut, int16_t* blurOut)
+{
+    const int shift = kFixedWeightBits - kFixedRowBits;
+    const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+
+    // Two pixels per iteration fill one register of int16 results
+    uint32_t x = x0;
+    for (; x + 2 <= x1; x += 2, bicubicOut += 8, blurOut += 8) {
+        __m128i b0, l0, b1, l1;
+        FilterPixelFixedSSE41(srcRow, filter, x, b0, l0);
+        FilterPixelFixedSSE41(srcRow, filter, x + 1, b1, l1);
+
+        b0 = _mm_srai_epi32(_mm_add_epi32(b0, round), shift);
+        b1 = _mm_srai_epi32(_mm_add_epi32(b1, round), shift);
+        l0 = _mm_srai_epi32(_mm_add_epi32(l0, round), shift);
+        l1 = _mm_srai_epi32(_mm_add_epi32(l1, round), shift);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bicubicOut), _mm_packs_epi32(b0, b1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(blurOut), _mm_packs_epi32(l0, l1));
+    }
+
+    if (x < x1) {
+        __m128i b, l;
+        FilterPixelFixedSSE41(srcRow, filter, x, b, l);
+        b = _mm_srai_epi32(_mm_add_epi32(b, round), shift);
+        l = _mm_srai_epi32(_mm_add_epi32(l, round), shift);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(bicubicOut), _mm_packs_epi32(b, b));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(blurOut), _mm_packs_epi32(l, l));
+    }
+}
+
+QISX_TARGET("sse4.1")
+void VerticalPassFixedSSE41(const int16_t* const bicubicRows[kFilterTaps],
+    const int16_t* const blurRows[kFilterTaps], const FixedVerticalWeights& weights,
+    uint32_t count, uint8_t* dst)
+{
+    const __m128i wb01 = TapPair(weights.bicubic);
+    const __m128i wb23 = TapPair(weights.bicubic + 2);
+    const __m128i wl01 = TapPair(weights.blur);
+    const __m128i wl23 = TapPair(weights.blur + 2);
+    const __m128i round = _mm_set1_epi32(1 << (weights.shift - 1));
+    const __m128i shift = _mm_cvtsi32_si128(weights.shift);
+
+    // Eight channels (two pixels) per iteration: rows t and t+1 interleaved per lane
+    const uint32_t values = count * 4;
+    uint32_t i = 0;
+    for (; i + 8 <= values; i += 8) {
+        const __m128i b0 = LoadRow(bicubicRows[0], i), b1 = LoadRow(bicubicRows[1], i);
+        const __m128i b2 = LoadRow(bicubicRows[2], i), b3 = LoadRow(bicubicRows[3], i);
+        const __m128i l0 = LoadRow(blurRows[0], i), l1 = LoadRow(blurRows[1], i);
+        const __m128i l2 = LoadRow(blurRows[2], i), l3 = LoadRow(blurRows[3], i);
+
+        __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(b0, b1), wb01), _mm_madd_epi16(_mm_unpacklo_epi16(b2, b3), wb23));
+        lo = _mm_add_epi32(lo, _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(l0, l1), wl01), _mm_madd_epi16(_mm_unpacklo_epi16(l2, l3), wl23)));
+        __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(b0, b1), wb01), _mm_madd_epi16(_mm_unpackhi_epi16(b2, b3), wb23));
+        hi = _mm_add_epi32(hi, _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(l0, l1), wl01), _mm_madd_epi16(_mm_unpackhi_epi16(l2, l3), wl23)));
+
+        lo = _mm_sra_epi32(_mm_add_epi32(lo, round), shift);
+        hi = _mm_sra_epi32(_mm_add_epi32(hi, round), shift);
+        const __m128i packed = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(packed, packed));
+    }
+
+    for (; i < values; i++) {
+        int32_t acc = 0;
+        for (int t = 0; t < kFilterTaps; t++)
+            acc += bicubicRows[t][i] * weights.bicubic[t] + blurRows[t][i] * weights.blur[t];
+        dst[i] = SaturateFixed(acc, weights.shift);
+    }
+}
+
+#endif
+
+const FixedKernelTable* GetFixedKernels(SimdLevel level)
+{
+    static const FixedKernelTable kScalar = { SimdLevel::Scalar, HorizontalPassFixedScalar, VerticalPassFixedScalar };
+#if defined(QISX_ARCH_X86)
+    static const FixedKernelTable kSSE41 = { SimdLevel::SSE41, HorizontalPassFixedSSE41, VerticalPassFixedSSE41 };
+#endif
+
+    if (level == SimdLevel::Auto)
+        level = DetectSimdLevel();
+
+#if defined(QISX_ARCH_X86)
+    if ((level == SimdLevel::SSE41 || level == SimdLevel::AVX2) && IsSimdLevelSupported(SimdLevel::SSE41))
+        return &kSSE41;
+#endif
+    return &kScalar;
+}
+
+}
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "TestImages.h"
+#include "UpscaleFixed.h"
+
+TEST(UpscaleFixedTests, FlatColourIsPreserved)
+{
+    qisx::Image src(97, 61);
+    for (size_t i = 0; i < src.SizeInBytes(); i += 4) {
+        src.Data()[i + 0] = 0;
+        src.Data()[i + 1] = 77;
+        src.Data()[i + 2] = 254;
+        src.Data()[i + 3] = 255;
+    }
+
+    qisx::Image dst(211, 100);
+    qisx::CpuUpscaler upscaler({ 1.5f, false, qisx::UpscalePath::FixedPoint });
+    ASSERT_TRUE(upscaler.Upscale(src.View(), dst.MutableView()));
+
+    for (size_t i = 0; i < dst.SizeInBytes(); i += 4) {
+        ASSERT_EQ(dst.Data()[i + 0], 0) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 1], 77) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 2], 254) << "pixel " << i / 4;
+        ASSERT_EQ(dst.Data()[i + 3], 255) << "pixel " << i / 4;
+    }
+}
+
+// Same contract as the float paths, across strengths that force fewer
+// fraction bits in the vertical weights.
+TEST(UpscaleFixedTests, MatchesReferenceWithinOneLsb)
+{
+    const uint32_t sizes[][4] = {
+        { 854, 480, 1280, 720 },
+        { 64, 48, 173, 91 },
+        { 3, 2, 17, 9 },
+    };
+
+    for (const auto& s : sizes) {
+        for (float strength : { 0.0f, 1.5f, 6.0f }) {
+            qisx::Image src(s[0], s[1]);
+            qisx::test::FillRandom(src, s[0] * 31 + s[1]);
+
+            qisx::Image expected(s[2], s[3]);
+            qisx::Image actual(s[2], s[3]);
+            qisx::CpuUpscaler reference({ strength, false, qisx::UpscalePath::Reference });
+            qisx::CpuUpscaler fixed({ strength, false, qisx::UpscalePath::FixedPoint });
+            ASSERT_TRUE(reference.Upscale(src.View(), expected.MutableView()));
+            ASSERT_TRUE(fixed.Upscale(src.View(), actual.MutableView()));
+
+            for (size_t i = 0; i < actual.SizeInBytes(); i++) {
+                ASSERT_NEAR(actual.Data()[i], expected.Data()[i], 1)
+                    << s[0] << "x" << s[1] << " strength " << strength << " byte " << i;
+            }
+        }
+    }
+}
+
+// Integer kernels have no summation-order slack: every ISA must be bit-exact.
+TEST(UpscaleFixedTests, SimdMatchesScalarExactly)
+{
+    const qisx::FixedKernelTable* simd = qisx::GetFixedKernels(qisx::SimdLevel::Auto);
+    if (simd->level == qisx::SimdLevel::Scalar)
+        GTEST_SKIP() << "no fixed-point SIMD kernels on this CPU/build";
+
+    qisx::Image src(211, 97);
+    qisx::test::FillRandom(src, 3);
+
+    for (uint32_t threads : { 1u, 2u }) {
+        qisx::Image expected(317, 146);
+        qisx::Image actual(317, 146);
+        qisx::CpuUpscaler a({ 1.5f, false, qisx::UpscalePath::FixedPoint, qisx::SimdLevel::Scalar, threads, 37, 19 });
+        qisx::CpuUpscaler b({ 1.5f, false, qisx::UpscalePath::FixedPoint, simd->level, threads, 37, 19 });
+        ASSERT_TRUE(a.Upscale(src.View(), expected.MutableView()));
+        ASSERT_TRUE(b.Upscale(src.View(), actual.MutableView()));
+
+        for (size_t i = 0; i < actual.SizeInBytes(); i++)
+            ASSERT_EQ(actual.Data()[i], expected.Data()[i]) << qisx::SimdLevelName(simd->level) << " byte " << i;
+    }
+}
+
+TEST(UpscaleFixedTests, QuantisedWeightsSumExactly)
+{
+    qisx::AxisFilter filter;
+    qisx::FixedAxisFilter fixed;
+    qisx::BuildAxisFilter(7, 23, filter);
+    qisx::BuildFixedAxisFilter(filter, fixed);
+
+    for (uint32_t o = 0; o < fixed.dstSize; o++) {
+        int bicubic = 0;
+        int blur = 0;
+        for (int t = 0; t < qisx::kFilterTaps; t++) {
+            bicubic += fixed.Bicubic(o)[t];
+            blur += fixed.Blur(o)[t];
+        }
+        EXPECT_EQ(bicubic, 1 << qisx::kFixedWeightBits) << "output " << o;
+        EXPECT_EQ(blur, 1 << qisx::kFixedWeightBits) << "output " << o;
+
+        qisx::FixedVerticalWeights weights;
+        qisx::QuantiseVerticalWeights(filter.Bicubic(o), filter.Blur(o), 1.5f, weights);
+        int total = 0;
+        for (int t = 0; t < qisx::kFilterTaps; t++)
+            total += weights.bicubic[t] + weights.blur[t];
+        EXPECT_EQ(total, 1 << (weights.shift - qisx::kFixedRowBits)) << "output " << o;
+    }
+}
@@ -0,0 +1,195 @@
+#include "UpscaleKernels.h"
+#include "ColorSpace.h"
+#include "CpuUpscaler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qisx {
+
+void BuildAxisFilter(uint32_t srcSize, uint32_t dstSize, AxisFilter& filter)
+{
+    if (filter.srcSize == srcSize && filter.dstSize == dstSize)
+        return;
+
+    filter.srcSize = srcSize;
+    filter.dstSize = dstSize;
+    filter.index.resize(size_t(dstSize) * kFilterTaps);
+    filter.bicubic.resize(size_t(dstSize) * kFilterTaps);
+    filter.blur.resize(size_t(dstSize) * kFilterTaps);
+
+    const int maxIndex = int(srcSize) - 1;
+    for (uint32_t o = 0; o < dstSize; o++) {
+        // Same expression order as BicubicSample so the fractions agree bit for bit
+        const float pos = ((o + 0.5f) / dstSize) * srcSize - 0.5f;
+        const float base = std::floor(pos);
+        const float f = pos - base;
+
+        int32_t* index = &filter.index[size_t(o) * kFilterTaps];
+        float* bicubic = &filter.bicubic[size_t(o) * kFilterTaps];
+        float* blur = &filter.blur[size_t(o) * kFilterTaps];
+
+        float total = 0.0f;
+        for (int t = 0; t < kFilterTaps; t++) {
+            const int i = int(base) + t - 1;
+            index[t] = std::clamp(i, 0, maxIndex);
+            bicubic[t] = (i < 0 || i > maxIndex) ? 0.0f : BicubicWeight((t - 1) - f);
+            total += bicubic[t];
+        }
+
+        const float inv = 1.0f / std::max(total, 1e-5f);
+        for (int t = 0; t < kFilterTaps; t++)
+            bicubic[t] *= inv;
+
+        const float third = 1.0f / 3.0f;
+        blur[0] = (1.0f - f) * third;
+        blur[1] = third;
+        blur[2] = third;
+        blur[3] = f * third;
+    }
+}
+
+void HorizontalPassScalar(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    for (uint32_t x = x0; x < x1; x++, bicubicOut += 4, blurOut += 4) {
+        const int32_t* index = filter.Index(x);
+        const float* wb = filter.Bicubic(x);
+        const float* wl = filter.Blur(x);
+
+        float b[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float l[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int t = 0; t < kFilterTaps; t++) {
+            const uint8_t* p = srcRow + size_t(index[t]) * 4;
+            for (int c = 0; c < 4; c++) {
+                b[c] += p[c] * wb[t];
+                l[c] += p[c] * wl[t];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            bicubicOut[c] = b[c];
+            blurOut[c] = l[c];
+        }
+    }
+}
+
+void VerticalPassScalar(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    // Rows hold 0..255 values; fold the 1/255 UNORM scale away by clamping to 255
+    const float keep = 1.0f + strength;
+    for (uint32_t i = 0; i < count * 4; i++) {
+        float b = 0.0f;
+        float l = 0.0f;
+        for (int t = 0; t < kFilterTaps; t++) {
+            b += bicubicRows[t][i] * bicubicWeights[t];
+            l += blurRows[t][i] * blurWeights[t];
+        }
+        const float v = std::clamp(keep * b - strength * l, 0.0f, 255.0f);
+        dst[i] = static_cast<uint8_t>(v + 0.5f);
+    }
+}
+
+uint32_t LinearSpanEnd(const AxisFilter& filter, uint32_t x0, uint32_t x1)
+{
+    // Tap indices never decrease along the axis, and one column spans at most
+    // kFilterTaps pixels, so the run always holds x0
+    const int32_t last = filter.Index(x0)[0] + int32_t(kLinearSpanPixels) - 1;
+    uint32_t x = x0 + 1;
+    while (x < x1 && filter.Index(x)[kFilterTaps - 1] <= last)
+        x++;
+    return x;
+}
+
+void DecodeLinearSpan(const uint8_t* src, uint32_t count, float* out)
+{
+    const float* lut = GetSrgbTables().toLinear;
+    for (uint32_t i = 0; i < count; i++, src += 4, out += 4) {
+        out[0] = lut[src[0]];
+        out[1] = lut[src[1]];
+        out[2] = lut[src[2]];
+        out[3] = src[3] * (1.0f / 255.0f);
+    }
+}
+
+void HorizontalPassLinearScalar(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    const float* lut = GetSrgbTables().toLinear;
+    for (uint32_t x = x0; x < x1; x++, bicubicOut += 4, blurOut += 4) {
+        const int32_t* index = filter.Index(x);
+        const float* wb = filter.Bicubic(x);
+        const float* wl = filter.Blur(x);
+
+        float b[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float l[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int t = 0; t < kFilterTaps; t++) {
+            const uint8_t* p = srcRow + size_t(index[t]) * 4;
+            const float texel[4] = { lut[p[0]], lut[p[1]], lut[p[2]], p[3] * (1.0f / 255.0f) };
+            for (int c = 0; c < 4; c++) {
+                b[c] += texel[c] * wb[t];
+                l[c] += texel[c] * wl[t];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            bicubicOut[c] = b[c];
+            blurOut[c] = l[c];
+        }
+    }
+}
+
+void VerticalPassLinearScalar(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const SrgbTables& tables = GetSrgbTables();
+    const float keep = 1.0f + strength;
+    for (uint32_t i = 0; i < count * 4; i++) {
+        float b = 0.0f;
+        float l = 0.0f;
+        for (int t = 0; t < kFilterTaps; t++) {
+            b += bicubicRows[t][i] * bicubicWeights[t];
+            l += blurRows[t][i] * blurWeights[t];
+        }
+        const float v = keep * b - strength * l;
+        dst[i] = (i & 3) == 3 ? LinearToUnorm8(v) : LinearToSrgb8(tables, v);
+    }
+}
+
+const UpscaleKernelTable* GetUpscaleKernels(SimdLevel level)
+{
+    static const UpscaleKernelTable kScalar = { SimdLevel::Scalar, HorizontalPassScalar, VerticalPassScalar,
+        HorizontalPassLinearScalar, VerticalPassLinearScalar };
+#if defined(QISX_ARCH_X86)
+    static const UpscaleKernelTable kSSE41 = { SimdLevel::SSE41, HorizontalPassSSE41, VerticalPassSSE41,
+        HorizontalPassLinearSSE41, VerticalPassLinearSSE41 };
+    static const UpscaleKernelTable kAVX2 = { SimdLevel::AVX2, HorizontalPassAVX2, VerticalPassAVX2,
+        HorizontalPassLinearAVX2, VerticalPassLinearAVX2 };
+#elif defined(QISX_ARCH_ARM64)
+    static const UpscaleKernelTable kNEON = { SimdLevel::NEON, HorizontalPassNEON, VerticalPassNEON,
+        HorizontalPassLinearNEON, VerticalPassLinearNEON };
+#endif
+
+    if (level == SimdLevel::Auto)
+        level = DetectSimdLevel();
+    if (!IsSimdLevelSupported(level))
+        return nullptr;
+
+    switch (level) {
+    case SimdLevel::Scalar:
+        return &kScalar;
+#if defined(QISX_ARCH_X86)
+    case SimdLevel::SSE41:
+        return &kSSE41;
+    case SimdLevel::AVX2:
+        return &kAVX2;
+#elif defined(QISX_ARCH_ARM64)
+    case SimdLevel::NEON:
+        return &kNEON;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+}
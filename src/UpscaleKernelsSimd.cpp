@@ -0,0 +1,590 @@
+#include "UpscaleKernels.h"
+#include "ColorSpace.h"
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+// Hand-vectorised versions of the separable pass kernels.
+//
+// Pixels stay packed RGBA: one pixel is one 4-lane float vector, so the
+// horizontal pass fills SSE/NEON registers with a single output pixel and AVX2
+// registers with two adjacent pixels (whose weights are contiguous in the
+// AxisFilter tables). The vertical pass applies the same weights to every
+// column and is a plain streaming MAC over 4 (SSE/NEON) or 8 (AVX2) pixels per
+// iteration. Accumulation order matches the scalar kernels, so results are
+// identical on targets without FMA contraction.
+//
+// The linear-light kernels fuse the sRGB conversions into the same passes: the
+// horizontal pass decodes the source span of a run of columns once through the
+// 256-entry LUT and filters floats from there, and the vertical pass vectorises
+// the clamp, sqrt, table index and alpha. Only the 4K encode table loads are
+// scalar (vpgatherdd is slower than plain loads on CPUs with the gather
+// microcode mitigation).
+
+namespace qisx {
+
+namespace {
+
+    // Offsets the row pointers so the scalar kernel can finish a remainder.
+    void VerticalTail(VerticalPassFn scalar, const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+        const float* bicubicWeights, const float* blurWeights, float strength,
+        uint32_t first, uint32_t count, uint8_t* dst)
+    {
+        if (first >= count)
+            return;
+
+        const float* b[kFilterTaps];
+        const float* l[kFilterTaps];
+        for (int t = 0; t < kFilterTaps; t++) {
+            b[t] = bicubicRows[t] + size_t(first) * 4;
+            l[t] = blurRows[t] + size_t(first) * 4;
+        }
+        scalar(b, l, bicubicWeights, blurWeights, strength, count - first, dst + size_t(first) * 4);
+    }
+
+    inline int32_t LoadPixelBits(const uint8_t* p)
+    {
+        int32_t bits;
+        memcpy(&bits, p, sizeof(bits));
+        return bits;
+    }
+
+    // Overwrites the colour bytes of count / 4 packed pixels with their sRGB
+    // codes, given one 4K encode table index per channel value.
+    inline void PatchLinearColour(const uint8_t* encode, const int32_t* index, int count, uint8_t* dst)
+    {
+        for (int i = 0; i < count; i += 4) {
+            dst[i + 0] = encode[index[i + 0]];
+            dst[i + 1] = encode[index[i + 1]];
+            dst[i + 2] = encode[index[i + 2]];
+        }
+    }
+
+}
+
+#if defined(QISX_ARCH_X86)
+
+namespace {
+
+    QISX_TARGET("sse4.1")
+    inline __m128 LoadPixelSSE41(const uint8_t* p)
+    {
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(LoadPixelBits(p))));
+    }
+
+    // Four output values (one pixel) of keep * b - strength * l, clamped and rounded.
+    QISX_TARGET("sse4.1")
+    inline __m128i ResolveSSE41(__m128 b, __m128 l, __m128 keep, __m128 strength)
+    {
+        __m128 v = _mm_sub_ps(_mm_mul_ps(keep, b), _mm_mul_ps(strength, l));
+        v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+        return _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+    }
+
+    QISX_TARGET("avx2")
+    inline __m256i ResolveAVX2(__m256 b, __m256 l, __m256 keep, __m256 strength)
+    {
+        __m256 v = _mm256_sub_ps(_mm256_mul_ps(keep, b), _mm256_mul_ps(strength, l));
+        v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+        return _mm256_cvttps_epi32(_mm256_add_ps(v, _mm256_set1_ps(0.5f)));
+    }
+
+}
+
+QISX_TARGET("sse4.1")
+void HorizontalPassSSE41(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    for (uint32_t x = x0; x < x1; x++, bicubicOut += 4, blurOut += 4) {
+        const int32_t* index = filter.Index(x);
+        const __m128 wb = _mm_loadu_ps(filter.Bicubic(x));
+        const __m128 wl = _mm_loadu_ps(filter.Blur(x));
+
+        const __m128 p0 = LoadPixelSSE41(srcRow + size_t(index[0]) * 4);
+        const __m128 p1 = LoadPixelSSE41(srcRow + size_t(index[1]) * 4);
+        const __m128 p2 = LoadPixelSSE41(srcRow + size_t(index[2]) * 4);
+        const __m128 p3 = LoadPixelSSE41(srcRow + size_t(index[3]) * 4);
+
+        __m128 b = _mm_mul_ps(p0, _mm_shuffle_ps(wb, wb, 0x00));
+        b = _mm_add_ps(b, _mm_mul_ps(p1, _mm_shuffle_ps(wb, wb, 0x55)));
+        b = _mm_add_ps(b, _mm_mul_ps(p2, _mm_shuffle_ps(wb, wb, 0xAA)));
+        b = _mm_add_ps(b, _mm_mul_ps(p3, _mm_shuffle_ps(wb, wb, 0xFF)));
+
+        __m128 l = _mm_mul_ps(p0, _mm_shuffle_ps(wl, wl, 0x00));
+        l = _mm_add_ps(l, _mm_mul_ps(p1, _mm_shuffle_ps(wl, wl, 0x55)));
+        l = _mm_add_ps(l, _mm_mul_ps(p2, _mm_shuffle_ps(wl, wl, 0xAA)));
+        l = _mm_add_ps(l, _mm_mul_ps(p3, _mm_shuffle_ps(wl, wl, 0xFF)));
+
+        _mm_storeu_ps(bicubicOut, b);
+        _mm_storeu_ps(blurOut, l);
+    }
+}
+
+QISX_TARGET("sse4.1")
+void VerticalPassSSE41(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const __m128 keep = _mm_set1_ps(1.0f + strength);
+    const __m128 s = _mm_set1_ps(strength);
+    __m128 wb[kFilterTaps];
+    __m128 wl[kFilterTaps];
+    for (int t = 0; t < kFilterTaps; t++) {
+        wb[t] = _mm_set1_ps(bicubicWeights[t]);
+        wl[t] = _mm_set1_ps(blurWeights[t]);
+    }
+
+    // 4 pixels (16 channel values) per iteration
+    uint32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128i resolved[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v) * 4;
+            __m128 b = _mm_mul_ps(_mm_loadu_ps(bicubicRows[0] + offset), wb[0]);
+            __m128 l = _mm_mul_ps(_mm_loadu_ps(blurRows[0] + offset), wl[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(bicubicRows[t] + offset), wb[t]));
+                l = _mm_add_ps(l, _mm_mul_ps(_mm_loadu_ps(blurRows[t] + offset), wl[t]));
+            }
+            resolved[v] = ResolveSSE41(b, l, keep, s);
+        }
+
+        const __m128i lo = _mm_packus_epi32(resolved[0], resolved[1]);
+        const __m128i hi = _mm_packus_epi32(resolved[2], resolved[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size_t(x) * 4), _mm_packus_epi16(lo, hi));
+    }
+
+    VerticalTail(VerticalPassScalar, bicubicRows, blurRows, bicubicWeights, blurWeights, strength, x, count, dst);
+}
+
+QISX_TARGET("sse4.1")
+void HorizontalPassLinearSSE41(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    alignas(16) float decoded[kLinearSpanPixels * 4];
+    for (uint32_t xs = x0; xs < x1;) {
+        const uint32_t xe = LinearSpanEnd(filter, xs, x1);
+        const int32_t first = filter.Index(xs)[0];
+        DecodeLinearSpan(srcRow + size_t(first) * 4, uint32_t(filter.Index(xe - 1)[kFilterTaps - 1] - first + 1), decoded);
+
+        for (uint32_t x = xs; x < xe; x++, bicubicOut += 4, blurOut += 4) {
+            const int32_t* index = filter.Index(x);
+            const __m128 wb = _mm_loadu_ps(filter.Bicubic(x));
+            const __m128 wl = _mm_loadu_ps(filter.Blur(x));
+
+            const __m128 p0 = _mm_load_ps(decoded + size_t(index[0] - first) * 4);
+            const __m128 p1 = _mm_load_ps(decoded + size_t(index[1] - first) * 4);
+            const __m128 p2 = _mm_load_ps(decoded + size_t(index[2] - first) * 4);
+            const __m128 p3 = _mm_load_ps(decoded + size_t(index[3] - first) * 4);
+
+            __m128 b = _mm_mul_ps(p0, _mm_shuffle_ps(wb, wb, 0x00));
+            b = _mm_add_ps(b, _mm_mul_ps(p1, _mm_shuffle_ps(wb, wb, 0x55)));
+            b = _mm_add_ps(b, _mm_mul_ps(p2, _mm_shuffle_ps(wb, wb, 0xAA)));
+            b = _mm_add_ps(b, _mm_mul_ps(p3, _mm_shuffle_ps(wb, wb, 0xFF)));
+
+            __m128 l = _mm_mul_ps(p0, _mm_shuffle_ps(wl, wl, 0x00));
+            l = _mm_add_ps(l, _mm_mul_ps(p1, _mm_shuffle_ps(wl, wl, 0x55)));
+            l = _mm_add_ps(l, _mm_mul_ps(p2, _mm_shuffle_ps(wl, wl, 0xAA)));
+            l = _mm_add_ps(l, _mm_mul_ps(p3, _mm_shuffle_ps(wl, wl, 0xFF)));
+
+            _mm_storeu_ps(bicubicOut, b);
+            _mm_storeu_ps(blurOut, l);
+        }
+        xs = xe;
+    }
+}
+
+QISX_TARGET("sse4.1")
+void VerticalPassLinearSSE41(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const uint8_t* encode = GetSrgbTables().fromSqrtLinear;
+    const __m128 keep = _mm_set1_ps(1.0f + strength);
+    const __m128 s = _mm_set1_ps(strength);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 scale = _mm_set1_ps(float(kSrgbEncodeTableSize));
+    __m128 wb[kFilterTaps];
+    __m128 wl[kFilterTaps];
+    for (int t = 0; t < kFilterTaps; t++) {
+        wb[t] = _mm_set1_ps(bicubicWeights[t]);
+        wl[t] = _mm_set1_ps(blurWeights[t]);
+    }
+
+    // 4 pixels (16 channel values) per iteration, colour bytes patched in after the packs
+    alignas(16) int32_t index[16];
+    uint32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128i alpha[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v) * 4;
+            __m128 b = _mm_mul_ps(_mm_loadu_ps(bicubicRows[0] + offset), wb[0]);
+            __m128 l = _mm_mul_ps(_mm_loadu_ps(blurRows[0] + offset), wl[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(bicubicRows[t] + offset), wb[t]));
+                l = _mm_add_ps(l, _mm_mul_ps(_mm_loadu_ps(blurRows[t] + offset), wl[t]));
+            }
+            __m128 value = _mm_sub_ps(_mm_mul_ps(keep, b), _mm_mul_ps(s, l));
+            value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(index + v * 4),
+                _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_sqrt_ps(value), scale), half)));
+            alpha[v] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), half));
+        }
+
+        const __m128i lo = _mm_packus_epi32(alpha[0], alpha[1]);
+        const __m128i hi = _mm_packus_epi32(alpha[2], alpha[3]);
+        uint8_t* out = dst + size_t(x) * 4;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(lo, hi));
+        PatchLinearColour(encode, index, 16, out);
+    }
+
+    VerticalTail(VerticalPassLinearScalar, bicubicRows, blurRows, bicubicWeights, blurWeights, strength, x, count, dst);
+}
+
+QISX_TARGET("avx2")
+void HorizontalPassAVX2(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    uint32_t x = x0;
+
+    // Two adjacent output pixels per register; their 2x4 weights are contiguous
+    for (; x + 2 <= x1; x += 2, bicubicOut += 8, blurOut += 8) {
+        const int32_t* indexA = filter.Index(x);
+        const int32_t* indexB = filter.Index(x + 1);
+        const __m256 wb = _mm256_loadu_ps(filter.Bicubic(x));
+        const __m256 wl = _mm256_loadu_ps(filter.Blur(x));
+
+        __m256 p[kFilterTaps];
+        for (int t = 0; t < kFilterTaps; t++) {
+            const __m128i pair = _mm_insert_epi32(
+                _mm_cvtsi32_si128(LoadPixelBits(srcRow + size_t(indexA[t]) * 4)),
+                LoadPixelBits(srcRow + size_t(indexB[t]) * 4), 1);
+            p[t] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(pair));
+        }
+
+        __m256 b = _mm256_mul_ps(p[0], _mm256_permute_ps(wb, 0x00));
+        b = _mm256_add_ps(b, _mm256_mul_ps(p[1], _mm256_permute_ps(wb, 0x55)));
+        b = _mm256_add_ps(b, _mm256_mul_ps(p[2], _mm256_permute_ps(wb, 0xAA)));
+        b = _mm256_add_ps(b, _mm256_mul_ps(p[3], _mm256_permute_ps(wb, 0xFF)));
+
+        __m256 l = _mm256_mul_ps(p[0], _mm256_permute_ps(wl, 0x00));
+        l = _mm256_add_ps(l, _mm256_mul_ps(p[1], _mm256_permute_ps(wl, 0x55)));
+        l = _mm256_add_ps(l, _mm256_mul_ps(p[2], _mm256_permute_ps(wl, 0xAA)));
+        l = _mm256_add_ps(l, _mm256_mul_ps(p[3], _mm256_permute_ps(wl, 0xFF)));
+
+        _mm256_storeu_ps(bicubicOut, b);
+        _mm256_storeu_ps(blurOut, l);
+    }
+
+    if (x < x1)
+        HorizontalPassSSE41(srcRow, filter, x, x1, bicubicOut, blurOut);
+}
+
+QISX_TARGET("avx2")
+void VerticalPassAVX2(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const __m256 keep = _mm256_set1_ps(1.0f + strength);
+    const __m256 s = _mm256_set1_ps(strength);
+    __m256 wb[kFilterTaps];
+    __m256 wl[kFilterTaps];
+    for (int t = 0; t < kFilterTaps; t++) {
+        wb[t] = _mm256_set1_ps(bicubicWeights[t]);
+        wl[t] = _mm256_set1_ps(blurWeights[t]);
+    }
+
+    // packus works per 128-bit lane; this restores linear dword (pixel) order
+    const __m256i unzip = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    // 8 pixels (32 channel values) per iteration
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256i resolved[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v * 2) * 4;
+            __m256 b = _mm256_mul_ps(_mm256_loadu_ps(bicubicRows[0] + offset), wb[0]);
+            __m256 l = _mm256_mul_ps(_mm256_loadu_ps(blurRows[0] + offset), wl[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_loadu_ps(bicubicRows[t] + offset), wb[t]));
+                l = _mm256_add_ps(l, _mm256_mul_ps(_mm256_loadu_ps(blurRows[t] + offset), wl[t]));
+            }
+            resolved[v] = ResolveAVX2(b, l, keep, s);
+        }
+
+        const __m256i lo = _mm256_packus_epi32(resolved[0], resolved[1]);
+        const __m256i hi = _mm256_packus_epi32(resolved[2], resolved[3]);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), unzip);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + size_t(x) * 4), bytes);
+    }
+
+    if (x < count) {
+        const float* b[kFilterTaps];
+        const float* l[kFilterTaps];
+        for (int t = 0; t < kFilterTaps; t++) {
+            b[t] = bicubicRows[t] + size_t(x) * 4;
+            l[t] = blurRows[t] + size_t(x) * 4;
+        }
+        VerticalPassSSE41(b, l, bicubicWeights, blurWeights, strength, count - x, dst + size_t(x) * 4);
+    }
+}
+
+// Two pixels per register, as in HorizontalPassAVX2
+QISX_TARGET("avx2")
+void HorizontalPassLinearAVX2(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    alignas(32) float decoded[kLinearSpanPixels * 4];
+    for (uint32_t xs = x0; xs < x1;) {
+        const uint32_t xe = LinearSpanEnd(filter, xs, x1);
+        const int32_t first = filter.Index(xs)[0];
+        DecodeLinearSpan(srcRow + size_t(first) * 4, uint32_t(filter.Index(xe - 1)[kFilterTaps - 1] - first + 1), decoded);
+
+        uint32_t x = xs;
+        for (; x + 2 <= xe; x += 2, bicubicOut += 8, blurOut += 8) {
+            const int32_t* indexA = filter.Index(x);
+            const int32_t* indexB = filter.Index(x + 1);
+            const __m256 wb = _mm256_loadu_ps(filter.Bicubic(x));
+            const __m256 wl = _mm256_loadu_ps(filter.Blur(x));
+
+            __m256 p[kFilterTaps];
+            for (int t = 0; t < kFilterTaps; t++) {
+                p[t] = _mm256_loadu2_m128(decoded + size_t(indexB[t] - first) * 4,
+                    decoded + size_t(indexA[t] - first) * 4);
+            }
+
+            __m256 b = _mm256_mul_ps(p[0], _mm256_permute_ps(wb, 0x00));
+            b = _mm256_add_ps(b, _mm256_mul_ps(p[1], _mm256_permute_ps(wb, 0x55)));
+            b = _mm256_add_ps(b, _mm256_mul_ps(p[2], _mm256_permute_ps(wb, 0xAA)));
+            b = _mm256_add_ps(b, _mm256_mul_ps(p[3], _mm256_permute_ps(wb, 0xFF)));
+
+            __m256 l = _mm256_mul_ps(p[0], _mm256_permute_ps(wl, 0x00));
+            l = _mm256_add_ps(l, _mm256_mul_ps(p[1], _mm256_permute_ps(wl, 0x55)));
+            l = _mm256_add_ps(l, _mm256_mul_ps(p[2], _mm256_permute_ps(wl, 0xAA)));
+            l = _mm256_add_ps(l, _mm256_mul_ps(p[3], _mm256_permute_ps(wl, 0xFF)));
+
+            _mm256_storeu_ps(bicubicOut, b);
+            _mm256_storeu_ps(blurOut, l);
+        }
+
+        if (x < xe) {
+            HorizontalPassLinearSSE41(srcRow, filter, x, xe, bicubicOut, blurOut);
+            bicubicOut += 4;
+            blurOut += 4;
+        }
+        xs = xe;
+    }
+}
+
+QISX_TARGET("avx2")
+void VerticalPassLinearAVX2(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const uint8_t* encode = GetSrgbTables().fromSqrtLinear;
+    const __m256 keep = _mm256_set1_ps(1.0f + strength);
+    const __m256 s = _mm256_set1_ps(strength);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 scale = _mm256_set1_ps(float(kSrgbEncodeTableSize));
+    __m256 wb[kFilterTaps];
+    __m256 wl[kFilterTaps];
+    for (int t = 0; t < kFilterTaps; t++) {
+        wb[t] = _mm256_set1_ps(bicubicWeights[t]);
+        wl[t] = _mm256_set1_ps(blurWeights[t]);
+    }
+
+    const __m256i unzip = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    // 8 pixels (32 channel values) per iteration
+    alignas(32) int32_t index[32];
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256i alpha[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v * 2) * 4;
+            __m256 b = _mm256_mul_ps(_mm256_loadu_ps(bicubicRows[0] + offset), wb[0]);
+            __m256 l = _mm256_mul_ps(_mm256_loadu_ps(blurRows[0] + offset), wl[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_loadu_ps(bicubicRows[t] + offset), wb[t]));
+                l = _mm256_add_ps(l, _mm256_mul_ps(_mm256_loadu_ps(blurRows[t] + offset), wl[t]));
+            }
+            __m256 value = _mm256_sub_ps(_mm256_mul_ps(keep, b), _mm256_mul_ps(s, l));
+            value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+
+            _mm256_store_si256(reinterpret_cast<__m256i*>(index + v * 8),
+                _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_sqrt_ps(value), scale), half)));
+            alpha[v] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)), half));
+        }
+
+        const __m256i lo = _mm256_packus_epi32(alpha[0], alpha[1]);
+        const __m256i hi = _mm256_packus_epi32(alpha[2], alpha[3]);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), unzip);
+        uint8_t* out = dst + size_t(x) * 4;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);
+        PatchLinearColour(encode, index, 32, out);
+    }
+
+    VerticalTail(VerticalPassLinearScalar, bicubicRows, blurRows, bicubicWeights, blurWeights, strength, x, count, dst);
+}
+
+#elif defined(QISX_ARCH_ARM64)
+
+namespace {
+
+    inline float32x4_t LoadPixelNEON(const uint8_t* p)
+    {
+        const uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(static_cast<uint32_t>(LoadPixelBits(p))));
+        return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(bytes))));
+    }
+
+    inline uint32x4_t ResolveNEON(float32x4_t b, float32x4_t l, float32x4_t keep, float32x4_t strength)
+    {
+        float32x4_t v = vsubq_f32(vmulq_f32(keep, b), vmulq_f32(strength, l));
+        v = vminq_f32(vmaxq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+        return vcvtq_u32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)));
+    }
+
+}
+
+void HorizontalPassNEON(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    for (uint32_t x = x0; x < x1; x++, bicubicOut += 4, blurOut += 4) {
+        const int32_t* index = filter.Index(x);
+        const float32x4_t wb = vld1q_f32(filter.Bicubic(x));
+        const float32x4_t wl = vld1q_f32(filter.Blur(x));
+
+        const float32x4_t p0 = LoadPixelNEON(srcRow + size_t(index[0]) * 4);
+        const float32x4_t p1 = LoadPixelNEON(srcRow + size_t(index[1]) * 4);
+        const float32x4_t p2 = LoadPixelNEON(srcRow + size_t(index[2]) * 4);
+        const float32x4_t p3 = LoadPixelNEON(srcRow + size_t(index[3]) * 4);
+
+        float32x4_t b = vmulq_laneq_f32(p0, wb, 0);
+        b = vaddq_f32(b, vmulq_laneq_f32(p1, wb, 1));
+        b = vaddq_f32(b, vmulq_laneq_f32(p2, wb, 2));
+        b = vaddq_f32(b, vmulq_laneq_f32(p3, wb, 3));
+
+        float32x4_t l = vmulq_laneq_f32(p0, wl, 0);
+        l = vaddq_f32(l, vmulq_laneq_f32(p1, wl, 1));
+        l = vaddq_f32(l, vmulq_laneq_f32(p2, wl, 2));
+        l = vaddq_f32(l, vmulq_laneq_f32(p3, wl, 3));
+
+        vst1q_f32(bicubicOut, b);
+        vst1q_f32(blurOut, l);
+    }
+}
+
+void VerticalPassNEON(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const float32x4_t keep = vdupq_n_f32(1.0f + strength);
+    const float32x4_t s = vdupq_n_f32(strength);
+
+    // 4 pixels (16 channel values) per iteration
+    uint32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        uint32x4_t resolved[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v) * 4;
+            float32x4_t b = vmulq_n_f32(vld1q_f32(bicubicRows[0] + offset), bicubicWeights[0]);
+            float32x4_t l = vmulq_n_f32(vld1q_f32(blurRows[0] + offset), blurWeights[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = vaddq_f32(b, vmulq_n_f32(vld1q_f32(bicubicRows[t] + offset), bicubicWeights[t]));
+                l = vaddq_f32(l, vmulq_n_f32(vld1q_f32(blurRows[t] + offset), blurWeights[t]));
+            }
+            resolved[v] = ResolveNEON(b, l, keep, s);
+        }
+
+        const uint16x8_t lo = vcombine_u16(vmovn_u32(resolved[0]), vmovn_u32(resolved[1]));
+        const uint16x8_t hi = vcombine_u16(vmovn_u32(resolved[2]), vmovn_u32(resolved[3]));
+        vst1q_u8(dst + size_t(x) * 4, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+
+    VerticalTail(VerticalPassScalar, bicubicRows, blurRows, bicubicWeights, blurWeights, strength, x, count, dst);
+}
+
+void HorizontalPassLinearNEON(const uint8_t* srcRow, const AxisFilter& filter,
+    uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+{
+    float decoded[kLinearSpanPixels * 4];
+    for (uint32_t xs = x0; xs < x1;) {
+        const uint32_t xe = LinearSpanEnd(filter, xs, x1);
+        const int32_t first = filter.Index(xs)[0];
+        DecodeLinearSpan(srcRow + size_t(first) * 4, uint32_t(filter.Index(xe - 1)[kFilterTaps - 1] - first + 1), decoded);
+
+        for (uint32_t x = xs; x < xe; x++, bicubicOut += 4, blurOut += 4) {
+            const int32_t* index = filter.Index(x);
+            const float32x4_t wb = vld1q_f32(filter.Bicubic(x));
+            const float32x4_t wl = vld1q_f32(filter.Blur(x));
+
+            const float32x4_t p0 = vld1q_f32(decoded + size_t(index[0] - first) * 4);
+            const float32x4_t p1 = vld1q_f32(decoded + size_t(index[1] - first) * 4);
+            const float32x4_t p2 = vld1q_f32(decoded + size_t(index[2] - first) * 4);
+            const float32x4_t p3 = vld1q_f32(decoded + size_t(index[3] - first) * 4);
+
+            float32x4_t b = vmulq_laneq_f32(p0, wb, 0);
+            b = vaddq_f32(b, vmulq_laneq_f32(p1, wb, 1));
+            b = vaddq_f32(b, vmulq_laneq_f32(p2, wb, 2));
+            b = vaddq_f32(b, vmulq_laneq_f32(p3, wb, 3));
+
+            float32x4_t l = vmulq_laneq_f32(p0, wl, 0);
+            l = vaddq_f32(l, vmulq_laneq_f32(p1, wl, 1));
+            l = vaddq_f32(l, vmulq_laneq_f32(p2, wl, 2));
+            l = vaddq_f32(l, vmulq_laneq_f32(p3, wl, 3));
+
+            vst1q_f32(bicubicOut, b);
+            vst1q_f32(blurOut, l);
+        }
+        xs = xe;
+    }
+}
+
+void VerticalPassLinearNEON(const float* const bicubicRows[kFilterTaps], const float* const blurRows[kFilterTaps],
+    const float* bicubicWeights, const float* blurWeights, float strength,
+    uint32_t count, uint8_t* dst)
+{
+    const uint8_t* encode = GetSrgbTables().fromSqrtLinear;
+    const float32x4_t keep = vdupq_n_f32(1.0f + strength);
+    const float32x4_t s = vdupq_n_f32(strength);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+
+    // 4 pixels (16 channel values) per iteration, colour bytes patched in after the narrows
+    int32_t index[16];
+    uint32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        uint32x4_t alpha[4];
+        for (int v = 0; v < 4; v++) {
+            const size_t offset = (size_t(x) + v) * 4;
+            float32x4_t b = vmulq_n_f32(vld1q_f32(bicubicRows[0] + offset), bicubicWeights[0]);
+            float32x4_t l = vmulq_n_f32(vld1q_f32(blurRows[0] + offset), blurWeights[0]);
+            for (int t = 1; t < kFilterTaps; t++) {
+                b = vaddq_f32(b, vmulq_n_f32(vld1q_f32(bicubicRows[t] + offset), bicubicWeights[t]));
+                l = vaddq_f32(l, vmulq_n_f32(vld1q_f32(blurRows[t] + offset), blurWeights[t]));
+            }
+            float32x4_t value = vsubq_f32(vmulq_f32(keep, b), vmulq_f32(s, l));
+            value = vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+
+            const float32x4_t scaled = vmulq_n_f32(vsqrtq_f32(value), float(kSrgbEncodeTableSize));
+            vst1q_s32(index + v * 4, vreinterpretq_s32_u32(vcvtq_u32_f32(vaddq_f32(scaled, half))));
+            alpha[v] = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(value, 255.0f), half));
+        }
+
+        const uint16x8_t lo = vcombine_u16(vmovn_u32(alpha[0]), vmovn_u32(alpha[1]));
+        const uint16x8_t hi = vcombine_u16(vmovn_u32(alpha[2]), vmovn_u32(alpha[3]));
+        uint8_t* out = dst + size_t(x) * 4;
+        vst1q_u8(out, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        PatchLinearColour(encode, index, 16, out);
+    }
+
+    VerticalTail(VerticalPassLinearScalar, bicubicRows, blurRows, bicubicWeights, blurWeights, strength, x, count, dst);
+}
+
+#endif
+
+}
@@ -0,0 +1,272 @@
+#include "UpscalePolyphase.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(QISX_ARCH_X86)
+#include <immintrin.h>
+#elif defined(QISX_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace qisx {
+
+namespace {
+
+    // Output columns [begin, end) that are whole phase groups inside [x0, x1) and
+    // whose four taps are all in bounds (so no renormalisation or clamping).
+    struct GroupRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    template <int N, int D>
+    GroupRange InteriorGroups(uint32_t srcSize, uint32_t x0, uint32_t x1)
+    {
+        constexpr auto& taps = Polyphase<N, D>::taps;
+        int minBase = taps[0].base;
+        int maxBase = taps[0].base;
+        for (const PolyphaseTaps& t : taps) {
+            minBase = std::min(minBase, t.base);
+            maxBase = std::max(maxBase, t.base);
+        }
+
+        // Lowest tap q*D + minBase - 1 >= 0; highest tap q*D + maxBase + 2 <= srcSize - 1
+        const int64_t qLow = std::max<int64_t>(0, (1 - minBase + D - 1) / D);
+        const int64_t highNum = int64_t(srcSize) - 3 - maxBase;
+        const int64_t qHigh = highNum < 0 ? 0 : highNum / D + 1;
+
+        const int64_t qBegin = std::max<int64_t>((int64_t(x0) + N - 1) / N, qLow);
+        const int64_t qEnd = std::min<int64_t>(int64_t(x1) / N, qHigh);
+        if (qBegin >= qEnd)
+            return { x1, x1 };
+        return { uint32_t(qBegin * N), uint32_t(qEnd * N) };
+    }
+
+    // Runs `interior` over whole phase groups and `edge` over the rest of [x0, x1).
+    template <int N, int D, typename Interior>
+    void RunPolyphase(const uint8_t* srcRow, const AxisFilter& filter, uint32_t x0, uint32_t x1,
+        float* bicubicOut, float* blurOut, HorizontalPassFn edge, Interior interior)
+    {
+        const GroupRange range = InteriorGroups<N, D>(filter.srcSize, x0, x1);
+        if (range.begin >= range.end) {
+            edge(srcRow, filter, x0, x1, bicubicOut, blurOut);
+            return;
+        }
+
+        if (range.begin > x0)
+            edge(srcRow, filter, x0, range.begin, bicubicOut, blurOut);
+
+        const size_t head = size_t(range.begin - x0) * 4;
+        interior(srcRow + size_t(range.begin / N) * D * 4, (range.end - range.begin) / N,
+            bicubicOut + head, blurOut + head);
+
+        if (range.end < x1) {
+            const size_t done = size_t(range.end - x0) * 4;
+            edge(srcRow, filter, range.end, x1, bicubicOut + done, blurOut + done);
+        }
+    }
+
+    template <int N, int D>
+    void HorizontalPassPolyphaseScalar(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+    {
+        RunPolyphase<N, D>(srcRow, filter, x0, x1, bicubicOut, blurOut, HorizontalPassScalar,
+            [](const uint8_t* src, uint32_t groups, float* b, float* l) {
+                constexpr auto& taps = Polyphase<N, D>::taps;
+                for (uint32_t g = 0; g < groups; g++, src += D * 4) {
+                    for (int p = 0; p < N; p++, b += 4, l += 4) {
+                        const uint8_t* s = src + (taps[p].base - 1) * 4;
+                        for (int c = 0; c < 4; c++) {
+                            b[c] = s[c] * taps[p].bicubic[0] + s[4 + c] * taps[p].bicubic[1]
+                                + s[8 + c] * taps[p].bicubic[2] + s[12 + c] * taps[p].bicubic[3];
+                            l[c] = s[c] * taps[p].blur[0] + s[4 + c] * taps[p].blur[1]
+                                + s[8 + c] * taps[p].blur[2] + s[12 + c] * taps[p].blur[3];
+                        }
+                    }
+                }
+            });
+    }
+
+#if defined(QISX_ARCH_X86)
+
+    // The four taps of an interior output are adjacent texels: one 16-byte load.
+    template <int N, int D>
+    QISX_TARGET("sse4.1")
+    inline void PolyphasePhaseSSE41(const uint8_t* src, int p, float* b, float* l)
+    {
+        constexpr auto& taps = Polyphase<N, D>::taps;
+        const __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (taps[p].base - 1) * 4));
+        const __m128 p0 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(texels));
+        const __m128 p1 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(texels, 4)));
+        const __m128 p2 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(texels, 8)));
+        const __m128 p3 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(texels, 12)));
+
+        __m128 vb = _mm_mul_ps(p0, _mm_set1_ps(taps[p].bicubic[0]));
+        vb = _mm_add_ps(vb, _mm_mul_ps(p1, _mm_set1_ps(taps[p].bicubic[1])));
+        vb = _mm_add_ps(vb, _mm_mul_ps(p2, _mm_set1_ps(taps[p].bicubic[2])));
+        vb = _mm_add_ps(vb, _mm_mul_ps(p3, _mm_set1_ps(taps[p].bicubic[3])));
+
+        __m128 vl = _mm_mul_ps(p0, _mm_set1_ps(taps[p].blur[0]));
+        vl = _mm_add_ps(vl, _mm_mul_ps(p1, _mm_set1_ps(taps[p].blur[1])));
+        vl = _mm_add_ps(vl, _mm_mul_ps(p2, _mm_set1_ps(taps[p].blur[2])));
+        vl = _mm_add_ps(vl, _mm_mul_ps(p3, _mm_set1_ps(taps[p].blur[3])));
+
+        _mm_storeu_ps(b, vb);
+        _mm_storeu_ps(l, vl);
+    }
+
+    template <int N, int D>
+    QISX_TARGET("sse4.1")
+    void PolyphaseInteriorSSE41(const uint8_t* src, uint32_t groups, float* b, float* l)
+    {
+        for (uint32_t g = 0; g < groups; g++, src += D * 4) {
+            for (int p = 0; p < N; p++, b += 4, l += 4)
+                PolyphasePhaseSSE41<N, D>(src, p, b, l);
+        }
+    }
+
+    template <int N, int D>
+    void HorizontalPassPolyphaseSSE41(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+    {
+        RunPolyphase<N, D>(srcRow, filter, x0, x1, bicubicOut, blurOut, HorizontalPassSSE41,
+            PolyphaseInteriorSSE41<N, D>);
+    }
+
+    // Two phases per register: the lanes of tap t hold texel t of phase p and
+    // of phase p + 1, zero-extended by a single byte shuffle.
+    template <int N, int D>
+    QISX_TARGET("avx2")
+    void PolyphaseInteriorAVX2(const uint8_t* src, uint32_t groups, float* b, float* l)
+    {
+        constexpr auto& taps = Polyphase<N, D>::taps;
+        const __m256i tapShuffle[kFilterTaps] = {
+            _mm256_setr_epi8(0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3, -1, -1, -1,
+                0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3, -1, -1, -1),
+            _mm256_setr_epi8(4, -1, -1, -1, 5, -1, -1, -1, 6, -1, -1, -1, 7, -1, -1, -1,
+                4, -1, -1, -1, 5, -1, -1, -1, 6, -1, -1, -1, 7, -1, -1, -1),
+            _mm256_setr_epi8(8, -1, -1, -1, 9, -1, -1, -1, 10, -1, -1, -1, 11, -1, -1, -1,
+                8, -1, -1, -1, 9, -1, -1, -1, 10, -1, -1, -1, 11, -1, -1, -1),
+            _mm256_setr_epi8(12, -1, -1, -1, 13, -1, -1, -1, 14, -1, -1, -1, 15, -1, -1, -1,
+                12, -1, -1, -1, 13, -1, -1, -1, 14, -1, -1, -1, 15, -1, -1, -1),
+        };
+
+        for (uint32_t g = 0; g < groups; g++, src += D * 4) {
+            int p = 0;
+            for (; p + 1 < N; p += 2, b += 8, l += 8) {
+                const __m256i texels = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (taps[p].base - 1) * 4))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (taps[p + 1].base - 1) * 4)), 1);
+
+                __m256 vb = _mm256_setzero_ps();
+                __m256 vl = _mm256_setzero_ps();
+                for (int t = 0; t < kFilterTaps; t++) {
+                    const __m256 px = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(texels, tapShuffle[t]));
+                    vb = _mm256_add_ps(vb, _mm256_mul_ps(px, _mm256_setr_m128(
+                        _mm_set1_ps(taps[p].bicubic[t]), _mm_set1_ps(taps[p + 1].bicubic[t]))));
+                    vl = _mm256_add_ps(vl, _mm256_mul_ps(px, _mm256_setr_m128(
+                        _mm_set1_ps(taps[p].blur[t]), _mm_set1_ps(taps[p + 1].blur[t]))));
+                }
+                _mm256_storeu_ps(b, vb);
+                _mm256_storeu_ps(l, vl);
+            }
+
+            if (N & 1) {
+                PolyphasePhaseSSE41<N, D>(src, N - 1, b, l);
+                b += 4;
+                l += 4;
+            }
+        }
+    }
+
+    template <int N, int D>
+    void HorizontalPassPolyphaseAVX2(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+    {
+        RunPolyphase<N, D>(srcRow, filter, x0, x1, bicubicOut, blurOut, HorizontalPassAVX2,
+            PolyphaseInteriorAVX2<N, D>);
+    }
+
+#elif defined(QISX_ARCH_ARM64)
+
+    template <int N, int D>
+    void PolyphaseInteriorNEON(const uint8_t* src, uint32_t groups, float* b, float* l)
+    {
+        constexpr auto& taps = Polyphase<N, D>::taps;
+        for (uint32_t g = 0; g < groups; g++, src += D * 4) {
+            for (int p = 0; p < N; p++, b += 4, l += 4) {
+                const uint8x16_t texels = vld1q_u8(src + (taps[p].base - 1) * 4);
+                const uint16x8_t lo = vmovl_u8(vget_low_u8(texels));
+                const uint16x8_t hi = vmovl_u8(vget_high_u8(texels));
+                const float32x4_t p0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo)));
+                const float32x4_t p1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo)));
+                const float32x4_t p2 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi)));
+                const float32x4_t p3 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi)));
+
+                float32x4_t vb = vmulq_n_f32(p0, taps[p].bicubic[0]);
+                vb = vaddq_f32(vb, vmulq_n_f32(p1, taps[p].bicubic[1]));
+                vb = vaddq_f32(vb, vmulq_n_f32(p2, taps[p].bicubic[2]));
+                vb = vaddq_f32(vb, vmulq_n_f32(p3, taps[p].bicubic[3]));
+
+                float32x4_t vl = vmulq_n_f32(p0, taps[p].blur[0]);
+                vl = vaddq_f32(vl, vmulq_n_f32(p1, taps[p].blur[1]));
+                vl = vaddq_f32(vl, vmulq_n_f32(p2, taps[p].blur[2]));
+                vl = vaddq_f32(vl, vmulq_n_f32(p3, taps[p].blur[3]));
+
+                vst1q_f32(b, vb);
+                vst1q_f32(l, vl);
+            }
+        }
+    }
+
+    template <int N, int D>
+    void HorizontalPassPolyphaseNEON(const uint8_t* srcRow, const AxisFilter& filter,
+        uint32_t x0, uint32_t x1, float* bicubicOut, float* blurOut)
+    {
+        RunPolyphase<N, D>(srcRow, filter, x0, x1, bicubicOut, blurOut, HorizontalPassNEON,
+            PolyphaseInteriorNEON<N, D>);
+    }
+
+#endif
+
+    template <int N, int D>
+    HorizontalPassFn PickPolyphase(SimdLevel level)
+    {
+        switch (level) {
+#if defined(QISX_ARCH_X86)
+        case SimdLevel::SSE41:
+            return &HorizontalPassPolyphaseSSE41<N, D>;
+        case SimdLevel::AVX2:
+            return &HorizontalPassPolyphaseAVX2<N, D>;
+#elif defined(QISX_ARCH_ARM64)
+        case SimdLevel::NEON:
+            return &HorizontalPassPolyphaseNEON<N, D>;
+#endif
+        default:
+            return &HorizontalPassPolyphaseScalar<N, D>;
+        }
+    }
+
+}
+
+HorizontalPassFn SelectPolyphaseHorizontal(uint32_t srcSize, uint32_t dstSize, SimdLevel level)
+{
+    if (level == SimdLevel::Auto)
+        level = DetectSimdLevel();
+    if (!IsSimdLevelSupported(level))
+        return nullptr;
+
+    const uint64_t src = srcSize;
+    const uint64_t dst = dstSize;
+    if (dst * 2 == src * 3)
+        return PickPolyphase<3, 2>(level);
+    if (dst == src * 2)
+        return PickPolyphase<2, 1>(level);
+    if (dst * 3 == src * 4)
+        return PickPolyphase<4, 3>(level);
+    if (dst == src * 3)
+        return PickPolyphase<3, 1>(level);
+    return nullptr;
+}
+
+}
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "CpuUpscaler.h"
+#include "UpscalePolyphase.h"
+
+namespace {
+
+    std::vector<uint8_t> RandomBytes(size_t count, uint32_t seed)
+    {
+        std::vector<uint8_t> bytes(count);
+        for (uint8_t& b : bytes) {
+            seed = seed * 1664525u + 1013904223u;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+        return bytes;
+    }
+
+    // Interior phases of the constexpr table must reproduce the AxisFilter entries.
+    template <int N, int D>
+    void CompareTables()
+    {
+        constexpr auto& taps = qisx::Polyphase<N, D>::taps;
+        const uint32_t srcSize = D * 40;
+        qisx::AxisFilter filter;
+        qisx::BuildAxisFilter(srcSize, N * 40, filter);
+
+        for (uint32_t q = 4; q < 36; q++) {
+            for (int p = 0; p < N; p++) {
+                const uint32_t x = q * N + p;
+                for (int t = 0; t < qisx::kFilterTaps; t++) {
+                    ASSERT_EQ(filter.Index(x)[t], int32_t(q * D) + taps[p].base + t - 1) << N << "/" << D << " x=" << x;
+                    ASSERT_NEAR(filter.Bicubic(x)[t], taps[p].bicubic[t], 1e-5f) << N << "/" << D << " x=" << x;
+                    ASSERT_NEAR(filter.Blur(x)[t], taps[p].blur[t], 1e-5f) << N << "/" << D << " x=" << x;
+                }
+            }
+        }
+    }
+
+    // The specialised pass must match the generic kernel of the same level,
+    // including partial groups and edge columns at arbitrary tile offsets. The
+    // generic tables derive frac() from float positions, which drift by ~1e-4
+    // towards the right edge of 1080p; the polyphase phases are exact.
+    void CompareWithGeneric(qisx::SimdLevel level, uint32_t srcW, uint32_t dstW)
+    {
+        const qisx::UpscaleKernelTable* generic = qisx::GetUpscaleKernels(level);
+        const qisx::HorizontalPassFn polyphase = qisx::SelectPolyphaseHorizontal(srcW, dstW, level);
+        ASSERT_NE(generic, nullptr);
+        ASSERT_NE(polyphase, nullptr) << srcW << "->" << dstW;
+
+        qisx::AxisFilter filter;
+        qisx::BuildAxisFilter(srcW, dstW, filter);
+        const std::vector<uint8_t> row = RandomBytes(size_t(srcW) * 4, srcW);
+
+        const uint32_t ranges[][2] = { { 0, dstW }, { 1, dstW - 2 }, { 5, 6 }, { 7, std::min(dstW, 40u) } };
+        for (const auto& r : ranges) {
+            const uint32_t count = r[1] - r[0];
+            std::vector<float> eb(count * 4), el(count * 4), ab(count * 4), al(count * 4);
+            generic->horizontal(row.data(), filter, r[0], r[1], eb.data(), el.data());
+            polyphase(row.data(), filter, r[0], r[1], ab.data(), al.data());
+
+            for (uint32_t i = 0; i < count * 4; i++) {
+                ASSERT_NEAR(ab[i], eb[i], 0.05f) << qisx::SimdLevelName(level) << " " << srcW << "->" << dstW << " bicubic " << i;
+                ASSERT_NEAR(al[i], el[i], 0.05f) << qisx::SimdLevelName(level) << " " << srcW << "->" << dstW << " blur " << i;
+            }
+        }
+    }
+
+}
+
+TEST(UpscalePolyphaseTests, TablesMatchAxisFilter)
+{
+    CompareTables<3, 2>();
+    CompareTables<2, 1>();
+    CompareTables<4, 3>();
+    CompareTables<3, 1>();
+}
+
+TEST(UpscalePolyphaseTests, SelectsOnlyExactRatios)
+{
+    const qisx::SimdLevel level = qisx::SimdLevel::Scalar;
+    EXPECT_NE(qisx::SelectPolyphaseHorizontal(1280, 1920, level), nullptr);
+    EXPECT_NE(qisx::SelectPolyphaseHorizontal(960, 1920, level), nullptr);
+    EXPECT_NE(qisx::SelectPolyphaseHorizontal(1440, 1920, level), nullptr);
+    EXPECT_NE(qisx::SelectPolyphaseHorizontal(640, 1920, level), nullptr);
+
+    // 854 -> 1280 is 1.4988x, not 3/2
+    EXPECT_EQ(qisx::SelectPolyphaseHorizontal(854, 1280, level), nullptr);
+    EXPECT_EQ(qisx::SelectPolyphaseHorizontal(100, 100, level), nullptr);
+    EXPECT_EQ(qisx::SelectPolyphaseHorizontal(200, 100, level), nullptr);
+}
+
+TEST(UpscalePolyphaseTests, MatchesGenericKernels)
+{
+    for (qisx::SimdLevel level : { qisx::SimdLevel::Scalar, qisx::SimdLevel::SSE41, qisx::SimdLevel::AVX2, qisx::SimdLevel::NEON }) {
+        if (!qisx::IsSimdLevelSupported(level) || !qisx::GetUpscaleKernels(level))
+            continue;
+        CompareWithGeneric(level, 1280, 1920);
+        CompareWithGeneric(level, 960, 1920);
+        CompareWithGeneric(level, 1440, 1920);
+        CompareWithGeneric(level, 640, 1920);
+        CompareWithGeneric(level, 6, 9);    // No interior group at all
+        CompareWithGeneric(level, 3, 9);
+    }
+}
+
+// End-to-end at a 2x ratio: polyphase on and off must both track the reference.
+TEST(UpscalePolyphaseTests, UpscalerMatchesReference)
+{
+    qisx::Image src(160, 90);
+    const std::vector<uint8_t> bytes = RandomBytes(src.SizeInBytes(), 11);
+    std::copy(bytes.begin(), bytes.end(), src.Data());
+
+    qisx::Image expected(320, 180);
+    qisx::CpuUpscaler reference({ 1.5f, false, qisx::UpscalePath::Reference });
+    ASSERT_TRUE(reference.Upscale(src.View(), expected.MutableView()));
+
+    for (bool polyphase : { false, true }) {
+        qisx::CpuUpscaler::Options options;
+        options.polyphase = polyphase;
+        options.tileWidth = 45;     // Tiles that start mid-group
+
+        qisx::Image actual(320, 180);
+        qisx::CpuUpscaler upscaler(options);
+        ASSERT_TRUE(upscaler.Upscale(src.View(), actual.MutableView()));
+
+        for (size_t i = 0; i < actual.SizeInBytes(); i++)
+            ASSERT_NEAR(actual.Data()[i], expected.Data()[i], 1) << "polyphase=" << polyphase << " byte " << i;
+    }
+}
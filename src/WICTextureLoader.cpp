@@ -31,6 +31,12 @@
 #include "DirectXHelpers.h"
 #include "PlatformHelpers.h"
 #include "LoaderHelpers.h"
+#include "MipGenerator.h"
+#include "PixelConvert.h"
+#include "Resampler.h"
+
+#include <new>
+#include <vector>
 
 using namespace DirectX;
 using Microsoft::WRL::ComPtr;
@@ -148,6 +154,68 @@ namespace
         // We don't support n-channel formats
     };
 
+    //-------------------------------------------------------------------------------------
+    // WIC Pixel Format to qisx::ConvertPixels layouts (see PixelConvert.h)
+    //-------------------------------------------------------------------------------------
+    struct WICPixelLayout
+    {
+        const GUID&         wic;
+        qisx::PixelFormat   layout;
+
+        constexpr WICPixelLayout(const GUID& wg, qisx::PixelFormat pf) noexcept :
+            wic(wg),
+            layout(pf)
+        {}
+    };
+
+    constexpr WICPixelLayout g_WICLayouts[] =
+    {
+        { GUID_WICPixelFormat32bppRGBA,             qisx::PixelFormat::RGBA8 },
+        { GUID_WICPixelFormat32bppBGRA,             qisx::PixelFormat::BGRA8 },
+        { GUID_WICPixelFormat32bppRGB,              qisx::PixelFormat::RGBX8 },
+        { GUID_WICPixelFormat32bppBGR,              qisx::PixelFormat::BGRX8 },
+        { GUID_WICPixelFormat32bppPRGBA,            qisx::PixelFormat::PRGBA8 },
+        { GUID_WICPixelFormat32bppPBGRA,            qisx::PixelFormat::PBGRA8 },
+        { GUID_WICPixelFormat24bppRGB,              qisx::PixelFormat::RGB8 },
+        { GUID_WICPixelFormat24bppBGR,              qisx::PixelFormat::BGR8 },
+
+        { GUID_WICPixelFormat8bppGray,              qisx::PixelFormat::Gray8 },
+        { GUID_WICPixelFormat8bppAlpha,             qisx::PixelFormat::Alpha8 },
+        { GUID_WICPixelFormatBlackWhite,            qisx::PixelFormat::Gray1 },
+        { GUID_WICPixelFormat2bppGray,              qisx::PixelFormat::Gray2 },
+        { GUID_WICPixelFormat4bppGray,              qisx::PixelFormat::Gray4 },
+        { GUID_WICPixelFormat32bppCMYK,             qisx::PixelFormat::CMYK8 },
+
+        { GUID_WICPixelFormat16bppBGR565,           qisx::PixelFormat::BGR565 },
+        { GUID_WICPixelFormat16bppBGR555,           qisx::PixelFormat::BGR555 },
+        { GUID_WICPixelFormat16bppBGRA5551,         qisx::PixelFormat::BGRA5551 },
+        { GUID_WICPixelFormat32bppRGBA1010102,      qisx::PixelFormat::RGBA1010102 },
+        { GUID_WICPixelFormat32bppBGR101010,        qisx::PixelFormat::BGR101010 },
+
+        { GUID_WICPixelFormat16bppGray,             qisx::PixelFormat::Gray16 },
+        { GUID_WICPixelFormat48bppRGB,              qisx::PixelFormat::RGB16 },
+        { GUID_WICPixelFormat48bppBGR,              qisx::PixelFormat::BGR16 },
+        { GUID_WICPixelFormat64bppRGBA,             qisx::PixelFormat::RGBA16 },
+        { GUID_WICPixelFormat64bppBGRA,             qisx::PixelFormat::BGRA16 },
+        { GUID_WICPixelFormat64bppRGB,              qisx::PixelFormat::RGBX16 },
+        { GUID_WICPixelFormat64bppPRGBA,            qisx::PixelFormat::PRGBA16 },
+        { GUID_WICPixelFormat64bppPBGRA,            qisx::PixelFormat::PBGRA16 },
+
+        { GUID_WICPixelFormat16bppGrayHalf,         qisx::PixelFormat::GrayHalf },
+        { GUID_WICPixelFormat48bppRGBHalf,          qisx::PixelFormat::RGBHalf },
+        { GUID_WICPixelFormat64bppRGBHalf,          qisx::PixelFormat::RGBXHalf },
+        { GUID_WICPixelFormat64bppRGBAHalf,         qisx::PixelFormat::RGBAHalf },
+        { GUID_WICPixelFormat64bppPRGBAHalf,        qisx::PixelFormat::PRGBAHalf },
+
+        { GUID_WICPixelFormat32bppGrayFloat,        qisx::PixelFormat::GrayFloat },
+        { GUID_WICPixelFormat96bppRGBFloat,         qisx::PixelFormat::RGBFloat },
+        { GUID_WICPixelFormat128bppRGBFloat,        qisx::PixelFormat::RGBXFloat },
+        { GUID_WICPixelFormat128bppRGBAFloat,       qisx::PixelFormat::RGBAFloat },
+        { GUID_WICPixelFormat128bppPRGBAFloat,      qisx::PixelFormat::PRGBAFloat },
+
+        // Indexed, fixed-point, RGBE and n-channel formats stay with IWICFormatConverter
+    };
+
     bool g_WIC2 = false;
 
     BOOL WINAPI InitializeWICFactory(PINIT_ONCE, PVOID, PVOID *ifactory) noexcept
@@ -267,6 +335,117 @@ namespace
         return bpp;
     }
 
+    //---------------------------------------------------------------------------------
+    qisx::PixelFormat WICToPixelLayout(const GUID& guid) noexcept
+    {
+        for (size_t i = 0; i < std::size(g_WICLayouts); ++i)
+        {
+            if (memcmp(&g_WICLayouts[i].wic, &guid, sizeof(GUID)) == 0)
+                return g_WICLayouts[i].layout;
+        }
+
+        return qisx::PixelFormat::Unknown;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Shared by every load; concurrent conversions take turns on it
+    qisx::ThreadPool& ConversionPool()
+    {
+        static qisx::ThreadPool pool;
+        return pool;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Copies the whole frame, at its own size, into dst in the convertGUID layout
+    HRESULT CopyFramePixels(
+        _In_ IWICBitmapFrameDecode* frame,
+        const WICPixelFormatGUID& pixelFormat,
+        const WICPixelFormatGUID& convertGUID,
+        UINT width,
+        UINT height,
+        size_t rowPitch,
+        size_t imageSize,
+        _Out_writes_bytes_(imageSize) uint8_t* dst) noexcept
+    {
+        HRESULT hr;
+        if (memcmp(&convertGUID, &pixelFormat, sizeof(GUID)) == 0)
+        {
+            // No format conversion needed
+            return frame->CopyPixels(nullptr, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), dst);
+        }
+        else if (qisx::CanConvertPixels(WICToPixelLayout(pixelFormat), WICToPixelLayout(convertGUID)))
+        {
+            // Copy the frame in its own layout and convert with the vectorised
+            // row kernels, split across the pool
+            const qisx::PixelFormat srcLayout = WICToPixelLayout(pixelFormat);
+            const uint64_t srcRowBytes = (uint64_t(width) * qisx::PixelFormatBitsPerPixel(srcLayout) + 7u) / 8u;
+            const uint64_t srcBytes = srcRowBytes * uint64_t(height);
+            if (srcBytes > UINT32_MAX)
+                return HRESULT_FROM_WIN32(ERROR_ARITHMETIC_OVERFLOW);
+
+            std::unique_ptr<uint8_t[]> source(new (std::nothrow) uint8_t[static_cast<size_t>(srcBytes)]);
+            if (!source)
+                return E_OUTOFMEMORY;
+
+            hr = frame->CopyPixels(nullptr, static_cast<UINT>(srcRowBytes), static_cast<UINT>(srcBytes), source.get());
+            if (FAILED(hr))
+                return hr;
+
+            if (!qisx::ConvertPixels(source.get(), static_cast<size_t>(srcRowBytes), srcLayout,
+                dst, rowPitch, WICToPixelLayout(convertGUID), width, height, &ConversionPool()))
+                return E_UNEXPECTED;
+            return S_OK;
+        }
+        else
+        {
+            // Layouts qisx::ConvertPixels can't read
+            auto pWIC = GetWIC();
+            if (!pWIC)
+                return E_NOINTERFACE;
+
+            ComPtr<IWICFormatConverter> FC;
+            hr = pWIC->CreateFormatConverter(FC.GetAddressOf());
+            if (FAILED(hr))
+                return hr;
+
+            BOOL canConvert = FALSE;
+            hr = FC->CanConvert(pixelFormat, convertGUID, &canConvert);
+            if (FAILED(hr) || !canConvert)
+            {
+                return E_UNEXPECTED;
+            }
+
+            hr = FC->Initialize(frame, convertGUID, WICBitmapDitherTypeErrorDiffusion, nullptr, 0, WICBitmapPaletteTypeMedianCut);
+            if (FAILED(hr))
+                return hr;
+
+            return FC->CopyPixels(nullptr, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), dst);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // 8 bits per channel, 4 channels: the layouts qisx::MipGenerator filters
+    bool IsCpuMipFormat(DXGI_FORMAT format, bool& srgb) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+            srgb = false;
+            return true;
+
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+            srgb = true;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
     //---------------------------------------------------------------------------------
     HRESULT CreateTextureFromWIC(
         _In_ ID3D11Device* d3dDevice,
@@ -540,18 +719,49 @@ namespace
             return E_OUTOFMEMORY;
 
         // Load image data
-        if (memcmp(&convertGUID, &pixelFormat, sizeof(GUID)) == 0
-            && twidth == width
-            && theight == height)
+        bool srgbResize = false;
+        if (twidth == width && theight == height)
+        {
+            // No resize needed
+            hr = CopyFramePixels(frame, pixelFormat, convertGUID, width, height, rowPitch, imageSize, temp.get());
+            if (FAILED(hr))
+                return hr;
+        }
+        else if (!(loadFlags & WIC_LOADER_RESIZE_WIC)
+            && IsCpuMipFormat(format, srgbResize)
+            && uint64_t(width) * uint64_t(height) * 4u <= UINT32_MAX)
         {
-            // No format conversion or resize needed
-            hr = frame->CopyPixels(nullptr, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
+            // Resize: decode at full size, then filter with qisx::Resampler (area or
+            // Lanczos, in linear light for sRGB targets, across all cores)
+            const size_t fullPitch = size_t(width) * 4u;
+            const size_t fullSize = fullPitch * height;
+            std::unique_ptr<uint8_t[]> full(new (std::nothrow) uint8_t[fullSize]);
+            if (!full)
+                return E_OUTOFMEMORY;
+
+            hr = CopyFramePixels(frame, pixelFormat, convertGUID, width, height, fullPitch, fullSize, full.get());
             if (FAILED(hr))
                 return hr;
+
+            qisx::Resampler::Options resizeOptions;
+            resizeOptions.filter = (loadFlags & WIC_LOADER_RESIZE_LANCZOS) ? qisx::ResampleFilter::Lanczos3 : qisx::ResampleFilter::Box;
+            resizeOptions.srgb = srgbResize;
+            resizeOptions.bandHeight = 64;  // Fewer, taller bands re-filter fewer apron rows on big reductions
+            try
+            {
+                qisx::Resampler resampler(resizeOptions);
+                if (!resampler.Resample(qisx::ImageView{ full.get(), width, height, fullPitch },
+                    qisx::MutableImageView{ temp.get(), twidth, theight, rowPitch }))
+                    return E_FAIL;
+            }
+            catch (const std::bad_alloc&)
+            {
+                return E_OUTOFMEMORY;
+            }
         }
-        else if (twidth != width || theight != height)
+        else
         {
-            // Resize
+            // Resize other formats (or with WIC_LOADER_RESIZE_WIC) through WIC
             auto pWIC = GetWIC();
             if (!pWIC)
                 return E_NOINTERFACE;
@@ -600,37 +810,34 @@ namespace
                     return hr;
             }
         }
-        else
-        {
-            // Format conversion but no resize
-            auto pWIC = GetWIC();
-            if (!pWIC)
-                return E_NOINTERFACE;
 
-            ComPtr<IWICFormatConverter> FC;
-            hr = pWIC->CreateFormatConverter(FC.GetAddressOf());
-            if (FAILED(hr))
-                return hr;
+        // 8-bit RGBA formats get their mip chain on the CPU, gamma-correct for
+        // sRGB, with every level passed as initial data. GenerateMips is only used
+        // for the other formats, and only when there is a context to run it on.
+        const bool wantMips = (d3dContext && textureView) || (loadFlags & WIC_LOADER_MIP_AUTOGEN);
+        bool srgbMips = false;
+        const bool cpuMips = wantMips && IsCpuMipFormat(format, srgbMips);
 
-            BOOL canConvert = FALSE;
-            hr = FC->CanConvert(pixelFormat, convertGUID, &canConvert);
-            if (FAILED(hr) || !canConvert)
+        std::vector<qisx::Image> mips;
+        if (cpuMips)
+        {
+            qisx::MipGenerator::Options mipOptions;
+            mipOptions.srgb = srgbMips;
+            try
             {
-                return E_UNEXPECTED;
+                qisx::MipGenerator generator(mipOptions);
+                if (!generator.Generate(qisx::ImageView{ temp.get(), twidth, theight, rowPitch }, mips))
+                    return E_FAIL;
+            }
+            catch (const std::bad_alloc&)
+            {
+                return E_OUTOFMEMORY;
             }
-
-            hr = FC->Initialize(frame, convertGUID, WICBitmapDitherTypeErrorDiffusion, nullptr, 0, WICBitmapPaletteTypeMedianCut);
-            if (FAILED(hr))
-                return hr;
-
-            hr = FC->CopyPixels(nullptr, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
-            if (FAILED(hr))
-                return hr;
         }
 
         // See if format is supported for auto-gen mipmaps (varies by feature level)
         bool autogen = false;
-        if (d3dContext && textureView) // Must have context and shader-view to auto generate mipmaps
+        if (!cpuMips && d3dContext && textureView) // Must have context and shader-view to auto generate mipmaps
         {
             UINT fmtSupport = 0;
             hr = d3dDevice->CheckFormatSupport(format, &fmtSupport);
@@ -648,7 +855,7 @@ namespace
         D3D11_TEXTURE2D_DESC desc = {};
         desc.Width = twidth;
         desc.Height = theight;
-        desc.MipLevels = (autogen) ? 0u : 1u;
+        desc.MipLevels = (autogen) ? 0u : static_cast<UINT>(1 + mips.size());
         desc.ArraySize = 1;
         desc.Format = format;
         desc.SampleDesc.Count = 1;
@@ -669,8 +876,17 @@ namespace
 
         D3D11_SUBRESOURCE_DATA initData = { temp.get(), static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize) };
 
+        std::vector<D3D11_SUBRESOURCE_DATA> levelData;
+        if (!mips.empty())
+        {
+            levelData.reserve(1 + mips.size());
+            levelData.push_back(initData);
+            for (const qisx::Image& mip : mips)
+                levelData.push_back({ mip.Data(), static_cast<UINT>(mip.RowPitch()), static_cast<UINT>(mip.SizeInBytes()) });
+        }
+
         ID3D11Texture2D* tex = nullptr;
-        hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : &initData, &tex);
+        hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : (levelData.empty() ? &initData : levelData.data()), &tex);
         if (SUCCEEDED(hr) && tex)
         {
             if (textureView)
@@ -679,7 +895,7 @@ namespace
                 SRVDesc.Format = desc.Format;
 
                 SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-                SRVDesc.Texture2D.MipLevels = (autogen) ? unsigned(-1) : 1u;
+                SRVDesc.Texture2D.MipLevels = (autogen) ? unsigned(-1) : desc.MipLevels;
 
                 hr = d3dDevice->CreateShaderResourceView(tex, &SRVDesc, textureView);
                 if (FAILED(hr))
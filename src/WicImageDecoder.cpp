@@ -0,0 +1,135 @@
+#if defined(_WIN32)
+
+#include "ImageDecoder.h"
+#include <cstring>
+#include <wincodec.h>
+#include <wrl/client.h>
+#pragma comment(lib, "windowscodecs.lib")
+
+using Microsoft::WRL::ComPtr;
+
+namespace qisx {
+
+namespace {
+
+    void SetError(std::string* error, const char* message)
+    {
+        if (error)
+            *error = message;
+    }
+
+    // COM on the calling thread for the duration of one call. Threads already in
+    // an apartment (e.g. the UI thread) get RPC_E_CHANGED_MODE, which is fine.
+    class ComScope {
+    public:
+        ComScope() : m_hr(CoInitializeEx(nullptr, COINIT_MULTITHREADED)) {}
+        ~ComScope()
+        {
+            if (SUCCEEDED(m_hr))
+                CoUninitialize();
+        }
+
+    private:
+        HRESULT m_hr;
+    };
+
+    // The factory is created per call, inside the caller's ComScope, so it
+    // never outlives the apartment it was created in.
+    HRESULT OpenFrame(const uint8_t* data, size_t size, ComPtr<IWICImagingFactory>& factory,
+        ComPtr<IWICBitmapFrameDecode>& frame)
+    {
+        if (size > UINT32_MAX)
+            return E_INVALIDARG;
+
+        HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+            IID_PPV_ARGS(factory.GetAddressOf()));
+        ComPtr<IWICStream> stream;
+        if (SUCCEEDED(hr))
+            hr = factory->CreateStream(stream.GetAddressOf());
+        if (SUCCEEDED(hr))
+            hr = stream->InitializeFromMemory(const_cast<BYTE*>(data), DWORD(size));
+        ComPtr<IWICBitmapDecoder> decoder;
+        if (SUCCEEDED(hr))
+            hr = factory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+        if (SUCCEEDED(hr))
+            hr = decoder->GetFrame(0, frame.GetAddressOf());
+        return hr;
+    }
+
+    // Reference decoder backed by Windows Imaging Component, mainly so the
+    // portable decoders can be benchmarked and cross-checked against it.
+    class WicDecoder final : public ImageDecoder {
+    public:
+        const char* Name() const override { return "wic"; }
+
+        bool CanDecode(const uint8_t* data, size_t size) const override
+        {
+            static const uint8_t kPng[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            if (size < 8)
+                return false;
+            return !std::memcmp(data, kPng, 8)
+                || (data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+                || (data[0] == 'B' && data[1] == 'M')
+                || !std::memcmp(data, "GIF8", 4)
+                || !std::memcmp(data, "II*\0", 4) || !std::memcmp(data, "MM\0*", 4);
+        }
+
+        bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info, std::string* error) const override
+        {
+            ComScope com;
+            ComPtr<IWICImagingFactory> factory;
+            ComPtr<IWICBitmapFrameDecode> frame;
+            UINT width = 0, height = 0;
+            if (FAILED(OpenFrame(data, size, factory, frame)) || FAILED(frame->GetSize(&width, &height))) {
+                SetError(error, "WIC cannot read this image");
+                return false;
+            }
+            info.width = width;
+            info.height = height;
+            return true;
+        }
+
+        bool Decode(const uint8_t* data, size_t size, const MutableImageView& dst, std::string* error) const override
+        {
+            ComScope com;
+            ComPtr<IWICImagingFactory> factory;
+            ComPtr<IWICBitmapFrameDecode> frame;
+            UINT width = 0, height = 0;
+            if (FAILED(OpenFrame(data, size, factory, frame)) || FAILED(frame->GetSize(&width, &height))) {
+                SetError(error, "WIC cannot read this image");
+                return false;
+            }
+            if (dst.width != width || dst.height != height) {
+                SetError(error, "destination size does not match the image");
+                return false;
+            }
+
+            // The converter is a pass-through when the frame is already RGBA8
+            ComPtr<IWICFormatConverter> converter;
+            HRESULT hr = factory->CreateFormatConverter(converter.GetAddressOf());
+            if (SUCCEEDED(hr))
+                hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone,
+                    nullptr, 0.0, WICBitmapPaletteTypeMedianCut);
+            const uint64_t bytes = uint64_t(dst.rowPitch) * dst.height;
+            if (SUCCEEDED(hr) && (dst.rowPitch > UINT32_MAX || bytes > UINT32_MAX))
+                hr = E_INVALIDARG;
+            if (SUCCEEDED(hr))
+                hr = converter->CopyPixels(nullptr, UINT(dst.rowPitch), UINT(bytes), dst.data);
+            if (FAILED(hr)) {
+                SetError(error, "WIC decode failed");
+                return false;
+            }
+            return true;
+        }
+    };
+
+}
+
+std::unique_ptr<ImageDecoder> CreateWicDecoder()
+{
+    return std::make_unique<WicDecoder>();
+}
+
+}
+
+#endif
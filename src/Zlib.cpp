@@ -0,0 +1,537 @@
+#include "Zlib.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace qisx {
+
+namespace {
+
+    const uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    const uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    const uint8_t kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    constexpr size_t kWindowSize = 32768;
+    constexpr int kMinMatch = 3;
+    constexpr int kMaxMatch = 258;
+    constexpr int kHashBits = 15;
+    constexpr int kMaxChain = 8;
+
+    const std::array<uint32_t, 256>& CrcTable()
+    {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // LSB-first bit packer as deflate requires
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+        void PutBits(uint32_t value, int count)
+        {
+            m_bits |= uint64_t(value) << m_count;
+            m_count += count;
+            while (m_count >= 8) {
+                m_out.push_back(uint8_t(m_bits));
+                m_bits >>= 8;
+                m_count -= 8;
+            }
+        }
+
+        // Huffman codes are defined MSB-first
+        void PutCode(uint32_t code, int length)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; i++)
+                reversed |= ((code >> i) & 1) << (length - 1 - i);
+            PutBits(reversed, length);
+        }
+
+        void Flush()
+        {
+            if (m_count > 0)
+                m_out.push_back(uint8_t(m_bits));
+            m_bits = 0;
+            m_count = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint64_t m_bits = 0;
+        int m_count = 0;
+    };
+
+    void PutFixedLiteral(BitWriter& bits, int symbol)
+    {
+        if (symbol < 144)
+            bits.PutCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            bits.PutCode(0x190 + (symbol - 144), 9);
+        else if (symbol < 280)
+            bits.PutCode(symbol - 256, 7);
+        else
+            bits.PutCode(0xC0 + (symbol - 280), 8);
+    }
+
+    void PutMatch(BitWriter& bits, int length, int distance)
+    {
+        int code = 0;
+        while (code < 28 && kLengthBase[code + 1] <= length)
+            code++;
+        PutFixedLiteral(bits, 257 + code);
+        bits.PutBits(length - kLengthBase[code], kLengthExtra[code]);
+
+        int dcode = 0;
+        while (dcode < 29 && kDistanceBase[dcode + 1] <= distance)
+            dcode++;
+        bits.PutCode(dcode, 5);
+        bits.PutBits(distance - kDistanceBase[dcode], kDistanceExtra[dcode]);
+    }
+
+    inline uint32_t Hash3(const uint8_t* p)
+    {
+        const uint32_t v = uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+    const std::array<uint32_t, 256>& table = CrcTable();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler)
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        // 5552 is the largest block that cannot overflow b before the modulo
+        const size_t block = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < block; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += block;
+        size -= block;
+    }
+    return (b << 16) | a;
+}
+
+void ZlibCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+{
+    out.push_back(0x78);    // CM = deflate, 32 KB window
+    out.push_back(0x01);    // FLEVEL = fastest, FCHECK
+
+    BitWriter bits(out);
+    bits.PutBits(1, 1);     // BFINAL
+    bits.PutBits(1, 2);     // BTYPE = fixed Huffman
+
+    std::vector<int32_t> head(size_t(1) << kHashBits, -1);
+    std::vector<int32_t> prev(kWindowSize, -1);
+    auto insert = [&](size_t pos) {
+        const uint32_t h = Hash3(data + pos);
+        prev[pos & (kWindowSize - 1)] = head[h];
+        head[h] = int32_t(pos);
+    };
+
+    size_t pos = 0;
+    while (pos < size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+
+        if (pos + kMinMatch <= size) {
+            const int maxLength = int(std::min<size_t>(kMaxMatch, size - pos));
+            int32_t candidate = head[Hash3(data + pos)];
+            for (int chain = 0; chain < kMaxChain && candidate >= 0; chain++) {
+                const size_t distance = pos - size_t(candidate);
+                if (distance > kWindowSize)
+                    break;
+
+                int length = 0;
+                while (length < maxLength && data[candidate + length] == data[pos + length])
+                    length++;
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = int(distance);
+                    if (length == maxLength)
+                        break;
+                }
+                candidate = prev[size_t(candidate) & (kWindowSize - 1)];
+            }
+            insert(pos);
+        }
+
+        if (bestLength >= kMinMatch) {
+            PutMatch(bits, bestLength, bestDistance);
+            for (size_t i = pos + 1; i < pos + bestLength && i + kMinMatch <= size; i++)
+                insert(i);
+            pos += bestLength;
+        }
+        else {
+            PutFixedLiteral(bits, data[pos]);
+            pos++;
+        }
+    }
+
+    PutFixedLiteral(bits, 256);
+    bits.Flush();
+
+    const uint32_t adler = Adler32(data, size);
+    out.push_back(uint8_t(adler >> 24));
+    out.push_back(uint8_t(adler >> 16));
+    out.push_back(uint8_t(adler >> 8));
+    out.push_back(uint8_t(adler));
+}
+
+namespace {
+
+    // Canonical Huffman decoder: a 9-bit lookup for short codes and a
+    // per-length limit scan for the rest (deflate codes are at most 15 bits).
+    class HuffmanTable {
+    public:
+        static constexpr int kFastBits = 9;
+
+        bool Build(const uint8_t* lengths, int count)
+        {
+            int lengthCount[17] = {};
+            for (int i = 0; i < count; i++)
+                lengthCount[lengths[i]]++;
+            lengthCount[0] = 0;
+
+            std::memset(m_fast, 0, sizeof(m_fast));
+            std::memset(m_size, 0, sizeof(m_size));
+            int nextCode[16];
+            int code = 0;
+            int symbol = 0;
+            for (int len = 1; len < 16; len++) {
+                nextCode[len] = code;
+                m_firstCode[len] = uint16_t(code);
+                m_firstSymbol[len] = uint16_t(symbol);
+                code += lengthCount[len];
+                if (lengthCount[len] && code - 1 >= (1 << len))
+                    return false;   // Over-subscribed
+                m_maxCode[len] = code << (16 - len);
+                code <<= 1;
+                symbol += lengthCount[len];
+            }
+            m_maxCode[16] = 0x10000;
+
+            for (int i = 0; i < count; i++) {
+                const int len = lengths[i];
+                if (!len)
+                    continue;
+                const int slot = nextCode[len] - m_firstCode[len] + m_firstSymbol[len];
+                m_size[slot] = uint8_t(len);
+                m_value[slot] = uint16_t(i);
+                if (len <= kFastBits) {
+                    // Bits arrive LSB-first, so index by the reversed code
+                    int reversed = Reverse(nextCode[len], len);
+                    for (; reversed < (1 << kFastBits); reversed += 1 << len)
+                        m_fast[reversed] = uint16_t(slot + 1);
+                }
+                nextCode[len]++;
+            }
+            return true;
+        }
+
+        // Returns the symbol, or -1 on an invalid code; consumes its bits.
+        int Decode(uint64_t& bits, int& count) const
+        {
+            const int fast = m_fast[bits & ((1 << kFastBits) - 1)];
+            if (fast) {
+                const int slot = fast - 1;
+                bits >>= m_size[slot];
+                count -= m_size[slot];
+                return m_value[slot];
+            }
+
+            const int k = Reverse(int(bits & 0xFFFF), 16);
+            int len = kFastBits + 1;
+            while (k >= m_maxCode[len])
+                len++;
+            if (len >= 16)
+                return -1;
+            const int slot = (k >> (16 - len)) - m_firstCode[len] + m_firstSymbol[len];
+            if (slot < 0 || slot >= 288 || m_size[slot] != len)
+                return -1;
+            bits >>= len;
+            count -= len;
+            return m_value[slot];
+        }
+
+    private:
+        static int Reverse(int v, int bits)
+        {
+            int r = 0;
+            for (int i = 0; i < bits; i++)
+                r |= ((v >> i) & 1) << (bits - 1 - i);
+            return r;
+        }
+
+        uint16_t m_fast[1 << kFastBits];
+        uint16_t m_firstCode[17];
+        uint16_t m_firstSymbol[17];
+        int m_maxCode[18];
+        uint8_t m_size[288];
+        uint16_t m_value[288];
+    };
+
+    class Inflater {
+    public:
+        Inflater(const ByteSpan* spans, size_t spanCount, uint8_t* out, size_t outSize)
+            : m_spans(spans), m_spanCount(spanCount), m_out(out), m_outSize(outSize) {}
+
+        bool Run()
+        {
+            const int cmf = ReadByte();
+            const int flg = ReadByte();
+            if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20))
+                return false;   // Not deflate, bad check bits, or preset dictionary
+
+            bool final = false;
+            while (!final) {
+                Refill();
+                final = Bits(1) != 0;
+                const int type = int(Bits(2));
+                bool ok = false;
+                if (type == 0)
+                    ok = StoredBlock();
+                else if (type == 1)
+                    ok = FixedTables() && CompressedBlock();
+                else if (type == 2)
+                    ok = DynamicTables() && CompressedBlock();
+                if (!ok || Overrun())
+                    return false;
+            }
+
+            // Adler-32 trailer is byte aligned
+            DropBits(m_count & 7);
+            uint32_t adler = 0;
+            for (int i = 0; i < 4; i++)
+                adler = (adler << 8) | uint32_t(ReadByte());
+            return !Overrun() && m_pos == m_outSize && adler == Adler32(m_out, m_outSize);
+        }
+
+    private:
+        // Refill pads with zeros past the end; consuming any of them means short input
+        bool Overrun() const { return m_overrun * 8 > size_t(m_count); }
+
+        // Next input byte across spans; zero (and counted) past the end
+        uint8_t NextByte()
+        {
+            while (m_span < m_spanCount) {
+                if (m_offset < m_spans[m_span].size)
+                    return m_spans[m_span].data[m_offset++];
+                m_span++;
+                m_offset = 0;
+            }
+            m_overrun++;
+            return 0;
+        }
+
+        void Refill()
+        {
+            while (m_count <= 56) {
+                m_bits |= uint64_t(NextByte()) << m_count;
+                m_count += 8;
+            }
+        }
+
+        uint32_t Bits(int n)
+        {
+            const uint32_t v = uint32_t(m_bits & ((uint64_t(1) << n) - 1));
+            DropBits(n);
+            return v;
+        }
+
+        void DropBits(int n)
+        {
+            m_bits >>= n;
+            m_count -= n;
+        }
+
+        // Byte from the bit buffer first (after alignment), then the input
+        int ReadByte()
+        {
+            if (m_count >= 8)
+                return int(Bits(8));
+            return NextByte();
+        }
+
+        bool StoredBlock()
+        {
+            DropBits(m_count & 7);
+            const int len = ReadByte() | (ReadByte() << 8);
+            const int nlen = ReadByte() | (ReadByte() << 8);
+            if ((len ^ 0xFFFF) != nlen || m_pos + size_t(len) > m_outSize)
+                return false;
+
+            for (int i = 0; i < len; i++)
+                m_out[m_pos++] = uint8_t(ReadByte());
+            return true;
+        }
+
+        bool FixedTables()
+        {
+            uint8_t lengths[288 + 32];
+            std::memset(lengths, 8, 144);
+            std::memset(lengths + 144, 9, 112);
+            std::memset(lengths + 256, 7, 24);
+            std::memset(lengths + 280, 8, 8);
+            std::memset(lengths + 288, 5, 32);
+            return m_literals.Build(lengths, 288) && m_distances.Build(lengths + 288, 32);
+        }
+
+        bool DynamicTables()
+        {
+            static const uint8_t kOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            Refill();
+            const int hlit = int(Bits(5)) + 257;
+            const int hdist = int(Bits(5)) + 1;
+            const int hclen = int(Bits(4)) + 4;
+
+            uint8_t codeLengths[19] = {};
+            Refill();
+            for (int i = 0; i < hclen; i++) {
+                if (i == 10)
+                    Refill();
+                codeLengths[kOrder[i]] = uint8_t(Bits(3));
+            }
+            HuffmanTable lengthCode;
+            if (!lengthCode.Build(codeLengths, 19))
+                return false;
+
+            uint8_t lengths[288 + 32] = {};
+            int n = 0;
+            while (n < hlit + hdist) {
+                Refill();
+                const int symbol = lengthCode.Decode(m_bits, m_count);
+                if (symbol < 0)
+                    return false;
+                if (symbol < 16) {
+                    lengths[n++] = uint8_t(symbol);
+                    continue;
+                }
+
+                int repeat = 0;
+                uint8_t value = 0;
+                if (symbol == 16) {
+                    if (n == 0)
+                        return false;
+                    repeat = 3 + int(Bits(2));
+                    value = lengths[n - 1];
+                }
+                else if (symbol == 17) {
+                    repeat = 3 + int(Bits(3));
+                }
+                else {
+                    repeat = 11 + int(Bits(7));
+                }
+                if (n + repeat > hlit + hdist)
+                    return false;
+                std::memset(lengths + n, value, size_t(repeat));
+                n += repeat;
+            }
+            if (lengths[256] == 0)
+                return false;
+
+            // Distance lengths follow the literal lengths directly
+            uint8_t distances[32] = {};
+            std::memcpy(distances, lengths + hlit, size_t(hdist));
+            return m_literals.Build(lengths, hlit) && m_distances.Build(distances, 32);
+        }
+
+        bool CompressedBlock()
+        {
+            for (;;) {
+                Refill();
+                const int symbol = m_literals.Decode(m_bits, m_count);
+                if (symbol < 0)
+                    return false;
+                if (symbol < 256) {
+                    if (m_pos >= m_outSize)
+                        return false;
+                    m_out[m_pos++] = uint8_t(symbol);
+                    continue;
+                }
+                if (symbol == 256)
+                    return true;
+
+                const int lengthCode = symbol - 257;
+                if (lengthCode >= 29)
+                    return false;
+                const size_t length = kLengthBase[lengthCode] + Bits(kLengthExtra[lengthCode]);
+
+                Refill();
+                const int distanceCode = m_distances.Decode(m_bits, m_count);
+                if (distanceCode < 0 || distanceCode >= 30)
+                    return false;
+                const size_t distance = kDistanceBase[distanceCode] + Bits(kDistanceExtra[distanceCode]);
+                if (distance > m_pos || m_pos + length > m_outSize)
+                    return false;
+
+                uint8_t* dst = m_out + m_pos;
+                const uint8_t* src = dst - distance;
+                if (distance >= length) {
+                    std::memcpy(dst, src, length);
+                }
+                else if (distance == 1) {
+                    std::memset(dst, *src, length);
+                }
+                else {
+                    for (size_t i = 0; i < length; i++)
+                        dst[i] = src[i];
+                }
+                m_pos += length;
+            }
+        }
+
+        const ByteSpan* m_spans;
+        size_t m_spanCount;
+        size_t m_span = 0;
+        size_t m_offset = 0;
+        size_t m_overrun = 0;
+
+        uint64_t m_bits = 0;
+        int m_count = 0;
+
+        uint8_t* m_out;
+        size_t m_outSize;
+        size_t m_pos = 0;
+
+        HuffmanTable m_literals;
+        HuffmanTable m_distances;
+    };
+
+}
+
+bool ZlibDecompress(const ByteSpan* spans, size_t spanCount, uint8_t* out, size_t outSize)
+{
+    Inflater inflater(spans, spanCount, out, outSize);
+    return inflater.Run();
+}
+
+}